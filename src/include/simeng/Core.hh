@@ -56,6 +56,13 @@ class Core {
  protected:
   /** Apply changes to the process state. */
   void applyStateChange(const arch::ProcessStateChange& change) const {
+    applyStateChange(change, dataMemory_);
+  }
+
+  /** Apply changes to the process state, making any memory changes through
+   * `memory`. */
+  void applyStateChange(const arch::ProcessStateChange& change,
+                        memory::MemoryInterface& memory) const {
     auto& regFile = const_cast<ArchitecturalRegisterFileSet&>(
         getArchitecturalRegisterFileSet());
     // Update registers in accordance with the ProcessStateChange type
@@ -90,8 +97,13 @@ class Core {
     // TODO: Analyse if ChangeType::INCREMENT or ChangeType::DECREMENT case is
     // required for memory changes
     for (size_t i = 0; i < change.memoryAddresses.size(); i++) {
-      dataMemory_.requestWrite(change.memoryAddresses[i],
-                               change.memoryAddressValues[i]);
+      memory.requestWrite(change.memoryAddresses[i],
+                          change.memoryAddressValues[i]);
+    }
+    for (size_t i = 0; i < change.memoryBlockAddresses.size(); i++) {
+      memory.requestBlockWrite(change.memoryBlockAddresses[i],
+                               change.memoryBlockValues[i].data(),
+                               change.memoryBlockValues[i].size());
     }
   }
 
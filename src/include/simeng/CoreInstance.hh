@@ -11,6 +11,7 @@
 #include "simeng/branchpredictors/AlwaysNotTakenPredictor.hh"
 #include "simeng/branchpredictors/GenericPredictor.hh"
 #include "simeng/branchpredictors/PerceptronPredictor.hh"
+#include "simeng/branchpredictors/TagePredictor.hh"
 #include "simeng/config/SimInfo.hh"
 #include "simeng/kernel/Linux.hh"
 #include "simeng/memory/FixedLatencyMemoryInterface.hh"
@@ -20,6 +21,7 @@
 #include "simeng/models/outoforder/Core.hh"
 #include "simeng/pipeline/A64FXPortAllocator.hh"
 #include "simeng/pipeline/BalancedPortAllocator.hh"
+#include "simeng/pipeline/TablePortAllocator.hh"
 
 namespace simeng {
 
@@ -79,21 +81,51 @@ class CoreInstance {
   void createProcess(std::string executablePath,
                      std::vector<std::string> executableArgs);
 
+  /** Construct a SimEng linux process object from command line arguments, or
+   * from the source assembled by LLVM if the command line is empty. */
+  std::unique_ptr<kernel::LinuxProcess> makeProcess(
+      std::string executablePath,
+      std::vector<std::string> executableArgs) const;
+
   /** Construct the process memory from the generated process_ object. */
   void createProcessMemory();
 
+  /** Construct a non-External memory interface of type `type` onto the
+   * `size` bytes of process memory at `memory`. Returns a nullptr if the type
+   * is unsupported. */
+  std::shared_ptr<memory::MemoryInterface> makeL1Memory(
+      const memory::MemInterfaceType type, char* memory, uint64_t size) const;
+
   /** Construct the SimEng L1 instruction cache memory. */
   void createL1InstructionMemory(const memory::MemInterfaceType type);
 
   /** Construct the SimEng L1 data cache memory. */
   void createL1DataMemory(const memory::MemInterfaceType type);
 
-  /** Construct the special file directory. */
-  void createSpecialFileDirectory();
+  /** Construct the process, kernel, and memory interfaces of each hardware
+   * thread beyond the first, which runs its own copy of the program. */
+  void createHardwareThreads(std::string executablePath,
+                             std::vector<std::string> executableArgs,
+                             const memory::MemInterfaceType iType,
+                             const memory::MemInterfaceType dType);
+
+  /** Construct an architecture, with knowledge of `kernel`. */
+  std::unique_ptr<arch::Architecture> makeArchitecture(
+      kernel::Linux& kernel) const;
+
+  /** Construct a branch predictor of the configured type. */
+  std::unique_ptr<BranchPredictor> makePredictor() const;
+
+  /** Construct the virtual filesystem served to the simulated program,
+   * holding the generated special files and any input overlay directory. */
+  std::shared_ptr<kernel::VirtualFileSystem> makeFileSystem() const;
 
   /** The config file describing the modelled core to be created. */
   ryml::ConstNodeRef config_;
 
+  /** The virtual filesystem shared by the kernel of each hardware thread. */
+  std::shared_ptr<kernel::VirtualFileSystem> fileSystem_;
+
   /** The SimEng Linux kernel object. */
   simeng::kernel::Linux kernel_;
 
@@ -138,6 +170,34 @@ class CoreInstance {
 
   /** Reference to the SimEng instruction memory object. */
   std::shared_ptr<simeng::memory::MemoryInterface> instructionMemory_ = nullptr;
+
+  /** The simulation objects private to a hardware thread beyond the first. */
+  struct HardwareThread {
+    /** The Linux kernel managing the thread's process. */
+    std::unique_ptr<simeng::kernel::Linux> kernel;
+
+    /** The thread's process. */
+    std::unique_ptr<simeng::kernel::LinuxProcess> process;
+
+    /** The thread's process memory space. */
+    std::shared_ptr<char> processMemory;
+
+    /** The thread's instruction memory interface. */
+    std::shared_ptr<simeng::memory::MemoryInterface> instructionMemory;
+
+    /** The thread's data memory interface. */
+    std::shared_ptr<simeng::memory::MemoryInterface> dataMemory;
+
+    /** The thread's architecture, bound to its kernel. */
+    std::unique_ptr<simeng::arch::Architecture> arch;
+
+    /** The thread's branch predictor. */
+    std::unique_ptr<simeng::BranchPredictor> predictor;
+  };
+
+  /** The hardware threads beyond the first, whose simulation objects are held
+   * in the members above. */
+  std::vector<HardwareThread> hardwareThreads_;
 };
 
 }  // namespace simeng
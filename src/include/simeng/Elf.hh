@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,16 @@ struct Elf64_Phdr {
   uint64_t p_memsz;
 };
 
+/** A function defined by an ELF file's symbol table. */
+struct ElfSymbol {
+  /** The name of the function. */
+  std::string name;
+  /** The virtual address of the function's first instruction. */
+  uint64_t address;
+  /** The size of the function in bytes. It may be zero where unknown. */
+  uint64_t size;
+};
+
 /** A processed Executable and Linkable Format (ELF) file. */
 class Elf {
  public:
@@ -71,7 +82,16 @@ class Elf {
   /** Returns the number of program headers */
   uint64_t getNumPhdr() const;
 
+  /** Returns the functions defined by the symbol table, sorted by address. The
+   * vector is empty if the ELF has been stripped of its symbol table. */
+  const std::vector<ElfSymbol>& getSymbols() const;
+
  private:
+  /** Read the functions defined by the symbol table from `file`, whose section
+   * header table resides at offset `e_shoff`. */
+  void readSymbols(std::ifstream& file, uint64_t e_shoff, uint16_t e_shentsize,
+                   uint16_t e_shnum);
+
   /** The entry point of the program */
   uint64_t entryPoint_;
 
@@ -93,6 +113,9 @@ class Elf {
 
   /** The size of the process image */
   uint64_t processImageSize_;
+
+  /** The functions defined by the symbol table, sorted by address */
+  std::vector<ElfSymbol> symbols_;
 };
 
 }  // namespace simeng
@@ -128,6 +128,12 @@ class Instruction {
   /** Retrieve this instruction's instruction ID. */
   uint64_t getInstructionId() const { return instructionId_; }
 
+  /** Set the ID of the hardware thread this instruction belongs to. */
+  void setThreadId(uint16_t threadId) { threadId_ = threadId; }
+
+  /** Retrieve the ID of the hardware thread this instruction belongs to. */
+  uint16_t getThreadId() const { return threadId_; }
+
   /** Set this instruction's instruction memory address. */
   void setInstructionAddress(uint64_t address) {
     instructionAddress_ = address;
@@ -210,6 +216,15 @@ class Instruction {
   /** Get arbitrary micro-operation index. */
   int getMicroOpIndex() const { return microOpIndex_; }
 
+  /** Is this a macro-op fused from two instructions? */
+  bool isFused() const { return isFused_; }
+
+  /** Record the cycle in which this load began accessing memory. */
+  void setLoadStartCycle(uint64_t cycle) { loadStartCycle_ = cycle; }
+
+  /** Retrieve the cycle in which this load began accessing memory. */
+  uint64_t getLoadStartCycle() const { return loadStartCycle_; }
+
  protected:
   /** Set the accessed memory addresses, and create a corresponding memory data
    * vector. */
@@ -245,6 +260,9 @@ class Instruction {
    * newer instruction. */
   uint64_t sequenceId_ = 0;
 
+  /** The hardware thread this instruction belongs to. */
+  uint16_t threadId_ = 0;
+
   /** The location in memory of this instruction was decoded at. */
   uint64_t instructionAddress_ = 0;
 
@@ -282,6 +300,9 @@ class Instruction {
   /** The number of data items that still need to be supplied. */
   uint8_t dataPending_ = 0;
 
+  /** The cycle in which a load began accessing memory. */
+  uint64_t loadStartCycle_ = 0;
+
   // Branches
   /** The predicted branching result. */
   BranchPrediction prediction_ = {false, 0};
@@ -321,6 +342,10 @@ class Instruction {
   /** An arbitrary index value for the micro-operation. Its use is based on the
    * implementation of specific micro-operations. */
   int microOpIndex_ = 0;
+
+  // Macro-op fusion
+  /** Is this a macro-op fused from two adjacent instructions? */
+  bool isFused_ = false;
 };
 
 }  // namespace simeng
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "simeng/config/SimInfo.hh"
+#include "simeng/kernel/VirtualFileSystem.hh"
 
 namespace simeng {
 class SpecialFileDirGen {
@@ -19,6 +20,10 @@ class SpecialFileDirGen {
    * the '/src.lib/kernel/specialFiles' directory. */
   void GenerateSFDir();
 
+  /** Adds the special files to `fileSystem` at the paths they're opened from,
+   * such that they're served from memory without creating the directory. */
+  void GenerateSFDir(kernel::VirtualFileSystem& fileSystem) const;
+
  private:
   /** Path to the root of the SimEng special files directory. */
   const std::string specialFilesDir_;
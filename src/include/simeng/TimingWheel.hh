@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace simeng {
+
+/** A timing wheel (calendar queue) holding entries scheduled for a cycle.
+ * Entries are popped in order of their cycle, and in the order they were
+ * pushed within a cycle.
+ *
+ * The wheel holds a bucket for each cycle within a window of `size` cycles,
+ * indexed by the cycle modulo the size. Each bucket keeps the entries pushed to
+ * it for reuse once popped, such that pushing an entry doesn't allocate once
+ * the wheel has warmed up; any storage an entry owns is recycled along with it.
+ * Should a push fall outside the window of pending cycles, the wheel doubles in
+ * size. */
+template <class T>
+class TimingWheel {
+ public:
+  /** Construct a timing wheel with an initial window of at least `size`
+   * cycles. */
+  explicit TimingWheel(size_t size = 64) {
+    size_t buckets = 1;
+    while (buckets < size) buckets <<= 1;
+    buckets_.resize(buckets);
+  }
+
+  /** Append an entry to those scheduled for `cycle`, returning a reference to
+   * it. The entry may hold the values of an entry previously popped, and
+   * should be fully reassigned by the caller. */
+  T& push(uint64_t cycle) {
+    if (count_ == 0) {
+      head_ = cycle;
+      last_ = cycle;
+    } else {
+      uint64_t first = std::min(head_, cycle);
+      uint64_t last = std::max(last_, cycle);
+      while (last - first >= buckets_.size()) grow();
+      head_ = first;
+      last_ = last;
+    }
+
+    auto& bucket = buckets_[mask(cycle)];
+    if (bucket.head == bucket.tail) bucket.cycle = cycle;
+    assert(bucket.cycle == cycle && "Timing wheel bucket holds another cycle");
+    if (bucket.tail == bucket.entries.size()) bucket.entries.emplace_back();
+    count_++;
+    return bucket.entries[bucket.tail++];
+  }
+
+  /** Retrieve the earliest scheduled entry. The wheel must not be empty. */
+  T& front() {
+    auto& bucket = findHead();
+    return bucket.entries[bucket.head];
+  }
+
+  /** Retrieve the cycle of the earliest scheduled entry. The wheel must not be
+   * empty. */
+  uint64_t frontCycle() {
+    findHead();
+    return head_;
+  }
+
+  /** Remove the earliest scheduled entry. Its storage is retained, to be
+   * reused by a later push. The wheel must not be empty. */
+  void pop_front() {
+    auto& bucket = findHead();
+    bucket.head++;
+    if (bucket.head == bucket.tail) {
+      bucket.head = 0;
+      bucket.tail = 0;
+    }
+    count_--;
+  }
+
+  /** Query whether any entries are scheduled. */
+  bool empty() const { return count_ == 0; }
+
+  /** Retrieve the number of scheduled entries. */
+  size_t size() const { return count_; }
+
+ private:
+  /** A bucket of the entries scheduled for a single cycle. */
+  struct bucket {
+    /** The cycle the entries are scheduled for. */
+    uint64_t cycle = 0;
+    /** The bucket's entries; those outside [head, tail) have been popped and
+     * are awaiting reuse. */
+    std::vector<T> entries;
+    /** The index of the earliest entry in `entries`. */
+    size_t head = 0;
+    /** The index after the latest entry in `entries`. */
+    size_t tail = 0;
+  };
+
+  /** Retrieve the bucket index of `cycle`. */
+  size_t mask(uint64_t cycle) const { return cycle & (buckets_.size() - 1); }
+
+  /** Advance `head_` to the earliest non-empty bucket, and return it. */
+  bucket& findHead() {
+    assert(count_ > 0 && "Attempted to access an empty timing wheel");
+    while (buckets_[mask(head_)].head == buckets_[mask(head_)].tail) head_++;
+    return buckets_[mask(head_)];
+  }
+
+  /** Double the number of buckets, moving each pending entry to the bucket of
+   * its cycle in the larger wheel. */
+  void grow() {
+    std::vector<bucket> old(buckets_.size() * 2);
+    std::swap(old, buckets_);
+    for (auto& from : old) {
+      if (from.head == from.tail) continue;
+      auto& to = buckets_[mask(from.cycle)];
+      to.cycle = from.cycle;
+      for (size_t i = from.head; i < from.tail; i++) {
+        to.entries.push_back(std::move(from.entries[i]));
+      }
+      to.tail = to.entries.size();
+    }
+  }
+
+  /** The wheel's buckets, of which there are a power of two. */
+  std::vector<bucket> buckets_;
+
+  /** A cycle no later than that of the earliest scheduled entry. */
+  uint64_t head_ = 0;
+
+  /** The cycle of the latest scheduled entry. */
+  uint64_t last_ = 0;
+
+  /** The number of scheduled entries. */
+  size_t count_ = 0;
+};
+
+}  // namespace simeng
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 #include "simeng/Core.hh"
@@ -26,6 +27,24 @@ struct ExceptionResult {
   ProcessStateChange stateChange;
 };
 
+/** A user-defined macro-op fusion rule, matching a pair of adjacent
+ * instructions by instruction group or opcode. */
+struct FusionRule {
+  /** The instruction groups the first instruction may belong to. */
+  std::unordered_set<uint16_t> firstGroups;
+  /** The opcodes the first instruction may have. */
+  std::unordered_set<uint16_t> firstOpcodes;
+  /** The instruction groups the second instruction may belong to. */
+  std::unordered_set<uint16_t> secondGroups;
+  /** The opcodes the second instruction may have. */
+  std::unordered_set<uint16_t> secondOpcodes;
+  /** Whether the second instruction must write a register the first writes. */
+  bool sharedDestination;
+  /** The execution latency of the fused macro-op; a value of 0 takes that of
+   * the second instruction. */
+  uint16_t latency;
+};
+
 /** An abstract multi-cycle exception handler interface. Should be ticked each
  * cycle until complete. */
 class ExceptionHandler {
@@ -78,8 +97,17 @@ class Architecture {
   virtual uint8_t getMinInstructionSize() const = 0;
 
   /** Updates System registers of any system-based timers. */
-  virtual void updateSystemTimerRegisters(RegisterFileSet* regFile,
-                                          const uint64_t iterations) const = 0;
+  virtual void updateSystemTimerRegisters(
+      ArchitecturalRegisterFileSet* regFile,
+      const uint64_t iterations) const = 0;
+
+  /** Determine whether `first` and the `second` instruction immediately
+   * following it match a user-defined macro-op fusion rule. If so, returns
+   * true and writes the execution information of the fused macro-op into
+   * `info`. */
+  virtual bool getFusionInfo(const Instruction& first,
+                             const Instruction& second,
+                             ExecutionInfo& info) const = 0;
 
  protected:
   /** A Capstone decoding library handle, for decoding instructions. */
@@ -98,6 +126,9 @@ class Architecture {
   /** A map to hold the relationship between instruction opcode and
    * user-defined execution information. */
   std::unordered_map<uint16_t, ExecutionInfo> opcodeExecutionInfo_;
+
+  /** The user-defined macro-op fusion rules, in order of priority. */
+  std::vector<FusionRule> fusionRules_;
 };
 
 }  // namespace arch
@@ -25,6 +25,11 @@ struct ProcessStateChange {
   std::vector<memory::MemoryAccessTarget> memoryAddresses;
   /** Values to write to memory */
   std::vector<RegisterValue> memoryAddressValues;
+  /** Start addresses of contiguous blocks of memory to modify, each written
+   * with a single transfer */
+  std::vector<uint64_t> memoryBlockAddresses;
+  /** Data to write to each block of memory */
+  std::vector<std::vector<char>> memoryBlockValues;
 };
 
 }  // namespace arch
@@ -51,9 +51,18 @@ class Architecture : public arch::Architecture {
   uint8_t getMinInstructionSize() const override;
 
   /** Updates System registers of any system-based timers. */
-  void updateSystemTimerRegisters(RegisterFileSet* regFile,
+  void updateSystemTimerRegisters(ArchitecturalRegisterFileSet* regFile,
                                   const uint64_t iterations) const override;
 
+  /** Determine whether `first` and the `second` instruction immediately
+   * following it form a fusible idiom matching a user-defined macro-op fusion
+   * rule. If so, returns true and writes the execution information of the
+   * fused macro-op into `info`; that of the second instruction, with any
+   * latency override the rule defines. */
+  bool getFusionInfo(const simeng::Instruction& first,
+                     const simeng::Instruction& second,
+                     ExecutionInfo& info) const override;
+
   /** Retrieve an ExecutionInfo object for the requested instruction. If a
    * opcode-based override has been defined for the latency and/or
    * port information, return that instead of the group-defined execution
@@ -74,6 +83,11 @@ class Architecture : public arch::Architecture {
   void setSVCRval(const uint64_t newVal) const;
 
  private:
+  /** Determine whether `first` and `second` form one of the AArch64 idioms
+   * which may be fused: ADRP+ADD, MOVZ+MOVK, or a CMP or TST followed by a
+   * B.cond, with the second building upon the register the first writes. */
+  bool isFusionIdiom(const Instruction& first, const Instruction& second) const;
+
   /** A decoding cache, mapping an instruction word to a previously decoded
    * instruction. Instructions are added to the cache as they're decoded, to
    * reduce the overhead of future decoding. */
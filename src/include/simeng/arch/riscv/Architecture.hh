@@ -49,10 +49,24 @@ class Architecture : public arch::Architecture {
   uint8_t getMinInstructionSize() const override;
 
   /** Updates System registers of any system-based timers. */
-  void updateSystemTimerRegisters(RegisterFileSet* regFile,
+  void updateSystemTimerRegisters(ArchitecturalRegisterFileSet* regFile,
                                   const uint64_t iterations) const override;
 
+  /** Determine whether `first` and the `second` instruction immediately
+   * following it form a fusible idiom matching a user-defined macro-op fusion
+   * rule. If so, returns true and writes the execution information of the
+   * fused macro-op into `info`; that of the second instruction, with any
+   * latency override the rule defines. */
+  bool getFusionInfo(const simeng::Instruction& first,
+                     const simeng::Instruction& second,
+                     ExecutionInfo& info) const override;
+
  private:
+  /** Determine whether `first` and `second` form one of the RISC-V idioms
+   * which may be fused: LUI+ADDI(W), AUIPC+ADDI, AUIPC+JALR, or SLLI+SRLI by
+   * 32 bits, with the second building upon the register the first writes. */
+  bool isFusionIdiom(const Instruction& first, const Instruction& second) const;
+
   /** Retrieve an ExecutionInfo object for the requested instruction. If a
    * opcode-based override has been defined for the latency and/or
    * port information, return that instead of the group-defined execution
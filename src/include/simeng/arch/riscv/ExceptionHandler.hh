@@ -51,13 +51,20 @@ class ExceptionHandler : public simeng::arch::ExceptionHandler {
   /** Read `length` bytes of data from `ptr`, and then call `then`.
    *
    * This function will repeatedly set itself as the handler for the next cycle
-   * until it has read `length` bytes of data. The data may be read in chunks if
-   * it is larger than can be read in a single memory request. The data will be
-   * appended to the member vector `dataBuffer`.
+   * until it has read `length` bytes of data. If the memory interface permits
+   * it, the data is read immediately as a single block; otherwise, it may be
+   * read in chunks if it is larger than can be read in a single memory
+   * request. The data will be appended to the member vector `dataBuffer`.
    */
   bool readBufferThen(uint64_t ptr, uint64_t length, std::function<bool()> then,
                       bool firstCall = true);
 
+  /** Write the contents of any shared file mappings between `addr` and
+   * `addr + length` back to their files, and then call `then`. The contents
+   * of each mapping are read from memory in turn using `readBufferThen`. */
+  bool writeBackThen(uint64_t addr, uint64_t length,
+                     std::function<bool()> then);
+
   /** A data buffer used for reading data from memory. */
   std::vector<uint8_t> dataBuffer_;
 
@@ -68,6 +75,21 @@ class ExceptionHandler : public simeng::arch::ExceptionHandler {
    * exception results. */
   bool concludeSyscall(ProcessStateChange& stateChange);
 
+  /** Capture the registers of the running thread, updated by the register
+   * changes of `stateChange`, as the context to resume the thread from after
+   * the syscall. */
+  kernel::ThreadContext saveContext(
+      const ProcessStateChange& stateChange = {}) const;
+
+  /** Conclude a syscall which suspended or ended the running thread by
+   * switching to the next thread to run, whose registers are restored
+   * alongside the memory changes of `stateChange`. */
+  bool switchThread(ProcessStateChange& stateChange);
+
+  /** Retrieve the index of `reg` within the registers of a thread context. */
+  static size_t getRegisterIndex(const std::vector<Register>& registers,
+                                 Register reg);
+
   /** Sets a generic fatal result and returns true. */
   bool fatal();
 
@@ -105,6 +127,7 @@ class ExceptionHandler : public simeng::arch::ExceptionHandler {
   friend class RiscVExceptionHandlerTest_readStringThen_maxLenReached_Test;
   friend class RiscVExceptionHandlerTest_readBufferThen_Test;
   friend class RiscVExceptionHandlerTest_readBufferThen_length0_Test;
+  friend class RiscVExceptionHandlerTest_readBufferThen_block_Test;
   friend class RiscVExceptionHandlerTest_printException_Test;
 };
 
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "simeng/branchpredictors/BranchPrediction.hh"
+
+namespace simeng {
+
+/** A retired branch, as recorded in a branch trace. */
+struct BranchTraceRecord {
+  /** The address of the branch instruction. */
+  uint64_t address;
+
+  /** The address of the instruction executed after the branch; the branch
+   * target if taken, otherwise the next sequential instruction. */
+  uint64_t target;
+
+  /** The branch offset known at decode, or 0 for register-indirect
+   * branches. */
+  int64_t knownOffset;
+
+  /** The number of instructions retired before the branch. */
+  uint64_t instructionCount;
+
+  /** The type of the branch. */
+  BranchType type;
+
+  /** Whether the branch was taken. */
+  bool taken;
+};
+
+/** Writes a binary trace of retired branches, in commit order, to a file.
+ * Records are buffered and written in blocks to keep the cost of tracing
+ * low. The trace is stored in the host's byte order. */
+class BranchTraceWriter {
+ public:
+  /** Open the file at `path` for writing, replacing any existing file. */
+  BranchTraceWriter(const std::string& path);
+
+  /** Write out any buffered records and close the file. */
+  ~BranchTraceWriter();
+
+  /** Query whether the file was opened successfully. */
+  bool isValid() const;
+
+  /** Append a retired branch to the trace. */
+  void record(const BranchTraceRecord& record);
+
+  /** Write out all buffered records. */
+  void flush();
+
+ private:
+  /** The file being written. */
+  std::ofstream file_;
+
+  /** The serialised records yet to be written. */
+  std::vector<char> buffer_;
+};
+
+/** Reads a binary trace of retired branches written by a
+ * `BranchTraceWriter`. */
+class BranchTraceReader {
+ public:
+  /** Read the trace held in the file at `path`. */
+  BranchTraceReader(const std::string& path);
+
+  /** Query whether the file held a valid trace. */
+  bool isValid() const;
+
+  /** Retrieve the branches of the trace, in commit order. */
+  const std::vector<BranchTraceRecord>& getRecords() const;
+
+  /** Retrieve the number of instructions retired up to and including the
+   * last branch of the trace. */
+  uint64_t getInstructionCount() const;
+
+ private:
+  /** Whether the file held a valid trace. */
+  bool isValid_ = false;
+
+  /** The branches of the trace. */
+  std::vector<BranchTraceRecord> records_;
+};
+
+}  // namespace simeng
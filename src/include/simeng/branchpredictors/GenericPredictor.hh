@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "simeng/branchpredictors/BranchPredictor.hh"
+#include "simeng/branchpredictors/IndirectTargetPredictor.hh"
 #include "simeng/config/SimInfo.hh"
 
 namespace simeng {
@@ -19,6 +20,9 @@ namespace simeng {
  * 2-bit saturating counter.
  *
  * - A Return Address Stack (RAS) is also in use.
+ *
+ * - An indirect target predictor, which when enabled predicts the targets of
+ * register-indirect branches in place of the BTB.
  */
 
 class GenericPredictor : public BranchPredictor {
@@ -84,6 +88,9 @@ class GenericPredictor : public BranchPredictor {
 
   /** The size of the RAS. */
   uint16_t rasSize_;
+
+  /** A predictor of the targets of register-indirect branches. */
+  IndirectTargetPredictor indirectPredictor_;
 };
 
 }  // namespace simeng
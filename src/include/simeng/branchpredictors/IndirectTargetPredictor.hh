@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+
+/** An indirect branch target predictor, modelled on the ITTAGE predictor
+ * described in Seznec ("A 64-Kbytes ITTAGE indirect branch predictor", Third
+ * Championship Branch Prediction (2011)). A number of partially tagged tables
+ * of branch targets are indexed by hashes of the branch address and
+ * geometrically increasing lengths of the path history of indirect branch
+ * targets. The table using the longest history with a matching tag provides
+ * the target, falling back to that of the owning predictor's BTB otherwise.
+ *
+ * Owned by a direction predictor, which queries it for register-indirect
+ * branches, and passes it every branch update and flush. Predictions are
+ * matched to their updates and flushes by address, relying on branches being
+ * updated in program order and flushed in reverse program order. */
+class IndirectTargetPredictor {
+ public:
+  /** Initialise the predictor from the Branch-Predictor config options. A
+   * table count of 0 disables the predictor. */
+  IndirectTargetPredictor(
+      ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Query whether the predictor is enabled. */
+  bool isEnabled() const;
+
+  /** Predict the target of the register-indirect branch at `address`, given
+   * the target `btbTarget` predicted by the BTB. Returns the predicted target,
+   * which is also speculatively inserted into the path history. */
+  uint64_t predict(uint64_t address, uint64_t btbTarget);
+
+  /** Update the predictor with the resolved target of the branch at `address`.
+   * Branches not predicted by this predictor are ignored. */
+  void update(uint64_t address, uint64_t targetAddress);
+
+  /** Discard the prediction made for the flushed branch at `address`, rolling
+   * back the path history. Branches not predicted by this predictor are
+   * ignored. */
+  void flush(uint64_t address);
+
+  /** Retrieve the number of indirect branches each tagged table's path history
+   * spans. */
+  const std::vector<uint16_t>& getHistoryLengths() const;
+
+ private:
+  /** An entry of a tagged table. */
+  struct TaggedEntry {
+    /** Whether the entry has been allocated to a branch; an unallocated entry
+     * never matches, whatever the tag. */
+    bool valid = false;
+
+    /** The predicted target. */
+    uint64_t target = 0;
+
+    /** The partial tag of the branch the entry belongs to. */
+    uint16_t tag = 0;
+
+    /** A 2-bit confidence counter; the target is replaced once it reaches 0
+     * and mispredicts. */
+    uint8_t confidence = 0;
+
+    /** A 1-bit usefulness flag, protecting the entry from replacement. */
+    bool useful = false;
+  };
+
+  /** The state of the predictor when predict was called on a branch, needed
+   * to update it once the branch is resolved. */
+  struct FtqEntry {
+    /** The address of the branch. */
+    uint64_t address;
+
+    /** The predicted target. */
+    uint64_t target;
+
+    /** The target predicted by the next longest matching table, or the BTB. */
+    uint64_t altTarget;
+
+    /** The tagged table providing the target, or -1 for the BTB. */
+    int8_t provider;
+
+    /** The index of the branch into each tagged table. */
+    std::vector<uint32_t> indices;
+
+    /** The tag of the branch for each tagged table. */
+    std::vector<uint16_t> tags;
+  };
+
+  /** Hash the `length` most recent targets of the path history into `bits`
+   * bits. */
+  uint64_t foldHistory(uint16_t length, uint8_t bits) const;
+
+  /** Reduce `target` to the fragment recorded in the path history. */
+  static uint16_t hashTarget(uint64_t target);
+
+  /** The length in bits of each tagged table's index. */
+  uint8_t indexBits_;
+
+  /** The number of bits in each tagged table entry's tag. */
+  uint8_t tagBits_;
+
+  /** The tagged tables, ordered by increasing history length. */
+  std::vector<std::vector<TaggedEntry>> tables_;
+
+  /** The number of most recent indirect branch targets used to index each
+   * tagged table. */
+  std::vector<uint16_t> historyLengths_;
+
+  /** The predictor state at the time of prediction for each of the indirect
+   * branches that are currently unresolved. */
+  std::deque<FtqEntry> ftq_;
+
+  /** Fragments of the targets of recent indirect branches, with the most
+   * recent at the back. Twice the longest history length is recorded, to
+   * allow rolling back of the speculatively updated history. */
+  std::deque<uint16_t> pathHistory_;
+};
+
+}  // namespace simeng
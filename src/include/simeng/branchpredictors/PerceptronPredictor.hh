@@ -1,11 +1,12 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <deque>
-#include <map>
 #include <vector>
 
 #include "simeng/branchpredictors/BranchPredictor.hh"
+#include "simeng/branchpredictors/IndirectTargetPredictor.hh"
 #include "simeng/config/SimInfo.hh"
 
 namespace simeng {
@@ -22,6 +23,9 @@ namespace simeng {
  * perceptron.
  *
  * - A Return Address Stack (RAS) is also in use.
+ *
+ * - An indirect target predictor, which when enabled predicts the targets of
+ * register-indirect branches in place of the BTB.
  */
 
 class PerceptronPredictor : public BranchPredictor {
@@ -51,28 +55,76 @@ class PerceptronPredictor : public BranchPredictor {
   void flush(uint64_t address) override;
 
  private:
-  /** Returns the dot product of a perceptron and a history vector.  Used to
-   * determine a direction prediction */
-  int64_t getDotProduct(const std::vector<int8_t>& perceptron,
-                        uint64_t history);
+  /** The maximum number of global history bits a perceptron can be trained
+   * on, to which each perceptron's weights are padded with zeros. */
+  static constexpr uint8_t maxHistoryLength_ = 32;
+
+  /** The global history expanded into one input per history bit, being 1 for
+   * a taken branch and -1 otherwise. */
+  using HistoryInputs = std::array<int8_t, maxHistoryLength_>;
+
+  /** The state of the predictor when predict was called on a branch, needed
+   * to update it once the branch is resolved, or to undo its effect on the RAS
+   * if flushed. */
+  struct FtqEntry {
+    /** The dot product of the perceptron and the global history, representing
+     * the confidence of the direction prediction. */
+    int64_t dotProduct;
+
+    /** The global history at the time of prediction. Stored in place of the
+     * hashed index as hashing loses information needed to train the
+     * perceptron. */
+    uint64_t globalHistory;
+
+    /** The target popped off of the RAS by a return instruction, or 0 if none
+     * was popped. */
+    uint64_t rasPopped;
+
+    /** Whether a branch-and-link instruction pushed its return address onto
+     * the RAS. */
+    bool rasPushed;
+  };
+
+  /** Expand the globalHistoryLength_ most recent bits of `history` into
+   * perceptron inputs, with those beyond it being 0. */
+  HistoryInputs getHistoryInputs(uint64_t history) const;
+
+  /** Returns the dot product of the perceptron at `index` and the history
+   * `inputs`.  Used to determine a direction prediction */
+  int64_t getDotProduct(uint64_t index, const HistoryInputs& inputs) const;
+
+  /** Push `target` onto the RAS, overwriting the oldest entry if full. */
+  void pushRas(uint64_t target);
+
+  /** Pop the most recent entry off of the RAS. The RAS must not be empty. */
+  uint64_t popRas();
 
   /** The length in bits of the BTB index; BTB will have 2^bits entries. */
   uint64_t btbBits_;
 
-  /** A 2^bits length vector of pairs containing a perceptron with
-   * globalHistoryLength_ + 1 inputs, and a branch target.
-   * The perceptrons are used to provide a branch direction prediction by
-   * taking a dot product with the global history, as described
-   * in Jiminez and Lin */
-  std::vector<std::pair<std::vector<int8_t>, uint64_t>> btb_;
-
-  /** Fetch Target Queue containing the dot product of the perceptron and the
-   * global history; and the global history, both at the time of prediction,
-   * for each of the branch instructions that are currently unresolved.  The dot
-   * product represents the confidence of the perceptrons direction
-   * prediction and is needed for a correct update when the branch
-   * instruction is resolved. */
-  std::deque<std::pair<int64_t, uint64_t>> ftq_;
+  /** The history weights of the 2^bits perceptrons of the BTB, stored
+   * contiguously with maxHistoryLength_ weights per perceptron. As the inputs
+   * beyond globalHistoryLength_ are 0, the weights padding each perceptron are
+   * never trained, allowing the dot product and training loops to be of a
+   * fixed length which the compiler may vectorise. The perceptrons are used to
+   * provide a branch direction prediction by taking a dot product with the
+   * global history, as described in Jiminez and Lin */
+  std::vector<int8_t> weights_;
+
+  /** The bias weight of each perceptron of the BTB. */
+  std::vector<int8_t> biases_;
+
+  /** The branch target of each entry of the BTB. */
+  std::vector<uint64_t> btbTargets_;
+
+  /** Per history input, all bits set if it is within globalHistoryLength_
+   * and 0 otherwise; masks the expanded history to the length in use. */
+  HistoryInputs historyLengthMask_;
+
+  /** Fetch Target Queue containing the predictor state at the time of
+   * prediction for each of the branch instructions that are currently
+   * unresolved. */
+  std::deque<FtqEntry> ftq_;
 
   /** An n-bit history of previous branch directions where n is equal to
    * globalHistoryLength_.  Each bit represents a branch taken (1) or not
@@ -90,16 +142,22 @@ class PerceptronPredictor : public BranchPredictor {
    * below which the perceptron's weight must be updated */
   uint64_t trainingThreshold_;
 
-  /** A return address stack. */
-  std::deque<uint64_t> ras_;
+  /** A return address stack, held as a circular buffer of rasSize_ entries.
+   * The speculative pushes and pops made on it are recorded in the FTQ, so
+   * that they may be undone on a flush. */
+  std::vector<uint64_t> ras_;
+
+  /** The index of the entry of ras_ the next push will write to. */
+  uint64_t rasTop_ = 0;
 
-  /** RAS history with instruction address as the keys. A non-zero value
-   * represents the target prediction for a return instruction and a 0 entry for
-   * a branch-and-link instruction. */
-  std::map<uint64_t, uint64_t> rasHistory_;
+  /** The number of valid entries in the RAS. */
+  uint64_t rasCount_ = 0;
 
   /** The size of the RAS. */
   uint64_t rasSize_;
+
+  /** A predictor of the targets of register-indirect branches. */
+  IndirectTargetPredictor indirectPredictor_;
 };
 
 }  // namespace simeng
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cassert>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "simeng/branchpredictors/BranchPredictor.hh"
+#include "simeng/branchpredictors/IndirectTargetPredictor.hh"
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+
+/** A TAgged GEometric history length (TAGE) branch predictor implementing the
+ * direction predictor described in Seznec and Michaud ("A case for (partially)
+ * TAgged GEometric history length branch prediction", Journal of
+ * Instruction-Level Parallelism 8 (2006) --
+ * https://www.jilp.org/vol8/v8paper1.pdf).
+ * The following predictors have been included:
+ *
+ * - Static predictor based on pre-allocated branch type.
+ *
+ * - A bimodal base predictor of 2-bit saturating counters, alongside a Branch
+ * Target Buffer (BTB) holding branch targets, both indexed by address.
+ *
+ * - A number of partially tagged tables of 3-bit saturating counters, indexed
+ * by hashes of the address and geometrically increasing lengths of the global
+ * history. The table using the longest history with a matching tag provides
+ * the prediction.
+ *
+ * - A Return Address Stack (RAS) is also in use.
+ *
+ * - An indirect target predictor, which when enabled predicts the targets of
+ * register-indirect branches in place of the BTB.
+ */
+
+class TagePredictor : public BranchPredictor {
+ public:
+  /** Initialise predictor models. */
+  TagePredictor(ryml::ConstNodeRef config = config::SimInfo::getConfig());
+  ~TagePredictor();
+
+  /** Generate a branch prediction for the supplied instruction address, a
+   * branch type, and a known branch offset.  Returns a branch direction and
+   * branch target address. */
+  BranchPrediction predict(uint64_t address, BranchType type,
+                           int64_t knownOffset) override;
+
+  /** Updates appropriate predictor model objects based on the address, type and
+   * outcome of the branch instruction.  Update must be called on
+   * branches in program order.  To check this, instructionId is also passed
+   * to this function. */
+  void update(uint64_t address, bool isTaken, uint64_t targetAddress,
+              BranchType type, uint64_t instructionId) override;
+
+  /** Provides flushing behaviour for the implemented branch prediction schemes
+   * via the instruction address.  Branches must be flushed in reverse
+   * program order (though, if a block of n instructions is being flushed at
+   * once, the exact order that the individual instructions within this block
+   * are flushed does not matter so long as they are all flushed). */
+  void flush(uint64_t address) override;
+
+  /** Retrieve the history length used to index each tagged table. */
+  const std::vector<uint16_t>& getHistoryLengths() const;
+
+ private:
+  /** An entry of a tagged table. */
+  struct TaggedEntry {
+    /** Whether the entry has been allocated to a branch; an unallocated entry
+     * never matches, whatever the tag. */
+    bool valid = false;
+
+    /** A 3-bit signed saturating counter; the branch is predicted taken if
+     * non-negative. */
+    int8_t counter = 0;
+
+    /** The partial tag of the branch the entry belongs to. */
+    uint16_t tag = 0;
+
+    /** A 2-bit usefulness counter, protecting the entry from replacement. */
+    uint8_t useful = 0;
+  };
+
+  /** The state of the predictor when predict was called on a branch, needed
+   * to update it once the branch is resolved. */
+  struct FtqEntry {
+    /** The direction speculatively inserted into the global history. */
+    bool historyBit;
+
+    /** Whether the branch is trained on; false for those branch types always
+     * predicted taken. */
+    bool conditional;
+
+    /** The direction predicted by the providing component. */
+    bool providerTaken;
+
+    /** The direction predicted by the alternate component, used when the
+     * provider's entry is newly allocated. */
+    bool altTaken;
+
+    /** The final direction prediction. */
+    bool predictedTaken;
+
+    /** The tagged table providing the prediction, or -1 for the base
+     * predictor. */
+    int8_t provider;
+
+    /** The tagged table providing the alternate prediction, or -1 for the
+     * base predictor. */
+    int8_t altProvider;
+
+    /** The index of the branch into each tagged table. */
+    std::vector<uint32_t> indices;
+
+    /** The tag of the branch for each tagged table. */
+    std::vector<uint16_t> tags;
+  };
+
+  /** Fold the `length` most recent bits of the global history into `bits`
+   * bits by XORing successive chunks together. */
+  uint64_t foldHistory(uint16_t length, uint8_t bits) const;
+
+  /** Retrieve the index of `address` into the base predictor and BTB. */
+  uint64_t getBaseIndex(uint64_t address) const;
+
+  /** Retrieve the direction predicted by tagged table `table` or, if -1, the
+   * base predictor for the branch described by `entry`. */
+  bool getTableTaken(int8_t table, uint64_t address,
+                     const FtqEntry& entry) const;
+
+  /** Train the counter of tagged table `table` or, if -1, the base predictor
+   * towards the branch outcome `isTaken`. */
+  void trainCounter(int8_t table, uint64_t address, const FtqEntry& entry,
+                    bool isTaken);
+
+  /** Allocate entries for a mispredicted branch in the tagged tables using
+   * longer histories than the provider. */
+  void allocate(const FtqEntry& entry, bool isTaken);
+
+  /** Speculatively shift the direction `taken` into the global history. */
+  void pushHistory(bool taken);
+
+  /** The length in bits of the base predictor and BTB index; each will have
+   * 2^bits entries. */
+  uint8_t btbBits_;
+
+  /** The base predictor's 2-bit saturating counters. */
+  std::vector<uint8_t> base_;
+
+  /** The BTB, holding the most recent target of each branch. */
+  std::vector<uint64_t> btb_;
+
+  /** The length in bits of each tagged table's index. */
+  uint8_t indexBits_;
+
+  /** The number of bits in each tagged table entry's tag. */
+  uint8_t tagBits_;
+
+  /** The tagged tables, ordered by increasing history length. */
+  std::vector<std::vector<TaggedEntry>> tables_;
+
+  /** The number of most recent global history bits used to index each tagged
+   * table. */
+  std::vector<uint16_t> historyLengths_;
+
+  /** Fetch Target Queue containing the predictor state at the time of
+   * prediction for each of the branch instructions that are currently
+   * unresolved. */
+  std::deque<FtqEntry> ftq_;
+
+  /** The global history of branch directions, with the most recent branch
+   * being the least-significant bit of the first word. Twice the longest
+   * history length is recorded, to allow rolling back of the speculatively
+   * updated global history in the event of a misprediction. */
+  std::vector<uint64_t> globalHistory_;
+
+  /** The number of bits recorded in the global history. */
+  uint32_t globalHistoryCapacity_;
+
+  /** A 4-bit signed counter deciding whether the alternate prediction is used
+   * in place of that of a newly allocated provider entry, which it is whilst
+   * non-negative. Starting at 0 prefers the alternate until newly allocated
+   * entries prove the more accurate, as in Seznec and Michaud's predictor. */
+  int8_t useAltOnNewEntry_ = 0;
+
+  /** The number of conditional branches updated since usefulness counters
+   * were last aged. */
+  uint64_t updatesSinceAging_ = 0;
+
+  /** The number of conditional branch updates between each ageing of the
+   * usefulness counters. */
+  static constexpr uint64_t agingPeriod_ = 1 << 18;
+
+  /** A return address stack. */
+  std::deque<uint64_t> ras_;
+
+  /** RAS history with instruction address as the keys. A non-zero value
+   * represents the target prediction for a return instruction and a 0 entry for
+   * a branch-and-link instruction. */
+  std::map<uint64_t, uint64_t> rasHistory_;
+
+  /** The size of the RAS. */
+  uint64_t rasSize_;
+
+  /** A predictor of the targets of register-indirect branches. */
+  IndirectTargetPredictor indirectPredictor_;
+};
+
+}  // namespace simeng
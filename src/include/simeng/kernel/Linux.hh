@@ -1,11 +1,18 @@
 #pragma once
 
+#include <deque>
+#include <map>
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "simeng/Register.hh"
+#include "simeng/RegisterValue.hh"
 #include "simeng/kernel/LinuxProcess.hh"
+#include "simeng/kernel/VirtualFileSystem.hh"
+#include "simeng/kernel/VirtualMemoryAreas.hh"
 #include "simeng/version.hh"
 
 namespace simeng {
@@ -53,14 +60,45 @@ struct timeval {
   int64_t tv_usec;  // microseconds
 };
 
-/** Struct to hold information about a contiguous virtual memory area. */
-struct vm_area_struct {
-  /** The address representing the end of the memory allocation. */
-  uint64_t vm_end = 0;
-  /** The address representing the start of the memory allocation. */
-  uint64_t vm_start = 0;
-  /** The next allocation in the contiguous list. */
-  std::shared_ptr<struct vm_area_struct> vm_next = NULL;
+/** The saved execution context of a thread which isn't running. */
+struct ThreadContext {
+  /** The address of the next instruction the thread will execute. */
+  uint64_t pc = 0;
+  /** The thread's architectural registers. */
+  std::vector<Register> registers;
+  /** The values of the thread's architectural registers. */
+  std::vector<RegisterValue> values;
+};
+
+/** A state container for a thread of a Linux process. */
+struct LinuxThreadState {
+  /** The thread ID. */
+  int64_t tid;
+  /** The clear_child_tid value; the address zeroed and woken on exit. */
+  uint64_t clearChildTid = 0;
+  /** The address of the futex the thread is waiting on, or 0 if it isn't
+   * waiting. */
+  uint64_t futexAddress = 0;
+  /** The bitset the thread is waiting on its futex with. */
+  uint32_t futexBitset = 0;
+  /** The simulated time, in nanoseconds, at which the futex wait times out. */
+  uint64_t futexDeadline = UINT64_MAX;
+  /** The value returned by the syscall which suspended the thread, once it
+   * resumes. */
+  int64_t result = 0;
+  /** The context to resume the thread from. */
+  ThreadContext context;
+};
+
+/** A file of a virtual filesystem opened by a Linux process. */
+struct OpenVirtualFile {
+  /** The absolute path of the file. */
+  std::string path;
+  /** The file. */
+  const VirtualFile* file;
+  /** The offset of the next byte read from a regular file, or the index of the
+   * next entry read from a directory. */
+  uint64_t offset = 0;
 };
 
 /** A state container for a Linux process. */
@@ -75,25 +113,38 @@ struct LinuxProcessState {
   uint64_t currentBrk;
   /** The initial stack pointer. */
   uint64_t initialStackPointer;
+  /** The address of the bottom of the stack, which ends the process memory. */
+  uint64_t stackStart;
   /** The address of the start of the mmap region. */
   uint64_t mmapRegion;
   /** The page size of the process memory. */
   uint64_t pageSize;
-  /** Contiguous memory allocations from the mmap system call. */
-  std::vector<vm_area_struct> contiguousAllocations;
-  /** Non-Contiguous memory allocations from the mmap system call. */
-  std::vector<vm_area_struct> nonContiguousAllocations;
-
-  // Thread state
-  // TODO: Support multiple threads per process
-  /** The clear_child_tid value. */
-  uint64_t clearChildTid = 0;
+  /** The virtual memory areas mapped by the mmap and brk system calls. */
+  VirtualMemoryAreas memoryAreas;
+
+  /** The threads of the process, keyed by thread ID. */
+  std::map<int64_t, LinuxThreadState> threads;
+  /** The ID of the running thread. */
+  int64_t currentTid = 0;
+  /** The IDs of the threads ready to run, in the order they will run. */
+  std::deque<int64_t> runQueue;
+  /** The IDs of the threads waiting on each futex, in the order they began
+   * waiting. */
+  std::unordered_map<uint64_t, std::deque<int64_t>> futexQueues;
+  /** The ID to give the next thread created. */
+  int64_t nextTid = 0;
+  /** The simulated time at which the running thread was last scheduled. */
+  uint64_t sliceStart = 0;
 
   /** The virtual file descriptor mapping table. Maps virtual file descriptors
-   * to host file descriptors */
+   * to host file descriptors, or to `VIRTUAL_FILE_FD` for files of the
+   * virtual filesystem */
   std::vector<int64_t> fileDescriptorTable;
   /** Set of deallocated virtual file descriptors available for reuse. */
   std::set<int64_t> freeFileDescriptors;
+  /** The open files of the virtual filesystem, keyed by virtual file
+   * descriptor. */
+  std::unordered_map<int64_t, OpenVirtualFile> virtualFiles;
 };
 
 /** Fixed-width definition of 'rusage' (from <sys/resource.h>). */
@@ -131,8 +182,13 @@ struct linux_dirent64 {
    to Linux system calls. */
 class Linux {
  public:
-  Linux(const std::string specialFiledirPath)
-      : specialFilesDir_(specialFiledirPath) {}
+  /** Construct a kernel using the special files found beneath
+   * `specialFiledirPath`. If `fileSystem` is provided, the files it holds are
+   * served from memory in place of those on the host. */
+  Linux(const std::string specialFiledirPath,
+        std::shared_ptr<const VirtualFileSystem> fileSystem = nullptr)
+      : specialFilesDir_(specialFiledirPath),
+        fileSystem_(std::move(fileSystem)) {}
 
   /** Create a new Linux process running above this kernel. */
   void createProcess(const LinuxProcess& process);
@@ -172,6 +228,56 @@ class Linux {
   /** getrusage syscall: get recource usage measures for Who*/
   int64_t getrusage(int64_t who, rusage& out);
 
+  /** clone syscall: create a thread, which shares the memory and file
+   * descriptors of the process and starts from `context` once scheduled. Only
+   * threads (CLONE_VM and CLONE_THREAD) are supported. If CLONE_CHILD_CLEARTID
+   * is set, `childTidPtr` is zeroed and woken when the thread exits. Returns
+   * the ID of the new thread. */
+  int64_t clone(uint64_t flags, uint64_t childTidPtr, ThreadContext context);
+
+  /** exit syscall: terminate the running thread, waking any thread waiting on
+   * its clear_child_tid address. Returns that address, which must then be
+   * zeroed, or 0 if none was set. The process exits with its last thread. */
+  uint64_t exitThread();
+
+  /** Retrieve the number of threads of the process which haven't exited. */
+  size_t getThreadCount() const;
+
+  /** futex syscall, FUTEX_WAIT operations: block the running thread on the
+   * futex at `addr` until it's woken by a FUTEX_WAKE operation with a bitset
+   * intersecting `bitset`, or until the simulated time reaches `deadline`.
+   * `value` is the current value of the futex, and `context` the state to
+   * resume the thread from. Returns 0 if the thread was blocked, and must be
+   * switched out, or a negative error code if `value` didn't match
+   * `expected`. */
+  int64_t futexWait(uint64_t addr, uint32_t value, uint32_t expected,
+                    uint32_t bitset, uint64_t deadline, ThreadContext context);
+
+  /** futex syscall, FUTEX_WAKE operations: wake up to `count` threads waiting
+   * on the futex at `addr` with a bitset intersecting `bitset`, in the order
+   * they began waiting. Returns the number of threads woken. */
+  int64_t futexWake(uint64_t addr, int64_t count, uint32_t bitset);
+
+  /** sched_yield syscall: suspend the running thread behind those ready to
+   * run, to be resumed from `context` with the syscall result `result`. Also
+   * used to preempt the running thread. */
+  void yield(ThreadContext context, int64_t result);
+
+  /** Query whether any thread is ready to run, besides the running thread. */
+  bool hasReadyThreads() const;
+
+  /** Query whether the running thread has used up its time slice at the
+   * simulated time `systemTimer`, while others are ready to run. Only queried
+   * when the running thread makes a syscall. */
+  bool shouldPreempt(uint64_t systemTimer) const;
+
+  /** Select the next thread to run once the running thread has been suspended
+   * or has exited, at the simulated time `systemTimer`. Threads whose futex
+   * waits have timed out are made ready first. If every thread is blocked, the
+   * wait which times out soonest does so immediately. Returns nullptr if every
+   * thread is blocked indefinitely. */
+  const LinuxThreadState* scheduleNext(uint64_t systemTimer);
+
   /** getpid syscall: get the process owner's process ID. */
   int64_t getpid() const;
   /** getuid syscall: get the process owner's user ID. */
@@ -182,7 +288,7 @@ class Linux {
   int64_t getgid() const;
   /** getegid syscall: get the process owner's effective group ID. */
   int64_t getegid() const;
-  /** gettid syscall: get the process owner's thread ID. */
+  /** gettid syscall: get the ID of the running thread. */
   int64_t gettid() const;
 
   /** gettimeofday syscall: get the current time, using the system timer
@@ -197,13 +303,46 @@ class Linux {
   /** lseek syscall: reposition read/write file offset. */
   uint64_t lseek(int64_t fd, uint64_t offset, int64_t whence);
 
-  /** munmap syscall: deletes the mappings for the specified address range. */
+  /** munmap syscall: deletes the mappings for the specified address range.
+   * Any pages of the range which aren't mapped are ignored. */
   int64_t munmap(uint64_t addr, size_t length);
 
-  /** mmap syscall: map files or devices into memory. */
+  /** mmap syscall: map files or devices into memory. Supports placement at a
+   * hint address, and MAP_FIXED and MAP_FIXED_NOREPLACE mappings. Returns 0
+   * if the mapping couldn't be made. */
   uint64_t mmap(uint64_t addr, size_t length, int prot, int flags, int fd,
                 off_t offset);
 
+  /** Retrieve the initial contents of the `length` bytes, rounded up to
+   * whole pages, of the mapping just made at `addr` into `contents`. File
+   * mappings hold the contents of the file, and any bytes beyond the end of
+   * the file are zero, as are those of anonymous mappings. `contents` is
+   * left empty if `addr` isn't mapped. */
+  void getMappingContents(uint64_t addr, size_t length,
+                          std::vector<char>& contents) const;
+
+  /** Retrieve the ranges of each shared file-backed mapping between `addr`
+   * and `addr + length`, clipped to that range and in address order, whose
+   * contents must be written back to their files by `writeBack`. */
+  std::vector<std::pair<uint64_t, uint64_t>> getWriteBackRanges(
+      uint64_t addr, uint64_t length) const;
+
+  /** Write the contents of any shared file-backed mappings between `addr` and
+   * `addr + length` back to their files, where `data` holds the contents of
+   * that memory. */
+  void writeBack(uint64_t addr, uint64_t length, const char* data);
+
+  /** msync syscall: validate a request to synchronise a range of mapped
+   * memory with its files. The contents are written back separately, through
+   * `writeBack`. */
+  int64_t msync(uint64_t addr, size_t length, int flags);
+
+  /** mprotect syscall: set the protection of the mapped pages in the
+   * specified address range. Returns -ENOMEM if any page of the range isn't
+   * mapped. The process image and stack are mapped but not tracked, so their
+   * protection is left unchanged. */
+  int64_t mprotect(uint64_t addr, size_t length, int prot);
+
   /** openat syscall: open/create a file. */
   int64_t openat(int64_t vdfd, const std::string& pathname, int64_t flags,
                  uint16_t mode);
@@ -218,7 +357,8 @@ class Linux {
   /** set a process's CPU affinity mask. */
   int64_t schedSetAffinity(pid_t pid, size_t cpusetsize, uint64_t mask);
 
-  /** set_tid_address syscall: set clear_child_tid value for calling thread. */
+  /** set_tid_address syscall: set clear_child_tid value for calling thread.
+   * Returns the ID of the calling thread. */
   int64_t setTidAddress(uint64_t tidptr);
 
   /** getdents64 syscall: read several linux_dirent structures from directory
@@ -240,6 +380,21 @@ class Linux {
   /** The maximum size of a filesystem path. */
   static const size_t LINUX_PATH_MAX = 4096;
 
+  /** The simulated time, in nanoseconds, a thread may run for before it's
+   * preempted by a thread waiting to run. Preemption only happens at a syscall
+   * made once the time slice has expired, so a thread spinning without making
+   * syscalls is never switched out. */
+  static const uint64_t TIME_SLICE = 1000000;
+
+  /** The ID of the simulated process, which is also the thread ID of its
+   * first thread. It's non-zero, as a thread ID of 0 refers to the calling
+   * thread in syscalls such as sched_setaffinity. */
+  static const int64_t PROCESS_ID = 100;
+
+  /** The host file descriptor mapped to by the virtual file descriptors of
+   * files of the virtual filesystem. */
+  static const int64_t VIRTUAL_FILE_FD = -2;
+
  private:
   /** Return the host directory file descriptor mapped to by the virtual dfd
    * given to syscall. If vdfd is Linux::AT_FDCWD (-100) then Host::AT_FDCWD is
@@ -251,6 +406,27 @@ class Linux {
    * to point to the SimEng equivalent. */
   std::string getSpecialFile(const std::string filename);
 
+  /** Find the file of the virtual filesystem at `pathname`, relative to the
+   * directory open as the virtual dfd given to the syscall, and set `path` to
+   * its absolute path. Returns nullptr if the file isn't held. */
+  const VirtualFile* findVirtualFile(int64_t vdfd, const std::string& pathname,
+                                     std::string& path) const;
+
+  /** Retrieve the open virtual filesystem file with the virtual file
+   * descriptor `fd`, or nullptr if `fd` isn't one. */
+  OpenVirtualFile* getVirtualFile(int64_t fd);
+
+  /** Fill `out` with the status of the virtual filesystem file `file`. */
+  void statVirtualFile(const VirtualFile& file, stat& out) const;
+
+  /** Allocate a virtual file descriptor mapped to the host file descriptor
+   * `hostFd`, or to `VIRTUAL_FILE_FD`. */
+  int64_t allocateFileDescriptor(int64_t hostFd);
+
+  /** Make the blocked thread `thread` ready to run, resuming with the syscall
+   * result `result`. */
+  void wakeThread(LinuxThreadState& thread, int64_t result);
+
   /** The state of the user-space processes running above the kernel. */
   std::vector<LinuxProcessState> processStates_;
 
@@ -262,6 +438,11 @@ class Linux {
 
   /** Vector of all currently supported special file paths & files.*/
   std::vector<std::string> supportedSpecialFiles_;
+
+  /** The virtual filesystem whose files are served from memory, or nullptr if
+   * every file is served by the host. Shared by the kernels of every hardware
+   * thread. */
+  std::shared_ptr<const VirtualFileSystem> fileSystem_;
 };
 
 }  // namespace kernel
@@ -101,6 +101,10 @@ class LinuxProcess {
   /** Get the path of the executable. */
   std::string getPath() const;
 
+  /** Get the functions defined by the executable's symbol table, sorted by
+   * address. */
+  const std::vector<ElfSymbol>& getSymbols() const;
+
   /** Check whether the process image was created successfully. */
   bool isValid() const;
 
@@ -111,6 +115,10 @@ class LinuxProcess {
   /** The space to reserve for the heap, in bytes. */
   const uint64_t HEAP_SIZE;
 
+  /** The number of threads OpenMP parallel regions use, passed to the
+   * program through the OMP_NUM_THREADS environment variable. */
+  const uint64_t OPENMP_THREADS;
+
   /** Create and populate the initial process stack. */
   void createStack(char** processImage);
 
@@ -144,6 +152,9 @@ class LinuxProcess {
   /** The process command and its arguments. */
   std::vector<std::string> commandLine_;
 
+  /** The functions defined by the executable's symbol table. */
+  std::vector<ElfSymbol> symbols_;
+
   /** Whether the process image was created successfully. */
   bool isValid_ = false;
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace simeng {
+namespace kernel {
+
+/** A file or directory held in memory by a virtual filesystem. */
+struct VirtualFile {
+  /** The inode number of the file, unique within its filesystem. */
+  uint64_t inode;
+
+  /** Whether the file is a directory. */
+  bool isDirectory;
+
+  /** The contents of a regular file. Shared, such that memory mappings of the
+   * file may hold onto them. */
+  std::shared_ptr<const std::string> contents;
+
+  /** The names of the files held by a directory, in sorted order. */
+  std::set<std::string> entries;
+};
+
+/** A read-only filesystem held in memory, serving synthetic files such as the
+ * generated special files, and snapshots of host files, to the simulated
+ * program without any host file I/O.
+ *
+ * Files are held by their absolute path. Only the files and directories added
+ * are held, such that any other path, including the parents of those added,
+ * continues to be served by the host. */
+class VirtualFileSystem {
+ public:
+  /** Add a regular file holding `contents` at the absolute path `path`,
+   * replacing any file already there. The file is listed by its parent
+   * directory if that has already been added. */
+  void addFile(const std::string& path, std::string contents);
+
+  /** Add an empty directory at the absolute path `path`, unless one is already
+   * there. The directory is listed by its parent directory if that has already
+   * been added. */
+  void addDirectory(const std::string& path);
+
+  /** Add a snapshot of the tree of the host directory `hostPath`, held at its
+   * absolute path on the host. Returns false if the directory couldn't be
+   * read. */
+  bool addHostDirectory(const std::string& hostPath);
+
+  /** Retrieve the file at the absolute path `path`, or nullptr if it isn't
+   * held. */
+  const VirtualFile* find(const std::string& path) const;
+
+  /** Retrieve every file held, keyed by their absolute path. Directories
+   * precede the files they hold. */
+  const std::map<std::string, VirtualFile>& getFiles() const;
+
+  /** Query whether no files are held. */
+  bool empty() const;
+
+  /** Normalise the absolute path `path`, removing repeated separators and
+   * resolving any `.` and `..` components lexically. */
+  static std::string normalise(const std::string& path);
+
+ private:
+  /** Insert a file at the normalised path `path`, listing it in its parent
+   * directory, and return it. */
+  VirtualFile& insert(const std::string& path, bool isDirectory);
+
+  /** The files held, keyed by their normalised absolute path. */
+  std::map<std::string, VirtualFile> files_;
+
+  /** The inode number of the next file inserted. */
+  uint64_t nextInode_ = 1;
+};
+
+}  // namespace kernel
+}  // namespace simeng
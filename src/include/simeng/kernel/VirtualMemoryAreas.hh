@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace simeng {
+namespace kernel {
+
+/** A host file mapped into memory. Holds its own host file descriptor, which
+ * is closed once no area maps the file, such that the mapping outlives the
+ * file descriptor it was created from. Files of the virtual filesystem are
+ * instead mapped from their contents held in memory. */
+class MappedFile {
+ public:
+  /** Construct a mapped file which takes ownership of `hostFd`. */
+  MappedFile(int64_t hostFd);
+
+  /** Construct a read-only mapped file of the in-memory `contents`. */
+  MappedFile(std::shared_ptr<const std::string> contents);
+
+  /** Close the host file descriptor. */
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /** Retrieve the host file descriptor of the file, or -1 if it's held in
+   * memory. */
+  int64_t getHostFd() const;
+
+  /** Retrieve the contents of a file held in memory, or nullptr if it's a
+   * host file. */
+  const std::shared_ptr<const std::string>& getContents() const;
+
+ private:
+  /** The host file descriptor of the file. */
+  int64_t hostFd_;
+
+  /** The contents of a file held in memory. */
+  std::shared_ptr<const std::string> contents_;
+};
+
+/** A contiguous, page-aligned area of mapped virtual memory. */
+struct VirtualMemoryArea {
+  /** The address of the first byte of the area. */
+  uint64_t start;
+  /** The address immediately after the last byte of the area. */
+  uint64_t end;
+  /** The memory protection of the area, as given to mmap/mprotect. */
+  int prot;
+  /** The mapping flags of the area, as given to mmap. */
+  int flags;
+  /** The file mapped into the area, or nullptr for anonymous areas. */
+  std::shared_ptr<MappedFile> file = nullptr;
+  /** The offset into `file` mapped at the start of the area. */
+  uint64_t offset = 0;
+};
+
+/** Manages the virtual memory areas of a process, as created by the mmap, brk
+ * and mprotect system calls.
+ *
+ * Areas are held in an ordered map keyed by their start address, while the
+ * free gaps of the region available for placement are held in a treap keyed
+ * by address and augmented with the size of the largest gap in each subtree.
+ * This allows areas to be placed, found, split and removed in O(log n) time:
+ * new areas are placed in the first gap at or above a hint address large
+ * enough to hold them (next-fit), falling back to the first such gap in the
+ * region (first-fit). */
+class VirtualMemoryAreas {
+ public:
+  /** Construct a manager placing areas within the region of memory between
+   * `regionStart` and `regionEnd`, in pages of `pageSize` bytes. */
+  VirtualMemoryAreas(uint64_t regionStart, uint64_t regionEnd,
+                     uint64_t pageSize);
+
+  /** Map an area of `length` bytes, rounded up to a whole number of pages,
+   * with the protection `prot` and flags `flags`. If `fixed` is set, the area
+   * is placed at `addr` and replaces any areas it overlaps. Otherwise, `addr`
+   * is a hint; the area is placed there if free, and otherwise in the first
+   * free gap above it. If `file` is provided, the area maps it from byte
+   * `offset` onwards. Returns the address of the area, or 0 if it couldn't be
+   * placed. */
+  uint64_t map(uint64_t addr, uint64_t length, int prot, int flags,
+               bool fixed, std::shared_ptr<MappedFile> file = nullptr,
+               uint64_t offset = 0);
+
+  /** Unmap the pages between `addr` and `addr + length`, splitting any areas
+   * which partially overlap them. Returns false if `addr` isn't page-aligned
+   * or `length` is 0. */
+  bool unmap(uint64_t addr, uint64_t length);
+
+  /** Set the protection of the mapped pages between `addr` and
+   * `addr + length` to `prot`, splitting any areas which partially overlap
+   * them. Returns false if `addr` isn't page-aligned or `length` is 0. */
+  bool protect(uint64_t addr, uint64_t length, int prot);
+
+  /** Query whether no area overlaps the memory between `start` and `end`. */
+  bool isFree(uint64_t start, uint64_t end) const;
+
+  /** Query whether every byte of the memory between `start` and `end` is
+   * mapped. */
+  bool isMapped(uint64_t start, uint64_t end) const;
+
+  /** Retrieve the area holding `addr`, or nullptr if it isn't mapped. */
+  const VirtualMemoryArea* find(uint64_t addr) const;
+
+  /** Retrieve the areas overlapping the memory between `start` and `end`, in
+   * address order. */
+  std::vector<VirtualMemoryArea> getAreas(uint64_t start, uint64_t end) const;
+
+  /** Retrieve the number of areas currently mapped. */
+  size_t getAreaCount() const;
+
+ private:
+  /** A free gap of the placement region, held as a node of the gap treap. */
+  struct Gap {
+    /** The address of the start of the gap. */
+    uint64_t start;
+    /** The address of the end of the gap. */
+    uint64_t end;
+    /** The size of the largest gap in the subtree rooted at this node. */
+    uint64_t maxSize;
+    /** The heap priority of the node. */
+    uint32_t priority;
+    /** The index of the left child node, or -1 if there is none. */
+    int32_t left;
+    /** The index of the right child node, or -1 if there is none. */
+    int32_t right;
+  };
+
+  /** Iterator over the mapped areas. */
+  using AreaIterator = std::map<uint64_t, VirtualMemoryArea>::iterator;
+
+  /** Find the first area ending after `addr`. */
+  AreaIterator firstAreaAfter(uint64_t addr);
+
+  /** Merge the area at `it` with any adjacent areas of the same protection and
+   * flags which continue the same mapping, returning the merged area. */
+  AreaIterator coalesce(AreaIterator it);
+
+  /** Find the address of the first free range of `length` bytes at or above
+   * `from`, or 0 if there is none. */
+  uint64_t findFreeRange(uint64_t from, uint64_t length) const;
+
+  /** Remove the memory between `start` and `end`, which must be free, from
+   * the gaps available for placement. */
+  void reserve(uint64_t start, uint64_t end);
+
+  /** Return the memory between `start` and `end` to the gaps available for
+   * placement, merging it with adjacent gaps. */
+  void release(uint64_t start, uint64_t end);
+
+  /** Find the node of the gap with the largest start address not above
+   * `addr`, or -1 if there is none. */
+  int32_t findGap(uint64_t addr) const;
+
+  /** Find the node of the lowest gap starting above `above` with at least
+   * `length` bytes, within the subtree rooted at `node`. */
+  int32_t findFit(int32_t node, uint64_t above, uint64_t length) const;
+
+  /** Insert a gap spanning `start` to `end`. */
+  void insertGap(uint64_t start, uint64_t end);
+
+  /** Remove the gap starting at `start`. */
+  void eraseGap(uint64_t start);
+
+  /** Recalculate the largest gap size of the subtree rooted at `node`. */
+  void refresh(int32_t node);
+
+  /** Split the subtree rooted at `node` into the gaps starting below `key`,
+   * placed in `left`, and the remainder, placed in `right`. */
+  void split(int32_t node, uint64_t key, int32_t& left, int32_t& right);
+
+  /** Merge the subtrees `left` and `right`, where every gap of `left` starts
+   * below those of `right`, returning the root of the merged subtree. */
+  int32_t merge(int32_t left, int32_t right);
+
+  /** The start of the region areas are placed within. */
+  uint64_t regionStart_;
+
+  /** The end of the region areas are placed within. */
+  uint64_t regionEnd_;
+
+  /** The page size, in bytes. */
+  uint64_t pageSize_;
+
+  /** The mapped areas, keyed by their start address. */
+  std::map<uint64_t, VirtualMemoryArea> areas_;
+
+  /** The nodes of the gap treap. */
+  std::vector<Gap> gaps_;
+
+  /** The indices of the unused nodes of `gaps_`, available for reuse. */
+  std::vector<int32_t> freeGaps_;
+
+  /** The index of the root node of the gap treap, or -1 if it's empty. */
+  int32_t root_ = -1;
+
+  /** The state of the generator of node priorities. A fixed seed keeps the
+   * shape of the treap, and so the simulation, deterministic. */
+  uint32_t seed_ = 0x9e3779b9;
+};
+
+}  // namespace kernel
+}  // namespace simeng
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <queue>
 #include <vector>
 
+#include "simeng/TimingWheel.hh"
 #include "simeng/memory/MemoryInterface.hh"
 
 namespace simeng {
@@ -15,27 +15,16 @@ struct FixedLatencyMemoryInterfaceRequest {
   bool write;
 
   /** The memory target to access. */
-  const MemoryAccessTarget target;
+  MemoryAccessTarget target;
 
   /** The value to write to the target (writes only) */
-  const RegisterValue data;
-
-  /** The cycle count this request will be ready at. */
-  uint64_t readyAt;
+  RegisterValue data;
 
   /** A unique request identifier for read operations. */
   uint64_t requestId;
 
-  /** Construct a write request. */
-  FixedLatencyMemoryInterfaceRequest(const MemoryAccessTarget& target,
-                                     const RegisterValue& data,
-                                     uint64_t readyAt)
-      : write(true), target(target), data(data), readyAt(readyAt) {}
-
-  /** Construct a read request. */
-  FixedLatencyMemoryInterfaceRequest(const MemoryAccessTarget& target,
-                                     uint64_t readyAt, uint64_t requestId)
-      : write(false), target(target), readyAt(readyAt), requestId(requestId) {}
+  /** The block of data to write from `target.address` (block writes only). */
+  std::vector<char> block;
 };
 
 /** A memory interface where all requests respond with a fixed latency. */
@@ -53,6 +42,14 @@ class FixedLatencyMemoryInterface : public MemoryInterface {
   /** Queue a write request of `data` to the target location. */
   void requestWrite(const MemoryAccessTarget& target,
                     const RegisterValue& data) override;
+  /** Queue a write of the `size` bytes at `data` to memory starting at
+   * `address`, completing as a single copy. */
+  void requestBlockWrite(uint64_t address, const char* data,
+                         uint64_t size) override;
+  /** Copy the `size` bytes of memory starting at `address` into `buffer`,
+   * provided no requests are in flight that could alter them. Returns false
+   * otherwise, or if the block lies outside of memory. */
+  bool readBlock(uint64_t address, char* buffer, uint64_t size) override;
   /** Retrieve all completed requests. */
   const span<MemoryReadResult> getCompletedReads() const override;
 
@@ -73,8 +70,9 @@ class FixedLatencyMemoryInterface : public MemoryInterface {
   /** A vector containing all completed read requests. */
   std::vector<MemoryReadResult> completedReads_;
 
-  /** A queue containing all pending memory requests. */
-  std::queue<FixedLatencyMemoryInterfaceRequest> pendingRequests_;
+  /** A timing wheel containing all pending memory requests, keyed by the
+   * cycle they complete on. */
+  TimingWheel<FixedLatencyMemoryInterfaceRequest> pendingRequests_;
 
   /** The latency all requests are completed after. */
   uint16_t latency_;
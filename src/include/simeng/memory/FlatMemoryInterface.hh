@@ -23,6 +23,13 @@ class FlatMemoryInterface : public MemoryInterface {
   /** Request a write of `data` to the target location. */
   void requestWrite(const MemoryAccessTarget& target,
                     const RegisterValue& data) override;
+  /** Write the `size` bytes at `data` to memory starting at `address`, with
+   * a single copy. */
+  void requestBlockWrite(uint64_t address, const char* data,
+                         uint64_t size) override;
+  /** Copy the `size` bytes of memory starting at `address` into `buffer`.
+   * Returns false if the block lies outside of memory. */
+  bool readBlock(uint64_t address, char* buffer, uint64_t size) override;
   /** Retrieve all completed requests. */
   const span<MemoryReadResult> getCompletedReads() const override;
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "simeng/RegisterValue.hh"
 #include "simeng/memory/MemoryReadResult.hh"
 #include "simeng/span.hh"
@@ -32,6 +34,28 @@ class MemoryInterface {
   /** Request a write of `data` to the target location. */
   virtual void requestWrite(const MemoryAccessTarget& target,
                             const RegisterValue& data) = 0;
+  /** Request a write of the `size` bytes at `data` to memory, starting at
+   * `address`. Interfaces with direct access to memory perform the write as a
+   * single copy; by default, it's split into requests of up to 128 bytes. */
+  virtual void requestBlockWrite(uint64_t address, const char* data,
+                                 uint64_t size) {
+    while (size > 0) {
+      uint16_t chunk = static_cast<uint16_t>(std::min<uint64_t>(size, 128));
+      requestWrite({address, chunk}, RegisterValue(data, chunk));
+      address += chunk;
+      data += chunk;
+      size -= chunk;
+    }
+  }
+
+  /** Immediately copy the `size` bytes of memory starting at `address` into
+   * `buffer`, bypassing any modelled latency. Returns false without reading
+   * if the interface can't service the read immediately, in which case it
+   * must instead be requested through `requestRead`; this is the default. */
+  virtual bool readBlock(uint64_t address, char* buffer, uint64_t size) {
+    return false;
+  }
+
   /** Retrieve all completed read requests. */
   virtual const span<MemoryReadResult> getCompletedReads() const = 0;
 
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <string>
 
 #include "simeng/ArchitecturalRegisterFileSet.hh"
 #include "simeng/Core.hh"
 #include "simeng/arch/Architecture.hh"
+#include "simeng/branchpredictors/BranchTrace.hh"
 #include "simeng/span.hh"
 
 namespace simeng {
@@ -73,6 +75,10 @@ class Core : public simeng::Core {
 
   /** The number of branches executed. */
   uint64_t branchesExecuted_ = 0;
+
+  /** A writer recording each executed branch to a branch trace, if one was
+   * requested by the Core:Branch-Trace-File config option. */
+  std::unique_ptr<BranchTraceWriter> branchTrace_;
 };
 
 }  // namespace emulation
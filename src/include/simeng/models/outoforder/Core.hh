@@ -6,23 +6,64 @@
 #include "simeng/pipeline/DispatchIssueUnit.hh"
 #include "simeng/pipeline/ExecuteUnit.hh"
 #include "simeng/pipeline/FetchUnit.hh"
+#include "simeng/pipeline/HotspotProfiler.hh"
 #include "simeng/pipeline/LoadStoreQueue.hh"
 #include "simeng/pipeline/MappedRegisterFileSet.hh"
+#include "simeng/pipeline/MicroOpCache.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
 #include "simeng/pipeline/PortAllocator.hh"
 #include "simeng/pipeline/RegisterAliasTable.hh"
 #include "simeng/pipeline/RenameUnit.hh"
 #include "simeng/pipeline/ReorderBuffer.hh"
+#include "simeng/pipeline/StoreSetPredictor.hh"
+#include "simeng/pipeline/TopDownAnalysis.hh"
 #include "simeng/pipeline/WritebackUnit.hh"
 
 namespace simeng {
 namespace models {
 namespace outoforder {
 
+/** The policy selecting the hardware thread to fetch for each cycle. */
+enum class FetchPolicy {
+  /** Fetch for each thread in turn. */
+  RoundRobin,
+  /** Fetch for the thread with the fewest instructions in the front-end and
+   * reservation stations. */
+  ICount
+};
+
+/** The policy selecting the hardware threads to commit from each cycle. */
+enum class CommitPolicy {
+  /** Commit from a single thread per cycle, taking each thread in turn. */
+  RoundRobin,
+  /** Share the commit width amongst all threads, rotating their priority each
+   * cycle. */
+  Shared
+};
+
 /** An out-of-order pipeline core model. Provides a 6-stage pipeline: Fetch,
- * Decode, Rename, Dispatch/Issue, Execute, Writeback. */
+ * Decode, Rename, Dispatch/Issue, Execute, Writeback. The core may run several
+ * hardware threads, each with its own front-end, register mapping, reorder
+ * buffer and load/store queue, which share the physical register file,
+ * reservation stations, and execution units. */
 class Core : public simeng::Core {
  public:
+  /** The resources private to a hardware thread. */
+  struct ThreadContext {
+    /** The memory interface to fetch instructions from. */
+    memory::MemoryInterface& instructionMemory;
+    /** The memory interface to access data through. */
+    memory::MemoryInterface& dataMemory;
+    /** The size of the thread's process memory. */
+    uint64_t processMemorySize;
+    /** The address of the first instruction to execute. */
+    uint64_t entryPoint;
+    /** The ISA, bound to the kernel managing the thread's process. */
+    const arch::Architecture& isa;
+    /** The thread's branch predictor. */
+    BranchPredictor& branchPredictor;
+  };
+
   /** Construct a core model, providing the process memory, and an ISA, branch
    * predictor, and port allocator to use. */
   Core(memory::MemoryInterface& instructionMemory,
@@ -31,52 +72,171 @@ class Core : public simeng::Core {
        BranchPredictor& branchPredictor, pipeline::PortAllocator& portAllocator,
        ryml::ConstNodeRef config = config::SimInfo::getConfig());
 
+  /** Construct a core model running a hardware thread for each of the supplied
+   * thread contexts, providing the port allocator to use. The memory
+   * interfaces of the first thread are expected to be ticked alongside the
+   * core, as for a single-threaded core; those of any other threads are ticked
+   * by the core itself. */
+  Core(const std::vector<ThreadContext>& threads,
+       pipeline::PortAllocator& portAllocator,
+       ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Write the hotspot profile and top-down breakdown, if requested by the
+   * Core:Profile-File and Core:Top-Down-File config options. */
+  ~Core();
+
   /** Tick the core. Ticks each of the pipeline stages sequentially, then ticks
    * the buffers between them. Checks for and executes pipeline flushes at the
    * end of each cycle. */
   void tick() override;
 
-  /** Check whether the program has halted. */
+  /** Check whether the program has halted. The core halts once every hardware
+   * thread has. */
   bool hasHalted() const override;
 
-  /** Retrieve the architectural register file set. */
+  /** Retrieve the architectural register file set of the first hardware
+   * thread, or of the thread whose exception is being handled. */
   const ArchitecturalRegisterFileSet& getArchitecturalRegisterFileSet()
       const override;
 
+  /** Set whether execution units, the load/store queue, issue ports, and
+   * completion slots are only ticked while active. Enabled by default;
+   * disabling it ticks every unit and buffer each cycle, with identical
+   * results. */
+  void setActivityTracking(bool enabled);
+
   /** Retrieve the number of instructions retired. */
   uint64_t getInstructionsRetiredCount() const override;
 
   /** Generate a map of statistics to report. */
   std::map<std::string, std::string> getStats() const override;
 
+  /** Supply the function symbols of the simulated program, naming the
+   * instruction addresses of the hotspot profile. */
+  void setProfileSymbols(std::vector<ElfSymbol> symbols);
+
+  /** Retrieve the hotspot profiler, or nullptr if profiling is disabled. */
+  const pipeline::HotspotProfiler* getProfiler() const;
+
  private:
-  /** Raise an exception to the core, providing the generating instruction. */
-  void raiseException(const std::shared_ptr<Instruction>& instruction);
+  /** The pipeline state private to a hardware thread. */
+  struct Thread {
+    /** Construct the pipeline state of hardware thread `id` of `core`. */
+    Thread(Core& core, uint16_t id, const ThreadContext& context,
+           ryml::ConstNodeRef config);
 
-  /** Handle an exception raised during the cycle. */
-  void handleException();
+    /** The thread's memory interfaces, ISA, and branch predictor. */
+    ThreadContext context;
 
-  /** Process the active exception handler. */
-  void processExceptionHandler();
+    /** The thread's register alias table, mapping onto its partition of the
+     * physical register file. */
+    pipeline::RegisterAliasTable registerAliasTable;
 
-  /** Inspect units and flush pipelines if required. */
-  void flushIfNeeded();
+    /** The thread's mapped register file set. */
+    pipeline::MappedRegisterFileSet mappedRegisterFileSet;
 
-  const std::vector<simeng::RegisterFileStructure> physicalRegisterStructures_;
+    /** The buffer between fetch and decode. */
+    pipeline::PipelineBuffer<MacroOp> fetchToDecodeBuffer;
 
-  const std::vector<uint16_t> physicalRegisterQuantities_;
+    /** The buffer between decode and rename. */
+    pipeline::PipelineBuffer<std::shared_ptr<Instruction>> decodeToRenameBuffer;
+
+    /** The micro-op cache, holding previously predecoded instructions. */
+    pipeline::MicroOpCache microOpCache;
+
+    /** The fetch unit; fetches instructions from memory. */
+    pipeline::FetchUnit fetchUnit;
+
+    /** The decode unit; decodes instructions into uops and reads operands. */
+    pipeline::DecodeUnit decodeUnit;
+
+    /** The rename unit; renames instruction registers. */
+    pipeline::RenameUnit renameUnit;
+
+    /** The thread's reorder buffer. */
+    pipeline::ReorderBuffer reorderBuffer;
+
+    /** The thread's load/store queue. */
+    pipeline::LoadStoreQueue loadStoreQueue;
+
+    /** The active exception handler. */
+    std::shared_ptr<arch::ExceptionHandler> exceptionHandler;
+
+    /** Whether an exception was generated during the cycle. */
+    bool exceptionGenerated = false;
+
+    /** A pointer to the instruction responsible for generating the exception.
+     */
+    std::shared_ptr<Instruction> exceptionGeneratingInstruction;
+
+    /** Whether the thread has halted due to a fatal exception. */
+    bool halted = false;
+
+    /** Whether the thread takes part in the current cycle; a thread doesn't
+     * while it's halted or handling an exception. */
+    bool active = false;
+
+    /** The thread's stall counts, by cause, as of the last profiled cycle. */
+    std::array<uint64_t, pipeline::STALL_CAUSE_COUNT> profiledStalls = {};
+
+    /** The cause of the flush the thread is recovering from until it next
+     * delivers uops to the back-end, or Frontend if it isn't recovering. */
+    pipeline::SlotStall recovery = pipeline::SlotStall::Frontend;
+
+    /** The number of uops renamed, as of the last cycle accounted for. */
+    uint64_t accountedRenamed = 0;
 
-  /** The core's register alias table. */
-  pipeline::RegisterAliasTable registerAliasTable_;
+    /** The number of rename stalls on a full load or store queue, as of the
+     * last cycle accounted for. */
+    uint64_t accountedMemoryStalls = 0;
+  };
 
-  /** The mapped register file set. */
-  pipeline::MappedRegisterFileSet mappedRegisterFileSet_;
+  /** Tick the pipeline stages and buffers, on behalf of the active threads. */
+  void tickPipeline();
 
-  /** The buffer between fetch and decode. */
-  pipeline::PipelineBuffer<MacroOp> fetchToDecodeBuffer_;
+  /** Select the hardware thread to fetch for this cycle according to the
+   * fetch policy, returning the number of threads if none can. */
+  uint16_t selectFetchThread();
 
-  /** The buffer between decode and rename. */
-  pipeline::PipelineBuffer<std::shared_ptr<Instruction>> decodeToRenameBuffer_;
+  /** Select the hardware thread to rename for this cycle, returning the number
+   * of threads if none has instructions to rename. */
+  uint16_t selectRenameThread();
+
+  /** Commit instructions from the reorder buffers according to the commit
+   * policy. */
+  void commit();
+
+  /** Retrieve the number of instructions of thread `id` in the front-end and
+   * reservation stations, for the ICOUNT fetch policy. */
+  uint32_t getInFlightCount(uint16_t id) const;
+
+  /** Check whether hardware thread `thread` has halted. */
+  bool hasHalted(const Thread& thread) const;
+
+  /** Handle an exception raised by thread `id` during the cycle. */
+  void handleException(uint16_t id);
+
+  /** Process the active exception handler of thread `id`. */
+  void processExceptionHandler(uint16_t id);
+
+  /** Inspect units and flush the pipeline of thread `id` if required. */
+  void flushIfNeeded(uint16_t id);
+
+  /** Remove the flushed instructions from the rename/dispatch buffer, shared
+   * between the threads. */
+  void purgeRenameToDispatchBuffer();
+
+  /** Attribute the cycle just ended for each hardware thread to the hotspot
+   * profiler. */
+  void profileCycle();
+
+  /** Attribute the issue slots of the cycle to the top-down categories, given
+   * the thread renamed for, or the number of threads if none was. */
+  void accountSlots(uint16_t renameThread);
+
+  const std::vector<simeng::RegisterFileStructure> physicalRegisterStructures_;
+
+  const std::vector<uint16_t> physicalRegisterQuantities_;
 
   /** The buffer between rename and dispatch/issue. */
   pipeline::PipelineBuffer<std::shared_ptr<Instruction>>
@@ -87,18 +247,14 @@ class Core : public simeng::Core {
       issuePorts_;
 
   /** The completion slots; single-width buffers between execute and writeback.
-   */
+   * The slots of the execution units are followed by those of each thread's
+   * load/store queue. */
   std::vector<pipeline::PipelineBuffer<std::shared_ptr<Instruction>>>
       completionSlots_;
 
-  /** The fetch unit; fetches instructions from memory. */
-  pipeline::FetchUnit fetchUnit_;
-
-  /** The decode unit; decodes instructions into uops and reads operands. */
-  pipeline::DecodeUnit decodeUnit_;
-
-  /** The rename unit; renames instruction registers. */
-  pipeline::RenameUnit renameUnit_;
+  /** The memory dependence predictor; holds back loads predicted to depend on
+   * an in-flight store. */
+  pipeline::StoreSetPredictor storeSetPredictor_;
 
   /** The dispatch/issue unit; dispatches instructions to the reservation
    * station, reads operands, and issues ready instructions to the execution
@@ -112,12 +268,6 @@ class Core : public simeng::Core {
   /** The writeback unit; writes uop results to the register files. */
   pipeline::WritebackUnit writebackUnit_;
 
-  /** The core's reorder buffer. */
-  pipeline::ReorderBuffer reorderBuffer_;
-
-  /** The core's load/store queue. */
-  pipeline::LoadStoreQueue loadStoreQueue_;
-
   /** The port allocator unit; allocates a port that an instruction will be
    * issued from based on a defined algorithm. */
   pipeline::PortAllocator& portAllocator_;
@@ -126,17 +276,52 @@ class Core : public simeng::Core {
    * cycle. */
   uint64_t commitWidth_ = 0;
 
+  /** The policy selecting the thread to fetch for each cycle. */
+  FetchPolicy fetchPolicy_ = FetchPolicy::RoundRobin;
+
+  /** The policy selecting the threads to commit from each cycle. */
+  CommitPolicy commitPolicy_ = CommitPolicy::RoundRobin;
+
+  /** The hardware threads. */
+  std::vector<std::unique_ptr<Thread>> threads_;
+
+  /** The thread most recently fetched for. */
+  uint16_t fetchThread_ = 0;
+
+  /** The thread most recently renamed for. */
+  uint16_t renameThread_ = 0;
+
+  /** The thread most recently committed from, or given priority to commit. */
+  uint16_t commitThread_ = 0;
+
+  /** The thread whose architectural register file set is exposed; switched to
+   * a thread while its exception is handled. */
+  uint16_t activeThread_ = 0;
+
   /** The number of times the pipeline has been flushed. */
   uint64_t flushes_ = 0;
 
-  /** Whether an exception was generated during the cycle. */
-  bool exceptionGenerated_ = false;
+  /** Whether idle units and buffers are skipped when ticking. */
+  bool trackActivity_ = true;
+
+  /** The path to write the hotspot profile to, if one was requested by the
+   * Core:Profile-File config option. */
+  std::string profilePath_;
+
+  /** The hotspot profiler, attributing cycles to instruction addresses; a
+   * nullptr when profiling is disabled. */
+  std::unique_ptr<pipeline::HotspotProfiler> profiler_;
+
+  /** The stall counts of the shared dispatch/issue unit, by cause, as of the
+   * last profiled cycle. */
+  std::array<uint64_t, pipeline::STALL_CAUSE_COUNT> profiledStalls_ = {};
 
-  /** A pointer to the instruction responsible for generating the exception. */
-  std::shared_ptr<Instruction> exceptionGeneratingInstruction_;
+  /** The top-down breakdown of the issue slots between rename and dispatch. */
+  pipeline::TopDownAnalysis topDown_;
 
-  /** Reference to the current branch predictor */
-  BranchPredictor& branchPredictor_;
+  /** The path to write the top-down breakdown to, if one was requested by the
+   * Core:Top-Down-File config option. */
+  std::string topDownPath_;
 };
 
 }  // namespace outoforder
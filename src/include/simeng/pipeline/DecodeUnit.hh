@@ -9,17 +9,20 @@ namespace simeng {
 namespace pipeline {
 
 /** A decode unit for a pipelined processor. Splits pre-decoded macro-ops into
- * uops. */
+ * uops, and optionally fuses adjacent pairs of uops into single macro-ops
+ * according to the fusion rules of the architecture. */
 class DecodeUnit {
  public:
   /** Constructs a decode unit with references to input/output buffers and the
-   * current branch predictor. */
+   * current branch predictor. Uops are fused according to the macro-op fusion
+   * rules of `isa` if supplied. */
   DecodeUnit(PipelineBuffer<MacroOp>& input,
              PipelineBuffer<std::shared_ptr<Instruction>>& output,
-             BranchPredictor& predictor);
+             BranchPredictor& predictor,
+             const arch::Architecture* isa = nullptr);
 
-  /** Ticks the decode unit. Breaks macro-ops into uops, and performs early
-   * branch misprediction checks. */
+  /** Ticks the decode unit. Breaks macro-ops into uops, fuses pairs of uops
+   * where possible, and performs early branch misprediction checks. */
   void tick();
 
   /** Check whether the core should be flushed this cycle. */
@@ -33,10 +36,22 @@ class DecodeUnit {
    * discovering a branch misprediction early. */
   uint64_t getEarlyFlushes() const;
 
+  /** Retrieve the number of uops passed on by the decode unit. A fused
+   * macro-op counts once, as it occupies a single slot. */
+  uint64_t getDecodedCount() const;
+
+  /** Retrieve the number of pairs of uops fused into a single macro-op. */
+  uint64_t getFusedCount() const;
+
   /** Clear the microOps_ queue. */
   void purgeFlushed();
 
  private:
+  /** Check whether `first` and `second` may be fused into a single macro-op,
+   * writing the execution information of the macro-op into `info` if so. */
+  bool canFuse(const Instruction& first, const Instruction& second,
+               ExecutionInfo& info) const;
+
   /** A buffer of macro-ops to split into uops. */
   PipelineBuffer<MacroOp>& input_;
   /** An internal buffer for storing one or more uops. */
@@ -47,6 +62,10 @@ class DecodeUnit {
   /** A reference to the current branch predictor. */
   BranchPredictor& predictor_;
 
+  /** The architecture whose macro-op fusion rules are applied; fusion is
+   * disabled if null. */
+  const arch::Architecture* isa_;
+
   /** Whether the core should be flushed after this cycle. */
   bool shouldFlush_;
 
@@ -56,6 +75,12 @@ class DecodeUnit {
   /** The number of times that the decode unit requested a flush due to
    * discovering a branch misprediction early. */
   uint64_t earlyFlushes_ = 0;
+
+  /** The number of uops passed on, counting fused macro-ops once. */
+  uint64_t decoded_ = 0;
+
+  /** The number of pairs of uops fused into a single macro-op. */
+  uint64_t fused_ = 0;
 };
 
 }  // namespace pipeline
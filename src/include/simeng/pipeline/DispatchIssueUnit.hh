@@ -1,16 +1,14 @@
 #pragma once
 
 #include <deque>
-#include <initializer_list>
-#include <queue>
-#include <tuple>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "simeng/Instruction.hh"
 #include "simeng/config/SimInfo.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
 #include "simeng/pipeline/PortAllocator.hh"
+#include "simeng/pipeline/StoreSetPredictor.hh"
 
 namespace simeng {
 namespace pipeline {
@@ -19,9 +17,11 @@ namespace pipeline {
 struct ReservationStationPort {
   /** Issue port this port maps to */
   uint16_t issuePort;
-  /** Queue of instructions that are ready to be
-   * issued */
-  std::deque<std::shared_ptr<Instruction>> ready;
+  /** Bitmap of the reservation station slots holding instructions that are
+   * ready to be issued to this port */
+  std::vector<uint64_t> ready;
+  /** Number of instructions that are ready to be issued to this port */
+  uint32_t readyCount;
 };
 
 /** A reservation station */
@@ -34,16 +34,30 @@ struct ReservationStation {
   uint32_t currentSize;
   /** Issue ports belonging to reservation station */
   std::vector<ReservationStationPort> ports;
+  /** Index of the first of this reservation station's slots in the unit's
+   * slot array */
+  uint32_t slotOffset;
+  /** Unoccupied slots of this reservation station */
+  std::vector<uint32_t> freeSlots;
 };
 
 /** An entry in the reservation station. */
-struct dependencyEntry {
+struct reservationStationEntry {
   /** The instruction to execute. */
   std::shared_ptr<Instruction> uop;
   /** The port to issue to. */
   uint16_t port;
-  /** The operand waiting on a value. */
-  uint16_t operandIndex;
+  /** The order in which the instruction was dispatched, used to select the
+   * oldest ready instruction at issue. */
+  uint64_t age;
+  /** Whether the instruction is a load held back on a predicted store
+   * dependence. */
+  bool held;
+  /** The sequence ID of the store a held load is waiting on. */
+  uint64_t storeSeqId;
+  /** The operands waiting on a value, as pairs of the flattened physical
+   * register index and the operand index. */
+  std::vector<std::pair<uint32_t, uint16_t>> pendingOperands;
 };
 
 /** A dispatch/issue unit for an out-of-order pipelined processor. Reads
@@ -52,12 +66,14 @@ struct dependencyEntry {
 class DispatchIssueUnit {
  public:
   /** Construct a dispatch/issue unit with references to input/output buffers,
-   * the register file, the port allocator, and a description of the number of
-   * physical registers the scoreboard needs to reflect. */
+   * the register file, the port allocator, the memory dependence predictor,
+   * and a description of the number of physical registers the scoreboard needs
+   * to reflect. */
   DispatchIssueUnit(
       PipelineBuffer<std::shared_ptr<Instruction>>& fromRename,
       std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& issuePorts,
       const RegisterFileSet& registerFileSet, PortAllocator& portAllocator,
+      StoreSetPredictor& storeSetPredictor,
       const std::vector<uint16_t>& physicalRegisterStructure,
       ryml::ConstNodeRef config = config::SimInfo::getConfig());
 
@@ -74,9 +90,19 @@ class DispatchIssueUnit {
   void forwardOperands(const span<Register>& destinations,
                        const span<RegisterValue>& values);
 
-  /** Clear the RS of all flushed instructions. */
+  /** Release any loads held back on the predicted dependence upon `store`, now
+   * that it has generated its addresses. */
+  void releaseMemoryDependents(const std::shared_ptr<Instruction>& store);
+
+  /** Clear the RS of all flushed instructions. As flushed instructions are
+   * always the youngest dispatched of their hardware thread, only the youngest
+   * entries of each thread are inspected. */
   void purgeFlushed();
 
+  /** Retrieve the number of instructions of hardware thread `threadId` held in
+   * the reservation stations. */
+  uint32_t getThreadOccupancy(uint16_t threadId) const;
+
   /** Retrieve the number of cycles this unit stalled due to insufficient RS
    * space. */
   uint64_t getRSStalls() const;
@@ -97,6 +123,18 @@ class DispatchIssueUnit {
   void getRSSizes(std::vector<uint32_t>&) const;
 
  private:
+  /** Retrieve the flattened physical register index of `reg`. */
+  uint32_t getRegisterIndex(const Register& reg) const;
+
+  /** Mark the instruction in reservation station slot `slot` as ready to
+   * issue. */
+  void setReady(uint32_t slot);
+
+  /** Select the oldest ready instruction of reservation station port `port`,
+   * returning its slot and clearing its ready bit. */
+  uint32_t selectOldest(const ReservationStation& rs,
+                        ReservationStationPort& port);
+
   /** A buffer of instructions to dispatch and read operands for. */
   PipelineBuffer<std::shared_ptr<Instruction>>& input_;
 
@@ -106,8 +144,13 @@ class DispatchIssueUnit {
   /** A reference to the physical register file set. */
   const RegisterFileSet& registerFileSet_;
 
-  /** The register availability scoreboard. */
-  std::vector<std::vector<bool>> scoreboard_;
+  /** The offset of each register type within the flattened physical register
+   * index used by the scoreboard and wakeup matrix. */
+  std::vector<uint32_t> registerOffsets_;
+
+  /** The register availability scoreboard; a bitmap over the flattened
+   * physical register index. */
+  std::vector<uint64_t> scoreboard_;
 
   /** Reservation stations */
   std::vector<ReservationStation> reservationStations_;
@@ -115,14 +158,35 @@ class DispatchIssueUnit {
   /** A mapping from port to RS port */
   std::vector<std::pair<uint16_t, uint16_t>> portMapping_;
 
-  /** A dependency matrix, containing all the instructions waiting on an
-   * operand. For a register `{type,tag}`, the vector of dependents may be found
-   * at `dependencyMatrix[type][tag]`. */
-  std::vector<std::vector<std::vector<dependencyEntry>>> dependencyMatrix_;
+  /** The slots of all reservation stations. Each reservation station owns a
+   * contiguous range, beginning at its `slotOffset`. */
+  std::vector<reservationStationEntry> entries_;
 
-  /** A map to collect flushed instructions for each reservation station. */
-  std::unordered_map<uint16_t, std::unordered_set<std::shared_ptr<Instruction>>>
-      flushed_;
+  /** The number of 64-bit words in each row of the wakeup matrix. */
+  size_t rowWords_ = 0;
+
+  /** The wakeup matrix, containing a row for each physical register with a bit
+   * set for every slot holding an instruction waiting on that register. The
+   * row for flattened register index `r` begins at `r * rowWords_`. */
+  std::vector<uint64_t> wakeupMatrix_;
+
+  /** The number of instructions dispatched, used to age reservation station
+   * entries. */
+  uint64_t dispatched_ = 0;
+
+  /** The slots of dispatched instructions, paired with their age, in program
+   * order; one queue is held per hardware thread, and grown as new threads are
+   * seen. Records of instructions which have since issued are left in place
+   * and skipped, and removed once they reach either end. */
+  std::vector<std::deque<std::pair<uint32_t, uint64_t>>> dispatchOrder_;
+
+  /** The number of instructions held in the reservation stations for each
+   * hardware thread. */
+  std::vector<uint32_t> threadOccupancy_;
+
+  /** A map from the sequence ID of an in-flight store to the slots of the
+   * loads held back on a predicted dependence upon it. */
+  std::unordered_map<uint64_t, std::vector<uint32_t>> storeDependents_;
 
   /** Records the number of instructions dispatched for each reservation station
    * within a cycle. */
@@ -131,6 +195,9 @@ class DispatchIssueUnit {
   /** A reference to the execution port allocator. */
   PortAllocator& portAllocator_;
 
+  /** A reference to the memory dependence predictor. */
+  StoreSetPredictor& storeSetPredictor_;
+
   /** The number of cycles stalled due to a full reservation station. */
   uint64_t rsStalls_ = 0;
 
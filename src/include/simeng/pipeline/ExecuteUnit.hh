@@ -4,6 +4,7 @@
 #include <functional>
 
 #include "simeng/Instruction.hh"
+#include "simeng/TimingWheel.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
 
 namespace simeng {
@@ -50,6 +51,10 @@ class ExecuteUnit {
    * misprediction. */
   uint64_t getFlushInsnId() const;
 
+  /** Retrieve the hardware thread of the most recently discovered
+   * misprediction. */
+  uint16_t getFlushThreadId() const;
+
   /** Purge flushed instructions from the internal pipeline and clear any active
    * stall, if applicable. */
   void purgeFlushed();
@@ -61,11 +66,22 @@ class ExecuteUnit {
    * instructions. */
   bool isEmpty() const;
 
+  /** Query whether ticking the unit would have any effect; that is, whether it
+   * is processing or stalled on any instructions, has an instruction waiting
+   * in its input buffer, or has a flush to clear. Ticking an inactive unit only
+   * advances its tick counter, which is solely used to time instructions
+   * relative to one another, so may be skipped. */
+  bool isActive() const;
+
  private:
   /** Execute the supplied uop, write it into the output buffer, and forward
    * results back to dispatch/issue. */
   void execute(std::shared_ptr<Instruction>& uop);
 
+  /** Add `uop` to the back of the internal pipeline, ready to execute on tick
+   * `readyAt`. */
+  void addToPipeline(std::shared_ptr<Instruction> uop, uint64_t readyAt);
+
   /** A buffer of instructions to execute. */
   PipelineBuffer<std::shared_ptr<Instruction>>& input_;
 
@@ -89,8 +105,18 @@ class ExecuteUnit {
 
   /** The execution unit's internal pipeline, holding instructions until their
    * execution latency has expired and they are ready for their final results to
-   * be calculated and forwarded. */
-  std::deque<ExecutionUnitPipelineEntry> pipeline_;
+   * be calculated and forwarded. Instructions leave the pipeline in order, one
+   * per tick, so each is keyed by the first tick it can do so on: the later of
+   * its `readyAt` tick and the tick after that of the instruction ahead of
+   * it. */
+  TimingWheel<ExecutionUnitPipelineEntry> pipeline_;
+
+  /** The tick the youngest instruction in the pipeline is keyed by. */
+  uint64_t lastScheduled_ = 0;
+
+  /** A reusable buffer for the instructions remaining in the pipeline while it
+   * is purged of flushed instructions. */
+  std::vector<ExecutionUnitPipelineEntry> purgeBuffer_;
 
   /** A group of operation types that are blocked whilst a similar operation
    * is being executed. */
@@ -111,6 +137,9 @@ class ExecuteUnit {
    * current flush. */
   uint64_t flushAfter_;
 
+  /** The hardware thread the current flush applies to. */
+  uint16_t flushThreadId_ = 0;
+
   /** The number of times this unit has been ticked. */
   uint64_t tickCounter_ = 0;
 
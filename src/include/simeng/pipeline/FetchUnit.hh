@@ -1,9 +1,11 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
 #include "simeng/arch/Architecture.hh"
 #include "simeng/memory/MemoryInterface.hh"
+#include "simeng/pipeline/MicroOpCache.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
 
 namespace simeng {
@@ -37,11 +39,17 @@ struct loopBufferEntry {
 class FetchUnit {
  public:
   /** Construct a fetch unit with a reference to an output buffer, the ISA, and
-   * the current branch predictor, and information on the instruction memory. */
+   * the current branch predictor, and information on the instruction memory.
+   * When an enabled `microOpCache` is supplied, instructions held by it are
+   * supplied from it rather than read from instruction memory. A non-zero
+   * `fetchTargetQueueSize` decouples the prediction of fetch blocks from fetch,
+   * queueing and prefetching up to that many blocks ahead. */
   FetchUnit(PipelineBuffer<MacroOp>& output,
             memory::MemoryInterface& instructionMemory,
             uint64_t programByteLength, uint64_t entryPoint, uint16_t blockSize,
-            const arch::Architecture& isa, BranchPredictor& branchPredictor);
+            const arch::Architecture& isa, BranchPredictor& branchPredictor,
+            MicroOpCache* microOpCache = nullptr,
+            uint16_t fetchTargetQueueSize = 0);
 
   ~FetchUnit();
 
@@ -59,7 +67,9 @@ class FetchUnit {
   /** Update the program counter to the specified address. */
   void updatePC(uint64_t address);
 
-  /** Request instructions at the current program counter for a future cycle. */
+  /** Request instructions at the current program counter for a future cycle.
+   * When the fetch target queue is enabled, also queues and prefetches the
+   * next predicted fetch block. */
   void requestFromPC();
 
   /** Retrieve the number of cycles fetch terminated early due to a predicted
@@ -72,7 +82,84 @@ class FetchUnit {
   /** Retrieve the number of branch instructions that have been fetched. */
   uint64_t getBranchFetchedCount() const;
 
+  /** Retrieve the number of micro-op cache lookups which supplied
+   * instructions. */
+  uint64_t getMicroOpCacheHits() const;
+
+  /** Retrieve the number of micro-op cache lookups which missed, such that
+   * instructions were predecoded from instruction memory instead. */
+  uint64_t getMicroOpCacheMisses() const;
+
+  /** Retrieve the mean number of fetch blocks held by the fetch target queue
+   * each cycle. */
+  double getAverageFetchTargetQueueOccupancy() const;
+
+  /** Retrieve the number of fetch blocks prefetched ahead of fetch. */
+  uint64_t getPrefetchesIssued() const;
+
+  /** Retrieve the number of prefetched fetch blocks which were later used by
+   * fetch. */
+  uint64_t getPrefetchesUsed() const;
+
  private:
+  /** A fetch block held by the fetch target queue. */
+  struct FetchTarget {
+    /** The address of the fetch block. */
+    uint64_t address;
+
+    /** Whether the block was queued ahead of fetch requiring it. */
+    bool prefetched;
+
+    /** Whether the read of the block from instruction memory has completed. */
+    bool ready;
+
+    /** The data of the block, once read. */
+    RegisterValue data;
+  };
+
+  /** An entry of the next block table, recording the block that followed a
+   * fetch block when it was last fetched. */
+  struct NextBlockEntry {
+    /** Whether the entry is in use. */
+    bool valid = false;
+
+    /** The address of the fetch block the entry belongs to. */
+    uint64_t block = 0;
+
+    /** The address of the fetch block which followed it. */
+    uint64_t next = 0;
+  };
+
+  /** Supply instructions from the micro-op cache line holding the current
+   * program counter. Returns false if no line holds it. */
+  bool supplyFromMicroOpCache();
+
+  /** Record the data of completed instruction memory reads in the fetch
+   * target queue entries awaiting them. */
+  void receiveFetchTargets();
+
+  /** Retrieve the data of the fetch block at `blockAddress` from the head of
+   * the fetch target queue. Returns a nullptr if the block's read is yet to
+   * complete. The queue is discarded if its head isn't the block, as it ran
+   * ahead down a different path to that of fetch. */
+  const uint8_t* getFetchTargetData(uint64_t blockAddress);
+
+  /** Remove the fetch block at `blockAddress`, whose data has been used, from
+   * the head of the fetch target queue. */
+  void consumeFetchTarget(uint64_t blockAddress);
+
+  /** Ensure the fetch block next required by fetch heads the fetch target
+   * queue, then queue and prefetch the block predicted to follow the last
+   * queued. */
+  void fillFetchTargetQueue();
+
+  /** Predict the fetch block to follow the block at `blockAddress`. */
+  uint64_t predictNextBlock(uint64_t blockAddress) const;
+
+  /** Train the next block table on the block at `nextBlock` having followed
+   * the block at `blockAddress`. */
+  void trainNextBlock(uint64_t blockAddress, uint64_t nextBlock);
+
   /** An output buffer connecting this unit to the decode unit. */
   PipelineBuffer<MacroOp>& output_;
 
@@ -124,6 +211,55 @@ class FetchUnit {
   /** The number of branch instructions that were fetched. */
   uint64_t branchesFetched_ = 0;
 
+  /** The micro-op cache, or a nullptr if none is enabled. */
+  MicroOpCache* microOpCache_;
+
+  /** The number of micro-op cache lookups which supplied instructions. */
+  uint64_t microOpCacheHits_ = 0;
+
+  /** The number of micro-op cache lookups which missed, such that
+   * instructions were predecoded from instruction memory instead. */
+  uint64_t microOpCacheMisses_ = 0;
+
+  /** The maximum number of fetch blocks in the fetch target queue, or 0 if
+   * it's disabled. */
+  uint16_t fetchTargetQueueSize_;
+
+  /** The fetch target queue, holding the fetch blocks predicted to be
+   * required by fetch, oldest first. Runs ahead of fetch, such that the
+   * latency of instruction memory is overlapped with the fetch of earlier
+   * blocks. */
+  std::deque<FetchTarget> fetchTargetQueue_;
+
+  /** The number of entries in the next block table. */
+  static constexpr size_t nextBlockTableSize_ = 4096;
+
+  /** A direct-mapped table, indexed by fetch block address, of the fetch
+   * blocks which followed those that didn't continue to the next sequential
+   * block. Used to predict the path of fetch blocks ahead of fetch. */
+  std::vector<NextBlockEntry> nextBlockTable_;
+
+  /** The address of the fetch block last read by fetch, used to train the
+   * next block table. */
+  uint64_t lastFetchedBlock_ = 0;
+
+  /** Whether `lastFetchedBlock_` was the block read before the one fetch is
+   * currently reading; false after a redirection of fetch, or once the loop
+   * buffer or micro-op cache supplied instructions instead. */
+  bool hasLastFetchedBlock_ = false;
+
+  /** The total occupancy of the fetch target queue, summed over each cycle. */
+  uint64_t fetchTargetQueueOccupancy_ = 0;
+
+  /** The number of cycles the fetch target queue's occupancy was sampled. */
+  uint64_t fetchTargetQueueCycles_ = 0;
+
+  /** The number of fetch blocks prefetched ahead of fetch. */
+  uint64_t prefetchesIssued_ = 0;
+
+  /** The number of prefetched fetch blocks used by fetch. */
+  uint64_t prefetchesUsed_ = 0;
+
   /** Let the following PipelineFetchUnitTest derived classes be a friend of
    * this class to allow proper testing of 'tick' function. */
   friend class PipelineFetchUnitTest_invalidMinBytesAtEndOfBuffer_Test;
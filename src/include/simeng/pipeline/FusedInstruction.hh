@@ -0,0 +1,164 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "simeng/Instruction.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** A macro-op fused from two adjacent instructions, the second of which reads
+ * a result of the first. The pair occupies a single slot in each pipeline
+ * structure and executes as one operation, with the results of the first
+ * instruction forwarded to the second internally. Memory operations may not be
+ * fused. */
+class FusedInstruction : public Instruction {
+ public:
+  /** Construct a macro-op fusing `first` and `second`, which executes as
+   * described by `info`. */
+  FusedInstruction(std::shared_ptr<Instruction> first,
+                   std::shared_ptr<Instruction> second,
+                   const ExecutionInfo& info);
+
+  /** Retrieve the source registers this instruction reads. Sources of the
+   * second instruction produced by the first aren't included. */
+  const span<Register> getSourceRegisters() const override;
+
+  /** Retrieve the data contained in the source registers this instruction
+   * reads. */
+  const span<RegisterValue> getSourceOperands() const override;
+
+  /** Retrieve the destination registers this instruction will write to; those
+   * of the first instruction which the second doesn't also write, followed by
+   * those of the second. */
+  const span<Register> getDestinationRegisters() const override;
+
+  /** Override the specified source register with a renamed physical register.
+   */
+  void renameSource(uint16_t i, Register renamed) override;
+
+  /** Override the specified destination register with a renamed physical
+   * register. A destination of the second instruction which the first also
+   * writes is renamed for both. */
+  void renameDestination(uint16_t i, Register renamed) override;
+
+  /** Provide a value for the operand at the specified index. */
+  void supplyOperand(uint16_t i, const RegisterValue& value) override;
+
+  /** Check whether the operand at index `i` has had a value supplied. */
+  bool isOperandReady(int i) const override;
+
+  /** Retrieve register results. */
+  const span<RegisterValue> getResults() const override;
+
+  /** Fused instructions don't access memory; generates no addresses. */
+  span<const memory::MemoryAccessTarget> generateAddresses() override;
+
+  /** Fused instructions don't access memory; returns no addresses. */
+  span<const memory::MemoryAccessTarget> getGeneratedAddresses() const override;
+
+  /** Fused instructions don't access memory; ignores the data supplied. */
+  void supplyData(uint64_t address, const RegisterValue& data) override;
+
+  /** Fused instructions don't access memory; returns no data. */
+  span<const RegisterValue> getData() const override;
+
+  /** Early misprediction check, deferring to the second instruction. */
+  std::tuple<bool, uint64_t> checkEarlyBranchMisprediction() const override;
+
+  /** Retrieve the branch type of the second instruction. */
+  BranchType getBranchType() const override;
+
+  /** Retrieve the known branch offset of the second instruction. */
+  int64_t getKnownOffset() const override;
+
+  /** Is this a store address operation? Always false. */
+  bool isStoreAddress() const override;
+
+  /** Is this a store data operation? Always false. */
+  bool isStoreData() const override;
+
+  /** Is this a load operation? Always false. */
+  bool isLoad() const override;
+
+  /** Is this a branch operation? True if the second instruction is a branch.
+   */
+  bool isBranch() const override;
+
+  /** Retrieve the instruction group of the second instruction. */
+  uint16_t getGroup() const override;
+
+  /** Check whether all operand values have been supplied, and the instruction
+   * is ready to execute. */
+  bool canExecute() const override;
+
+  /** Execute the first instruction, forward its results to the second, and
+   * then execute the second. */
+  void execute() override;
+
+  /** Get this instruction's supported set of ports. */
+  const std::vector<uint16_t>& getSupportedPorts() override;
+
+  /** Set this instruction's execution information including it's execution
+   * latency and throughput, and the set of ports which support it. */
+  void setExecutionInfo(const ExecutionInfo& info) override;
+
+  /** Retrieve the first of the fused instructions. */
+  const std::shared_ptr<Instruction>& getFirst() const;
+
+  /** Retrieve the second of the fused instructions. */
+  const std::shared_ptr<Instruction>& getSecond() const;
+
+  /** Retrieve the fused instruction which encountered an exception. */
+  const std::shared_ptr<Instruction>& getExceptionInstruction() const;
+
+ private:
+  /** The first of the fused instructions. */
+  std::shared_ptr<Instruction> first_;
+
+  /** The second of the fused instructions, which reads a result of the
+   * first. */
+  std::shared_ptr<Instruction> second_;
+
+  /** The source registers of both instructions, excluding those of the second
+   * produced by the first. */
+  std::vector<Register> sourceRegisters_;
+
+  /** The values supplied for each source register. */
+  std::vector<RegisterValue> sourceValues_;
+
+  /** The instruction and operand index each source register belongs to, as
+   * {isSecond, index} pairs. */
+  std::vector<std::pair<bool, uint16_t>> sourceOwners_;
+
+  /** The operands of the second instruction produced by the first, as
+   * {second source index, first destination index} pairs. */
+  std::vector<std::pair<uint16_t, uint16_t>> forwardedOperands_;
+
+  /** The number of source operands yet to be supplied. */
+  uint16_t sourceOperandsPending_ = 0;
+
+  /** The destination registers of the first instruction which the second
+   * doesn't also write, and then those of the second instruction. */
+  std::vector<Register> destinationRegisters_;
+
+  /** The number of destination registers belonging to the first instruction.
+   */
+  uint16_t firstDestinationCount_;
+
+  /** The index within the first instruction of each of its destination
+   * registers. */
+  std::vector<uint16_t> firstDestinationIndices_;
+
+  /** The destinations written by both instructions, as {first destination
+   * index, second destination index} pairs. */
+  std::vector<std::pair<uint16_t, uint16_t>> sharedDestinations_;
+
+  /** The results of the first and then the second instruction, for each
+   * destination register. */
+  std::vector<RegisterValue> results_;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "simeng/Elf.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** The causes to which an instruction's stall cycles are attributed. */
+enum class StallCause : uint8_t {
+  /** The reorder buffer was empty, awaiting instructions from the front-end. */
+  Frontend,
+  /** The reorder buffer was empty, recovering from a branch misprediction or
+   * exception raised by the instruction. */
+  Recovery,
+  /** Rename stalled on a full reorder buffer. */
+  ROB,
+  /** Rename stalled on a full load queue. */
+  LoadQueue,
+  /** Rename stalled on a full store queue. */
+  StoreQueue,
+  /** Rename stalled on a lack of free physical registers. */
+  Allocation,
+  /** Dispatch stalled on a full reservation station. */
+  ReservationStation,
+  /** A ready instruction couldn't issue as its port was busy. */
+  PortBusy
+};
+
+/** The number of stall causes. */
+constexpr size_t STALL_CAUSE_COUNT = 8;
+
+/** The statistics attributed to a single instruction address. */
+struct ProfileEntry {
+  /** The number of instructions retired. */
+  uint64_t retired = 0;
+
+  /** The number of cycles attributed to the instruction. A cycle in which
+   * several instructions retire is shared evenly between them. */
+  double cycles = 0.0;
+
+  /** The number of stall cycles attributed to the instruction, by cause. */
+  std::array<uint64_t, STALL_CAUSE_COUNT> stalls = {};
+
+  /** The number of retired branch mispredictions. */
+  uint64_t mispredicts = 0;
+
+  /** The number of loads completed. */
+  uint64_t loads = 0;
+
+  /** The total latency of the loads completed, in cycles. */
+  uint64_t loadLatency = 0;
+};
+
+/** A profiler attributing the cycles of an out-of-order core to the
+ * instruction addresses responsible for them.
+ *
+ * Each cycle, a hardware thread's cycle is attributed to the instructions it
+ * retires; if none retire, to the oldest instruction in its reorder buffer,
+ * which is blocking retirement. While the reorder buffer is empty, the cycle
+ * is attributed to the mispredicted branch or excepting instruction which last
+ * flushed it, or otherwise to the next instruction to retire, as the
+ * front-end failed to supply it in time. The stall cycles counted in aggregate
+ * by the pipeline units are attributed to the same instruction. */
+class HotspotProfiler {
+ public:
+  /** Construct a profiler for a core running `threads` hardware threads. */
+  explicit HotspotProfiler(uint16_t threads);
+
+  /** Record an instruction of hardware thread `thread` at `address` retiring
+   * `instructions` instructions, noting whether it was a mispredicted branch
+   * or raised an exception, and so flushed the pipeline. */
+  void retire(uint16_t thread, uint64_t address, uint8_t instructions,
+              bool mispredicted, bool raisedException);
+
+  /** Record the completion of a load at `address` after `latency` cycles. */
+  void completeLoad(uint64_t address, uint64_t latency);
+
+  /** Attribute the cycle just ended for hardware thread `thread`. The oldest
+   * instruction remaining in its reorder buffer is at `headAddress`, unless
+   * `robEmpty` is set. `stalls` holds the number of stall cycles counted for
+   * each cause during the cycle; those of the empty reorder buffer causes are
+   * ignored. */
+  void endCycle(uint16_t thread, bool robEmpty, uint64_t headAddress,
+                const std::array<uint64_t, STALL_CAUSE_COUNT>& stalls);
+
+  /** Supply the function symbols to name instruction addresses with. */
+  void setSymbols(std::vector<ElfSymbol> symbols);
+
+  /** Retrieve the name of the function holding `address` with the offset of
+   * the address within it, or an empty string if no function holds it. */
+  std::string symbolise(uint64_t address) const;
+
+  /** Retrieve the statistics attributed to each instruction address. */
+  const std::unordered_map<uint64_t, ProfileEntry>& getEntries() const;
+
+  /** Write the profile to `out`, as a table of functions followed by a table
+   * of instruction addresses, each sorted by descending cycles. */
+  void write(std::ostream& out) const;
+
+ private:
+  /** The attribution state of a hardware thread. */
+  struct ThreadState {
+    /** The addresses of the instructions retired during the cycle. */
+    std::vector<uint64_t> retired;
+
+    /** The cycles and stall cycles awaiting the next instruction to retire. */
+    ProfileEntry pending;
+
+    /** The address of the instruction which last flushed the pipeline. */
+    uint64_t flushAddress = 0;
+
+    /** Whether the reorder buffer has remained empty since the instruction at
+     * `flushAddress` flushed the pipeline. */
+    bool recovering = false;
+  };
+
+  /** Add the cycles and stall cycles of `from` to `to`. */
+  static void addStalls(ProfileEntry& to, const ProfileEntry& from);
+
+  /** Find the function symbol holding `address`, or nullptr if none does. */
+  const ElfSymbol* findSymbol(uint64_t address) const;
+
+  /** The attribution state of each hardware thread. */
+  std::vector<ThreadState> threads_;
+
+  /** The statistics attributed to each instruction address. */
+  std::unordered_map<uint64_t, ProfileEntry> entries_;
+
+  /** The function symbols, sorted by address. */
+  std::vector<ElfSymbol> symbols_;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -2,11 +2,12 @@
 
 #include <deque>
 #include <functional>
-#include <map>
+#include <list>
 #include <queue>
 #include <unordered_map>
 
 #include "simeng/Instruction.hh"
+#include "simeng/TimingWheel.hh"
 #include "simeng/memory/MemoryInterface.hh"
 #include "simeng/pipeline/PipelineBuffer.hh"
 
@@ -16,14 +17,65 @@ namespace pipeline {
 /** The memory access types which are processed. */
 enum accessType { LOAD = 0, STORE };
 
-/** A requestQueue_ entry. */
+/** A requestQueue_ entry. Entries are recycled by the request queues, such
+ * that the storage of their addresses is reused. */
 struct requestEntry {
   /** The memory address(es) to be accessed. */
-  std::queue<simeng::memory::MemoryAccessTarget> reqAddresses;
+  std::vector<simeng::memory::MemoryAccessTarget> reqAddresses;
+  /** The index of the next address in `reqAddresses` to be requested. */
+  size_t nextAddress = 0;
   /** The instruction sending the request(s). */
   std::shared_ptr<Instruction> insn;
 };
 
+/** A memory request formed by coalescing multiple element accesses which fall
+ * within the same cache line. */
+struct coalescedRequest {
+  /** The memory region spanned by the coalesced element accesses. */
+  simeng::memory::MemoryAccessTarget target;
+  /** The element accesses serviced by this request. */
+  std::vector<simeng::memory::MemoryAccessTarget> elements;
+};
+
+/** An in-flight memory access registered within an address index. */
+struct indexedAccess {
+  /** The instruction performing the access. */
+  std::shared_ptr<Instruction> insn;
+  /** The memory region accessed. */
+  simeng::memory::MemoryAccessTarget target;
+  /** Whether a load access was found to overlap an older in-flight store when
+   * the load was started. */
+  bool dependsOnStore = false;
+  /** The sequence ID of the store a load access overlapped. */
+  uint64_t storeSeqId = 0;
+};
+
+/** A load access which overlaps an older in-flight store. */
+struct conflictionEntry {
+  /** The load instruction performing the access. */
+  std::shared_ptr<Instruction> load;
+  /** The memory region accessed by the load. */
+  simeng::memory::MemoryAccessTarget target;
+  /** Whether the access is contained within a single access of the store, such
+   * that the store's data can be forwarded to it. Otherwise, the access is
+   * requested from memory once the store has committed. */
+  bool forwardable;
+  /** The index of the store access containing the load access. */
+  size_t storeIndex;
+};
+
+/** Data forwarded from a store to a load access. */
+struct forwardEntry {
+  /** The load instruction receiving the data. */
+  std::shared_ptr<Instruction> load;
+  /** The address of the load access. */
+  uint64_t address;
+  /** The forwarded data. */
+  RegisterValue data;
+  /** The LSQ cycle on which the data is supplied to the load. */
+  uint64_t readyAt;
+};
+
 /** A load store queue (known as "load/store buffers" or "memory order buffer").
  * Holds in-flight memory access requests to ensure load/store consistency. */
 class LoadStoreQueue {
@@ -40,7 +92,8 @@ class LoadStoreQueue {
       uint16_t storeBandwidth = UINT16_MAX,
       uint16_t permittedRequests = UINT16_MAX,
       uint16_t permittedLoads = UINT16_MAX,
-      uint16_t permittedStores = UINT16_MAX);
+      uint16_t permittedStores = UINT16_MAX, bool coalesceRequests = false,
+      uint16_t cacheLineWidth = 64, uint16_t forwardingLatency = 4);
 
   /** Constructs a split load/store queue model, simulating discrete queues for
    * load and store instructions, supplying completion slots for loads and an
@@ -55,7 +108,8 @@ class LoadStoreQueue {
       uint16_t storeBandwidth = UINT16_MAX,
       uint16_t permittedRequests = UINT16_MAX,
       uint16_t permittedLoads = UINT16_MAX,
-      uint16_t permittedStores = UINT16_MAX);
+      uint16_t permittedStores = UINT16_MAX, bool coalesceRequests = false,
+      uint16_t cacheLineWidth = 64, uint16_t forwardingLatency = 4);
 
   /** Retrieve the available space for load uops. For combined queue this is the
    * total remaining space. */
@@ -89,7 +143,10 @@ class LoadStoreQueue {
   /** Remove the oldest load instruction from the load queue. */
   void commitLoad(const std::shared_ptr<Instruction>& uop);
 
-  /** Remove all flushed instructions from the queues. */
+  /** Remove all flushed instructions from the queues. As flushed instructions
+   * are always the youngest in flight, the load and store queues are truncated
+   * at the first instruction which remains. Any other state held for flushed
+   * loads is discarded when it's next reached. */
   void purgeFlushed();
 
   /** Whether this is a combined load/store queue. */
@@ -98,11 +155,87 @@ class LoadStoreQueue {
   /** Process received load data and send any completed loads for writeback. */
   void tick();
 
+  /** Query whether ticking the queue would have any effect; that is, whether
+   * it has memory requests to send, read responses or forwarded data to
+   * process, or completed loads to write back. */
+  bool isActive() const;
+
   /** Retrieve the load instruction associated with the most recently discovered
    * memory order violation. */
   std::shared_ptr<Instruction> getViolatingLoad() const;
 
+  /** Retrieve the number of element accesses serviced by coalesced requests. */
+  uint64_t getCoalescedAccessesCount() const;
+
+  /** Retrieve the number of coalesced requests generated. */
+  uint64_t getCoalescedRequestsCount() const;
+
+  /** Retrieve the number of load accesses supplied with data forwarded from an
+   * older store. */
+  uint64_t getForwardedAccessesCount() const;
+
+  /** Retrieve the number of load accesses which partially overlapped an older
+   * store and so were stalled until that store committed. */
+  uint64_t getStalledAccessesCount() const;
+
  private:
+  /** Merge the element accesses of a load which fall within the same cache
+   * line into single requests and add them to `reqAddresses`. Accesses which
+   * couldn't be merged are added unchanged. */
+  void coalesceLoadRequests(
+      const std::shared_ptr<Instruction>& insn,
+      const std::list<simeng::memory::MemoryAccessTarget>& targets,
+      std::vector<simeng::memory::MemoryAccessTarget>& reqAddresses);
+
+  /** Create an entry without addresses for `insn` in `queue`, ready after the
+   * instruction's LSQ latency has elapsed. */
+  requestEntry& scheduleRequest(TimingWheel<requestEntry>& queue,
+                                const std::shared_ptr<Instruction>& insn);
+
+  /** Scatter the data returned for a coalesced request back to the element
+   * accesses of `load` it was formed from. Returns `false` if the response
+   * doesn't belong to a coalesced request. */
+  bool supplyCoalescedData(const std::shared_ptr<Instruction>& load,
+                           const memory::MemoryReadResult& response);
+
+  /** Register `access` within `index` under every cache line it spans. */
+  void indexAccess(
+      std::unordered_map<uint64_t, std::vector<indexedAccess>>& index,
+      const indexedAccess& access);
+
+  /** Remove the accesses `targets` registered by `insn` from `index`. */
+  void unindexAccesses(
+      std::unordered_map<uint64_t, std::vector<indexedAccess>>& index,
+      const std::shared_ptr<Instruction>& insn,
+      span<const memory::MemoryAccessTarget> targets);
+
+  /** Retrieve the youngest in-flight store older than sequence ID `seqId` which
+   * overlaps `target`. Returns `nullptr` if there is no such store. */
+  std::shared_ptr<Instruction> findConflictingStore(
+      uint64_t seqId, const simeng::memory::MemoryAccessTarget& target) const;
+
+  /** Register the access `target` of `load` as conflicting with `store`. If the
+   * access can be serviced by the store's data, it is forwarded once
+   * available. */
+  void registerConfliction(const std::shared_ptr<Instruction>& load,
+                           const simeng::memory::MemoryAccessTarget& target,
+                           const std::shared_ptr<Instruction>& store);
+
+  /** Forward the data of `store` to the load accesses awaiting it. */
+  void forwardStoreData(const std::shared_ptr<Instruction>& store,
+                        span<const simeng::RegisterValue> data);
+
+  /** Schedule the portion of `data`, stored to `storeTarget`, read by the load
+   * access `target` to be supplied to `load` after the forwarding latency. */
+  void forwardData(const std::shared_ptr<Instruction>& load,
+                   const simeng::memory::MemoryAccessTarget& target,
+                   const simeng::memory::MemoryAccessTarget& storeTarget,
+                   const RegisterValue& data);
+
+  /** Execute a load which has received all of its data and queue it for
+   * writeback. */
+  void completeLoad(const std::shared_ptr<Instruction>& load);
+
   /** The load queue: holds in-flight load instructions. */
   std::deque<std::shared_ptr<Instruction>> loadQueue_;
 
@@ -118,6 +251,16 @@ class LoadStoreQueue {
   /** Map of loads that have requested their data, keyed by sequence ID. */
   std::unordered_map<uint64_t, std::shared_ptr<Instruction>> requestedLoads_;
 
+  /** The generated addresses of loads that have requested their data, keyed by
+   * cache line. Used to find loads which overlap a committing store without
+   * inspecting every requested load. */
+  std::unordered_map<uint64_t, std::vector<indexedAccess>> loadAddressIndex_;
+
+  /** The generated addresses of in-flight stores, keyed by cache line. Used to
+   * find older stores which a starting load conflicts with without inspecting
+   * every entry of the store queue. */
+  std::unordered_map<uint64_t, std::vector<indexedAccess>> storeAddressIndex_;
+
   /** A function handler to call to forward the results of a completed load. */
   std::function<void(span<Register>, span<RegisterValue>)> forwardOperands_;
 
@@ -158,23 +301,23 @@ class LoadStoreQueue {
   /** The number of times this unit has been ticked. */
   uint64_t tickCounter_ = 0;
 
-  /** A map to hold load instructions that are stalled due to a detected
-   * memory reordering confliction. First key is a store's sequence id and the
-   * second key the conflicting address. The value takes the form of a vector of
-   * pairs containing a pointer to the conflicted load and the size of the data
-   * needed at that address by the load. */
-  std::unordered_map<
-      uint64_t,
-      std::unordered_map<
-          uint64_t,
-          std::vector<std::pair<std::shared_ptr<Instruction>, uint16_t>>>>
-      conflictionMap_;
+  /** A map to hold load accesses that overlap an older in-flight store, keyed
+   * by the store's sequence ID. Accesses remain until the store's data is
+   * forwarded to them or, if they can't be forwarded to, until the store
+   * commits. Accesses of flushed loads are discarded at either point. */
+  std::unordered_map<uint64_t, std::vector<conflictionEntry>> conflictionMap_;
 
-  /** A map between LSQ cycles and load requests ready on that cycle. */
-  std::map<uint64_t, std::deque<requestEntry>> requestLoadQueue_;
+  /** A queue of data forwarded from stores, in order of the cycle on which it
+   * is supplied to its load. */
+  std::deque<forwardEntry> pendingForwards_;
 
-  /** A map between LSQ cycles and store requests ready on that cycle. */
-  std::map<uint64_t, std::deque<requestEntry>> requestStoreQueue_;
+  /** A timing wheel of load requests, keyed by the LSQ cycle they're ready
+   * on. */
+  TimingWheel<requestEntry> requestLoadQueue_;
+
+  /** A timing wheel of store requests, keyed by the LSQ cycle they're ready
+   * on. */
+  TimingWheel<requestEntry> requestStoreQueue_;
 
   /** A queue of completed loads ready for writeback. */
   std::queue<std::shared_ptr<Instruction>> completedLoads_;
@@ -193,6 +336,33 @@ class LoadStoreQueue {
 
   /** The number of loads and stores permitted per cycle. */
   std::array<uint16_t, 2> reqLimits_;
+
+  /** Whether element accesses falling within the same cache line are merged
+   * into a single request. */
+  bool coalesceRequests_;
+
+  /** The width of a L1 cache line in bytes. */
+  uint16_t cacheLineWidth_;
+
+  /** Map of in-flight coalesced requests, keyed by the sequence ID of the load
+   * which generated them. */
+  std::unordered_map<uint64_t, std::vector<coalescedRequest>> coalescedLoads_;
+
+  /** The number of element accesses serviced by coalesced requests. */
+  uint64_t coalescedAccesses_ = 0;
+
+  /** The number of coalesced requests generated. */
+  uint64_t coalescedRequests_ = 0;
+
+  /** The number of cycles taken to forward data from a store to a load. */
+  uint16_t forwardingLatency_;
+
+  /** The number of load accesses supplied with data forwarded from a store. */
+  uint64_t forwardedAccesses_ = 0;
+
+  /** The number of load accesses stalled until an overlapping store
+   * committed. */
+  uint64_t stalledAccesses_ = 0;
 };
 
 }  // namespace pipeline
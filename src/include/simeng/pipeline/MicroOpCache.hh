@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace simeng {
+namespace pipeline {
+
+/** An instruction held in a micro-op cache line. */
+struct MicroOpCacheEntry {
+  /** Encoding of the instruction. */
+  uint32_t encoding;
+
+  /** Size of the instruction, in bytes. */
+  uint16_t instructionSize;
+
+  /** Address of the instruction. */
+  uint64_t address;
+
+  /** The number of micro-ops the instruction decodes into. */
+  uint16_t microOpCount;
+};
+
+/** A set-associative cache of decoded instructions, indexed by fetch block
+ * address. Each line holds a run of sequential instructions from a single fetch
+ * block, ending at a predicted-taken branch or once the micro-ops of the next
+ * instruction wouldn't fit. Lines are filled from the instructions predecoded
+ * by the fetch unit, and replaced in least recently used order. */
+class MicroOpCache {
+ public:
+  /** Construct a micro-op cache holding `capacity` micro-ops, in lines of
+   * `microOpsPerLine` micro-ops grouped into sets of `associativity` lines.
+   * Lines are indexed by the address of the `blockSize`-byte fetch block their
+   * instructions belong to. A capacity of 0 disables the cache. */
+  MicroOpCache(uint32_t capacity, uint16_t associativity,
+               uint16_t microOpsPerLine, uint16_t blockSize);
+
+  /** Query whether the cache is enabled. */
+  bool isEnabled() const;
+
+  /** Query whether a line holds the instruction at `address`, without
+   * updating the replacement state. */
+  bool probe(uint64_t address) const;
+
+  /** Find the line holding the instruction at `address`. Returns the line's
+   * entries and the index of the entry at `address`, or a nullptr if no line
+   * holds it. The line found becomes the most recently used of its set. */
+  std::pair<const std::vector<MicroOpCacheEntry>*, size_t> lookup(
+      uint64_t address);
+
+  /** Record a predecoded instruction, appending it to the line being filled.
+   * The line is inserted into the cache once it ends; when `taken` is set, the
+   * instruction is a branch predicted to be taken and ends the line. */
+  void fill(const MicroOpCacheEntry& entry, bool taken);
+
+ private:
+  /** A line of the cache. */
+  struct Line {
+    /** Whether the line holds valid entries. */
+    bool valid = false;
+
+    /** The value of `useCounter_` at the line's last use, for LRU
+     * replacement. */
+    uint64_t lastUsed = 0;
+
+    /** The instructions held by the line, in program order. */
+    std::vector<MicroOpCacheEntry> entries;
+  };
+
+  /** Retrieve the index of the set holding lines for the fetch block
+   * containing `address`. */
+  size_t getSet(uint64_t address) const;
+
+  /** Find the way of `set` holding the instruction at `address`, returning it
+   * and the index of that instruction within the line. Returns a way of
+   * `associativity_` if no line holds it. */
+  std::pair<uint16_t, size_t> find(size_t set, uint64_t address) const;
+
+  /** Insert the line being filled into the cache, replacing the least recently
+   * used line of its set, and begin a new line. */
+  void insertPending();
+
+  /** The number of lines in each set. */
+  uint16_t associativity_;
+
+  /** The maximum number of micro-ops held by each line. */
+  uint16_t microOpsPerLine_;
+
+  /** The size of a fetch block, in bytes. */
+  uint16_t blockSize_;
+
+  /** The number of sets. */
+  size_t setCount_;
+
+  /** The lines of the cache, stored set by set. */
+  std::vector<Line> lines_;
+
+  /** The line currently being filled. */
+  std::vector<MicroOpCacheEntry> pending_;
+
+  /** The number of micro-ops in the line currently being filled. */
+  uint16_t pendingMicroOps_ = 0;
+
+  /** A counter incremented on each use of a line, providing LRU ordering. */
+  uint64_t useCounter_ = 0;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
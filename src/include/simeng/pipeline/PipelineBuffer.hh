@@ -70,6 +70,13 @@ class PipelineBuffer {
   /** Fill the buffer with a specified value. */
   void fill(const T& value) { std::fill(buffer.begin(), buffer.end(), value); }
 
+  /** Check whether every head and tail slot holds `emptyValue`. Ticking an
+   * empty buffer has no effect, so may be skipped. */
+  bool isEmpty(const T& emptyValue) const {
+    return std::all_of(buffer.begin(), buffer.end(),
+                       [&](const T& value) { return value == emptyValue; });
+  }
+
   /** Get the width of the buffer slots. */
   uint16_t getWidth() const { return width; }
 
@@ -13,9 +13,12 @@ class RegisterAliasTable {
  public:
   /** Construct a RAT, supplying a description of the architectural register
    * structure, and the corresponding numbers of physical registers that should
-   * be available. */
+   * be available. The RAT maps onto the `partition`th block of
+   * `physicalRegisterCounts` registers of each type, such that several RATs
+   * may share one physical register file. */
   RegisterAliasTable(std::vector<RegisterFileStructure> architecturalStructure,
-                     std::vector<uint16_t> physicalRegisterCounts);
+                     std::vector<uint16_t> physicalRegisterCounts,
+                     uint16_t partition = 0);
 
   /** Retrieve the current physical register assigned to the provided
    * architectural register. */
@@ -60,6 +63,11 @@ class RegisterAliasTable {
   /** The free register queues. Holds a list of unallocated physical registers
    * for each register type. */
   std::vector<std::queue<uint16_t>> freeQueues_;
+
+  /** The tag of the first physical register of each type belonging to this
+   * RAT's partition. The history and destination tables are indexed relative
+   * to it. */
+  std::vector<uint16_t> tagOffsets_;
 };
 
 }  // namespace pipeline
@@ -41,6 +41,9 @@ class RenameUnit {
    * space for a store operation. */
   uint64_t getStoreQueueStalls() const;
 
+  /** Retrieve the number of uops renamed and reserved a place in the ROB. */
+  uint64_t getRenamedCount() const;
+
  private:
   /** A buffer of instructions to rename. */
   PipelineBuffer<std::shared_ptr<Instruction>>& input_;
@@ -75,6 +78,9 @@ class RenameUnit {
   /** The number of cycles stalled due to insufficient load/store queue space
    * for a store operation. */
   uint64_t sqStalls_ = 0;
+
+  /** The number of uops renamed. */
+  uint64_t renamed_ = 0;
 };
 
 }  // namespace pipeline
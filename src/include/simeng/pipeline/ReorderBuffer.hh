@@ -1,12 +1,14 @@
 #pragma once
 
-#include <deque>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 #include "simeng/Instruction.hh"
 #include "simeng/branchpredictors/BranchPredictor.hh"
 #include "simeng/pipeline/LoadStoreQueue.hh"
 #include "simeng/pipeline/RegisterAliasTable.hh"
+#include "simeng/pipeline/StoreSetPredictor.hh"
 
 namespace simeng {
 namespace pipeline {
@@ -43,19 +45,31 @@ struct idCompare {
 class ReorderBuffer {
  public:
   /** Constructs a reorder buffer of maximum size `maxSize`, supplying a
-   * reference to the register alias table. */
+   * reference to the register alias table. Reserved instructions are tagged as
+   * belonging to hardware thread `threadId`, and take sequence and instruction
+   * IDs from a range private to that thread, keeping them unique amongst the
+   * threads sharing a core. */
   ReorderBuffer(
       uint32_t maxSize, RegisterAliasTable& rat, LoadStoreQueue& lsq,
       std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
       std::function<void(uint64_t branchAddress)> sendLoopBoundary,
-      BranchPredictor& predictor, uint16_t loopBufSize,
-      uint16_t loopDetectionThreshold);
+      BranchPredictor& predictor, StoreSetPredictor& storeSetPredictor,
+      uint16_t loopBufSize, uint16_t loopDetectionThreshold,
+      uint16_t threadId = 0);
 
   /** Add the provided instruction to the ROB. */
   void reserve(const std::shared_ptr<Instruction>& insn);
 
+  /** Mark all micro-ops belonging to the macro-op with instruction ID
+   * `insnId` as ready to commit, provided every one of them is waiting to
+   * commit and the final micro-op has been reserved. */
   void commitMicroOps(uint64_t insnId);
 
+  /** Set a function to call with each micro-op as it's committed, including
+   * one raising an exception. */
+  void setRetireHandler(
+      std::function<void(const std::shared_ptr<Instruction>&)> retireHandler);
+
   /** Commit and remove up to `maxCommitSize` instructions. */
   unsigned int commit(uint64_t maxCommitSize);
 
@@ -92,7 +106,27 @@ class ReorderBuffer {
   /** Retrieve the number of retired brancehs. */
   uint64_t getRetiredBranchesCount() const;
 
+  /** Retrieve the number of register-indirect branch mispredictions. */
+  uint64_t getIndirectBranchMispredictedCount() const;
+
+  /** Retrieve the number of retired register-indirect branches. */
+  uint64_t getRetiredIndirectBranchesCount() const;
+
+  /** Retrieve the oldest in-flight instruction. The ROB must not be empty. */
+  const std::shared_ptr<Instruction>& getHead() const;
+
  private:
+  /** Retrieve the instruction `offset` entries behind the head of the ROB. */
+  std::shared_ptr<Instruction>& at(uint32_t offset);
+
+  /** Pop the instruction at the head of the ROB, maintaining the micro-op
+   * group index. */
+  void popFront();
+
+  /** Pop the instruction at the tail of the ROB, maintaining the micro-op
+   * group index. */
+  void popBack();
+
   /** A reference to the register alias table. */
   RegisterAliasTable& rat_;
 
@@ -108,14 +142,33 @@ class ReorderBuffer {
   /** A function to send an instruction at a detected loop boundary. */
   std::function<void(uint64_t branchAddress)> sendLoopBoundary_;
 
+  /** A function to call with each committed micro-op, if set. */
+  std::function<void(const std::shared_ptr<Instruction>&)> retireHandler_;
+
   /** Whether or not a loop has been detected. */
   bool loopDetected_ = false;
 
   /** A reference to the current branch predictor. */
   BranchPredictor& predictor_;
 
-  /** The buffer containing in-flight instructions. */
-  std::deque<std::shared_ptr<Instruction>> buffer_;
+  /** A reference to the memory dependence predictor, trained upon each memory
+   * order violation. */
+  StoreSetPredictor& storeSetPredictor_;
+
+  /** The circular buffer containing in-flight instructions, with a fixed
+   * capacity of `maxSize_` entries. */
+  std::vector<std::shared_ptr<Instruction>> buffer_;
+
+  /** The index of the oldest in-flight instruction within `buffer_`. */
+  uint32_t head_ = 0;
+
+  /** The number of in-flight instructions held in `buffer_`. */
+  uint32_t count_ = 0;
+
+  /** A map of instruction ID to the `buffer_` index holding the oldest
+   * in-flight micro-op of that macro-op. Allows `commitMicroOps` to locate a
+   * macro-op's micro-ops without scanning the ROB. */
+  std::unordered_map<uint64_t, uint32_t> microOpGroups_;
 
   /** Whether the core should be flushed after the most recent commit. */
   bool shouldFlush_ = false;
@@ -139,12 +192,15 @@ class ReorderBuffer {
    * considered a loop. */
   uint16_t loopDetectionThreshold_;
 
+  /** The hardware thread the ROB's instructions belong to. */
+  uint16_t threadId_;
+
   /** The next available sequence ID. */
-  uint64_t seqId_ = 0;
+  uint64_t seqId_;
 
   /** The next available instruction ID. Used to identify in-order groups of
    * micro-operations. */
-  uint64_t insnId_ = 0;
+  uint64_t insnId_;
 
   /** The number of instructions committed. */
   uint64_t instructionsCommitted_ = 0;
@@ -157,6 +213,13 @@ class ReorderBuffer {
 
   /** The number of retired branch instructions */
   uint64_t retiredBranches_ = 0;
+
+  /** The number of register-indirect branch mispredictions that were
+   * observed. */
+  uint64_t indirectBranchMispredicts_ = 0;
+
+  /** The number of retired register-indirect branch instructions. */
+  uint64_t retiredIndirectBranches_ = 0;
 };
 
 }  // namespace pipeline
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "simeng/Instruction.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** A store set memory dependence predictor. Loads and stores which have
+ * previously been involved in a memory order violation are grouped into a
+ * common store set, and later instances of such loads are predicted to depend
+ * on the most recently dispatched store of their set. Contains a Store Set ID
+ * Table (SSIT), indexed by instruction address, and a Last Fetched Store Table
+ * (LFST) holding the youngest in-flight store of each set. */
+class StoreSetPredictor {
+ public:
+  /** Construct a predictor with an SSIT of `ssitSize` entries and an LFST of
+   * `lfstSize` entries. An SSIT size of 0 disables prediction. */
+  StoreSetPredictor(uint32_t ssitSize, uint32_t lfstSize);
+
+  /** Query whether the predictor is enabled. */
+  bool isEnabled() const;
+
+  /** Predict the in-flight store that `load` depends on. Returns a nullptr if
+   * no dependence is predicted. A flushed store is never predicted, and is
+   * removed from the LFST once found; nor is a store of another hardware
+   * thread. */
+  std::shared_ptr<Instruction> predictDependency(
+      const std::shared_ptr<Instruction>& load);
+
+  /** Record `store` as the most recently dispatched store of its store set. */
+  void dispatchStore(const std::shared_ptr<Instruction>& store);
+
+  /** Notify the predictor that `store` has generated its addresses, such that
+   * later loads of its set no longer need to wait on it. */
+  void storeExecuted(const std::shared_ptr<Instruction>& store);
+
+  /** Train the predictor on a memory order violation between `load` and the
+   * older `store` it should have waited for. */
+  void update(const std::shared_ptr<Instruction>& load,
+              const std::shared_ptr<Instruction>& store);
+
+  /** Retrieve the number of loads predicted to depend on an in-flight store. */
+  uint64_t getPredictedDependenciesCount() const;
+
+  /** Retrieve the number of memory order violations trained on. */
+  uint64_t getTrainingsCount() const;
+
+ private:
+  /** Retrieve the SSIT index for the instruction at `address`. */
+  uint32_t getIndex(uint64_t address) const;
+
+  /** Value of an SSIT entry which belongs to no store set. */
+  static constexpr uint32_t invalidSet_ = UINT32_MAX;
+
+  /** The Store Set ID Table, mapping hashed instruction addresses to store set
+   * IDs. */
+  std::vector<uint32_t> ssit_;
+
+  /** The Last Fetched Store Table, holding the youngest dispatched store of
+   * each store set which has yet to generate its addresses. */
+  std::vector<std::shared_ptr<Instruction>> lfst_;
+
+  /** The number of loads predicted to depend on an in-flight store. */
+  uint64_t predictedDependencies_ = 0;
+
+  /** The number of memory order violations trained on. */
+  uint64_t trainings_ = 0;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
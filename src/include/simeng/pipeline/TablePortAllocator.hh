@@ -0,0 +1,139 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "simeng/config/SimInfo.hh"
+#include "simeng/pipeline/PortAllocator.hh"
+
+namespace simeng {
+namespace pipeline {
+
+/** A table-driven port allocator implementation. The allocation policy is
+ * read from the [Port-Allocator][Rules] config option, such that
+ * microarchitecture-specific policies (e.g. that of the A64FX) can be described
+ * without a dedicated allocator class.
+ *
+ * Each rule applies to instructions supporting exactly the rule's set of ports,
+ * and holds an ordered list of cases. The first case whose conditions all hold
+ * on the free entries of the reservation stations supplies a table of
+ * reservation stations, from which the instruction's station is selected by its
+ * dispatch slot within the cycle. The lowest weighted of the instruction's
+ * ports within that station is then allocated. Instructions no rule applies to
+ * are allocated the lowest weighted of their ports, as for the
+ * BalancedPortAllocator.
+ *
+ * As the free entries are only sampled once per cycle, each rule's table is
+ * resolved on tick, leaving a single lookup to each allocation. */
+class TablePortAllocator : public PortAllocator {
+ public:
+  /** Construct a table-driven port allocator, providing a port arrangement
+   * specification and the config holding the reservation station layout and
+   * allocation rules. */
+  TablePortAllocator(const std::vector<std::vector<uint16_t>>& portArrangement,
+                     ryml::ConstNodeRef config = config::SimInfo::getConfig());
+
+  /** Allocate a port for the specified instruction group using the resolved
+   * table of the applicable rule. Returns the allocated port, and increases the
+   * weight of the port. */
+  uint16_t allocate(const std::vector<uint16_t>& ports) override;
+
+  /** Decrease the weight for the specified port. */
+  void issued(uint16_t port) override;
+
+  /** Decrease the weight for the specified port. */
+  void deallocate(uint16_t port) override;
+
+  /** Set function from DispatchIssueUnit to retrieve reservation
+   * station sizes during execution. */
+  void setRSSizeGetter(
+      std::function<void(std::vector<uint32_t>&)> rsSizes) override;
+
+  /** Sample the free entries of each reservation station and resolve the table
+   * of each rule for the coming cycle. */
+  void tick() override;
+
+ private:
+  /** A condition on the free entries of the reservation stations. */
+  struct condition {
+    /** The stations whose free entries are summed. */
+    std::vector<uint16_t> stations;
+    /** The stations whose free entries are subtracted from the sum. */
+    std::vector<uint16_t> minus;
+    /** The inclusive lower bound of the resulting value. */
+    int32_t atLeast;
+    /** The inclusive upper bound of the resulting value. */
+    int32_t atMost;
+    /** The stations amongst which the first with the most free entries must be
+     * one of `in`. Unchecked if empty. */
+    std::vector<uint16_t> mostFree;
+    /** The stations permitted to have the most free entries. */
+    std::vector<uint16_t> in;
+  };
+
+  /** An entry of a case's table, selecting the `rank`th most free of the
+   * listed stations, ties favouring the earlier listed. */
+  struct tableEntry {
+    /** The stations to select from. */
+    std::vector<uint16_t> stations;
+    /** The position of the selected station when ordered by free entries. */
+    uint16_t rank;
+  };
+
+  /** A case of a rule, whose table applies when all its conditions hold. */
+  struct ruleCase {
+    /** The conditions which must all hold. */
+    std::vector<condition> conditions;
+    /** The table of stations, indexed by dispatch slot. */
+    std::vector<tableEntry> table;
+  };
+
+  /** An allocation rule for instructions supporting a set of ports. */
+  struct rule {
+    /** The rule's cases, in order of precedence. */
+    std::vector<ruleCase> cases;
+    /** The instruction's ports, indexed by reservation station. */
+    std::vector<std::vector<uint16_t>> stationPorts;
+    /** The stations resolved from the first applicable case on the last tick.
+     */
+    std::vector<uint16_t> resolved;
+  };
+
+  /** Query whether a condition holds on the current free entries. */
+  bool holds(const condition& cond) const;
+
+  /** Retrieve the station selected by a table entry on the current free
+   * entries. */
+  uint16_t select(const tableEntry& entry);
+
+  /** Retrieve the lowest weighted port of those supplied. */
+  uint16_t lowestWeight(const std::vector<uint16_t>& ports) const;
+
+  /** The allocation rules. */
+  std::vector<rule> rules_;
+
+  /** A mapping from a set of ports, as a bitmask of port indices, to the rule
+   * applying to instructions supporting those ports. */
+  std::unordered_map<uint64_t, size_t> ruleLookup_;
+
+  /** The port weighting map. Each element corresponds to a port, and contains a
+   * weighting representing the number of in-flight instructions allocated to
+   * that port. */
+  std::vector<uint16_t> weights_;
+
+  /** The index of the instruction within the dispatch unit's input buffer, as
+   * approximated by the number of allocations made this cycle. */
+  uint16_t dispatchSlot_ = 0;
+
+  /** Get the current sizes an capacity of the reservation stations */
+  std::function<void(std::vector<uint32_t>&)> rsSizes_;
+
+  /** Vector of free entries across all reservation stations. */
+  std::vector<uint32_t> freeEntries_;
+
+  /** Scratch space used to rank stations by their free entries. */
+  std::vector<uint16_t> ranked_;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
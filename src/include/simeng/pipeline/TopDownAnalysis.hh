@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace simeng {
+namespace pipeline {
+
+/** The causes to which the issue slots left unfilled in a cycle are
+ * attributed. */
+enum class SlotStall : uint8_t {
+  /** The front-end failed to supply instructions to fill the slots. */
+  Frontend,
+  /** The front-end is refetching after a branch misprediction. */
+  BranchMispredict,
+  /** The pipeline is recovering from an exception or memory order violation.
+   */
+  MachineClear,
+  /** The back-end couldn't accept instructions, for want of a core resource.
+   */
+  CoreBound,
+  /** The back-end couldn't accept instructions while awaiting memory. */
+  MemoryBound
+};
+
+/** A node of the top-down breakdown: the issue slots of a category, and those
+ * of its subcategories. */
+struct TopDownNode {
+  /** The name of the category. */
+  std::string name;
+
+  /** The number of issue slots attributed to the category. */
+  uint64_t slots = 0;
+
+  /** The subcategories, whose slots sum to those of the category. */
+  std::vector<TopDownNode> children;
+};
+
+/** A top-down analysis of a core's issue slots, as used by hardware
+ * performance monitoring units.
+ *
+ * Each cycle provides `width` slots in which the front-end may deliver a
+ * micro-op to the back-end. A slot is either filled by a micro-op which goes
+ * on to retire (Retiring) or to be squashed (Bad Speculation), or left unfilled
+ * while the pipeline recovers from a flush (Bad Speculation), while the
+ * back-end can't accept micro-ops (Backend Bound), or otherwise (Frontend
+ * Bound). Every slot belongs to exactly one category, so the categories sum to
+ * the slots of every cycle recorded once all micro-ops delivered have retired
+ * or been squashed. */
+class TopDownAnalysis {
+ public:
+  /** Construct an analysis of a core delivering up to `width` micro-ops to the
+   * back-end each cycle. */
+  explicit TopDownAnalysis(uint16_t width);
+
+  /** Record a cycle in which `delivered` micro-ops were delivered to the
+   * back-end, attributing the slots left unfilled to `stall`. Unfilled slots
+   * of the front-end are split by whether any micro-op was delivered. */
+  void addCycle(uint16_t delivered, SlotStall stall);
+
+  /** Record the retirement of `uops` micro-ops. */
+  void retire(uint64_t uops);
+
+  /** Record `uops` micro-ops squashed by a flush due to `cause`, which is one
+   * of the Bad Speculation causes. */
+  void squash(uint64_t uops, SlotStall cause);
+
+  /** Retrieve the number of cycles recorded. */
+  uint64_t getCycles() const;
+
+  /** Retrieve the hierarchical breakdown of the slots: the Retiring, Frontend
+   * Bound, Bad Speculation and Backend Bound categories, each split into
+   * subcategories. */
+  std::vector<TopDownNode> getBreakdown() const;
+
+  /** Generate a map of statistics to report, holding each category's share of
+   * the slots keyed by its path in the hierarchy. */
+  std::map<std::string, std::string> getStats() const;
+
+  /** Write the breakdown to `out` as a YAML document, or as a JSON object if
+   * `json` is set. Each category reports its slots and its fraction of all
+   * slots. */
+  void write(std::ostream& out, bool json) const;
+
+ private:
+  /** Retrieve the number of slots of every category. */
+  uint64_t getTotalSlots() const;
+
+  /** The number of micro-ops delivered to the back-end each cycle. */
+  uint16_t width_;
+
+  /** The number of cycles recorded. */
+  uint64_t cycles_ = 0;
+
+  /** The number of micro-ops retired. */
+  uint64_t retired_ = 0;
+
+  /** The number of micro-ops squashed by branch mispredictions. */
+  uint64_t mispredictSquashed_ = 0;
+
+  /** The number of micro-ops squashed by machine clears. */
+  uint64_t clearSquashed_ = 0;
+
+  /** The number of unfilled slots, by cause. */
+  uint64_t frontendLatencySlots_ = 0;
+  uint64_t frontendBandwidthSlots_ = 0;
+  uint64_t mispredictSlots_ = 0;
+  uint64_t clearSlots_ = 0;
+  uint64_t coreBoundSlots_ = 0;
+  uint64_t memoryBoundSlots_ = 0;
+};
+
+}  // namespace pipeline
+}  // namespace simeng
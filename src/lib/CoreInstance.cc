@@ -6,16 +6,20 @@ CoreInstance::CoreInstance(std::string executablePath,
                            std::vector<std::string> executableArgs,
                            ryml::ConstNodeRef config)
     : config_(config),
+      fileSystem_(makeFileSystem()),
       kernel_(kernel::Linux(
-          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>())) {
+          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+          fileSystem_)) {
   generateCoreModel(executablePath, executableArgs);
 }
 
 CoreInstance::CoreInstance(uint8_t* assembledSource, size_t sourceSize,
                            ryml::ConstNodeRef config)
     : config_(config),
+      fileSystem_(makeFileSystem()),
       kernel_(kernel::Linux(
-          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>())),
+          config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+          fileSystem_)),
       source_(assembledSource),
       sourceSize_(sourceSize),
       assembledSource_(true) {
@@ -71,6 +75,8 @@ void CoreInstance::generateCoreModel(std::string executablePath,
     createL1InstructionMemory(iType);
   }
 
+  createHardwareThreads(executablePath, executableArgs, iType, dType);
+
   // Create the core if neither memory interfaces are externally constructed
   if (!(setDataMemory_ || setInstructionMemory_)) createCore();
 
@@ -79,26 +85,40 @@ void CoreInstance::generateCoreModel(std::string executablePath,
 
 void CoreInstance::createProcess(std::string executablePath,
                                  std::vector<std::string> executableArgs) {
+  process_ = makeProcess(executablePath, executableArgs);
+
+  // Create the process memory space from the generated process image
+  createProcessMemory();
+
+  // Create the OS kernel with the process
+  kernel_.createProcess(*process_.get());
+
+  return;
+}
+
+std::unique_ptr<kernel::LinuxProcess> CoreInstance::makeProcess(
+    std::string executablePath, std::vector<std::string> executableArgs) const {
+  std::unique_ptr<kernel::LinuxProcess> process;
   if (executablePath.length() > 0) {
     // Concatenate the command line arguments into a single vector and create
     // the process image
     std::vector<std::string> commandLine = {executablePath};
     commandLine.insert(commandLine.end(), executableArgs.begin(),
                        executableArgs.end());
-    process_ = std::make_unique<kernel::LinuxProcess>(commandLine, config_);
+    process = std::make_unique<kernel::LinuxProcess>(commandLine, config_);
 
     // Raise error if created process is not valid
-    if (!process_->isValid()) {
+    if (!process->isValid()) {
       std::cerr << "[SimEng:CoreInstance] Could not read/parse "
                 << commandLine[0] << std::endl;
       exit(1);
     }
   } else if (assembledSource_) {
     // Create a process image from the source code assembled by LLVM.
-    process_ = std::make_unique<kernel::LinuxProcess>(
+    process = std::make_unique<kernel::LinuxProcess>(
         span<const uint8_t>(source_, sourceSize_), config_);
     // Raise error if created process is not valid
-    if (!process_->isValid()) {
+    if (!process->isValid()) {
       std::cerr << "[SimEng:CoreInstance] Could not create process based on "
                    "source assembled by LLVM"
                 << std::endl;
@@ -113,13 +133,7 @@ void CoreInstance::createProcess(std::string executablePath,
     exit(1);
   }
 
-  // Create the process memory space from the generated process image
-  createProcessMemory();
-
-  // Create the OS kernel with the process
-  kernel_.createProcess(*process_.get());
-
-  return;
+  return process;
 }
 
 void CoreInstance::createProcessMemory() {
@@ -130,18 +144,25 @@ void CoreInstance::createProcessMemory() {
   return;
 }
 
-void CoreInstance::createL1InstructionMemory(
-    const memory::MemInterfaceType type) {
-  // Create a L1I cache instance based on type supplied
+std::shared_ptr<memory::MemoryInterface> CoreInstance::makeL1Memory(
+    const memory::MemInterfaceType type, char* memory, uint64_t size) const {
   if (type == memory::MemInterfaceType::Flat) {
-    instructionMemory_ = std::make_shared<memory::FlatMemoryInterface>(
-        processMemory_.get(), processMemorySize_);
+    return std::make_shared<memory::FlatMemoryInterface>(memory, size);
   } else if (type == memory::MemInterfaceType::Fixed) {
     uint16_t accessLat =
         config_["LSQ-L1-Interface"]["Access-Latency"].as<uint16_t>();
-    instructionMemory_ = std::make_shared<memory::FixedLatencyMemoryInterface>(
-        processMemory_.get(), processMemorySize_, accessLat);
-  } else {
+    return std::make_shared<memory::FixedLatencyMemoryInterface>(memory, size,
+                                                                 accessLat);
+  }
+  return nullptr;
+}
+
+void CoreInstance::createL1InstructionMemory(
+    const memory::MemInterfaceType type) {
+  // Create a L1I cache instance based on type supplied
+  instructionMemory_ =
+      makeL1Memory(type, processMemory_.get(), processMemorySize_);
+  if (instructionMemory_ == nullptr) {
     std::cerr
         << "[SimEng:CoreInstance] Unsupported memory interface type used in "
            "createL1InstructionMemory()."
@@ -164,15 +185,8 @@ void CoreInstance::setL1InstructionMemory(
 
 void CoreInstance::createL1DataMemory(const memory::MemInterfaceType type) {
   // Create a L1D cache instance based on type supplied
-  if (type == memory::MemInterfaceType::Flat) {
-    dataMemory_ = std::make_shared<memory::FlatMemoryInterface>(
-        processMemory_.get(), processMemorySize_);
-  } else if (type == memory::MemInterfaceType::Fixed) {
-    uint16_t accessLat =
-        config_["LSQ-L1-Interface"]["Access-Latency"].as<uint16_t>();
-    dataMemory_ = std::make_shared<memory::FixedLatencyMemoryInterface>(
-        processMemory_.get(), processMemorySize_, accessLat);
-  } else {
+  dataMemory_ = makeL1Memory(type, processMemory_.get(), processMemorySize_);
+  if (dataMemory_ == nullptr) {
     std::cerr << "[SimEng:CoreInstance] Unsupported memory interface type used "
                  "in createL1DataMemory()."
               << std::endl;
@@ -192,6 +206,62 @@ void CoreInstance::setL1DataMemory(
   return;
 }
 
+void CoreInstance::createHardwareThreads(
+    std::string executablePath, std::vector<std::string> executableArgs,
+    const memory::MemInterfaceType iType,
+    const memory::MemInterfaceType dType) {
+  // The Hardware-Threads section is optional, running a single thread if
+  // omitted
+  if (!config_["Hardware-Threads"].is_map() ||
+      !config_["Hardware-Threads"].has_child(ryml::to_csubstr("Count"))) {
+    return;
+  }
+  uint16_t threadCount = config_["Hardware-Threads"]["Count"].as<uint16_t>();
+  for (uint16_t id = 1; id < threadCount; id++) {
+    HardwareThread thread;
+    thread.kernel = std::make_unique<kernel::Linux>(
+        config_["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+        fileSystem_);
+    thread.process = makeProcess(executablePath, executableArgs);
+    thread.processMemory = thread.process->getProcessImage();
+    thread.kernel->createProcess(*thread.process);
+
+    // Each thread's memory interfaces access its own process memory. External
+    // interfaces are rejected by the config validation when several hardware
+    // threads are used
+    uint64_t size = thread.process->getProcessImageSize();
+    thread.instructionMemory =
+        makeL1Memory(iType, thread.processMemory.get(), size);
+    thread.dataMemory = makeL1Memory(dType, thread.processMemory.get(), size);
+    hardwareThreads_.push_back(std::move(thread));
+  }
+
+  return;
+}
+
+std::unique_ptr<arch::Architecture> CoreInstance::makeArchitecture(
+    kernel::Linux& kernel) const {
+  if (config::SimInfo::getISA() == config::ISA::RV64) {
+    return std::make_unique<arch::riscv::Architecture>(kernel);
+  } else if (config::SimInfo::getISA() == config::ISA::AArch64) {
+    return std::make_unique<arch::aarch64::Architecture>(kernel);
+  }
+  return nullptr;
+}
+
+std::unique_ptr<BranchPredictor> CoreInstance::makePredictor() const {
+  std::string predictorType =
+      config_["Branch-Predictor"]["Type"].as<std::string>();
+  if (predictorType == "Generic") {
+    return std::make_unique<GenericPredictor>();
+  } else if (predictorType == "Perceptron") {
+    return std::make_unique<PerceptronPredictor>();
+  } else if (predictorType == "TAGE") {
+    return std::make_unique<TagePredictor>();
+  }
+  return nullptr;
+}
+
 void CoreInstance::createCore() {
   // If memory interfaces must be manually set, ensure they have been
   if (setDataMemory_ && (dataMemory_ == nullptr)) {
@@ -210,18 +280,11 @@ void CoreInstance::createCore() {
   }
 
   // Create the architecture, with knowledge of the OS
-  if (config::SimInfo::getISA() == config::ISA::RV64) {
-    arch_ = std::make_unique<arch::riscv::Architecture>(kernel_);
-  } else if (config::SimInfo::getISA() == config::ISA::AArch64) {
-    arch_ = std::make_unique<arch::aarch64::Architecture>(kernel_);
-  }
-
-  std::string predictorType =
-      config_["Branch-Predictor"]["Type"].as<std::string>();
-  if (predictorType == "Generic") {
-    predictor_ = std::make_unique<GenericPredictor>();
-  } else if (predictorType == "Perceptron") {
-    predictor_ = std::make_unique<PerceptronPredictor>();
+  arch_ = makeArchitecture(kernel_);
+  predictor_ = makePredictor();
+  for (auto& thread : hardwareThreads_) {
+    thread.arch = makeArchitecture(*thread.kernel);
+    thread.predictor = makePredictor();
   }
 
   // Extract the port arrangement from the config file
@@ -236,8 +299,15 @@ void CoreInstance::createCore() {
       portArrangement[i].push_back(grp);
     }
   }
-  portAllocator_ =
-      std::make_unique<pipeline::BalancedPortAllocator>(portArrangement);
+  std::string portAllocatorType =
+      config_["Port-Allocator"]["Type"].as<std::string>();
+  if (portAllocatorType == "Table") {
+    portAllocator_ =
+        std::make_unique<pipeline::TablePortAllocator>(portArrangement);
+  } else {
+    portAllocator_ =
+        std::make_unique<pipeline::BalancedPortAllocator>(portArrangement);
+  }
 
   // Construct the core object based on the defined simulation mode
   uint64_t entryPoint = process_->getEntryPoint();
@@ -252,27 +322,44 @@ void CoreInstance::createCore() {
         *arch_, *predictor_);
   } else if (config::SimInfo::getSimMode() ==
              config::SimulationMode::Outoforder) {
-    core_ = std::make_shared<models::outoforder::Core>(
-        *instructionMemory_, *dataMemory_, processMemorySize_, entryPoint,
-        *arch_, *predictor_, *portAllocator_, config_);
+    std::vector<models::outoforder::Core::ThreadContext> threads = {
+        {*instructionMemory_, *dataMemory_, processMemorySize_, entryPoint,
+         *arch_, *predictor_}};
+    for (auto& thread : hardwareThreads_) {
+      threads.push_back({*thread.instructionMemory, *thread.dataMemory,
+                         thread.process->getProcessImageSize(),
+                         thread.process->getEntryPoint(), *thread.arch,
+                         *thread.predictor});
+    }
+    auto core = std::make_shared<models::outoforder::Core>(
+        threads, *portAllocator_, config_);
+    // The hardware threads all run the same executable, so share its symbols
+    core->setProfileSymbols(process_->getSymbols());
+    core_ = core;
   }
 
-  createSpecialFileDirectory();
-
   return;
 }
 
-void CoreInstance::createSpecialFileDirectory() {
-  // Create the Special Files directory if indicated to do so in Config
-  if (config::SimInfo::getGenSpecFiles()) {
-    SpecialFileDirGen SFdir = SpecialFileDirGen();
-    // Remove any current special files dir
-    SFdir.RemoveExistingSFDir();
-    // Create new special files dir
-    SFdir.GenerateSFDir();
+std::shared_ptr<kernel::VirtualFileSystem> CoreInstance::makeFileSystem()
+    const {
+  auto fileSystem = std::make_shared<kernel::VirtualFileSystem>();
+  // Generate the special files in memory if indicated to do so in Config,
+  // rather than writing them to the special files directory
+  if (config_["CPU-Info"]["Generate-Special-Dir"].as<bool>()) {
+    SpecialFileDirGen(config_).GenerateSFDir(*fileSystem);
   }
 
-  return;
+  // Snapshot the input overlay directory, such that its files are read from
+  // memory during the simulation
+  std::string overlayDir =
+      config_["Process-Image"]["Input-Overlay-Dir"].as<std::string>();
+  if (!overlayDir.empty() && !fileSystem->addHostDirectory(overlayDir)) {
+    std::cerr << "[SimEng:CoreInstance] Could not read input overlay directory "
+              << overlayDir << std::endl;
+    exit(1);
+  }
+  return fileSystem;
 }
 
 std::shared_ptr<Core> CoreInstance::getCore() const {
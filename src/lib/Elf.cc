@@ -1,5 +1,6 @@
 #include "simeng/Elf.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -82,6 +83,14 @@ Elf::Elf(std::string path, char** imagePointer) {
   uint64_t e_phoff = 0;
   file.read(reinterpret_cast<char*>(&e_phoff), sizeof(e_phoff));
 
+  /**
+   * The following 64-bit value represents the offset of the section header
+   * table in the ELF file, or zero if it has none. In `elf64_hdr` this value
+   * maps to the member `Elf64_Off e_shoff`.
+   */
+  uint64_t e_shoff = 0;
+  file.read(reinterpret_cast<char*>(&e_shoff), sizeof(e_shoff));
+
   /**
    * Starting from the 54th byte of the ELF Header a 16-bit value indicates the
    * size in bytes of one entry in the file's program header table; all entries
@@ -98,6 +107,15 @@ Elf::Elf(std::string path, char** imagePointer) {
    */
   file.read(reinterpret_cast<char*>(&e_phnum_), sizeof(e_phnum_));
 
+  /** The following two 16-bit values represent the size of a section header
+   * table entry and the number of entries. In the `elf64_hdr` struct these
+   * values map to `Elf64_Half e_shentsize` and `Elf64_Half e_shnum`.
+   */
+  uint16_t e_shentsize = 0;
+  uint16_t e_shnum = 0;
+  file.read(reinterpret_cast<char*>(&e_shentsize), sizeof(e_shentsize));
+  file.read(reinterpret_cast<char*>(&e_shnum), sizeof(e_shnum));
+
   // Resize the header to equal the number of header entries.
   pheaders_.resize(e_phnum_);
   processImageSize_ = 0;
@@ -184,10 +202,105 @@ Elf::Elf(std::string path, char** imagePointer) {
     }
   }
 
+  readSymbols(file, e_shoff, e_shentsize, e_shnum);
+
   file.close();
   return;
 }
 
+void Elf::readSymbols(std::ifstream& file, uint64_t e_shoff,
+                      uint16_t e_shentsize, uint16_t e_shnum) {
+  /**
+   * Each entry of the section header table is defined by the struct:
+   * typedef struct {
+   *    uint32_t   sh_name;
+   *    uint32_t   sh_type;
+   *    uint64_t   sh_flags;
+   *    Elf64_Addr sh_addr;
+   *    Elf64_Off  sh_offset;
+   *    uint64_t   sh_size;
+   *    uint32_t   sh_link;
+   *    uint32_t   sh_info;
+   *    uint64_t   sh_addralign;
+   *    uint64_t   sh_entsize;
+   * } Elf64_Shdr;
+   *
+   * The symbol table is held by the section with an `sh_type` of SHT_SYMTAB=2,
+   * whose `sh_link` member holds the index of the section containing the
+   * symbol names.
+   */
+  const uint32_t SHT_SYMTAB = 2;
+  const uint64_t symbolEntrySize = 24;
+  if (e_shoff == 0) return;
+  file.clear();
+
+  for (size_t i = 0; i < e_shnum; i++) {
+    uint32_t sh_type = 0;
+    file.seekg(e_shoff + (i * e_shentsize) + 0x4);
+    file.read(reinterpret_cast<char*>(&sh_type), sizeof(sh_type));
+    if (!file || sh_type != SHT_SYMTAB) continue;
+
+    uint64_t sh_offset = 0;
+    uint64_t sh_size = 0;
+    uint32_t sh_link = 0;
+    file.seekg(e_shoff + (i * e_shentsize) + 0x18);
+    file.read(reinterpret_cast<char*>(&sh_offset), sizeof(sh_offset));
+    file.read(reinterpret_cast<char*>(&sh_size), sizeof(sh_size));
+    file.read(reinterpret_cast<char*>(&sh_link), sizeof(sh_link));
+    if (sh_link >= e_shnum) return;
+
+    // Read the whole string table holding the symbol names
+    uint64_t strtabOffset = 0;
+    uint64_t strtabSize = 0;
+    file.seekg(e_shoff + (sh_link * e_shentsize) + 0x18);
+    file.read(reinterpret_cast<char*>(&strtabOffset), sizeof(strtabOffset));
+    file.read(reinterpret_cast<char*>(&strtabSize), sizeof(strtabSize));
+    std::string strtab(strtabSize, '\0');
+    file.seekg(strtabOffset);
+    file.read(&strtab[0], strtabSize);
+    if (!file) return;
+
+    /**
+     * Each symbol is defined by the struct:
+     * typedef struct {
+     *    uint32_t      st_name;
+     *    unsigned char st_info;
+     *    unsigned char st_other;
+     *    uint16_t      st_shndx;
+     *    Elf64_Addr    st_value;
+     *    uint64_t      st_size;
+     * } Elf64_Sym;
+     *
+     * The lower four bits of `st_info` hold the symbol's type, of which only
+     * functions (STT_FUNC=2) are of interest.
+     */
+    const uint8_t STT_FUNC = 2;
+    file.seekg(sh_offset);
+    for (uint64_t j = 0; j < sh_size / symbolEntrySize; j++) {
+      char entry[symbolEntrySize];
+      file.read(entry, symbolEntrySize);
+      if (!file) break;
+      uint32_t st_name;
+      uint64_t st_value;
+      uint64_t st_size;
+      std::memcpy(&st_name, entry, sizeof(st_name));
+      std::memcpy(&st_value, entry + 0x8, sizeof(st_value));
+      std::memcpy(&st_size, entry + 0x10, sizeof(st_size));
+      if ((entry[4] & 0xf) != STT_FUNC || st_value == 0 ||
+          st_name >= strtab.size()) {
+        continue;
+      }
+      symbols_.push_back({strtab.c_str() + st_name, st_value, st_size});
+    }
+    break;
+  }
+
+  std::sort(symbols_.begin(), symbols_.end(),
+            [](const ElfSymbol& a, const ElfSymbol& b) {
+              return a.address < b.address;
+            });
+}
+
 Elf::~Elf() {}
 
 uint64_t Elf::getProcessImageSize() const { return processImageSize_; }
@@ -202,4 +315,6 @@ uint64_t Elf::getPhdrEntrySize() const { return e_phentsize_; }
 
 uint64_t Elf::getNumPhdr() const { return e_phnum_; }
 
+const std::vector<ElfSymbol>& Elf::getSymbols() const { return symbols_; }
+
 }  // namespace simeng
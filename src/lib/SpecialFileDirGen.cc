@@ -81,68 +81,85 @@ void SpecialFileDirGen::RemoveExistingSFDir() {
 }
 
 void SpecialFileDirGen::GenerateSFDir() {
-  // Create root special files directory
+  // Generate the files in memory, then write them out beneath the root special
+  // files directory. Directories precede the files they hold
+  kernel::VirtualFileSystem fileSystem;
+  GenerateSFDir(fileSystem);
   systemWrapper("mkdir -p " + specialFilesDir_);
+  for (const auto& [path, file] : fileSystem.getFiles()) {
+    if (file.isDirectory) {
+      systemWrapper("mkdir -p " + specialFilesDir_ + path);
+    } else {
+      // Parent directories not held in full must still be created
+      std::string parent = path.substr(0, path.rfind('/'));
+      if (fileSystem.find(parent) == nullptr) {
+        systemWrapper("mkdir -p " + specialFilesDir_ + parent);
+      }
+      std::ofstream hostFile(specialFilesDir_ + path);
+      hostFile << *file.contents;
+      hostFile.close();
+    }
+  }
+
+  return;
+}
+
+void SpecialFileDirGen::GenerateSFDir(
+    kernel::VirtualFileSystem& fileSystem) const {
   // Define frequently accessed root directories in special file tree
-  const std::string proc_dir = specialFilesDir_ + "/proc/";
-  const std::string online_dir = specialFilesDir_ + "/sys/devices/system/cpu/";
-  const std::string cpu_base_dir =
-      specialFilesDir_ + "/sys/devices/system/cpu/cpu";
+  const std::string proc_dir = "/proc/";
+  const std::string online_dir = "/sys/devices/system/cpu/";
+  const std::string cpu_base_dir = "/sys/devices/system/cpu/cpu";
 
-  systemWrapper("mkdir " + proc_dir);
-  systemWrapper("mkdir " + specialFilesDir_ + "/sys/");
-  systemWrapper("mkdir " + specialFilesDir_ + "/sys/devices/");
-  systemWrapper("mkdir " + specialFilesDir_ + "/sys/devices/system/");
-  systemWrapper("mkdir " + online_dir);
+  // Only the CPU directory is held in full, such that the rest of '/proc' and
+  // '/sys' are still served by the host
+  fileSystem.addDirectory(online_dir);
 
   // Create '/proc/cpuinfo' file.
-  std::ofstream cpuinfo_File(proc_dir + "cpuinfo");
+  std::string cpuinfo_File;
   for (uint64_t i = 0; i < coreCount_ * socketCount_ * smt_; i++) {
-    cpuinfo_File << "processor\t: " + std::to_string(i) + "\nBogoMIPS\t: " +
-                        std::to_string(bogoMIPS_).erase(
-                            std::to_string(bogoMIPS_).length() - 4) +
-                        "\nFeatures\t: " + features_ +
-                        "\nCPU implementer\t: " + cpuImplementer_ +
-                        "\nCPU architecture: " +
-                        std::to_string(cpuArchitecture_) +
-                        "\nCPU variant\t: " + cpuVariant_ +
-                        "\nCPU part\t: " + cpuPart_ +
-                        "\nCPU revision\t: " + std::to_string(cpuRevision_) +
-                        "\n\n";
+    cpuinfo_File += "processor\t: " + std::to_string(i) + "\nBogoMIPS\t: " +
+                    std::to_string(bogoMIPS_).erase(
+                        std::to_string(bogoMIPS_).length() - 4) +
+                    "\nFeatures\t: " + features_ + "\nCPU implementer\t: " +
+                    cpuImplementer_ + "\nCPU architecture: " +
+                    std::to_string(cpuArchitecture_) + "\nCPU variant\t: " +
+                    cpuVariant_ + "\nCPU part\t: " + cpuPart_ +
+                    "\nCPU revision\t: " + std::to_string(cpuRevision_) +
+                    "\n\n";
   }
-  cpuinfo_File.close();
+  fileSystem.addFile(proc_dir + "cpuinfo", cpuinfo_File);
 
   // Create '/proc/stat' file.
-  std::ofstream stat_File(proc_dir + "stat");
-  stat_File << "cpu  0 0 0 0 0 0 0 0 0 0\n";
+  std::string stat_File = "cpu  0 0 0 0 0 0 0 0 0 0\n";
   for (uint64_t i = 0; i < coreCount_ * socketCount_ * smt_; i++) {
-    stat_File << "cpu" + std::to_string(i) + " 0 0 0 0 0 0 0 0 0 0\n";
+    stat_File += "cpu" + std::to_string(i) + " 0 0 0 0 0 0 0 0 0 0\n";
   }
-  stat_File << "intr 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
-               "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
-               "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
-               "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
-               "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
-               "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
-               "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
-  stat_File << "ctxt 0\n";
-  stat_File << "btime 0\n";
-  stat_File << "processes 0\n";
-  stat_File << "procs_running 1\n";
-  stat_File << "procs_blocked 0\n";
-  stat_File << "softirq 0 0 0 0 0 0 0 0 0 0 0\n";
-  stat_File.close();
+  stat_File +=
+      "intr 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+      "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+  stat_File += "ctxt 0\n";
+  stat_File += "btime 0\n";
+  stat_File += "processes 0\n";
+  stat_File += "procs_running 1\n";
+  stat_File += "procs_blocked 0\n";
+  stat_File += "softirq 0 0 0 0 0 0 0 0 0 0 0\n";
+  fileSystem.addFile(proc_dir + "stat", stat_File);
 
   // Create '/sys/devices/system/cpu/online' file.
-  std::ofstream online_File(online_dir + "online");
-  online_File << "0-" + std::to_string(coreCount_ * socketCount_ * smt_ - 1) +
-                     "\n";
-  online_File.close();
+  fileSystem.addFile(
+      online_dir + "online",
+      "0-" + std::to_string(coreCount_ * socketCount_ * smt_ - 1) + "\n");
 
   // Create sub directory for each CPU core and required files.
   for (uint64_t i = 0; i < coreCount_ * socketCount_ * smt_; i++) {
-    systemWrapper("mkdir " + cpu_base_dir + std::to_string(i) + "/");
-    systemWrapper("mkdir " + cpu_base_dir + std::to_string(i) + "/topology/");
+    fileSystem.addDirectory(cpu_base_dir + std::to_string(i) + "/");
+    fileSystem.addDirectory(cpu_base_dir + std::to_string(i) + "/topology/");
   }
 
   // Create '/sys/devices/system/cpu/cpuX/topology/{core_id,
@@ -155,22 +172,19 @@ void SpecialFileDirGen::GenerateSFDir() {
         current_package_id += 1;
       }
       for (uint64_t t = 0; t < smt_; t++) {
-        // core_id File generation
-        std::ofstream core_id_file(
+        const std::string topology_dir =
             cpu_base_dir +
             std::to_string(c + (t * coreCount_) + (s * smt_ * coreCount_)) +
-            "/topology/core_id");
-        core_id_file << (c % cores_per_package) +
-                            (s * coreCount_ * socketCount_ * smt_);
-        core_id_file.close();
+            "/topology/";
+        // core_id File generation
+        fileSystem.addFile(
+            topology_dir + "core_id",
+            std::to_string((c % cores_per_package) +
+                           (s * coreCount_ * socketCount_ * smt_)));
 
         // physical_package_id File generation
-        std::ofstream phys_package_id_file(
-            cpu_base_dir +
-            std::to_string(c + (t * coreCount_) + (s * smt_ * coreCount_)) +
-            "/topology/physical_package_id");
-        phys_package_id_file << current_package_id;
-        phys_package_id_file.close();
+        fileSystem.addFile(topology_dir + "physical_package_id",
+                           std::to_string(current_package_id));
       }
     }
     current_package_id += 1;
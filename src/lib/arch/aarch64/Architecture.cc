@@ -89,6 +89,28 @@ Architecture::Architecture(kernel::Linux& kernel, ryml::ConstNodeRef config)
     }
   }
 
+  // Extract any macro-op fusion rules. The group numbers of each rule already
+  // include those of the groups which inherit from them
+  if (config.has_child(ryml::to_csubstr("Macro-Op-Fusion"))) {
+    for (size_t i = 0; i < config["Macro-Op-Fusion"].num_children(); i++) {
+      ryml::ConstNodeRef rule_node = config["Macro-Op-Fusion"][i];
+      auto readSet = [&rule_node](const char* key) {
+        std::unordered_set<uint16_t> values;
+        ryml::ConstNodeRef values_node = rule_node[ryml::to_csubstr(key)];
+        for (size_t j = 0; j < values_node.num_children(); j++) {
+          values.insert(values_node[j].as<uint16_t>());
+        }
+        return values;
+      };
+      fusionRules_.push_back({readSet("First-Instruction-Group-Nums"),
+                              readSet("First-Instruction-Opcodes"),
+                              readSet("Second-Instruction-Group-Nums"),
+                              readSet("Second-Instruction-Opcodes"),
+                              rule_node["Shared-Destination"].as<bool>(),
+                              rule_node["Execution-Latency"].as<uint16_t>()});
+    }
+  }
+
   // ports entries in the groupExecutionInfo_ entries only apply for models
   // using the outoforder core archetype
   if (config::SimInfo::getSimMode() == config::SimulationMode::Outoforder) {
@@ -241,8 +263,8 @@ uint8_t Architecture::getMaxInstructionSize() const { return 4; }
 
 uint8_t Architecture::getMinInstructionSize() const { return 4; }
 
-void Architecture::updateSystemTimerRegisters(RegisterFileSet* regFile,
-                                              const uint64_t iterations) const {
+void Architecture::updateSystemTimerRegisters(
+    ArchitecturalRegisterFileSet* regFile, const uint64_t iterations) const {
   // Update the Processor Cycle Counter to total cycles completed.
   regFile->set(PCCreg_, iterations);
   // Update Virtual Counter Timer at correct frequency.
@@ -267,6 +289,83 @@ ExecutionInfo Architecture::getExecutionInfo(const Instruction& insn) const {
   return exeInfo;
 }
 
+bool Architecture::getFusionInfo(const simeng::Instruction& first,
+                                 const simeng::Instruction& second,
+                                 ExecutionInfo& info) const {
+  const auto& firstInsn = static_cast<const Instruction&>(first);
+  const auto& secondInsn = static_cast<const Instruction&>(second);
+  if (!isFusionIdiom(firstInsn, secondInsn)) return false;
+  for (const auto& rule : fusionRules_) {
+    if (!rule.firstGroups.count(firstInsn.getGroup()) &&
+        !rule.firstOpcodes.count(firstInsn.getMetadata().opcode))
+      continue;
+    if (!rule.secondGroups.count(secondInsn.getGroup()) &&
+        !rule.secondOpcodes.count(secondInsn.getMetadata().opcode))
+      continue;
+    if (rule.sharedDestination) {
+      // The second instruction must overwrite a result of the first
+      const auto& firstDestinations = first.getDestinationRegisters();
+      const auto& secondDestinations = second.getDestinationRegisters();
+      if (std::none_of(secondDestinations.begin(), secondDestinations.end(),
+                       [&](const Register& reg) {
+                         return std::find(firstDestinations.begin(),
+                                          firstDestinations.end(),
+                                          reg) != firstDestinations.end();
+                       }))
+        continue;
+    }
+    info = getExecutionInfo(secondInsn);
+    if (rule.latency != 0) info.latency = rule.latency;
+    return true;
+  }
+  return false;
+}
+
+bool Architecture::isFusionIdiom(const Instruction& first,
+                                 const Instruction& second) const {
+  // The second instruction must build upon the single register the first
+  // writes; for a CMP or TST, the NZCV flags
+  const auto& firstDestinations = first.getDestinationRegisters();
+  const auto& secondSources = second.getSourceRegisters();
+  if (firstDestinations.size() != 1 || secondSources.size() != 1 ||
+      !(secondSources[0] == firstDestinations[0]))
+    return false;
+
+  // Other than a branch, the second instruction must also overwrite it
+  const auto& secondDestinations = second.getDestinationRegisters();
+  bool overwrites = secondDestinations.size() == 1 &&
+                    secondDestinations[0] == firstDestinations[0];
+
+  const auto secondOpcode = second.getMetadata().opcode;
+  switch (first.getMetadata().opcode) {
+    case Opcode::AArch64_ADRP:  // ADRP+ADD; load a PC-relative address
+      return overwrites && secondOpcode == Opcode::AArch64_ADDXri;
+    case Opcode::AArch64_MOVZWi:  // MOVZ+MOVK; load a wide constant
+      return overwrites && secondOpcode == Opcode::AArch64_MOVKWi;
+    case Opcode::AArch64_MOVZXi:
+      return overwrites && secondOpcode == Opcode::AArch64_MOVKXi;
+    case Opcode::AArch64_SUBSWri:  // CMP+B.cond; compare and branch
+      [[fallthrough]];
+    case Opcode::AArch64_SUBSWrs:
+      [[fallthrough]];
+    case Opcode::AArch64_SUBSXri:
+      [[fallthrough]];
+    case Opcode::AArch64_SUBSXrs:
+      [[fallthrough]];
+    case Opcode::AArch64_ANDSWri:  // TST+B.cond; test and branch
+      [[fallthrough]];
+    case Opcode::AArch64_ANDSWrs:
+      [[fallthrough]];
+    case Opcode::AArch64_ANDSXri:
+      [[fallthrough]];
+    case Opcode::AArch64_ANDSXrs:
+      // Only a CMP or TST, discarding its result, writes the flags alone
+      return secondOpcode == Opcode::AArch64_Bcc;
+    default:
+      return false;
+  }
+}
+
 uint64_t Architecture::getVectorLength() const { return VL_; }
 
 uint64_t Architecture::getStreamingVectorLength() const { return SVL_; }
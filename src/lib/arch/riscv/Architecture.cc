@@ -108,6 +108,28 @@ Architecture::Architecture(kernel::Linux& kernel, ryml::ConstNodeRef config)
     }
   }
 
+  // Extract any macro-op fusion rules. The group numbers of each rule already
+  // include those of the groups which inherit from them
+  if (config.has_child(ryml::to_csubstr("Macro-Op-Fusion"))) {
+    for (size_t i = 0; i < config["Macro-Op-Fusion"].num_children(); i++) {
+      ryml::ConstNodeRef rule_node = config["Macro-Op-Fusion"][i];
+      auto readSet = [&rule_node](const char* key) {
+        std::unordered_set<uint16_t> values;
+        ryml::ConstNodeRef values_node = rule_node[ryml::to_csubstr(key)];
+        for (size_t j = 0; j < values_node.num_children(); j++) {
+          values.insert(values_node[j].as<uint16_t>());
+        }
+        return values;
+      };
+      fusionRules_.push_back({readSet("First-Instruction-Group-Nums"),
+                              readSet("First-Instruction-Opcodes"),
+                              readSet("Second-Instruction-Group-Nums"),
+                              readSet("Second-Instruction-Opcodes"),
+                              rule_node["Shared-Destination"].as<bool>(),
+                              rule_node["Execution-Latency"].as<uint16_t>()});
+    }
+  }
+
   // ports entries in the groupExecutionInfo_ entries only apply for models
   // using the outoforder core archetype
   if (config::SimInfo::getSimMode() == config::SimulationMode::Outoforder) {
@@ -292,8 +314,8 @@ uint8_t Architecture::getMaxInstructionSize() const { return 4; }
 
 uint8_t Architecture::getMinInstructionSize() const { return minInsnLength_; }
 
-void Architecture::updateSystemTimerRegisters(RegisterFileSet* regFile,
-                                              const uint64_t iterations) const {
+void Architecture::updateSystemTimerRegisters(
+    ArchitecturalRegisterFileSet* regFile, const uint64_t iterations) const {
   regFile->set(cycleSystemReg_, iterations);
 }
 
@@ -313,6 +335,73 @@ ExecutionInfo Architecture::getExecutionInfo(const Instruction& insn) const {
   return exeInfo;
 }
 
+bool Architecture::getFusionInfo(const simeng::Instruction& first,
+                                 const simeng::Instruction& second,
+                                 ExecutionInfo& info) const {
+  const auto& firstInsn = static_cast<const Instruction&>(first);
+  const auto& secondInsn = static_cast<const Instruction&>(second);
+  if (!isFusionIdiom(firstInsn, secondInsn)) return false;
+  for (const auto& rule : fusionRules_) {
+    if (!rule.firstGroups.count(firstInsn.getGroup()) &&
+        !rule.firstOpcodes.count(firstInsn.getMetadata().opcode))
+      continue;
+    if (!rule.secondGroups.count(secondInsn.getGroup()) &&
+        !rule.secondOpcodes.count(secondInsn.getMetadata().opcode))
+      continue;
+    if (rule.sharedDestination) {
+      // The second instruction must overwrite a result of the first
+      const auto& firstDestinations = first.getDestinationRegisters();
+      const auto& secondDestinations = second.getDestinationRegisters();
+      if (std::none_of(secondDestinations.begin(), secondDestinations.end(),
+                       [&](const Register& reg) {
+                         return std::find(firstDestinations.begin(),
+                                          firstDestinations.end(),
+                                          reg) != firstDestinations.end();
+                       }))
+        continue;
+    }
+    info = getExecutionInfo(secondInsn);
+    if (rule.latency != 0) info.latency = rule.latency;
+    return true;
+  }
+  return false;
+}
+
+bool Architecture::isFusionIdiom(const Instruction& first,
+                                 const Instruction& second) const {
+  // The second instruction must build upon the single register the first
+  // writes
+  const auto& firstDestinations = first.getDestinationRegisters();
+  const auto& secondSources = second.getSourceRegisters();
+  if (firstDestinations.size() != 1 || secondSources.size() != 1 ||
+      !(secondSources[0] == firstDestinations[0]))
+    return false;
+
+  // Other than a jump, the second instruction must also overwrite it
+  const auto& secondDestinations = second.getDestinationRegisters();
+  bool overwrites = secondDestinations.size() == 1 &&
+                    secondDestinations[0] == firstDestinations[0];
+
+  const auto& firstMetadata = first.getMetadata();
+  const auto& secondMetadata = second.getMetadata();
+  switch (firstMetadata.opcode) {
+    case Opcode::RISCV_LUI:  // LUI+ADDI(W); load a 32-bit constant
+      return overwrites && (secondMetadata.opcode == Opcode::RISCV_ADDI ||
+                            secondMetadata.opcode == Opcode::RISCV_ADDIW);
+    case Opcode::RISCV_AUIPC:
+      // AUIPC+ADDI; load a PC-relative address
+      if (secondMetadata.opcode == Opcode::RISCV_ADDI) return overwrites;
+      // AUIPC+JALR; a far call or jump
+      return secondMetadata.opcode == Opcode::RISCV_JALR;
+    case Opcode::RISCV_SLLI:  // SLLI+SRLI by 32; zero-extend a word
+      return overwrites && secondMetadata.opcode == Opcode::RISCV_SRLI &&
+             firstMetadata.operands[2].imm == 32 &&
+             secondMetadata.operands[2].imm == 32;
+    default:
+      return false;
+  }
+}
+
 }  // namespace riscv
 }  // namespace arch
 }  // namespace simeng
@@ -1,5 +1,7 @@
 #include "simeng/arch/riscv/ExceptionHandler.hh"
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 
@@ -106,30 +108,17 @@ bool ExceptionHandler::init() {
         uint64_t bufPtr = registerFileSet.get(R1).get<uint64_t>();
         uint64_t count = registerFileSet.get(R2).get<uint64_t>();
 
-        return readBufferThen(bufPtr, count, [=]() {
-          int64_t totalRead = linux_.getdents64(fd, dataBuffer_.data(), count);
-          ProcessStateChange stateChange = {
-              ChangeType::REPLACEMENT, {R0}, {totalRead}};
-          // Check for failure
-          if (totalRead < 0) {
-            return concludeSyscall(stateChange);
-          }
-
-          // Get pointer and size of the buffer
-          uint64_t iDst = bufPtr;
-          // Write data for this buffer in 128-byte chunks
-          auto iSrc = reinterpret_cast<const char*>(dataBuffer_.data());
-          while (totalRead > 0) {
-            uint8_t len =
-                totalRead > 128 ? 128 : static_cast<uint8_t>(totalRead);
-            stateChange.memoryAddresses.push_back({iDst, len});
-            stateChange.memoryAddressValues.push_back({iSrc, len});
-            iDst += len;
-            iSrc += len;
-            totalRead -= len;
-          }
-          return concludeSyscall(stateChange);
-        });
+        // Have the kernel write directly into a host buffer, copied into the
+        // guest's buffer as a single block
+        std::vector<char> buffer(count);
+        int64_t totalRead = linux_.getdents64(fd, buffer.data(), count);
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {totalRead}};
+        if (totalRead > 0) {
+          buffer.resize(totalRead);
+          stateChange.memoryBlockAddresses.push_back(bufPtr);
+          stateChange.memoryBlockValues.push_back(std::move(buffer));
+        }
+        break;
       }
       case 62: {  // lseek
         int64_t fd = registerFileSet.get(R0).get<int64_t>();
@@ -143,32 +132,17 @@ bool ExceptionHandler::init() {
         int64_t fd = registerFileSet.get(R0).get<int64_t>();
         uint64_t bufPtr = registerFileSet.get(R1).get<uint64_t>();
         uint64_t count = registerFileSet.get(R2).get<uint64_t>();
-        return readBufferThen(bufPtr, count, [=]() {
-          int64_t totalRead = linux_.read(fd, dataBuffer_.data(), count);
-          ProcessStateChange stateChange = {
-              ChangeType::REPLACEMENT, {R0}, {totalRead}};
-          // Check for failure
-          if (totalRead < 0) {
-            return concludeSyscall(stateChange);
-          }
-
-          // Get pointer and size of the buffer
-          uint64_t iDst = bufPtr;
-          // totalRead not negative due to above check so cast is safe
-          uint64_t iLength = static_cast<uint64_t>(totalRead);
-
-          // Write data for this buffer in 128-byte chunks
-          auto iSrc = reinterpret_cast<const char*>(dataBuffer_.data());
-          while (iLength > 0) {
-            uint8_t len = iLength > 128 ? 128 : static_cast<uint8_t>(iLength);
-            stateChange.memoryAddresses.push_back({iDst, len});
-            stateChange.memoryAddressValues.push_back({iSrc, len});
-            iDst += len;
-            iSrc += len;
-            iLength -= len;
-          }
-          return concludeSyscall(stateChange);
-        });
+        // Have the kernel write directly into a host buffer, copied into the
+        // guest's buffer as a single block
+        std::vector<char> buffer(count);
+        int64_t totalRead = linux_.read(fd, buffer.data(), count);
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {totalRead}};
+        if (totalRead > 0) {
+          buffer.resize(totalRead);
+          stateChange.memoryBlockAddresses.push_back(bufPtr);
+          stateChange.memoryBlockValues.push_back(std::move(buffer));
+        }
+        break;
       }
       case 64: {  // write
         int64_t fd = registerFileSet.get(R0).get<int64_t>();
@@ -202,7 +176,7 @@ bool ExceptionHandler::init() {
           uint64_t* iovdata = reinterpret_cast<uint64_t*>(dataBuffer_.data());
 
           // Allocate buffers to hold the data read by the kernel
-          std::vector<std::vector<uint8_t>> buffers(iovcnt);
+          std::vector<std::vector<char>> buffers(iovcnt);
           for (int64_t i = 0; i < iovcnt; i++) {
             buffers[i].resize(iovdata[i * 2 + 1]);
           }
@@ -235,17 +209,12 @@ bool ExceptionHandler::init() {
               iLength = bytesRemaining;
             }
             bytesRemaining -= iLength;
+            if (iLength == 0) continue;
 
-            // Write data for this buffer in 128-byte chunks
-            auto iSrc = reinterpret_cast<const char*>(buffers[i].data());
-            while (iLength > 0) {
-              uint8_t len = iLength > 128 ? 128 : static_cast<uint8_t>(iLength);
-              stateChange.memoryAddresses.push_back({iDst, len});
-              stateChange.memoryAddressValues.push_back({iSrc, len});
-              iDst += len;
-              iSrc += len;
-              iLength -= len;
-            }
+            // Write the data read into this buffer as a single block
+            buffers[i].resize(iLength);
+            stateChange.memoryBlockAddresses.push_back(iDst);
+            stateChange.memoryBlockValues.push_back(std::move(buffers[i]));
           }
 
           return concludeSyscall(stateChange);
@@ -355,17 +324,35 @@ bool ExceptionHandler::init() {
       }
       case 93: {  // exit
         auto exitCode = registerFileSet.get(R0).get<uint64_t>();
-        std::cout << "\n[SimEng:ExceptionHandler] Received exit syscall: "
-                     "terminating with exit code "
-                  << exitCode << std::endl;
-        return fatal();
+        if (linux_.getThreadCount() > 1) {
+          // Zero the exiting thread's clear_child_tid address, whose waiter
+          // the kernel has woken, and run another thread in its place
+          uint64_t clearChildTid = linux_.exitThread();
+          if (clearChildTid != 0) {
+            stateChange.memoryAddresses.push_back({clearChildTid, 4});
+            stateChange.memoryAddressValues.push_back(
+                static_cast<uint32_t>(0));
+          }
+          return switchThread(stateChange);
+        }
+        // The process exits with its last thread. Write shared file mappings
+        // back to their files before terminating
+        return writeBackThen(0, UINT64_MAX, [=]() {
+          std::cout << "\n[SimEng:ExceptionHandler] Received exit syscall: "
+                       "terminating with exit code "
+                    << exitCode << std::endl;
+          return fatal();
+        });
       }
       case 94: {  // exit_group
         auto exitCode = registerFileSet.get(R0).get<uint64_t>();
-        std::cout << "\n[SimEng:ExceptionHandler] Received exit_group syscall: "
-                     "terminating with exit code "
-                  << exitCode << std::endl;
-        return fatal();
+        // Write shared file mappings back to their files before terminating
+        return writeBackThen(0, UINT64_MAX, [=]() {
+          std::cout << "\n[SimEng:ExceptionHandler] Received exit_group "
+                       "syscall: terminating with exit code "
+                    << exitCode << std::endl;
+          return fatal();
+        });
       }
       case 96: {  // set_tid_address
         uint64_t ptr = registerFileSet.get(R0).get<uint64_t>();
@@ -374,18 +361,58 @@ bool ExceptionHandler::init() {
         break;
       }
       case 98: {  // futex
-        // TODO: Functionality temporarily omitted as it is unused within
-        // workloads regions of interest and not required for their simulation
+        uint64_t uaddr = registerFileSet.get(R0).get<uint64_t>();
         int op = registerFileSet.get(R1).get<int>();
-        if (op != 129) {
+        uint32_t val = registerFileSet.get(R2).get<uint32_t>();
+        uint64_t timeoutPtr = registerFileSet.get(R3).get<uint64_t>();
+        uint32_t bitset = registerFileSet.get(R5).get<uint32_t>();
+        // Ignore FUTEX_PRIVATE_FLAG and FUTEX_CLOCK_REALTIME; every futex is
+        // private to the process, and the simulated time serves both clocks
+        int command = op & ~(128 | 256);
+
+        if (command == 1 || command == 10) {  // FUTEX_WAKE(_BITSET)
+          int64_t woken = linux_.futexWake(uaddr, static_cast<int32_t>(val),
+                                           command == 1 ? UINT32_MAX : bitset);
+          stateChange = {ChangeType::REPLACEMENT, {R0}, {woken}};
+          break;
+        }
+        if (command != 0 && command != 9) {  // FUTEX_WAIT(_BITSET)
           printException(instruction_);
           std::cout << "\n[SimEng:ExceptionHandler] Unsupported arguments for "
                        "syscall: "
                     << syscallId << std::endl;
           return fatal();
         }
-        stateChange = {ChangeType::REPLACEMENT, {R0}, {1ull}};
-        break;
+        if (command == 0) bitset = UINT32_MAX;
+
+        // Read the futex value, followed by the timeout if one was given
+        size_t bufferStart = dataBuffer_.size();
+        uint64_t timeoutLength = (timeoutPtr != 0) ? 16 : 0;
+        return readBufferThen(uaddr, 4, [=]() {
+          return readBufferThen(timeoutPtr, timeoutLength, [=]() {
+            uint32_t value;
+            std::memcpy(&value, dataBuffer_.data() + bufferStart, 4);
+            uint64_t deadline = UINT64_MAX;
+            if (timeoutPtr != 0) {
+              uint64_t timespec[2];
+              std::memcpy(timespec, dataBuffer_.data() + bufferStart + 4, 16);
+              uint64_t timeout = timespec[0] * 1000000000 + timespec[1];
+              // FUTEX_WAIT timeouts are relative, and FUTEX_WAIT_BITSET
+              // timeouts absolute
+              if (command == 0) timeout += core_.getSystemTimer();
+              // Timeouts too long to represent never expire
+              if (timespec[0] < UINT64_MAX / 2000000000) deadline = timeout;
+            }
+
+            int64_t retval = linux_.futexWait(uaddr, value, val, bitset,
+                                              deadline, saveContext());
+            ProcessStateChange stateChange = {
+                ChangeType::REPLACEMENT, {R0}, {retval}};
+            if (retval != 0) return concludeSyscall(stateChange);
+            // The thread is now blocked; run another in its place
+            return switchThread(stateChange);
+          });
+        });
       }
       case 99: {  // set_robust_list
         // TODO: Functionality temporarily omitted as it is unused within
@@ -442,6 +469,14 @@ bool ExceptionHandler::init() {
         }
         break;
       }
+      case 124: {  // sched_yield
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {0ull}};
+        if (linux_.hasReadyThreads()) {
+          linux_.yield(saveContext(), 0);
+          return switchThread(stateChange);
+        }
+        break;
+      }
       case 131: {  // tgkill
         // TODO currently returns success without action
         stateChange = {ChangeType::REPLACEMENT, {R0}, {0}};
@@ -556,8 +591,49 @@ bool ExceptionHandler::init() {
         uint64_t addr = registerFileSet.get(R0).get<uint64_t>();
         size_t length = registerFileSet.get(R1).get<size_t>();
 
-        int64_t result = linux_.munmap(addr, length);
-        stateChange = {ChangeType::REPLACEMENT, {R0}, {result}};
+        // Shared file mappings are written back to their files before being
+        // unmapped
+        return writeBackThen(addr, length, [=]() {
+          int64_t result = linux_.munmap(addr, length);
+          ProcessStateChange stateChange = {
+              ChangeType::REPLACEMENT, {R0}, {result}};
+          return concludeSyscall(stateChange);
+        });
+      }
+      case 220: {  // clone
+        uint64_t flags = registerFileSet.get(R0).get<uint64_t>();
+        uint64_t stackPtr = registerFileSet.get(R1).get<uint64_t>();
+        uint64_t parentTidPtr = registerFileSet.get(R2).get<uint64_t>();
+        uint64_t tls = registerFileSet.get(R3).get<uint64_t>();
+        uint64_t childTidPtr = registerFileSet.get(R4).get<uint64_t>();
+
+        // The new thread starts from the instruction following the syscall,
+        // with its own stack and thread pointer if given
+        ProcessStateChange childChange = {ChangeType::REPLACEMENT, {}, {}};
+        if (stackPtr != 0) {
+          childChange.modifiedRegisters.push_back({RegisterType::GENERAL, 2});
+          childChange.modifiedRegisterValues.push_back(stackPtr);
+        }
+        if (flags & 0x80000) {  // CLONE_SETTLS
+          childChange.modifiedRegisters.push_back({RegisterType::GENERAL, 4});
+          childChange.modifiedRegisterValues.push_back(tls);
+        }
+        int64_t tid =
+            linux_.clone(flags, childTidPtr, saveContext(childChange));
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {tid}};
+        if (tid > 0) {
+          // The threads share memory, so the thread ID is written for both
+          if (flags & 0x100000) {  // CLONE_PARENT_SETTID
+            stateChange.memoryAddresses.push_back({parentTidPtr, 4});
+            stateChange.memoryAddressValues.push_back(
+                static_cast<uint32_t>(tid));
+          }
+          if (flags & 0x1000000) {  // CLONE_CHILD_SETTID
+            stateChange.memoryAddresses.push_back({childTidPtr, 4});
+            stateChange.memoryAddressValues.push_back(
+                static_cast<uint32_t>(tid));
+          }
+        }
         break;
       }
       case 222: {  // mmap
@@ -568,33 +644,62 @@ bool ExceptionHandler::init() {
         int fd = registerFileSet.get(R4).get<int>();
         off_t offset = registerFileSet.get(R5).get<off_t>();
 
-        // Currently, only support mmap from a malloc() call whose arguments
-        // match the first condition
-        if (addr == 0 && flags == 34 && fd == -1 && offset == 0) {
-          uint64_t result = linux_.mmap(addr, length, prot, flags, fd, offset);
-          // An allocation of 0 signifies a failed allocation, return value from
-          // syscall is changed to -1
+        auto map = [=]() {
+          uint64_t result =
+              linux_.mmap(addr, length, prot, flags, fd, offset);
+          // An allocation of 0 signifies a failed allocation, return value
+          // from syscall is changed to -1
           if (result == 0) {
-            stateChange = {
+            ProcessStateChange stateChange = {
                 ChangeType::REPLACEMENT, {R0}, {static_cast<int64_t>(-1)}};
-          } else {
-            stateChange = {ChangeType::REPLACEMENT, {R0}, {result}};
+            return concludeSyscall(stateChange);
           }
-          break;
-        } else {
-          printException(instruction_);
-          std::cout << "\n[SimEng:ExceptionHandler] Unsupported arguments for "
-                       "syscall: "
-                    << syscallId << std::endl;
-          return fatal();
-        }
+          ProcessStateChange stateChange = {
+              ChangeType::REPLACEMENT, {R0}, {result}};
+
+          // Populate the mapping with the contents of any file, and zero the
+          // rest, which may hold data of an earlier mapping. The contents are
+          // copied into memory as a single block.
+          std::vector<char> contents;
+          linux_.getMappingContents(result, length, contents);
+          if (!contents.empty()) {
+            stateChange.memoryBlockAddresses.push_back(result);
+            stateChange.memoryBlockValues.push_back(std::move(contents));
+          }
+          return concludeSyscall(stateChange);
+        };
+        // MAP_FIXED mappings replace any they overlap, so shared file
+        // mappings are written back to their files first, as on munmap
+        if (flags & 0x10) return writeBackThen(addr, length, map);
+        return map();
       }
       case 226: {  // mprotect
-        // mprotect is not supported
-        // always return zero to indicate success
-        stateChange = {ChangeType::REPLACEMENT, {R0}, {0ull}};
+        uint64_t addr = registerFileSet.get(R0).get<uint64_t>();
+        size_t length = registerFileSet.get(R1).get<size_t>();
+        int prot = registerFileSet.get(R2).get<int>();
+
+        int64_t result = linux_.mprotect(addr, length, prot);
+        stateChange = {ChangeType::REPLACEMENT, {R0}, {result}};
         break;
       }
+      case 227: {  // msync
+        uint64_t addr = registerFileSet.get(R0).get<uint64_t>();
+        size_t length = registerFileSet.get(R1).get<size_t>();
+        int flags = registerFileSet.get(R2).get<int>();
+
+        int64_t result = linux_.msync(addr, length, flags);
+        if (result != 0) {
+          stateChange = {ChangeType::REPLACEMENT, {R0}, {result}};
+          break;
+        }
+        // Writes to the files complete before returning, so MS_ASYNC and
+        // MS_SYNC are treated alike
+        return writeBackThen(addr, length, [=]() {
+          ProcessStateChange stateChange = {
+              ChangeType::REPLACEMENT, {R0}, {result}};
+          return concludeSyscall(stateChange);
+        });
+      }
       case 261: {  // prlimit64
         // TODO: Functionality temporarily omitted as it is unused within
         // workloads regions of interest and not required for their simulation
@@ -629,6 +734,13 @@ bool ExceptionHandler::init() {
         stateChange = {ChangeType::REPLACEMENT, {R0}, {0ull}};
         break;
       }
+      case 435: {  // clone3
+        // Returns -38 (errno 38, function not implemented), upon which C
+        // libraries fall back to clone
+        stateChange = {
+            ChangeType::REPLACEMENT, {R0}, {static_cast<int64_t>(-38)}};
+        break;
+      }
       default:
         printException(instruction_);
         std::cout << "\n[SimEng:ExceptionHandler] Unrecognised syscall: "
@@ -636,6 +748,14 @@ bool ExceptionHandler::init() {
         return fatal();
     }
 
+    // Once the running thread has used up its time slice, switch to the next
+    // thread waiting to run
+    if (linux_.shouldPreempt(core_.getSystemTimer())) {
+      kernel::ThreadContext context = saveContext(stateChange);
+      size_t result = getRegisterIndex(context.registers, R0);
+      linux_.yield(context, context.values[result].get<int64_t>());
+      return switchThread(stateChange);
+    }
     return concludeSyscall(stateChange);
   } else if (exception == InstructionException::PipelineFlush) {
     // Retrieve metadata, operand values and destination registers from
@@ -813,6 +933,16 @@ bool ExceptionHandler::readBufferThen(uint64_t ptr, uint64_t length,
       return then();
     }
 
+    // Copy the whole buffer at once if the memory interface permits it
+    size_t bufferEnd = dataBuffer_.size();
+    dataBuffer_.resize(bufferEnd + length);
+    if (memory_.readBlock(
+            ptr, reinterpret_cast<char*>(dataBuffer_.data() + bufferEnd),
+            length)) {
+      return then();
+    }
+    dataBuffer_.resize(bufferEnd);
+
     // Request a read of up to 128 bytes
     uint64_t numBytes = std::min<uint64_t>(length, 128);
     memory_.requestRead({ptr, static_cast<uint8_t>(numBytes)},
@@ -849,12 +979,87 @@ bool ExceptionHandler::readBufferThen(uint64_t ptr, uint64_t length,
   return then();
 }
 
+bool ExceptionHandler::writeBackThen(uint64_t addr, uint64_t length,
+                                     std::function<bool()> then) {
+  // Read and write back each shared mapping in turn, such that the memory
+  // between them isn't read
+  std::function<bool()> next = then;
+  auto ranges = linux_.getWriteBackRanges(addr, length);
+  for (auto range = ranges.rbegin(); range != ranges.rend(); range++) {
+    uint64_t start = range->first;
+    uint64_t size = range->second - range->first;
+    next = [=]() {
+      size_t bufferStart = dataBuffer_.size();
+      return readBufferThen(start, size, [=]() {
+        linux_.writeBack(
+            start, size,
+            reinterpret_cast<const char*>(dataBuffer_.data() + bufferStart));
+        dataBuffer_.resize(bufferStart);
+        return next();
+      });
+    };
+  }
+  return next();
+}
+
 bool ExceptionHandler::concludeSyscall(ProcessStateChange& stateChange) {
   uint64_t nextInstructionAddress = instruction_.getInstructionAddress() + 4;
-  result_ = {false, nextInstructionAddress, stateChange};
+  result_ = {false, nextInstructionAddress, std::move(stateChange)};
+  return true;
+}
+
+kernel::ThreadContext ExceptionHandler::saveContext(
+    const ProcessStateChange& stateChange) const {
+  assert(stateChange.type == ChangeType::REPLACEMENT &&
+         "Attempted to save a thread context with a relative state change");
+  const auto& registerFileSet = core_.getArchitecturalRegisterFileSet();
+  auto regFileStruct = config::SimInfo::getArchRegStruct();
+
+  kernel::ThreadContext context;
+  context.pc = instruction_.getInstructionAddress() + 4;
+  for (uint8_t type = 0; type < regFileStruct.size(); type++) {
+    for (uint16_t tag = 0; tag < regFileStruct[type].quantity; tag++) {
+      context.registers.push_back({type, tag});
+      context.values.push_back(registerFileSet.get({type, tag}));
+    }
+  }
+  for (size_t i = 0; i < stateChange.modifiedRegisters.size(); i++) {
+    size_t index =
+        getRegisterIndex(context.registers, stateChange.modifiedRegisters[i]);
+    context.values[index] = stateChange.modifiedRegisterValues[i];
+  }
+  return context;
+}
+
+bool ExceptionHandler::switchThread(ProcessStateChange& stateChange) {
+  const kernel::LinuxThreadState* next =
+      linux_.scheduleNext(core_.getSystemTimer());
+  if (next == nullptr) {
+    std::cout << "\n[SimEng:ExceptionHandler] All threads are blocked "
+                 "indefinitely: terminating"
+              << std::endl;
+    return fatal();
+  }
+
+  // Replace the registers of the suspended thread with those of the next,
+  // which returns from the syscall that suspended it
+  stateChange.type = ChangeType::REPLACEMENT;
+  stateChange.modifiedRegisters = next->context.registers;
+  stateChange.modifiedRegisterValues = next->context.values;
+  size_t result = getRegisterIndex(stateChange.modifiedRegisters, R0);
+  stateChange.modifiedRegisterValues[result] = next->result;
+
+  result_ = {false, next->context.pc, std::move(stateChange)};
   return true;
 }
 
+size_t ExceptionHandler::getRegisterIndex(
+    const std::vector<Register>& registers, Register reg) {
+  auto it = std::find(registers.begin(), registers.end(), reg);
+  assert(it != registers.end() && "Register missing from thread context");
+  return it - registers.begin();
+}
+
 const ExceptionResult& ExceptionHandler::getResult() const { return result_; }
 
 void ExceptionHandler::printException(const Instruction& insn) const {
@@ -0,0 +1,98 @@
+#include "simeng/branchpredictors/BranchTrace.hh"
+
+#include <cstring>
+
+namespace simeng {
+
+namespace {
+
+/** The magic number opening every branch trace. */
+const char traceMagic[4] = {'S', 'E', 'B', 'T'};
+
+/** The version of the trace format, incremented on incompatible changes. */
+const uint32_t traceVersion = 1;
+
+/** The size of a serialised record, in bytes: the address, target, known
+ * offset and instruction count, followed by the type and direction. */
+const size_t recordSize = 4 * sizeof(uint64_t) + 2;
+
+/** The number of records buffered before they're written out. */
+const size_t bufferedRecords = 4096;
+
+}  // namespace
+
+BranchTraceWriter::BranchTraceWriter(const std::string& path)
+    : file_(path, std::ios::binary | std::ios::trunc) {
+  if (!file_.is_open()) return;
+  file_.write(traceMagic, sizeof(traceMagic));
+  file_.write(reinterpret_cast<const char*>(&traceVersion),
+              sizeof(traceVersion));
+  buffer_.reserve(bufferedRecords * recordSize);
+}
+
+BranchTraceWriter::~BranchTraceWriter() { flush(); }
+
+bool BranchTraceWriter::isValid() const { return file_.is_open(); }
+
+void BranchTraceWriter::record(const BranchTraceRecord& record) {
+  size_t offset = buffer_.size();
+  buffer_.resize(offset + recordSize);
+  char* out = buffer_.data() + offset;
+  std::memcpy(out, &record.address, sizeof(uint64_t));
+  std::memcpy(out + 8, &record.target, sizeof(uint64_t));
+  std::memcpy(out + 16, &record.knownOffset, sizeof(int64_t));
+  std::memcpy(out + 24, &record.instructionCount, sizeof(uint64_t));
+  out[32] = static_cast<char>(record.type);
+  out[33] = record.taken;
+
+  if (buffer_.size() >= bufferedRecords * recordSize) flush();
+}
+
+void BranchTraceWriter::flush() {
+  if (!file_.is_open() || buffer_.empty()) return;
+  file_.write(buffer_.data(), buffer_.size());
+  file_.flush();
+  buffer_.clear();
+}
+
+BranchTraceReader::BranchTraceReader(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) return;
+
+  char magic[sizeof(traceMagic)];
+  uint32_t version = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!file || std::memcmp(magic, traceMagic, sizeof(magic)) ||
+      version != traceVersion) {
+    return;
+  }
+
+  char in[recordSize];
+  while (file.read(in, recordSize)) {
+    BranchTraceRecord record;
+    std::memcpy(&record.address, in, sizeof(uint64_t));
+    std::memcpy(&record.target, in + 8, sizeof(uint64_t));
+    std::memcpy(&record.knownOffset, in + 16, sizeof(int64_t));
+    std::memcpy(&record.instructionCount, in + 24, sizeof(uint64_t));
+    record.type = static_cast<BranchType>(in[32]);
+    record.taken = in[33];
+    records_.push_back(record);
+  }
+
+  // A truncated final record indicates a corrupt trace
+  isValid_ = (file.gcount() == 0);
+}
+
+bool BranchTraceReader::isValid() const { return isValid_; }
+
+const std::vector<BranchTraceRecord>& BranchTraceReader::getRecords() const {
+  return records_;
+}
+
+uint64_t BranchTraceReader::getInstructionCount() const {
+  if (records_.empty()) return 0;
+  return records_.back().instructionCount + 1;
+}
+
+}  // namespace simeng
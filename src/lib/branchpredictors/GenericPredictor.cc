@@ -10,7 +10,8 @@ GenericPredictor::GenericPredictor(ryml::ConstNodeRef config)
           config["Branch-Predictor"]["Saturating-Count-Bits"].as<uint8_t>()),
       globalHistoryLength_(
           config["Branch-Predictor"]["Global-History-Length"].as<uint16_t>()),
-      rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint16_t>()) {
+      rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint16_t>()),
+      indirectPredictor_(config) {
   // Calculate the saturation counter boundary between weakly taken and
   // not-taken. `(2 ^ num_sat_cnt_bits) / 2` gives the weakly taken state
   // value
@@ -55,6 +56,11 @@ BranchPrediction GenericPredictor::predict(uint64_t address, BranchType type,
   // Amend prediction based on branch type
   if (type == BranchType::Unconditional) {
     prediction.isTaken = true;
+    // Register-indirect branches use the indirect target predictor
+    if (knownOffset == 0) {
+      prediction.target =
+          indirectPredictor_.predict(address, prediction.target);
+    }
   } else if (type == BranchType::Return) {
     prediction.isTaken = true;
     // Return branches can use the RAS if an entry is available
@@ -66,6 +72,11 @@ BranchPrediction GenericPredictor::predict(uint64_t address, BranchType type,
     }
   } else if (type == BranchType::SubroutineCall) {
     prediction.isTaken = true;
+    // Register-indirect branches use the indirect target predictor
+    if (knownOffset == 0) {
+      prediction.target =
+          indirectPredictor_.predict(address, prediction.target);
+    }
     // Subroutine call branches must push their associated return address to RAS
     if (ras_.size() >= rasSize_) {
       ras_.pop_front();
@@ -115,6 +126,8 @@ void GenericPredictor::update(uint64_t address, bool isTaken,
     btb_[hashedIndex].second = targetAddress;
   }
 
+  indirectPredictor_.update(address, targetAddress);
+
   // Update global history if prediction was incorrect
   if (prevPrediction != isTaken) {
     // Bit-flip the global history bit corresponding to this prediction
@@ -149,6 +162,7 @@ void GenericPredictor::flush(uint64_t address) {
          "Cannot flush instruction from Branch Predictor "
          "when the ftq is empty");
   ftq_.pop_back();
+  indirectPredictor_.flush(address);
 
   // Roll back global history
   globalHistory_ >>= 1;
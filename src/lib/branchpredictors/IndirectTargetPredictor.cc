@@ -0,0 +1,167 @@
+#include "simeng/branchpredictors/IndirectTargetPredictor.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simeng {
+
+IndirectTargetPredictor::IndirectTargetPredictor(ryml::ConstNodeRef config)
+    : indexBits_(config["Branch-Predictor"]["Indirect-Table-Index-Bits"]
+                     .as<uint8_t>()),
+      tagBits_(
+          config["Branch-Predictor"]["Indirect-Table-Tag-Bits"].as<uint8_t>()) {
+  uint16_t tableCount =
+      config["Branch-Predictor"]["Indirect-Table-Count"].as<uint16_t>();
+  tables_.assign(tableCount, std::vector<TaggedEntry>(1ull << indexBits_));
+
+  // Derive the geometric series of history lengths from a single target up to
+  // the maximum length configured
+  double maxLength =
+      config["Branch-Predictor"]["Indirect-History-Length"].as<double>();
+  for (uint16_t i = 0; i < tableCount; i++) {
+    double exponent =
+        (tableCount > 1) ? static_cast<double>(i) / (tableCount - 1) : 1.0;
+    historyLengths_.push_back(
+        static_cast<uint16_t>(std::round(std::pow(maxLength, exponent))));
+  }
+}
+
+bool IndirectTargetPredictor::isEnabled() const { return !tables_.empty(); }
+
+uint64_t IndirectTargetPredictor::predict(uint64_t address,
+                                          uint64_t btbTarget) {
+  if (!isEnabled()) return btbTarget;
+
+  FtqEntry entry = {address, btbTarget, btbTarget, -1, {}, {}};
+  entry.indices.resize(tables_.size());
+  entry.tags.resize(tables_.size());
+
+  // Hash the address with the path history of each table's length. The
+  // address is shifted to remove the two least-significant bits as these are
+  // always 0 in an ISA with 4-byte aligned instructions.
+  uint64_t pc = address >> 2;
+  uint64_t indexMask = (1ull << indexBits_) - 1;
+  uint64_t tagMask = (1ull << tagBits_) - 1;
+  for (size_t table = 0; table < tables_.size(); table++) {
+    uint16_t length = historyLengths_[table];
+    entry.indices[table] =
+        (pc ^ (pc >> indexBits_) ^ foldHistory(length, indexBits_)) &
+        indexMask;
+    entry.tags[table] =
+        ((pc >> indexBits_) ^ pc ^ (foldHistory(length, tagBits_) << 1)) &
+        tagMask;
+  }
+
+  // The provider is the matching table with the longest history, and the
+  // alternate the next longest; the BTB stands in for either when there's no
+  // such match
+  for (int8_t table = tables_.size() - 1; table >= 0; table--) {
+    const TaggedEntry& tagged = tables_[table][entry.indices[table]];
+    if (!tagged.valid || tagged.tag != entry.tags[table]) continue;
+    if (entry.provider < 0) {
+      entry.provider = table;
+      entry.target = tagged.target;
+    } else {
+      entry.altTarget = tagged.target;
+      break;
+    }
+  }
+
+  // Speculatively update the path history with the predicted target
+  pathHistory_.push_back(hashTarget(entry.target));
+  if (pathHistory_.size() > 2u * historyLengths_.back()) {
+    pathHistory_.pop_front();
+  }
+
+  uint64_t target = entry.target;
+  ftq_.push_back(std::move(entry));
+  return target;
+}
+
+void IndirectTargetPredictor::update(uint64_t address,
+                                     uint64_t targetAddress) {
+  if (ftq_.empty() || ftq_.front().address != address) return;
+
+  FtqEntry entry = std::move(ftq_.front());
+  ftq_.pop_front();
+
+  if (entry.provider >= 0) {
+    TaggedEntry& provided =
+        tables_[entry.provider][entry.indices[entry.provider]];
+    if (provided.target == targetAddress) {
+      if (provided.confidence < 3) provided.confidence++;
+      // The provider is useful when it corrects the alternate prediction
+      if (entry.altTarget != targetAddress) provided.useful = true;
+    } else if (provided.confidence > 0) {
+      provided.confidence--;
+    } else {
+      provided.target = targetAddress;
+      provided.useful = false;
+    }
+  }
+
+  if (entry.target == targetAddress) return;
+
+  // Claim the first entry not in use amongst the tables with a longer history
+  // than the provider, or else clear the usefulness of all candidates so one
+  // may be claimed later
+  bool allocated = false;
+  for (size_t table = entry.provider + 1; table < tables_.size(); table++) {
+    TaggedEntry& candidate = tables_[table][entry.indices[table]];
+    if (!candidate.useful) {
+      candidate = {true, targetAddress, entry.tags[table], 0, false};
+      allocated = true;
+      break;
+    }
+  }
+  if (!allocated) {
+    for (size_t table = entry.provider + 1; table < tables_.size(); table++) {
+      tables_[table][entry.indices[table]].useful = false;
+    }
+  }
+
+  // Correct the target speculatively inserted into the path history. We know
+  // how many predictions there have since been by the size of the FTQ
+  if (ftq_.size() < pathHistory_.size()) {
+    pathHistory_[pathHistory_.size() - 1 - ftq_.size()] =
+        hashTarget(targetAddress);
+  }
+}
+
+void IndirectTargetPredictor::flush(uint64_t address) {
+  if (ftq_.empty() || ftq_.back().address != address) return;
+
+  ftq_.pop_back();
+  if (!pathHistory_.empty()) pathHistory_.pop_back();
+}
+
+const std::vector<uint16_t>& IndirectTargetPredictor::getHistoryLengths()
+    const {
+  return historyLengths_;
+}
+
+uint64_t IndirectTargetPredictor::foldHistory(uint16_t length,
+                                              uint8_t bits) const {
+  // Combine the most recent targets, rotating each by its age so that the
+  // order of the path is captured
+  uint64_t folded = 0;
+  size_t available = std::min<size_t>(length, pathHistory_.size());
+  for (size_t age = 0; age < available; age++) {
+    uint64_t fragment = pathHistory_[pathHistory_.size() - 1 - age];
+    unsigned shift = (age * 5) % 64;
+    folded ^= (fragment << shift) | (shift ? fragment >> (64 - shift) : 0);
+  }
+
+  // Fold the resulting word down to the number of bits requested
+  uint64_t result = 0;
+  for (; folded != 0; folded >>= bits) {
+    result ^= folded & ((1ull << bits) - 1);
+  }
+  return result;
+}
+
+uint16_t IndirectTargetPredictor::hashTarget(uint64_t target) {
+  return static_cast<uint16_t>((target >> 2) ^ (target >> 18));
+}
+
+}  // namespace simeng
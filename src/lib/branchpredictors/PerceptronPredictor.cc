@@ -1,39 +1,71 @@
 #include "simeng/branchpredictors/PerceptronPredictor.hh"
 
+#include <algorithm>
+#include <cstring>
+
 namespace simeng {
 
+namespace {
+
+/** The perceptron inputs for each byte of global history, being 1 for each set
+ * bit and -1 otherwise, with the least-significant bit first. */
+const std::array<std::array<int8_t, 8>, 256> byteInputs = [] {
+  std::array<std::array<int8_t, 8>, 256> table;
+  for (uint16_t byte = 0; byte < 256; byte++) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      table[byte][bit] = ((byte >> bit) & 1) ? 1 : -1;
+    }
+  }
+  return table;
+}();
+
+/** Clamp `weight` to the range of a perceptron weight, making sure no overflow
+ * (+-127). */
+int8_t saturateWeight(int16_t weight) {
+  return static_cast<int8_t>(
+      std::min<int16_t>(127, std::max<int16_t>(-127, weight)));
+}
+
+}  // namespace
+
 PerceptronPredictor::PerceptronPredictor(ryml::ConstNodeRef config)
     : btbBits_(config["Branch-Predictor"]["BTB-Tag-Bits"].as<uint64_t>()),
       globalHistoryLength_(
           config["Branch-Predictor"]["Global-History-Length"].as<uint64_t>()),
-      rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint64_t>()) {
-  // Build BTB based on config options
-  uint32_t btbSize = (1ul << btbBits_);
-  btb_.resize(btbSize);
-
-  // Initialise perceptron values with 0 for the global history weights, and 1
-  // for the bias weight; and initialise the target with 0 (i.e., unknown)
-  for (uint32_t i = 0; i < btbSize; i++) {
-    btb_[i].first.assign(globalHistoryLength_, 0);
-    btb_[i].first.push_back(1);
-    btb_[i].second = 0;
+      rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint64_t>()),
+      indirectPredictor_(config) {
+  assert(globalHistoryLength_ <= maxHistoryLength_ &&
+         "Global history length exceeds the maximum supported by the "
+         "perceptrons");
+
+  // Build BTB based on config options. Initialise perceptron values with 0 for
+  // the global history weights, and 1 for the bias weight; and initialise the
+  // target with 0 (i.e., unknown)
+  uint64_t btbSize = (1ull << btbBits_);
+  weights_.assign(btbSize * maxHistoryLength_, 0);
+  biases_.assign(btbSize, 1);
+  btbTargets_.assign(btbSize, 0);
+
+  for (uint8_t i = 0; i < maxHistoryLength_; i++) {
+    historyLengthMask_[i] = (i < globalHistoryLength_) ? -1 : 0;
   }
 
+  ras_.resize(rasSize_);
+
   // Set up training threshold according to empirically determined formula
   trainingThreshold_ = (uint64_t)((1.93 * globalHistoryLength_) + 14);
 
   // Generate a bitmask that is used to ensure only the relevant number of
   // bits are stored in the global history. This is two times the
   // globalHistoryLength_ to allow rolling back of the speculatively updated
-  // global history in the event of a misprediction.
-  globalHistoryMask_ = (1ull << (globalHistoryLength_ * 2)) - 1;
+  // global history in the event of a misprediction. A shift by the full 64 bits
+  // of the mask is undefined, so the longest history is handled separately.
+  globalHistoryMask_ = (globalHistoryLength_ * 2 < 64)
+                           ? (1ull << (globalHistoryLength_ * 2)) - 1
+                           : ~0ull;
 }
 
-PerceptronPredictor::~PerceptronPredictor() {
-  ras_.clear();
-  rasHistory_.clear();
-  ftq_.clear();
-}
+PerceptronPredictor::~PerceptronPredictor() { ftq_.clear(); }
 
 BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
                                               int64_t knownOffset) {
@@ -45,11 +77,8 @@ BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
   uint64_t hashedIndex =
       ((address >> 2) ^ globalHistory_) & ((1ull << btbBits_) - 1);
 
-  // Retrieve the perceptron from the BTB
-  std::vector<int8_t> perceptron = btb_[hashedIndex].first;
-
   // Get dot product of perceptron and history
-  int64_t Pout = getDotProduct(perceptron, globalHistory_);
+  int64_t Pout = getDotProduct(hashedIndex, getHistoryInputs(globalHistory_));
 
   // Determine direction prediction based on its sign
   bool direction = (Pout >= 0);
@@ -57,39 +86,45 @@ BranchPrediction PerceptronPredictor::predict(uint64_t address, BranchType type,
   // If there is a known offset then calculate target accordingly, otherwise
   // retrieve the target prediction from the btb.
   uint64_t target =
-      (knownOffset != 0) ? address + knownOffset : btb_[hashedIndex].second;
+      (knownOffset != 0) ? address + knownOffset : btbTargets_[hashedIndex];
 
   BranchPrediction prediction = {direction, target};
+  FtqEntry entry = {Pout, globalHistory_, 0, false};
 
   // Amend prediction based on branch type
   if (type == BranchType::Unconditional) {
     prediction.isTaken = true;
+    // Register-indirect branches use the indirect target predictor
+    if (knownOffset == 0) {
+      prediction.target =
+          indirectPredictor_.predict(address, prediction.target);
+    }
   } else if (type == BranchType::Return) {
     prediction.isTaken = true;
     // Return branches can use the RAS if an entry is available
-    if (ras_.size() > 0) {
-      prediction.target = ras_.back();
+    if (rasCount_ > 0) {
+      prediction.target = popRas();
       // Record top of RAS used for target prediction
-      rasHistory_[address] = ras_.back();
-      ras_.pop_back();
+      entry.rasPopped = prediction.target;
     }
   } else if (type == BranchType::SubroutineCall) {
     prediction.isTaken = true;
-    // Subroutine call branches must push their associated return address to RAS
-    if (ras_.size() >= rasSize_) {
-      ras_.pop_front();
+    // Register-indirect branches use the indirect target predictor
+    if (knownOffset == 0) {
+      prediction.target =
+          indirectPredictor_.predict(address, prediction.target);
     }
-    ras_.push_back(address + 4);
-    // Record that this address is a branch-and-link instruction
-    rasHistory_[address] = 0;
+    // Subroutine call branches must push their associated return address to RAS
+    pushRas(address + 4);
+    // Record that this branch is a branch-and-link instruction
+    entry.rasPushed = true;
   } else if (type == BranchType::Conditional) {
     if (!prediction.isTaken) prediction.target = address + 4;
   }
 
-  // Store the Pout and global history for correct update() --
-  // needs to be global history and not the hashed index as hashing loses
-  // information and the global history is required for updating perceptrons.
-  ftq_.emplace_back(Pout, globalHistory_);
+  // Store the Pout, global history and RAS interaction for correct update()
+  // and flush()
+  ftq_.push_back(entry);
 
   // Speculatively update the global history based on the direction
   // prediction being made
@@ -110,16 +145,14 @@ void PerceptronPredictor::update(uint64_t address, bool isTaken,
 
   // Retrieve the previous global history and branch direction prediction from
   // the front of the ftq (assumes branches are updated in program order).
-  int64_t prevPout = ftq_.front().first;
-  uint64_t prevGlobalHistory = ftq_.front().second;
+  int64_t prevPout = ftq_.front().dotProduct;
+  uint64_t prevGlobalHistory = ftq_.front().globalHistory;
   ftq_.pop_front();
 
   // Work out hashed index
   uint64_t hashedIndex =
       ((address >> 2) ^ prevGlobalHistory) & ((1ull << btbBits_) - 1);
 
-  std::vector<int8_t> perceptron = btb_[hashedIndex].first;
-
   // Work out the most recent prediction
   bool directionPrediction = (prevPout >= 0);
 
@@ -127,28 +160,24 @@ void PerceptronPredictor::update(uint64_t address, bool isTaken,
   // magnitude was not greater than the training threshold
   if ((directionPrediction != isTaken) ||
       (static_cast<uint64_t>(std::abs(prevPout)) < trainingThreshold_)) {
-    int8_t t = (isTaken) ? 1 : -1;
-
-    for (uint64_t i = 0; i < globalHistoryLength_; i++) {
-      int8_t xi = ((prevGlobalHistory &
-                    (1ull << ((globalHistoryLength_ - 1) - i))) == 0)
-                      ? -1
-                      : 1;
-      int8_t product_xi_t = xi * t;
-      // Make sure no overflow (+-127)
-      if (!(perceptron[i] == 127 && product_xi_t == 1) &&
-          !(perceptron[i] == -127 && product_xi_t == -1)) {
-        perceptron[i] += product_xi_t;
-      }
+    int16_t t = (isTaken) ? 1 : -1;
+    HistoryInputs inputs = getHistoryInputs(prevGlobalHistory);
+
+    // Move each weight towards agreeing with the outcome. Written without
+    // branches so that it may be vectorised
+    int8_t* perceptron = &weights_[hashedIndex * maxHistoryLength_];
+    for (uint8_t i = 0; i < maxHistoryLength_; i++) {
+      perceptron[i] = saturateWeight(perceptron[i] + inputs[i] * t);
     }
-    perceptron[globalHistoryLength_] += t;
+    biases_[hashedIndex] = saturateWeight(biases_[hashedIndex] + t);
   }
 
-  btb_[hashedIndex].first = perceptron;
   if (isTaken) {
-    btb_[hashedIndex].second = targetAddress;
+    btbTargets_[hashedIndex] = targetAddress;
   }
 
+  indirectPredictor_.update(address, targetAddress);
+
   // Update global history if prediction was incorrect
   // Bit-flip the global history bit corresponding to this prediction
   // We know how many predictions there have since been by the size of the FTQ
@@ -156,46 +185,67 @@ void PerceptronPredictor::update(uint64_t address, bool isTaken,
 }
 
 void PerceptronPredictor::flush(uint64_t address) {
-  // If address interacted with RAS, rewind entry
-  auto it = rasHistory_.find(address);
-  if (it != rasHistory_.end()) {
-    uint64_t target = it->second;
-    if (target != 0) {
-      // If history entry belongs to a return instruction, push target back onto
-      // stack
-      if (ras_.size() >= rasSize_) {
-        ras_.pop_front();
-      }
-      ras_.push_back(target);
-    } else {
-      // If history entry belongs to a branch-and-link instruction, pop target
-      // off of stack
-      if (ras_.size()) {
-        ras_.pop_back();
-      }
-    }
-    rasHistory_.erase(it);
-  }
-
   assert((ftq_.size() > 0) &&
          "Cannot flush instruction from Branch Predictor "
          "when the ftq is empty");
+
+  // If the branch interacted with the RAS, rewind the entry
+  const FtqEntry& entry = ftq_.back();
+  if (entry.rasPopped != 0) {
+    // If the branch is a return instruction, push the target back onto the
+    // stack
+    pushRas(entry.rasPopped);
+  } else if (entry.rasPushed && rasCount_ > 0) {
+    // If the branch is a branch-and-link instruction, pop its target off of
+    // the stack
+    popRas();
+  }
+
   ftq_.pop_back();
+  indirectPredictor_.flush(address);
 
   // Roll back global history
   globalHistory_ >>= 1;
 }
 
-int64_t PerceptronPredictor::getDotProduct(
-    const std::vector<int8_t>& perceptron, uint64_t history) {
-  int64_t Pout = perceptron[globalHistoryLength_];
-  for (uint64_t i = 0; i < globalHistoryLength_; i++) {
-    // Get branch direction for ith entry in the history
-    bool historyTaken =
-        ((history & (1ull << ((globalHistoryLength_ - 1) - i))) != 0);
-    Pout += historyTaken ? perceptron[i] : (0 - perceptron[i]);
+PerceptronPredictor::HistoryInputs PerceptronPredictor::getHistoryInputs(
+    uint64_t history) const {
+  // Expand the history a byte at a time through a lookup table, rather than bit
+  // by bit, then mask off the inputs beyond the history length in use
+  HistoryInputs inputs;
+  for (uint8_t byte = 0; byte < maxHistoryLength_ / 8; byte++) {
+    const auto& byteInput = byteInputs[(history >> (byte * 8)) & 0xFF];
+    std::memcpy(&inputs[byte * 8], byteInput.data(), 8);
+  }
+  for (uint8_t i = 0; i < maxHistoryLength_; i++) {
+    inputs[i] &= historyLengthMask_[i];
+  }
+  return inputs;
+}
+
+int64_t PerceptronPredictor::getDotProduct(uint64_t index,
+                                           const HistoryInputs& inputs) const {
+  // A fixed-length multiply-accumulate over the padded perceptron, which the
+  // compiler may vectorise
+  const int8_t* perceptron = &weights_[index * maxHistoryLength_];
+  int32_t Pout = 0;
+  for (uint8_t i = 0; i < maxHistoryLength_; i++) {
+    Pout += perceptron[i] * inputs[i];
   }
-  return Pout;
+  return Pout + biases_[index];
+}
+
+void PerceptronPredictor::pushRas(uint64_t target) {
+  ras_[rasTop_] = target;
+  rasTop_ = (rasTop_ + 1) % rasSize_;
+  if (rasCount_ < rasSize_) rasCount_++;
+}
+
+uint64_t PerceptronPredictor::popRas() {
+  assert(rasCount_ > 0 && "Cannot pop from an empty RAS");
+  rasTop_ = (rasTop_ + rasSize_ - 1) % rasSize_;
+  rasCount_--;
+  return ras_[rasTop_];
 }
 
 }  // namespace simeng
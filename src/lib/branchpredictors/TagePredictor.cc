@@ -0,0 +1,354 @@
+#include "simeng/branchpredictors/TagePredictor.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simeng {
+
+TagePredictor::TagePredictor(ryml::ConstNodeRef config)
+    : btbBits_(config["Branch-Predictor"]["BTB-Tag-Bits"].as<uint8_t>()),
+      indexBits_(
+          config["Branch-Predictor"]["Tagged-Table-Index-Bits"].as<uint8_t>()),
+      tagBits_(
+          config["Branch-Predictor"]["Tagged-Table-Tag-Bits"].as<uint8_t>()),
+      rasSize_(config["Branch-Predictor"]["RAS-entries"].as<uint64_t>()),
+      indirectPredictor_(config) {
+  // Initialise the base predictor's counters as weakly taken, and the BTB
+  // targets as 0 (i.e., unknown)
+  base_.assign(1ull << btbBits_, 2);
+  btb_.assign(1ull << btbBits_, 0);
+
+  uint16_t tableCount =
+      config["Branch-Predictor"]["Tagged-Table-Count"].as<uint16_t>();
+  tables_.assign(tableCount, std::vector<TaggedEntry>(1ull << indexBits_));
+
+  // Derive the geometric series of history lengths between the minimum and
+  // maximum lengths configured
+  double minLength =
+      config["Branch-Predictor"]["Min-History-Length"].as<double>();
+  double maxLength =
+      config["Branch-Predictor"]["Max-History-Length"].as<double>();
+  for (uint16_t i = 0; i < tableCount; i++) {
+    double exponent =
+        (tableCount > 1) ? static_cast<double>(i) / (tableCount - 1) : 1.0;
+    historyLengths_.push_back(static_cast<uint16_t>(
+        std::round(minLength * std::pow(maxLength / minLength, exponent))));
+  }
+
+  // Record twice the longest history length, to allow rolling back of the
+  // speculatively updated global history in the event of a misprediction
+  globalHistoryCapacity_ = 2 * historyLengths_.back();
+  globalHistory_.assign((globalHistoryCapacity_ + 63) / 64, 0);
+}
+
+TagePredictor::~TagePredictor() {
+  ras_.clear();
+  rasHistory_.clear();
+  ftq_.clear();
+}
+
+BranchPrediction TagePredictor::predict(uint64_t address, BranchType type,
+                                        int64_t knownOffset) {
+  FtqEntry entry;
+  entry.indices.resize(tables_.size());
+  entry.tags.resize(tables_.size());
+
+  // Hash the address with the folded global history of each table's length.
+  // The address is shifted to remove the two least-significant bits as these
+  // are always 0 in an ISA with 4-byte aligned instructions.
+  uint64_t pc = address >> 2;
+  uint64_t indexMask = (1ull << indexBits_) - 1;
+  uint64_t tagMask = (1ull << tagBits_) - 1;
+  for (size_t table = 0; table < tables_.size(); table++) {
+    uint16_t length = historyLengths_[table];
+    entry.indices[table] =
+        (pc ^ (pc >> indexBits_) ^ foldHistory(length, indexBits_)) &
+        indexMask;
+    entry.tags[table] = (pc ^ foldHistory(length, tagBits_) ^
+                         (foldHistory(length, tagBits_ - 1) << 1)) &
+                        tagMask;
+  }
+
+  // The provider is the matching table with the longest history, and the
+  // alternate the next longest; the base predictor stands in for either when
+  // there's no such match
+  entry.provider = -1;
+  entry.altProvider = -1;
+  for (int8_t table = tables_.size() - 1; table >= 0; table--) {
+    const TaggedEntry& tagged = tables_[table][entry.indices[table]];
+    if (tagged.valid && tagged.tag == entry.tags[table]) {
+      if (entry.provider < 0) {
+        entry.provider = table;
+      } else {
+        entry.altProvider = table;
+        break;
+      }
+    }
+  }
+
+  entry.providerTaken = getTableTaken(entry.provider, address, entry);
+  entry.altTaken = getTableTaken(entry.altProvider, address, entry);
+  entry.predictedTaken = entry.providerTaken;
+  if (entry.provider >= 0) {
+    // A newly allocated entry has a weak counter and has yet to prove useful;
+    // its prediction is often less accurate than the alternate
+    const auto& provided =
+        tables_[entry.provider][entry.indices[entry.provider]];
+    bool newEntry = (provided.counter == 0 || provided.counter == -1) &&
+                    provided.useful == 0;
+    if (newEntry && useAltOnNewEntry_ >= 0) {
+      entry.predictedTaken = entry.altTaken;
+    }
+  }
+
+  // If there is a known offset then calculate target accordingly, otherwise
+  // retrieve the target prediction from the btb.
+  uint64_t target =
+      (knownOffset != 0) ? address + knownOffset : btb_[getBaseIndex(address)];
+
+  BranchPrediction prediction = {entry.predictedTaken, target};
+
+  // Amend prediction based on branch type
+  entry.conditional = false;
+  if (type == BranchType::Unconditional) {
+    prediction.isTaken = true;
+    // Register-indirect branches use the indirect target predictor
+    if (knownOffset == 0) {
+      prediction.target =
+          indirectPredictor_.predict(address, prediction.target);
+    }
+  } else if (type == BranchType::Return) {
+    prediction.isTaken = true;
+    // Return branches can use the RAS if an entry is available
+    if (ras_.size() > 0) {
+      prediction.target = ras_.back();
+      // Record top of RAS used for target prediction
+      rasHistory_[address] = ras_.back();
+      ras_.pop_back();
+    }
+  } else if (type == BranchType::SubroutineCall) {
+    prediction.isTaken = true;
+    // Register-indirect branches use the indirect target predictor
+    if (knownOffset == 0) {
+      prediction.target =
+          indirectPredictor_.predict(address, prediction.target);
+    }
+    // Subroutine call branches must push their associated return address to RAS
+    if (ras_.size() >= rasSize_) {
+      ras_.pop_front();
+    }
+    ras_.push_back(address + 4);
+    // Record that this address is a branch-and-link instruction
+    rasHistory_[address] = 0;
+  } else {
+    entry.conditional = true;
+    if (type == BranchType::Conditional && !prediction.isTaken) {
+      prediction.target = address + 4;
+    }
+  }
+
+  // Store the table indices and tags, and the predictions made, for a correct
+  // update()
+  entry.historyBit = prediction.isTaken;
+  ftq_.push_back(std::move(entry));
+
+  // Speculatively update the global history based on the direction
+  // prediction being made
+  pushHistory(prediction.isTaken);
+
+  return prediction;
+}
+
+void TagePredictor::update(uint64_t address, bool isTaken,
+                           uint64_t targetAddress, BranchType type,
+                           uint64_t instructionId) {
+  // Make sure that this function is called in program order; and then update
+  // the lastUpdatedInstructionId variable
+  assert(instructionId >= lastUpdatedInstructionId_ &&
+         (lastUpdatedInstructionId_ = instructionId) >= 0 &&
+         "Update not called on branch instructions in program order");
+
+  // Retrieve the predictor state at the time of prediction from the front of
+  // the ftq (assumes branches are updated in program order).
+  FtqEntry entry = std::move(ftq_.front());
+  ftq_.pop_front();
+
+  if (entry.conditional) {
+    if (entry.provider >= 0) {
+      TaggedEntry& provided =
+          tables_[entry.provider][entry.indices[entry.provider]];
+      bool newEntry = (provided.counter == 0 || provided.counter == -1) &&
+                      provided.useful == 0;
+      if (entry.providerTaken != entry.altTaken) {
+        // Learn whether the alternate prediction is the more accurate for
+        // newly allocated entries
+        if (newEntry) {
+          if (entry.altTaken == isTaken) {
+            useAltOnNewEntry_ = std::min(useAltOnNewEntry_ + 1, 7);
+          } else {
+            useAltOnNewEntry_ = std::max(useAltOnNewEntry_ - 1, -8);
+          }
+        }
+        // The provider is useful when it corrects the alternate prediction
+        if (entry.providerTaken == isTaken) {
+          if (provided.useful < 3) provided.useful++;
+        } else if (provided.useful > 0) {
+          provided.useful--;
+        }
+      }
+      // Train the alternate whilst the provider has yet to prove useful
+      if (provided.useful == 0) {
+        trainCounter(entry.altProvider, address, entry, isTaken);
+      }
+    }
+    trainCounter(entry.provider, address, entry, isTaken);
+
+    if (entry.predictedTaken != isTaken) allocate(entry, isTaken);
+
+    // Periodically age the usefulness counters, so that entries no longer of
+    // use may be replaced
+    if (++updatesSinceAging_ == agingPeriod_) {
+      for (auto& table : tables_) {
+        for (auto& tagged : table) {
+          tagged.useful >>= 1;
+        }
+      }
+      updatesSinceAging_ = 0;
+    }
+  }
+
+  if (isTaken) {
+    btb_[getBaseIndex(address)] = targetAddress;
+  }
+
+  indirectPredictor_.update(address, targetAddress);
+
+  // Update global history if prediction was incorrect
+  // Bit-flip the global history bit corresponding to this prediction
+  // We know how many predictions there have since been by the size of the FTQ
+  if (entry.historyBit != isTaken && ftq_.size() < globalHistoryCapacity_) {
+    globalHistory_[ftq_.size() / 64] ^= (1ull << (ftq_.size() % 64));
+  }
+}
+
+void TagePredictor::flush(uint64_t address) {
+  // If address interacted with RAS, rewind entry
+  auto it = rasHistory_.find(address);
+  if (it != rasHistory_.end()) {
+    uint64_t target = it->second;
+    if (target != 0) {
+      // If history entry belongs to a return instruction, push target back onto
+      // stack
+      if (ras_.size() >= rasSize_) {
+        ras_.pop_front();
+      }
+      ras_.push_back(target);
+    } else {
+      // If history entry belongs to a branch-and-link instruction, pop target
+      // off of stack
+      if (ras_.size()) {
+        ras_.pop_back();
+      }
+    }
+    rasHistory_.erase(it);
+  }
+
+  assert((ftq_.size() > 0) &&
+         "Cannot flush instruction from Branch Predictor "
+         "when the ftq is empty");
+  ftq_.pop_back();
+  indirectPredictor_.flush(address);
+
+  // Roll back global history
+  for (size_t word = 0; word + 1 < globalHistory_.size(); word++) {
+    globalHistory_[word] =
+        (globalHistory_[word] >> 1) | (globalHistory_[word + 1] << 63);
+  }
+  globalHistory_.back() >>= 1;
+}
+
+const std::vector<uint16_t>& TagePredictor::getHistoryLengths() const {
+  return historyLengths_;
+}
+
+uint64_t TagePredictor::foldHistory(uint16_t length, uint8_t bits) const {
+  // XOR together the words holding the most recent `length` bits
+  uint64_t folded = 0;
+  for (uint16_t word = 0; word * 64 < length; word++) {
+    uint64_t value = globalHistory_[word];
+    uint16_t valid = length - word * 64;
+    if (valid < 64) value &= (1ull << valid) - 1;
+    folded ^= value;
+  }
+
+  // Fold the resulting word down to the number of bits requested
+  uint64_t result = 0;
+  for (; folded != 0; folded >>= bits) {
+    result ^= folded & ((1ull << bits) - 1);
+  }
+  return result;
+}
+
+uint64_t TagePredictor::getBaseIndex(uint64_t address) const {
+  return (address >> 2) & ((1ull << btbBits_) - 1);
+}
+
+bool TagePredictor::getTableTaken(int8_t table, uint64_t address,
+                                  const FtqEntry& entry) const {
+  if (table < 0) return base_[getBaseIndex(address)] >= 2;
+  return tables_[table][entry.indices[table]].counter >= 0;
+}
+
+void TagePredictor::trainCounter(int8_t table, uint64_t address,
+                                 const FtqEntry& entry, bool isTaken) {
+  if (table < 0) {
+    uint8_t& counter = base_[getBaseIndex(address)];
+    if (isTaken && counter < 3) {
+      counter++;
+    } else if (!isTaken && counter > 0) {
+      counter--;
+    }
+    return;
+  }
+
+  int8_t& counter = tables_[table][entry.indices[table]].counter;
+  if (isTaken && counter < 3) {
+    counter++;
+  } else if (!isTaken && counter > -4) {
+    counter--;
+  }
+}
+
+void TagePredictor::allocate(const FtqEntry& entry, bool isTaken) {
+  // Claim the first entry not in use amongst the tables with a longer history
+  // than the provider, initialised weakly towards the branch outcome
+  for (size_t table = entry.provider + 1; table < tables_.size(); table++) {
+    TaggedEntry& candidate = tables_[table][entry.indices[table]];
+    if (candidate.useful == 0) {
+      candidate.valid = true;
+      candidate.tag = entry.tags[table];
+      candidate.counter = isTaken ? 0 : -1;
+      return;
+    }
+  }
+
+  // Should no entry be free, age the candidates so one may be claimed later
+  for (size_t table = entry.provider + 1; table < tables_.size(); table++) {
+    TaggedEntry& candidate = tables_[table][entry.indices[table]];
+    candidate.useful--;
+  }
+}
+
+void TagePredictor::pushHistory(bool taken) {
+  for (size_t word = globalHistory_.size() - 1; word > 0; word--) {
+    globalHistory_[word] =
+        (globalHistory_[word] << 1) | (globalHistory_[word - 1] >> 63);
+  }
+  globalHistory_[0] = (globalHistory_[0] << 1) | taken;
+
+  // Discard the bits beyond the capacity of the global history
+  uint32_t topBits = globalHistoryCapacity_ % 64;
+  if (topBits != 0) globalHistory_.back() &= (1ull << topBits) - 1;
+}
+
+}  // namespace simeng
@@ -379,6 +379,21 @@ void ModelConfig::setExpectations(bool isDefault) {
         std::vector<uint64_t>{128, 256, 512, 1024, 2048});
   }
 
+  // An empty branch trace file path disables branch trace recording
+  expectations_["Core"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Branch-Trace-File",
+                                                      true));
+
+  // An empty profile file path disables hotspot profiling
+  expectations_["Core"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Profile-File",
+                                                      true));
+
+  // An empty top-down file path disables writing the top-down breakdown
+  expectations_["Core"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Top-Down-File",
+                                                      true));
+
   // Fetch
   expectations_.addChild(ExpectationNode::createExpectation("Fetch"));
 
@@ -397,6 +412,29 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Fetch"]["Loop-Detection-Threshold"].setValueBounds<uint16_t>(
       0, UINT16_MAX);
 
+  // A micro-op cache capacity of 0 disables the micro-op cache
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint32_t>(
+      0, "Micro-Op-Cache-Capacity", true));
+  expectations_["Fetch"]["Micro-Op-Cache-Capacity"].setValueBounds<uint32_t>(
+      0, UINT32_MAX);
+
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      8, "Micro-Op-Cache-Associativity", true));
+  expectations_["Fetch"]["Micro-Op-Cache-Associativity"]
+      .setValueBounds<uint16_t>(1, UINT16_MAX);
+
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      6, "Micro-Op-Cache-Line-Size", true));
+  expectations_["Fetch"]["Micro-Op-Cache-Line-Size"].setValueBounds<uint16_t>(
+      1, UINT16_MAX);
+
+  // A fetch target queue size of 0 couples branch prediction to fetch, with no
+  // instruction prefetching
+  expectations_["Fetch"].addChild(ExpectationNode::createExpectation<uint16_t>(
+      0, "Fetch-Target-Queue-Size", true));
+  expectations_["Fetch"]["Fetch-Target-Queue-Size"].setValueBounds<uint16_t>(
+      0, UINT16_MAX);
+
   // Process-Image
   expectations_.addChild(ExpectationNode::createExpectation("Process-Image"));
 
@@ -410,6 +448,15 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Process-Image"]["Stack-Size"].setValueBounds<uint64_t>(
       1, UINT64_MAX);
 
+  expectations_["Process-Image"].addChild(
+      ExpectationNode::createExpectation<uint64_t>(1, "OpenMP-Threads", true));
+  expectations_["Process-Image"]["OpenMP-Threads"].setValueBounds<uint64_t>(
+      1, UINT16_MAX);
+
+  expectations_["Process-Image"].addChild(
+      ExpectationNode::createExpectation<std::string>("", "Input-Overlay-Dir",
+                                                      true));
+
   // Register-Set
   expectations_.addChild(ExpectationNode::createExpectation("Register-Set"));
   if (isa_ == ISA::AArch64) {
@@ -497,6 +544,18 @@ void ModelConfig::setExpectations(bool isDefault) {
       ExpectationNode::createExpectation<uint32_t>(16, "Store"));
   expectations_["Queue-Sizes"]["Store"].setValueBounds<uint32_t>(1, UINT32_MAX);
 
+  expectations_["Queue-Sizes"].addChild(
+      ExpectationNode::createExpectation<uint32_t>(0, "Store-Set-ID-Table",
+                                                   true));
+  expectations_["Queue-Sizes"]["Store-Set-ID-Table"].setValueBounds<uint32_t>(
+      0, UINT32_MAX);
+
+  expectations_["Queue-Sizes"].addChild(
+      ExpectationNode::createExpectation<uint32_t>(
+          128, "Last-Fetched-Store-Table", true));
+  expectations_["Queue-Sizes"]["Last-Fetched-Store-Table"]
+      .setValueBounds<uint32_t>(1, UINT32_MAX);
+
   // Branch-Predictor
   expectations_.addChild(
       ExpectationNode::createExpectation("Branch-Predictor"));
@@ -504,7 +563,7 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Branch-Predictor"].addChild(
       ExpectationNode::createExpectation<std::string>("Perceptron", "Type"));
   expectations_["Branch-Predictor"]["Type"].setValueSet(
-      std::vector<std::string>{"Generic", "Perceptron"});
+      std::vector<std::string>{"Generic", "Perceptron", "TAGE"});
 
   expectations_["Branch-Predictor"].addChild(
       ExpectationNode::createExpectation<uint8_t>(8, "BTB-Tag-Bits"));
@@ -521,8 +580,34 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Branch-Predictor"]["RAS-entries"].setValueBounds<uint16_t>(
       1, UINT16_MAX);
 
-  // The saturating counter bits and the fallback predictor
-  // are relevant to the GenericPredictor only
+  // An indirect table count of 0 disables the indirect target predictor
+  expectations_["Branch-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(0, "Indirect-Table-Count",
+                                                   true));
+  expectations_["Branch-Predictor"]["Indirect-Table-Count"]
+      .setValueBounds<uint16_t>(0, 32);
+
+  expectations_["Branch-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint8_t>(
+          9, "Indirect-Table-Index-Bits", true));
+  expectations_["Branch-Predictor"]["Indirect-Table-Index-Bits"]
+      .setValueBounds<uint8_t>(1, 24);
+
+  expectations_["Branch-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint8_t>(
+          9, "Indirect-Table-Tag-Bits", true));
+  expectations_["Branch-Predictor"]["Indirect-Table-Tag-Bits"]
+      .setValueBounds<uint8_t>(1, 16);
+
+  expectations_["Branch-Predictor"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(
+          16, "Indirect-History-Length", true));
+  expectations_["Branch-Predictor"]["Indirect-History-Length"]
+      .setValueBounds<uint16_t>(1, 1024);
+
+  // The saturating counter bits and the fallback predictor are relevant to the
+  // GenericPredictor only, and the tagged table parameters to the
+  // TagePredictor only
   if (!isDefault) {
     // Ensure the key "Branch-Predictor" exists before querying the associated
     // YAML node
@@ -544,6 +629,37 @@ void ModelConfig::setExpectations(bool isDefault) {
           expectations_["Branch-Predictor"]["Fallback-Static-Predictor"]
               .setValueSet(
                   std::vector<std::string>{"Always-Taken", "Always-Not-Taken"});
+        } else if (configTree_["Branch-Predictor"]["Type"].as<std::string>() ==
+                   "TAGE") {
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint16_t>(
+                  4, "Tagged-Table-Count"));
+          expectations_["Branch-Predictor"]["Tagged-Table-Count"]
+              .setValueBounds<uint16_t>(1, 32);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(
+                  10, "Tagged-Table-Index-Bits"));
+          expectations_["Branch-Predictor"]["Tagged-Table-Index-Bits"]
+              .setValueBounds<uint8_t>(1, 24);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint8_t>(
+                  9, "Tagged-Table-Tag-Bits"));
+          expectations_["Branch-Predictor"]["Tagged-Table-Tag-Bits"]
+              .setValueBounds<uint8_t>(2, 16);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint16_t>(
+                  4, "Min-History-Length"));
+          expectations_["Branch-Predictor"]["Min-History-Length"]
+              .setValueBounds<uint16_t>(1, 1024);
+
+          expectations_["Branch-Predictor"].addChild(
+              ExpectationNode::createExpectation<uint16_t>(
+                  64, "Max-History-Length"));
+          expectations_["Branch-Predictor"]["Max-History-Length"]
+              .setValueBounds<uint16_t>(1, 1024);
         }
       } else {
         std::cerr << "[SimEng:ModelConfig] Attempted to access config key "
@@ -635,6 +751,24 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["LSQ-L1-Interface"]["Permitted-Stores-Per-Cycle"]
       .setValueBounds<uint16_t>(1, UINT16_MAX);
 
+  expectations_["LSQ-L1-Interface"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(64, "Cache-Line-Width",
+                                                   true));
+  expectations_["LSQ-L1-Interface"]["Cache-Line-Width"].setValueSet(
+      std::vector<uint16_t>{16, 32, 64, 128, 256, 512, 1024});
+
+  expectations_["LSQ-L1-Interface"].addChild(
+      ExpectationNode::createExpectation<bool>(false, "Coalesce-Requests",
+                                               true));
+  expectations_["LSQ-L1-Interface"]["Coalesce-Requests"].setValueSet(
+      std::vector{false, true});
+
+  expectations_["LSQ-L1-Interface"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(4, "Forwarding-Latency",
+                                                   true));
+  expectations_["LSQ-L1-Interface"]["Forwarding-Latency"]
+      .setValueBounds<uint16_t>(1, UINT16_MAX);
+
   // Ports
   expectations_.addChild(ExpectationNode::createExpectation("Ports"));
   expectations_["Ports"].addChild(
@@ -722,6 +856,92 @@ void ModelConfig::setExpectations(bool isDefault) {
       portnames);
   expectations_["Reservation-Stations"][wildcard]["Ports"].setAsSequence();
 
+  // Port-Allocator
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Port-Allocator", true));
+
+  expectations_["Port-Allocator"].addChild(
+      ExpectationNode::createExpectation<std::string>("Balanced", "Type",
+                                                      true));
+  expectations_["Port-Allocator"]["Type"].setValueSet(
+      std::vector<std::string>{"Balanced", "Table"});
+
+  if (!isDefault) {
+    // Only expect the allocation rules of a table-driven port allocator
+    if (configTree_.rootref().has_child(ryml::to_csubstr("Port-Allocator")) &&
+        configTree_["Port-Allocator"].has_child(ryml::to_csubstr("Type")) &&
+        configTree_["Port-Allocator"]["Type"].as<std::string>() == "Table") {
+      expectations_["Port-Allocator"].addChild(
+          ExpectationNode::createExpectation("Rules"));
+      expectations_["Port-Allocator"]["Rules"].addChild(
+          ExpectationNode::createExpectation<uint16_t>(0, wildcard));
+      ExpectationNode& rule =
+          expectations_["Port-Allocator"]["Rules"][wildcard];
+
+      rule.addChild(
+          ExpectationNode::createExpectation<std::string>("0", "Ports"));
+      rule["Ports"].setValueSet(portnames);
+      rule["Ports"].setAsSequence();
+
+      rule.addChild(ExpectationNode::createExpectation("Cases"));
+      rule["Cases"].addChild(
+          ExpectationNode::createExpectation<uint16_t>(0, wildcard));
+      ExpectationNode& ruleCase = rule["Cases"][wildcard];
+
+      // The conditions of a case on the free reservation station entries. An
+      // omitted sequence of stations is represented by UINT16_MAX
+      ruleCase.addChild(ExpectationNode::createExpectation("Conditions", true));
+      ruleCase["Conditions"].addChild(
+          ExpectationNode::createExpectation<uint16_t>(0, wildcard));
+      ExpectationNode& cond = ruleCase["Conditions"][wildcard];
+      for (std::string key : {"Stations", "Minus", "Most-Free", "In"}) {
+        cond.addChild(ExpectationNode::createExpectation<uint16_t>(UINT16_MAX,
+                                                                   key, true));
+        cond[key].setValueBounds<uint16_t>(0, UINT16_MAX);
+        cond[key].setAsSequence();
+      }
+      cond.addChild(ExpectationNode::createExpectation<int32_t>(
+          INT32_MIN, "At-Least", true));
+      cond["At-Least"].setValueBounds<int32_t>(INT32_MIN, INT32_MAX);
+      cond.addChild(ExpectationNode::createExpectation<int32_t>(
+          INT32_MAX, "At-Most", true));
+      cond["At-Most"].setValueBounds<int32_t>(INT32_MIN, INT32_MAX);
+
+      // The table of reservation stations supplied by a case
+      ruleCase.addChild(ExpectationNode::createExpectation("Table"));
+      ruleCase["Table"].addChild(
+          ExpectationNode::createExpectation<uint16_t>(0, wildcard));
+      ExpectationNode& entry = ruleCase["Table"][wildcard];
+      entry.addChild(
+          ExpectationNode::createExpectation<uint16_t>(0, "Stations"));
+      entry["Stations"].setValueBounds<uint16_t>(0, UINT16_MAX);
+      entry["Stations"].setAsSequence();
+      entry.addChild(
+          ExpectationNode::createExpectation<uint16_t>(0, "Rank", true));
+      entry["Rank"].setValueBounds<uint16_t>(0, UINT16_MAX);
+    }
+  }
+
+  // Hardware-Threads
+  expectations_.addChild(
+      ExpectationNode::createExpectation("Hardware-Threads", true));
+
+  expectations_["Hardware-Threads"].addChild(
+      ExpectationNode::createExpectation<uint16_t>(1, "Count", true));
+  expectations_["Hardware-Threads"]["Count"].setValueBounds<uint16_t>(1, 4);
+
+  expectations_["Hardware-Threads"].addChild(
+      ExpectationNode::createExpectation<std::string>("RoundRobin",
+                                                      "Fetch-Policy", true));
+  expectations_["Hardware-Threads"]["Fetch-Policy"].setValueSet(
+      std::vector<std::string>{"RoundRobin", "ICount"});
+
+  expectations_["Hardware-Threads"].addChild(
+      ExpectationNode::createExpectation<std::string>("RoundRobin",
+                                                      "Commit-Policy", true));
+  expectations_["Hardware-Threads"]["Commit-Policy"].setValueSet(
+      std::vector<std::string>{"RoundRobin", "Shared"});
+
   // Execution-Units
   expectations_.addChild(ExpectationNode::createExpectation("Execution-Units"));
   expectations_["Execution-Units"].addChild(
@@ -769,6 +989,39 @@ void ModelConfig::setExpectations(bool isDefault) {
   expectations_["Latencies"][wildcard]["Execution-Throughput"]
       .setValueBounds<uint16_t>(1, UINT16_MAX);
 
+  // Macro-Op-Fusion
+  if (!isDefault &&
+      configTree_.rootref().has_child(ryml::to_csubstr("Macro-Op-Fusion"))) {
+    expectations_.addChild(
+        ExpectationNode::createExpectation("Macro-Op-Fusion", true));
+    expectations_["Macro-Op-Fusion"].addChild(
+        ExpectationNode::createExpectation<uint16_t>(0, wildcard));
+    ExpectationNode& rule = expectations_["Macro-Op-Fusion"][wildcard];
+
+    for (std::string position : {"First", "Second"}) {
+      std::string groupsKey = position + "-Instruction-Groups";
+      rule.addChild(ExpectationNode::createExpectation<std::string>(
+          "NONE", groupsKey, true));
+      rule[groupsKey].setValueSet(groupOptions_);
+      rule[groupsKey].setAsSequence();
+
+      std::string opcodesKey = position + "-Instruction-Opcodes";
+      rule.addChild(ExpectationNode::createExpectation<uint16_t>(
+          maxOpcode, opcodesKey, true));
+      rule[opcodesKey].setValueBounds<uint16_t>(0, maxOpcode);
+      rule[opcodesKey].setAsSequence();
+    }
+
+    rule.addChild(ExpectationNode::createExpectation<bool>(
+        false, "Shared-Destination", true));
+    rule["Shared-Destination"].setValueSet(std::vector{false, true});
+
+    // An execution latency of 0 takes that of the second instruction
+    rule.addChild(ExpectationNode::createExpectation<uint16_t>(
+        0, "Execution-Latency", true));
+    rule["Execution-Latency"].setValueBounds<uint16_t>(0, UINT16_MAX);
+  }
+
   // CPU-Info
   expectations_.addChild(ExpectationNode::createExpectation("CPU-Info"));
 
@@ -888,6 +1141,12 @@ void ModelConfig::recursiveValidate(ExpectationNode expectation,
       if (!result.valid)
         invalid_ << "\t- "
                  << hierarchyString + nodeKey + " " + result.message + "\n";
+      // The port allocator type is read regardless of whether the section is
+      // present, so inject the defaults of its options should it be missing
+      if (nodeKey == "Port-Allocator") {
+        rymlChild |= ryml::MAP;
+        recursiveValidate(child, rymlChild, hierarchyString + nodeKey + ":");
+      }
     }
   }
 }
@@ -973,6 +1232,45 @@ void ModelConfig::postValidation() {
     }
   }
 
+  // Convert the groups of each macro-op fusion rule to their group numbers,
+  // expanded to include the groups that inherit from them
+  if (configTree_.rootref().has_child(ryml::to_csubstr("Macro-Op-Fusion"))) {
+    std::unordered_map<uint16_t, std::vector<uint16_t>> groupInheritance;
+    if (isa_ == ISA::AArch64) {
+      groupInheritance = arch::aarch64::groupInheritance_;
+    } else if (isa_ == ISA::RV64) {
+      groupInheritance = arch::riscv::groupInheritance_;
+    }
+    for (ryml::NodeRef node : configTree_["Macro-Op-Fusion"]) {
+      for (const auto& [groupsKey, numsKey] :
+           {std::pair{"First-Instruction-Groups",
+                      "First-Instruction-Group-Nums"},
+            std::pair{"Second-Instruction-Groups",
+                      "Second-Instruction-Group-Nums"}}) {
+        // Clear or create a new Instruction-Group-Nums config option
+        ryml::csubstr nums = ryml::to_csubstr(numsKey);
+        if (node.has_child(nums)) {
+          node[nums].clear_children();
+        } else {
+          node.append_child() << ryml::key(nums) |= ryml::SEQ;
+        }
+        std::queue<uint16_t> groups;
+        for (ryml::NodeRef child : node[ryml::to_csubstr(groupsKey)]) {
+          groups.push(groupMapping_[child.as<std::string>()]);
+        }
+        while (groups.size()) {
+          node[nums].append_child() << groups.front();
+          if (groupInheritance.find(groups.front()) != groupInheritance.end()) {
+            for (uint16_t inherited : groupInheritance.at(groups.front())) {
+              groups.push(inherited);
+            }
+          }
+          groups.pop();
+        }
+      }
+    }
+  }
+
   // Ensure all execution ports have an associated reservation station and
   // convert port strings to their associated port indexes
   if (configTree_["Ports"].num_children() !=
@@ -1015,6 +1313,71 @@ void ModelConfig::postValidation() {
   for (const auto& prt : portnames)
     invalid_ << "\t- " << prt << " has no associated reservation station\n";
 
+  // Convert the port strings of each table-driven port allocation rule to
+  // their associated port indexes, and ensure the reservation stations
+  // referenced are valid for the rule
+  if (configTree_["Port-Allocator"]["Type"].as<std::string>() == "Table") {
+    uint16_t rsCount = configTree_["Reservation-Stations"].num_children();
+    if (configTree_["Ports"].num_children() > 64) {
+      invalid_ << "\t- A table-driven port allocator supports at most 64 "
+                  "ports\n";
+    }
+    // Map each port index to its reservation station
+    std::unordered_map<uint16_t, uint16_t> portStations;
+    for (uint16_t rs = 0; rs < rsCount; rs++) {
+      for (ryml::NodeRef port :
+           configTree_["Reservation-Stations"][rs]["Port-Nums"]) {
+        portStations[port.as<uint16_t>()] = rs;
+      }
+    }
+    for (ryml::NodeRef node : configTree_["Port-Allocator"]["Rules"]) {
+      std::string rule =
+          "Port-Allocator:Rules:" +
+          std::string(node.key().data(), node.key().size());
+      // Clear or create a new Port-Nums config option
+      if (node.has_child("Port-Nums")) {
+        node["Port-Nums"].clear_children();
+      } else {
+        node.append_child() << ryml::key("Port-Nums") |= ryml::SEQ;
+      }
+      std::vector<uint16_t> ruleStations;
+      for (ryml::NodeRef port : node["Ports"]) {
+        uint16_t portNum = portIndexes[port.as<std::string>()];
+        node["Port-Nums"].append_child() << portNum;
+        ruleStations.push_back(portStations[portNum]);
+      }
+      for (ryml::NodeRef ruleCase : node["Cases"]) {
+        for (ryml::NodeRef cond : ruleCase["Conditions"]) {
+          for (const char* key : {"Stations", "Minus", "Most-Free", "In"}) {
+            for (ryml::NodeRef rs : cond[ryml::to_csubstr(key)]) {
+              uint16_t station = rs.as<uint16_t>();
+              if (station != UINT16_MAX && station >= rsCount) {
+                invalid_ << "\t- " << rule << " references reservation "
+                         << "station " << station << " which doesn't exist\n";
+              }
+            }
+          }
+        }
+        for (ryml::NodeRef entry : ruleCase["Table"]) {
+          if (entry["Rank"].as<uint16_t>() >=
+              entry["Stations"].num_children()) {
+            invalid_ << "\t- " << rule << " has a table entry whose Rank "
+                     << "exceeds its number of Stations\n";
+          }
+          for (ryml::NodeRef rs : entry["Stations"]) {
+            uint16_t station = rs.as<uint16_t>();
+            if (std::find(ruleStations.begin(), ruleStations.end(), station) ==
+                ruleStations.end()) {
+              invalid_ << "\t- " << rule << " has a table entry with "
+                       << "reservation station " << station
+                       << " which holds none of the rule's ports\n";
+            }
+          }
+        }
+      }
+    }
+  }
+
   // Ensure that given special file directory exists iff auto-generation is
   // False
   if (!configTree_["CPU-Info"]["Generate-Special-Dir"].as<bool>() &&
@@ -1027,6 +1390,14 @@ void ModelConfig::postValidation() {
         << "' does not exist\n";
   }
 
+  // Ensure that any given input overlay directory exists
+  std::string overlayDir =
+      configTree_["Process-Image"]["Input-Overlay-Dir"].as<std::string>();
+  if (!overlayDir.empty() && !std::ifstream(overlayDir).good()) {
+    invalid_ << "\t- Input Overlay Directory '" << overlayDir
+             << "' does not exist\n";
+  }
+
   // Ensure the L1-[Data|Instruction]-Memory:Interface-Type restrictions are
   // enforced
   std::string simMode =
@@ -1043,6 +1414,55 @@ void ModelConfig::postValidation() {
                << l1dType << "\n";
   }
 
+  // Several hardware threads may only be run by an outoforder core, whose
+  // physical register files are partitioned between them
+  uint16_t threadCount = 1;
+  if (configTree_["Hardware-Threads"].is_map() &&
+      configTree_["Hardware-Threads"].has_child(ryml::to_csubstr("Count"))) {
+    threadCount = configTree_["Hardware-Threads"]["Count"].as<uint16_t>();
+  }
+  if (threadCount > 1) {
+    if (simMode != "outoforder") {
+      invalid_ << "\t- Only the outoforder Simulation-Mode supports more than "
+                  "one hardware thread\n";
+    }
+    if (configTree_["L1-Data-Memory"]["Interface-Type"].as<std::string>() ==
+        "External") {
+      invalid_ << "\t- An External L1-Data-Memory Interface-Type doesn't "
+                  "support more than one hardware thread\n";
+    }
+    for (ryml::NodeRef node : configTree_["Register-Set"]) {
+      if (node.as<uint64_t>() * threadCount > UINT16_MAX) {
+        invalid_ << "\t- Register-Set:"
+                 << std::string(node.key().data(), node.key().size())
+                 << " multiplied by the number of hardware threads must not "
+                    "exceed "
+                 << UINT16_MAX << "\n";
+      }
+    }
+  }
+
+  // The history lengths of a TAGE predictor's tagged tables must increase
+  if (configTree_["Branch-Predictor"]["Type"].as<std::string>() == "TAGE" &&
+      configTree_["Branch-Predictor"]["Min-History-Length"].as<uint16_t>() >
+          configTree_["Branch-Predictor"]["Max-History-Length"]
+              .as<uint16_t>()) {
+    invalid_ << "\t- Min-History-Length must not be greater than "
+                "Max-History-Length\n";
+  }
+
+  // A micro-op cache must be divisible into whole sets of lines
+  uint32_t uopCacheCapacity =
+      configTree_["Fetch"]["Micro-Op-Cache-Capacity"].as<uint32_t>();
+  uint32_t uopCacheSetSize =
+      configTree_["Fetch"]["Micro-Op-Cache-Associativity"].as<uint32_t>() *
+      configTree_["Fetch"]["Micro-Op-Cache-Line-Size"].as<uint32_t>();
+  if (uopCacheCapacity % uopCacheSetSize != 0) {
+    invalid_ << "\t- Micro-Op-Cache-Capacity must be a multiple of "
+                "Micro-Op-Cache-Associativity multiplied by "
+                "Micro-Op-Cache-Line-Size\n";
+  }
+
   // Currently, only a Flat L1-Instruction-Memory:Interface-Type is supported
   std::string l1iType =
       configTree_["L1-Instruction-Memory"]["Interface-Type"].as<std::string>();
@@ -21,15 +21,26 @@ namespace kernel {
 void Linux::createProcess(const LinuxProcess& process) {
   assert(process.isValid() && "Attempted to use an invalid process");
   assert(processStates_.size() == 0 && "Multiple processes not yet supported");
-  processStates_.push_back({0,  // TODO: create unique PIDs
-                            process.getPath(), process.getHeapStart(),
-                            process.getHeapStart(),
-                            process.getInitialStackPointer(),
-                            process.getMmapStart(), process.getPageSize()});
+  // Place mmap allocations between the start of the mmap region and the
+  // initial stack pointer
+  uint64_t pageSize = process.getPageSize();
+  uint64_t mmapEnd = process.getInitialStackPointer() -
+                     (process.getInitialStackPointer() % pageSize);
+  processStates_.push_back(
+      {PROCESS_ID, process.getPath(), process.getHeapStart(),
+       process.getHeapStart(), process.getInitialStackPointer(),
+       process.getStackStart(), process.getMmapStart(), pageSize,
+       VirtualMemoryAreas(process.getMmapStart(), mmapEnd, pageSize)});
   processStates_.back().fileDescriptorTable.push_back(STDIN_FILENO);
   processStates_.back().fileDescriptorTable.push_back(STDOUT_FILENO);
   processStates_.back().fileDescriptorTable.push_back(STDERR_FILENO);
 
+  // The process begins with a single thread, sharing the process' ID
+  LinuxProcessState& state = processStates_.back();
+  state.threads.emplace(state.pid, LinuxThreadState{state.pid});
+  state.currentTid = state.pid;
+  state.nextTid = state.pid + 1;
+
   // Define vector of all currently supported special file paths & files.
   supportedSpecialFiles_.insert(
       supportedSpecialFiles_.end(),
@@ -82,6 +93,64 @@ std::string Linux::getSpecialFile(const std::string filename) {
   return filename;
 }
 
+const VirtualFile* Linux::findVirtualFile(int64_t vdfd,
+                                          const std::string& pathname,
+                                          std::string& path) const {
+  if (!fileSystem_ || fileSystem_->empty() || pathname.empty()) return nullptr;
+
+  if (pathname[0] == '/') {
+    path = pathname;
+  } else if (vdfd == -100) {
+    // Relative paths are resolved against the working directory, which is
+    // shared with the host
+    char workingDir[LINUX_PATH_MAX];
+    if (!::getcwd(workingDir, LINUX_PATH_MAX)) return nullptr;
+    path = std::string(workingDir) + "/" + pathname;
+  } else {
+    // Only paths relative to directories of the virtual filesystem are held
+    const auto& virtualFiles = processStates_[0].virtualFiles;
+    auto directory = virtualFiles.find(vdfd);
+    if (directory == virtualFiles.end()) return nullptr;
+    path = directory->second.path + "/" + pathname;
+  }
+  path = VirtualFileSystem::normalise(path);
+  return fileSystem_->find(path);
+}
+
+OpenVirtualFile* Linux::getVirtualFile(int64_t fd) {
+  auto& virtualFiles = processStates_[0].virtualFiles;
+  if (virtualFiles.empty()) return nullptr;
+  auto it = virtualFiles.find(fd);
+  return (it == virtualFiles.end()) ? nullptr : &it->second;
+}
+
+void Linux::statVirtualFile(const VirtualFile& file, stat& out) const {
+  // Files are read-only, and owned by root
+  out = {};
+  out.ino = file.inode;
+  out.mode = file.isDirectory ? (S_IFDIR | 0555) : (S_IFREG | 0444);
+  out.nlink = file.isDirectory ? 2 : 1;
+  out.size = file.isDirectory ? 0 : file.contents->size();
+  out.blksize = 4096;
+  out.blocks = (out.size + 511) / 512;
+}
+
+int64_t Linux::allocateFileDescriptor(int64_t hostFd) {
+  LinuxProcessState& processState = processStates_[0];
+  int64_t vfd;
+  if (!processState.freeFileDescriptors.empty()) {
+    // Take virtual descriptor from free pool
+    auto first = processState.freeFileDescriptors.begin();
+    vfd = processState.freeFileDescriptors.extract(first).value();
+    processState.fileDescriptorTable[vfd] = hostFd;
+  } else {
+    // Extend file descriptor table for a new virtual descriptor
+    vfd = processState.fileDescriptorTable.size();
+    processState.fileDescriptorTable.push_back(hostFd);
+  }
+  return vfd;
+}
+
 uint64_t Linux::getInitialStackPointer() const {
   assert(processStates_.size() > 0 &&
          "Attempted to retrieve a stack pointer before creating a process");
@@ -96,6 +165,17 @@ int64_t Linux::brk(uint64_t address) {
   auto& state = processStates_[0];
   // Move the break if it's within the heap region
   if (address > state.startBrk) {
+    // The heap is mapped as an area of whole pages, which mustn't grow into
+    // any other mapping
+    uint64_t oldEnd = alignToBoundary(state.currentBrk, state.pageSize);
+    uint64_t newEnd = alignToBoundary(address, state.pageSize);
+    if (newEnd > oldEnd) {
+      if (!state.memoryAreas.isFree(oldEnd, newEnd)) return state.currentBrk;
+      // PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS
+      state.memoryAreas.map(oldEnd, newEnd - oldEnd, 0x3, 0x22, true);
+    } else if (newEnd < oldEnd) {
+      state.memoryAreas.unmap(newEnd, oldEnd - newEnd);
+    }
     state.currentBrk = address;
   }
   return state.currentBrk;
@@ -119,6 +199,145 @@ uint64_t Linux::clockGetTime(uint64_t clkId, uint64_t systemTimer,
   }
 }
 
+int64_t Linux::clone(uint64_t flags, uint64_t childTidPtr,
+                     ThreadContext context) {
+  assert(processStates_.size() > 0);
+  LinuxProcessState& state = processStates_[0];
+  // Only threads sharing the process' memory can be created, not processes
+  if (!(flags & 0x100) || !(flags & 0x10000)) {  // CLONE_VM, CLONE_THREAD
+    return -ENOSYS;
+  }
+
+  LinuxThreadState thread = {state.nextTid++};
+  if (flags & 0x200000) {  // CLONE_CHILD_CLEARTID
+    thread.clearChildTid = childTidPtr;
+  }
+  thread.context = std::move(context);
+  state.runQueue.push_back(thread.tid);
+  int64_t tid = thread.tid;
+  state.threads.emplace(tid, std::move(thread));
+  return tid;
+}
+
+uint64_t Linux::exitThread() {
+  assert(processStates_.size() > 0);
+  LinuxProcessState& state = processStates_[0];
+  auto thread = state.threads.find(state.currentTid);
+  assert(thread != state.threads.end() && "No thread is running");
+  uint64_t clearChildTid = thread->second.clearChildTid;
+  state.threads.erase(thread);
+
+  // Wake any thread joining the exiting thread
+  if (clearChildTid != 0) futexWake(clearChildTid, 1, UINT32_MAX);
+  return clearChildTid;
+}
+
+size_t Linux::getThreadCount() const {
+  assert(processStates_.size() > 0);
+  return processStates_[0].threads.size();
+}
+
+int64_t Linux::futexWait(uint64_t addr, uint32_t value, uint32_t expected,
+                         uint32_t bitset, uint64_t deadline,
+                         ThreadContext context) {
+  assert(processStates_.size() > 0);
+  if (addr == 0) return -EFAULT;
+  if (bitset == 0) return -EINVAL;
+  if (value != expected) return -EAGAIN;
+
+  LinuxProcessState& state = processStates_[0];
+  LinuxThreadState& thread = state.threads.at(state.currentTid);
+  thread.futexAddress = addr;
+  thread.futexBitset = bitset;
+  thread.futexDeadline = deadline;
+  thread.context = std::move(context);
+  state.futexQueues[addr].push_back(thread.tid);
+  return 0;
+}
+
+int64_t Linux::futexWake(uint64_t addr, int64_t count, uint32_t bitset) {
+  assert(processStates_.size() > 0);
+  if (bitset == 0) return -EINVAL;
+
+  LinuxProcessState& state = processStates_[0];
+  auto queue = state.futexQueues.find(addr);
+  if (queue == state.futexQueues.end()) return 0;
+
+  int64_t woken = 0;
+  auto& waiters = queue->second;
+  for (auto it = waiters.begin(); it != waiters.end() && woken < count;) {
+    LinuxThreadState& thread = state.threads.at(*it);
+    if (!(thread.futexBitset & bitset)) {
+      it++;
+      continue;
+    }
+    it = waiters.erase(it);
+    wakeThread(thread, 0);
+    woken++;
+  }
+  if (waiters.empty()) state.futexQueues.erase(queue);
+  return woken;
+}
+
+void Linux::yield(ThreadContext context, int64_t result) {
+  assert(processStates_.size() > 0);
+  LinuxProcessState& state = processStates_[0];
+  LinuxThreadState& thread = state.threads.at(state.currentTid);
+  thread.result = result;
+  thread.context = std::move(context);
+  state.runQueue.push_back(thread.tid);
+}
+
+bool Linux::hasReadyThreads() const {
+  return processStates_.size() > 0 && !processStates_[0].runQueue.empty();
+}
+
+bool Linux::shouldPreempt(uint64_t systemTimer) const {
+  return hasReadyThreads() &&
+         systemTimer - processStates_[0].sliceStart >= TIME_SLICE;
+}
+
+const LinuxThreadState* Linux::scheduleNext(uint64_t systemTimer) {
+  assert(processStates_.size() > 0);
+  LinuxProcessState& state = processStates_[0];
+
+  auto timeOut = [&](LinuxThreadState& thread) {
+    auto& waiters = state.futexQueues[thread.futexAddress];
+    waiters.erase(std::find(waiters.begin(), waiters.end(), thread.tid));
+    if (waiters.empty()) state.futexQueues.erase(thread.futexAddress);
+    wakeThread(thread, -ETIMEDOUT);
+  };
+
+  // Wake the threads whose futex waits have timed out, noting the wait which
+  // times out soonest otherwise
+  LinuxThreadState* soonest = nullptr;
+  for (auto& [tid, thread] : state.threads) {
+    if (thread.futexAddress == 0 || thread.futexDeadline == UINT64_MAX) {
+      continue;
+    }
+    if (thread.futexDeadline <= systemTimer) {
+      timeOut(thread);
+    } else if (!soonest || thread.futexDeadline < soonest->futexDeadline) {
+      soonest = &thread;
+    }
+  }
+  // With no other thread to run, time passes until the soonest wait times out
+  if (state.runQueue.empty() && soonest) timeOut(*soonest);
+  if (state.runQueue.empty()) return nullptr;
+
+  state.currentTid = state.runQueue.front();
+  state.runQueue.pop_front();
+  state.sliceStart = systemTimer;
+  return &state.threads.at(state.currentTid);
+}
+
+void Linux::wakeThread(LinuxThreadState& thread, int64_t result) {
+  thread.futexAddress = 0;
+  thread.futexDeadline = UINT64_MAX;
+  thread.result = result;
+  processStates_[0].runQueue.push_back(thread.tid);
+}
+
 int64_t Linux::ftruncate(uint64_t fd, uint64_t length) {
   assert(fd < processStates_[0].fileDescriptorTable.size());
   int64_t hfd = processStates_[0].fileDescriptorTable[fd];
@@ -132,6 +351,12 @@ int64_t Linux::ftruncate(uint64_t fd, uint64_t length) {
 
 int64_t Linux::faccessat(int64_t dfd, const std::string& filename, int64_t mode,
                          int64_t flag) {
+  // Files of the virtual filesystem may be read but not written (W_OK)
+  std::string virtualPath;
+  if (findVirtualFile(dfd, filename, virtualPath)) {
+    return (mode & 0x2) ? -EACCES : 0;
+  }
+
   // Resolve absolute path to target file
   std::string new_pathname;
 
@@ -156,7 +381,7 @@ int64_t Linux::close(int64_t vfd) {
     assert(vfd >= 0 && static_cast<size_t>(vfd) <
                            processStates_[0].fileDescriptorTable.size());
     int64_t hfd = processStates_[0].fileDescriptorTable[vfd];
-    if (hfd < 0) {
+    if (hfd < 0 && hfd != VIRTUAL_FILE_FD) {
       // Early return, can't deallocate vfd that isn't in fileDescriptorTable
       return EBADF;
     }
@@ -166,6 +391,10 @@ int64_t Linux::close(int64_t vfd) {
     processStates_[0].freeFileDescriptors.insert(vfd);
     processStates_[0].fileDescriptorTable[vfd] = -1;
 
+    if (hfd == VIRTUAL_FILE_FD) {
+      processStates_[0].virtualFiles.erase(vfd);
+      return 0;
+    }
     return ::close(hfd);
   }
 
@@ -175,6 +404,18 @@ int64_t Linux::close(int64_t vfd) {
 
 int64_t Linux::newfstatat(int64_t dfd, const std::string& filename, stat& out,
                           int64_t flag) {
+  std::string virtualPath;
+  if (const VirtualFile* file = findVirtualFile(dfd, filename, virtualPath)) {
+    statVirtualFile(*file, out);
+    return 0;
+  }
+  // AT_EMPTY_PATH stats the file open as dfd itself
+  OpenVirtualFile* openFile = getVirtualFile(dfd);
+  if (openFile && filename.empty() && (flag & 0x1000)) {
+    statVirtualFile(*openFile->file, out);
+    return 0;
+  }
+
   // Resolve absolute path to target file
   std::string new_pathname;
 
@@ -224,6 +465,11 @@ int64_t Linux::newfstatat(int64_t dfd, const std::string& filename, stat& out,
 }
 
 int64_t Linux::fstat(int64_t fd, stat& out) {
+  if (OpenVirtualFile* openFile = getVirtualFile(fd)) {
+    statVirtualFile(*openFile->file, out);
+    return 0;
+  }
+
   assert(fd > 0 && static_cast<size_t>(fd) <
                        processStates_[0].fileDescriptorTable.size());
   int64_t hfd = processStates_[0].fileDescriptorTable[fd];
@@ -303,8 +549,10 @@ int64_t Linux::getuid() const { return 0; }
 int64_t Linux::geteuid() const { return 0; }
 int64_t Linux::getgid() const { return 0; }
 int64_t Linux::getegid() const { return 0; }
-// TODO update for multithreaded processes
-int64_t Linux::gettid() const { return 0; }
+int64_t Linux::gettid() const {
+  assert(processStates_.size() > 0);
+  return processStates_[0].currentTid;
+}
 
 int64_t Linux::gettimeofday(uint64_t systemTimer, timeval* tv, timeval* tz) {
   // TODO: Ideally this should get the system timer from the core directly
@@ -357,6 +605,27 @@ int64_t Linux::ioctl(int64_t fd, uint64_t request, std::vector<char>& out) {
 }
 
 uint64_t Linux::lseek(int64_t fd, uint64_t offset, int64_t whence) {
+  if (OpenVirtualFile* openFile = getVirtualFile(fd)) {
+    // The offsets of directories count their entries, including "." and ".."
+    const VirtualFile& file = *openFile->file;
+    int64_t size = file.isDirectory ? file.entries.size() + 2
+                                     : file.contents->size();
+    int64_t base;
+    if (whence == 0) {  // SEEK_SET
+      base = 0;
+    } else if (whence == 1) {  // SEEK_CUR
+      base = openFile->offset;
+    } else if (whence == 2) {  // SEEK_END
+      base = size;
+    } else {
+      return -EINVAL;
+    }
+    int64_t newOffset = base + static_cast<int64_t>(offset);
+    if (newOffset < 0) return -EINVAL;
+    openFile->offset = newOffset;
+    return newOffset;
+  }
+
   assert(fd > 0 && static_cast<size_t>(fd) <
                        processStates_[0].fileDescriptorTable.size());
   int64_t hfd = processStates_[0].fileDescriptorTable[fd];
@@ -372,83 +641,193 @@ int64_t Linux::munmap(uint64_t addr, size_t length) {
     // addr must be a multiple of the process page size
     return -1;
   };
-  vm_area_struct alloc;
-  // Find addr in allocations
-  for (size_t i = 0; i < lps->contiguousAllocations.size(); i++) {
-    alloc = lps->contiguousAllocations[i];
-    if (alloc.vm_start == addr) {
-      if ((alloc.vm_end - alloc.vm_start) < length) {
-        // Length must not be larger than the original allocation
-        return -1;
-      }
-      if (i != 0) {
-        lps->contiguousAllocations[i - 1].vm_next =
-            lps->contiguousAllocations[i].vm_next;
-      }
-      lps->contiguousAllocations.erase(lps->contiguousAllocations.begin() + i);
+  // Any mapped pages within the range are unmapped; it's not an error if the
+  // range contains unmapped pages, or none which are mapped
+  return lps->memoryAreas.unmap(addr, length) ? 0 : -1;
+}
+
+uint64_t Linux::mmap(uint64_t addr, size_t length, int prot, int flags,
+                     int fd, off_t offset) {
+  LinuxProcessState* lps = &processStates_[0];
+  bool fixed = flags & 0x10;               // MAP_FIXED
+  bool fixedNoReplace = flags & 0x100000;  // MAP_FIXED_NOREPLACE
+  if (fixedNoReplace) {
+    // The mapping must be placed at addr without replacing existing mappings
+    uint64_t end = addr + alignToBoundary(length, lps->pageSize);
+    if (!lps->memoryAreas.isFree(addr, end)) return 0;
+    fixed = true;
+  }
+
+  std::shared_ptr<MappedFile> file;
+  if (!(flags & 0x20)) {  // MAP_ANONYMOUS
+    // File-backed mappings must start at a page-aligned offset into a file
+    // open on the host
+    if (offset < 0 || offset % lps->pageSize != 0 || fd < 0 ||
+        static_cast<size_t>(fd) >= lps->fileDescriptorTable.size()) {
       return 0;
     }
+    int64_t hfd = lps->fileDescriptorTable[fd];
+    if (hfd == VIRTUAL_FILE_FD) {
+      // Files of the virtual filesystem are mapped from their contents in
+      // memory
+      const VirtualFile* virtualFile = lps->virtualFiles.at(fd).file;
+      if (virtualFile->isDirectory) return 0;
+      file = std::make_shared<MappedFile>(virtualFile->contents);
+    } else {
+      if (hfd < 0) return 0;
+      // Duplicate the host file descriptor, such that the mapping remains
+      // valid once the file is closed
+      int64_t mappedFd = ::dup(hfd);
+      if (mappedFd < 0) return 0;
+      file = std::make_shared<MappedFile>(mappedFd);
+    }
   }
+  return lps->memoryAreas.map(addr, length, prot, flags, fixed,
+                              std::move(file), offset);
+}
 
-  for (size_t j = 0; j < lps->nonContiguousAllocations.size(); j++) {
-    alloc = lps->nonContiguousAllocations[j];
-    if (alloc.vm_start == addr) {
-      if ((alloc.vm_end - alloc.vm_start) < length) {
-        // Length must not be larger than the original allocation
-        return -1;
-      }
-      lps->nonContiguousAllocations.erase(
-          lps->nonContiguousAllocations.begin() + j);
-      return 0;
+void Linux::getMappingContents(uint64_t addr, size_t length,
+                               std::vector<char>& contents) const {
+  const LinuxProcessState* lps = &processStates_[0];
+  contents.clear();
+  const VirtualMemoryArea* area = lps->memoryAreas.find(addr);
+  if (area == nullptr) return;
+
+  // Freed memory is reused by later mappings, so every page is populated,
+  // with zeroes wherever the file doesn't cover it
+  contents.assign(alignToBoundary(length, lps->pageSize), 0);
+  if (!area->file) return;
+
+  // The area may have been merged with an adjacent mapping of the file
+  uint64_t offset = area->offset + (addr - area->start);
+  const auto& fileContents = area->file->getContents();
+  uint64_t fileSize;
+  if (fileContents) {
+    fileSize = fileContents->size();
+  } else {
+    struct ::stat statbuf;
+    if (::fstat(area->file->getHostFd(), &statbuf) != 0) return;
+    fileSize = statbuf.st_size;
+  }
+  if (fileSize <= offset) return;
+
+  uint64_t size = std::min<uint64_t>(contents.size(), fileSize - offset);
+  if (fileContents) {
+    std::memcpy(contents.data(), fileContents->data() + offset, size);
+    return;
+  }
+  uint64_t bytesRead = 0;
+  while (bytesRead < size) {
+    ssize_t result =
+        ::pread(area->file->getHostFd(), contents.data() + bytesRead,
+                size - bytesRead, offset + bytesRead);
+    if (result <= 0) break;
+    bytesRead += result;
+  }
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> Linux::getWriteBackRanges(
+    uint64_t addr, uint64_t length) const {
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  if (processStates_.empty()) return ranges;
+  const LinuxProcessState* lps = &processStates_[0];
+  uint64_t end = addr + std::min(length, UINT64_MAX - addr);
+  for (const auto& area : lps->memoryAreas.getAreas(addr, end)) {
+    // Only MAP_SHARED mappings of host files are written back
+    if (!area.file || area.file->getContents() || !(area.flags & 0x01)) {
+      continue;
     }
+    ranges.push_back({std::max(area.start, addr), std::min(area.end, end)});
   }
-  // Not an error if the indicated range does not contain any mapped pages
-  return 0;
+  return ranges;
 }
 
-uint64_t Linux::mmap(uint64_t addr, size_t length, [[maybe_unused]] int prot,
-                     [[maybe_unused]] int flags, [[maybe_unused]] int fd,
-                     [[maybe_unused]] off_t offset) {
+void Linux::writeBack(uint64_t addr, uint64_t length, const char* data) {
   LinuxProcessState* lps = &processStates_[0];
-  std::shared_ptr<struct vm_area_struct> newAlloc(new vm_area_struct);
-  if (addr == 0) {  // Kernel decides allocation
-    if (lps->contiguousAllocations.size() > 1) {
-      // Determine if the new allocation can fit between existing allocations,
-      // append to end of allocations if not
-      for (auto& alloc : lps->contiguousAllocations) {
-        if (alloc.vm_next != NULL &&
-            (alloc.vm_next->vm_start - alloc.vm_end) >= length) {
-          newAlloc->vm_start = alloc.vm_end;
-          // Re-link contiguous allocation to include new allocation
-          newAlloc->vm_next = alloc.vm_next;
-          alloc.vm_next = newAlloc;
-        }
-      }
-      if (newAlloc->vm_start == 0) {
-        newAlloc->vm_start = lps->contiguousAllocations.back().vm_end;
-        lps->contiguousAllocations.back().vm_next = newAlloc;
-      }
-    } else if (lps->contiguousAllocations.size() > 0) {
-      // Append allocation to end of list and link first entry to new
-      // allocation
-      newAlloc->vm_start = lps->contiguousAllocations[0].vm_end;
-      lps->contiguousAllocations[0].vm_next = newAlloc;
-    } else {
-      // If no allocation exists, allocate to start of the mmap region
-      newAlloc->vm_start = lps->mmapRegion;
+  uint64_t end = addr + length;
+  for (const auto& area : lps->memoryAreas.getAreas(addr, end)) {
+    // Only MAP_SHARED mappings of host files are written back
+    if (!area.file || area.file->getContents() || !(area.flags & 0x01)) {
+      continue;
+    }
+
+    // Write back the part of the area within the range, without extending the
+    // file
+    struct ::stat statbuf;
+    if (::fstat(area.file->getHostFd(), &statbuf) != 0) continue;
+    uint64_t fileSize = statbuf.st_size;
+    uint64_t start = std::max(area.start, addr);
+    uint64_t fileOffset = area.offset + (start - area.start);
+    if (fileOffset >= fileSize) continue;
+    uint64_t size = std::min({area.end, end, start + (fileSize - fileOffset)}) -
+                    start;
+
+    uint64_t bytesWritten = 0;
+    while (bytesWritten < size) {
+      ssize_t result =
+          ::pwrite(area.file->getHostFd(), data + (start - addr) + bytesWritten,
+                   size - bytesWritten, fileOffset + bytesWritten);
+      if (result <= 0) break;
+      bytesWritten += result;
     }
-    // The end of the allocation must be rounded up to the nearest page size
-    newAlloc->vm_end =
-        alignToBoundary(newAlloc->vm_start + length, lps->pageSize);
-    lps->contiguousAllocations.push_back(*newAlloc);
-  } else {  // Use hint to provide allocation
-    return 0;
   }
-  return newAlloc->vm_start;
+}
+
+int64_t Linux::msync(uint64_t addr, size_t length, int flags) {
+  LinuxProcessState* lps = &processStates_[0];
+  // MS_ASYNC and MS_SYNC are mutually exclusive
+  if (addr % lps->pageSize != 0 || (flags & 0x1 && flags & 0x4)) {
+    return -1;
+  }
+  uint64_t end = addr + alignToBoundary(length, lps->pageSize);
+  if (length != 0 && !lps->memoryAreas.isMapped(addr, end)) {
+    // The whole range must be mapped
+    return -1;
+  }
+  return 0;
+}
+
+int64_t Linux::mprotect(uint64_t addr, size_t length, int prot) {
+  LinuxProcessState* lps = &processStates_[0];
+  // addr must be a multiple of the process page size
+  if (addr % lps->pageSize != 0) return -EINVAL;
+  if (length == 0) return 0;
+  uint64_t end = addr + alignToBoundary(length, lps->pageSize);
+  if (end <= addr || end > lps->stackStart) return -ENOMEM;
+
+  // The process image and stack are always mapped, but aren't tracked; every
+  // page of the heap and mmap regions between them must be mapped by mmap or
+  // brk
+  uint64_t mmapEnd = lps->initialStackPointer -
+                     (lps->initialStackPointer % lps->pageSize);
+  uint64_t trackedStart =
+      std::max(addr, alignToBoundary(lps->startBrk, lps->pageSize));
+  uint64_t trackedEnd = std::min(end, mmapEnd);
+  if (trackedStart < trackedEnd &&
+      !lps->memoryAreas.isMapped(trackedStart, trackedEnd)) {
+    return -ENOMEM;
+  }
+  lps->memoryAreas.protect(addr, length, prot);
+  return 0;
 }
 
 int64_t Linux::openat(int64_t dfd, const std::string& pathname, int64_t flags,
                       uint16_t mode) {
+  // Serve files held by the virtual filesystem from memory
+  std::string virtualPath;
+  if (const VirtualFile* file = findVirtualFile(dfd, pathname, virtualPath)) {
+    // Files may only be opened for reading
+    if ((flags & 0x3) || (flags & 0x200)) return -EACCES;  // O_TRUNC
+    // O_CREAT and O_EXCL
+    if ((flags & 0x40) && (flags & 0x80)) return -EEXIST;
+    // O_DIRECTORY
+    if ((flags & 0x10000) && !file->isDirectory) return -ENOTDIR;
+
+    int64_t vfd = allocateFileDescriptor(VIRTUAL_FILE_FD);
+    processStates_[0].virtualFiles[vfd] = {virtualPath, file};
+    return vfd;
+  }
+
   // Alter special file path to point to SimEng one (if pathname points to
   // special file)
   std::string new_pathname = Linux::getSpecialFile(pathname);
@@ -505,22 +884,8 @@ int64_t Linux::openat(int64_t dfd, const std::string& pathname, int64_t flags,
     return hostFd;
   }
 
-  LinuxProcessState& processState = processStates_[0];
-
   // Allocate virtual file descriptor and map to host file descriptor
-  int64_t vfd;
-  if (!processState.freeFileDescriptors.empty()) {
-    // Take virtual descriptor from free pool
-    auto first = processState.freeFileDescriptors.begin();
-    vfd = processState.freeFileDescriptors.extract(first).value();
-    processState.fileDescriptorTable[vfd] = hostFd;
-  } else {
-    // Extend file descriptor table for a new virtual descriptor
-    vfd = processState.fileDescriptorTable.size();
-    processState.fileDescriptorTable.push_back(hostFd);
-  }
-
-  return vfd;
+  return allocateFileDescriptor(hostFd);
 }
 
 int64_t Linux::readlinkat(int64_t dirfd, const std::string& pathname, char* buf,
@@ -548,6 +913,46 @@ int64_t Linux::readlinkat(int64_t dirfd, const std::string& pathname, char* buf,
 }
 
 int64_t Linux::getdents64(int64_t fd, void* buf, uint64_t count) {
+  if (OpenVirtualFile* openFile = getVirtualFile(fd)) {
+    const VirtualFile& directory = *openFile->file;
+    if (!directory.isDirectory) return -ENOTDIR;
+
+    // List "." and ".." before the files the directory holds. The parent is
+    // listed as the directory itself if it isn't held
+    std::vector<std::pair<std::string, const VirtualFile*>> entries = {
+        {".", &directory}, {"..", fileSystem_->find(openFile->path + "/..")}};
+    if (entries[1].second == nullptr) entries[1].second = &directory;
+    for (const auto& name : directory.entries) {
+      entries.push_back({name, fileSystem_->find(openFile->path + "/" + name)});
+    }
+
+    // Write as many whole entries as fit, resuming from the offset reached by
+    // the last call
+    uint64_t bytesRead = 0;
+    for (; openFile->offset < entries.size(); openFile->offset++) {
+      const auto& [name, file] = entries[openFile->offset];
+      // 20 = combined size of d_ino, d_off, d_reclen, d_type, and d_name's
+      // null-terminator
+      uint16_t structSize = 20 + name.size();
+      uint16_t reclen = alignToBoundary(structSize, 8);
+      if (bytesRead + reclen > count) break;
+
+      char* entry = static_cast<char*>(buf) + bytesRead;
+      uint64_t nextOffset = openFile->offset + 1;
+      uint8_t type = file->isDirectory ? DT_DIR : DT_REG;
+      std::memcpy(entry, &file->inode, 8);
+      std::memcpy(entry + 8, &nextOffset, 8);
+      std::memcpy(entry + 16, &reclen, 2);
+      std::memcpy(entry + 18, &type, 1);
+      std::memcpy(entry + 19, name.c_str(), name.size() + 1);
+      std::memset(entry + structSize, '\0', reclen - structSize);
+      bytesRead += reclen;
+    }
+    // The buffer must be large enough to hold at least one entry
+    if (bytesRead == 0 && openFile->offset < entries.size()) return -EINVAL;
+    return bytesRead;
+  }
+
   assert(fd > 0 && static_cast<size_t>(fd) <
                        processStates_[0].fileDescriptorTable.size());
   int64_t hfd = processStates_[0].fileDescriptorTable[fd];
@@ -605,6 +1010,16 @@ int64_t Linux::getdents64(int64_t fd, void* buf, uint64_t count) {
 }
 
 int64_t Linux::read(int64_t fd, void* buf, uint64_t count) {
+  if (OpenVirtualFile* openFile = getVirtualFile(fd)) {
+    if (openFile->file->isDirectory) return -EISDIR;
+    const std::string& contents = *openFile->file->contents;
+    uint64_t start = std::min<uint64_t>(openFile->offset, contents.size());
+    uint64_t size = std::min<uint64_t>(count, contents.size() - start);
+    std::memcpy(buf, contents.data() + start, size);
+    openFile->offset = start + size;
+    return size;
+  }
+
   assert(fd > 0 && static_cast<size_t>(fd) <
                        processStates_[0].fileDescriptorTable.size());
   int64_t hfd = processStates_[0].fileDescriptorTable[fd];
@@ -615,6 +1030,20 @@ int64_t Linux::read(int64_t fd, void* buf, uint64_t count) {
 }
 
 int64_t Linux::readv(int64_t fd, const void* iovdata, int iovcnt) {
+  if (getVirtualFile(fd)) {
+    // Fill each buffer in turn, stopping once the end of the file is reached
+    const uint64_t* iov = reinterpret_cast<const uint64_t*>(iovdata);
+    int64_t totalRead = 0;
+    for (int i = 0; i < iovcnt; i++) {
+      int64_t result =
+          read(fd, reinterpret_cast<void*>(iov[i * 2]), iov[i * 2 + 1]);
+      if (result < 0) return result;
+      totalRead += result;
+      if (static_cast<uint64_t>(result) < iov[i * 2 + 1]) break;
+    }
+    return totalRead;
+  }
+
   assert(fd > 0 && static_cast<size_t>(fd) <
                        processStates_[0].fileDescriptorTable.size());
   int64_t hfd = processStates_[0].fileDescriptorTable[fd];
@@ -642,8 +1071,9 @@ int64_t Linux::schedSetAffinity(pid_t pid, size_t cpusetsize, uint64_t mask) {
 }
 int64_t Linux::setTidAddress(uint64_t tidptr) {
   assert(processStates_.size() > 0);
-  processStates_[0].clearChildTid = tidptr;
-  return processStates_[0].pid;
+  LinuxProcessState& state = processStates_[0];
+  state.threads.at(state.currentTid).clearChildTid = tidptr;
+  return state.currentTid;
 }
 
 int64_t Linux::write(int64_t fd, const void* buf, uint64_t count) {
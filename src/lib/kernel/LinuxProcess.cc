@@ -20,6 +20,8 @@ LinuxProcess::LinuxProcess(const std::vector<std::string>& commandLine,
                            ryml::ConstNodeRef config)
     : STACK_SIZE(config["Process-Image"]["Stack-Size"].as<uint64_t>()),
       HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()),
+      OPENMP_THREADS(
+          config["Process-Image"]["OpenMP-Threads"].as<uint64_t>()),
       commandLine_(commandLine) {
   // Parse ELF file
   assert(commandLine.size() > 0);
@@ -35,6 +37,7 @@ LinuxProcess::LinuxProcess(const std::vector<std::string>& commandLine,
   progHeaderTableAddress_ = elf.getPhdrTableAddress();
   progHeaderEntSize_ = elf.getPhdrEntrySize();
   numProgHeaders_ = elf.getNumPhdr();
+  symbols_ = elf.getSymbols();
 
   // Align heap start to a 32-byte boundary
   heapStart_ = alignToBoundary(elf.getProcessImageSize(), 32);
@@ -65,7 +68,9 @@ LinuxProcess::LinuxProcess(const std::vector<std::string>& commandLine,
 LinuxProcess::LinuxProcess(span<const uint8_t> instructions,
                            ryml::ConstNodeRef config)
     : STACK_SIZE(config["Process-Image"]["Stack-Size"].as<uint64_t>()),
-      HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()) {
+      HEAP_SIZE(config["Process-Image"]["Heap-Size"].as<uint64_t>()),
+      OPENMP_THREADS(
+          config["Process-Image"]["OpenMP-Threads"].as<uint64_t>()) {
   // Set program command string to the full path of the default program even
   // though these aren't the instructions being executed
   commandLine_.push_back(SIMENG_SOURCE_DIR "/SimEngDefaultProgram\0");
@@ -100,6 +105,10 @@ uint64_t LinuxProcess::getPageSize() const { return pageSize_; }
 
 std::string LinuxProcess::getPath() const { return commandLine_[0]; }
 
+const std::vector<ElfSymbol>& LinuxProcess::getSymbols() const {
+  return symbols_;
+}
+
 bool LinuxProcess::isValid() const { return isValid_; }
 
 std::shared_ptr<char> LinuxProcess::getProcessImage() const {
@@ -135,7 +144,8 @@ void LinuxProcess::createStack(char** processImage) {
     stringBytes.push_back(0);
   }
   // Environment strings
-  std::vector<std::string> envStrings = {"OMP_NUM_THREADS=1"};
+  std::vector<std::string> envStrings = {"OMP_NUM_THREADS=" +
+                                         std::to_string(OPENMP_THREADS)};
   for (std::string& env : envStrings) {
     for (size_t i = 0; i < env.size(); i++) {
       stringBytes.push_back(env.c_str()[i]);
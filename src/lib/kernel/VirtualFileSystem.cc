@@ -0,0 +1,118 @@
+#include "simeng/kernel/VirtualFileSystem.hh"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace simeng {
+namespace kernel {
+
+void VirtualFileSystem::addFile(const std::string& path,
+                                std::string contents) {
+  VirtualFile& file = insert(normalise(path), false);
+  file.isDirectory = false;
+  file.entries.clear();
+  file.contents = std::make_shared<const std::string>(std::move(contents));
+}
+
+void VirtualFileSystem::addDirectory(const std::string& path) {
+  std::string normalised = normalise(path);
+  if (files_.count(normalised) && files_.at(normalised).isDirectory) return;
+  VirtualFile& directory = insert(normalised, true);
+  directory.isDirectory = true;
+  directory.contents = nullptr;
+}
+
+bool VirtualFileSystem::addHostDirectory(const std::string& hostPath) {
+  char absolutePath[PATH_MAX];
+  if (!::realpath(hostPath.c_str(), absolutePath)) return false;
+
+  // Walk the tree breadth-first, such that each directory is added before the
+  // files it holds
+  std::vector<std::string> directories = {absolutePath};
+  for (size_t i = 0; i < directories.size(); i++) {
+    const std::string directory = directories[i];
+    DIR* stream = ::opendir(directory.c_str());
+    if (stream == nullptr) return false;
+    addDirectory(directory);
+
+    while (dirent* entry = ::readdir(stream)) {
+      std::string name = entry->d_name;
+      if (name == "." || name == "..") continue;
+      std::string path = (directory == "/" ? "" : directory) + "/" + name;
+
+      // Symbolic links are followed, while other special files are skipped
+      struct ::stat statbuf;
+      if (::stat(path.c_str(), &statbuf) != 0) continue;
+      if (S_ISDIR(statbuf.st_mode)) {
+        directories.push_back(path);
+      } else if (S_ISREG(statbuf.st_mode)) {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        addFile(path, contents.str());
+      }
+    }
+    ::closedir(stream);
+  }
+  return true;
+}
+
+const VirtualFile* VirtualFileSystem::find(const std::string& path) const {
+  auto it = files_.find(normalise(path));
+  return (it == files_.end()) ? nullptr : &it->second;
+}
+
+const std::map<std::string, VirtualFile>& VirtualFileSystem::getFiles() const {
+  return files_;
+}
+
+bool VirtualFileSystem::empty() const { return files_.empty(); }
+
+std::string VirtualFileSystem::normalise(const std::string& path) {
+  std::vector<std::string> components;
+  size_t start = 0;
+  while (start <= path.size()) {
+    size_t end = path.find('/', start);
+    if (end == std::string::npos) end = path.size();
+    std::string component = path.substr(start, end - start);
+    if (component == "..") {
+      if (!components.empty()) components.pop_back();
+    } else if (!component.empty() && component != ".") {
+      components.push_back(component);
+    }
+    start = end + 1;
+  }
+
+  if (components.empty()) return "/";
+  std::string normalised;
+  for (const auto& component : components) normalised += "/" + component;
+  return normalised;
+}
+
+VirtualFile& VirtualFileSystem::insert(const std::string& path,
+                                       bool isDirectory) {
+  auto [it, inserted] = files_.try_emplace(path);
+  if (inserted) {
+    it->second.inode = nextInode_++;
+    it->second.isDirectory = isDirectory;
+    // List the file in its parent directory, if held
+    if (path != "/") {
+      size_t separator = path.rfind('/');
+      auto parent = files_.find(path.substr(0, std::max<size_t>(separator, 1)));
+      if (parent != files_.end() && parent->second.isDirectory) {
+        parent->second.entries.insert(path.substr(separator + 1));
+      }
+    }
+  }
+  return it->second;
+}
+
+}  // namespace kernel
+}  // namespace simeng
@@ -0,0 +1,343 @@
+#include "simeng/kernel/VirtualMemoryAreas.hh"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#include "simeng/kernel/LinuxProcess.hh"
+
+namespace simeng {
+namespace kernel {
+
+MappedFile::MappedFile(int64_t hostFd) : hostFd_(hostFd) {}
+
+MappedFile::MappedFile(std::shared_ptr<const std::string> contents)
+    : hostFd_(-1), contents_(std::move(contents)) {}
+
+MappedFile::~MappedFile() {
+  if (hostFd_ >= 0) ::close(hostFd_);
+}
+
+int64_t MappedFile::getHostFd() const { return hostFd_; }
+
+const std::shared_ptr<const std::string>& MappedFile::getContents() const {
+  return contents_;
+}
+
+VirtualMemoryAreas::VirtualMemoryAreas(uint64_t regionStart,
+                                       uint64_t regionEnd, uint64_t pageSize)
+    : regionStart_(regionStart), regionEnd_(regionEnd), pageSize_(pageSize) {
+  if (regionStart_ < regionEnd_) insertGap(regionStart_, regionEnd_);
+}
+
+uint64_t VirtualMemoryAreas::map(uint64_t addr, uint64_t length, int prot,
+                                 int flags, bool fixed,
+                                 std::shared_ptr<MappedFile> file,
+                                 uint64_t offset) {
+  if (length == 0) return 0;
+  length = alignToBoundary(length, pageSize_);
+
+  uint64_t start = 0;
+  if (fixed) {
+    if (addr == 0 || addr % pageSize_ != 0 || addr + length < addr) return 0;
+    // Any areas already mapped within the range are replaced
+    unmap(addr, length);
+    start = addr;
+  } else {
+    // Use the hint if the range it describes is free, otherwise search for a
+    // gap above it before searching the whole region
+    uint64_t hint = alignToBoundary(addr, pageSize_);
+    if (hint >= regionStart_ && hint < regionEnd_) {
+      start = findFreeRange(hint, length);
+    }
+    if (start == 0) start = findFreeRange(regionStart_, length);
+    if (start == 0) return 0;
+  }
+
+  reserve(start, start + length);
+  auto inserted = areas_.emplace(
+      start, VirtualMemoryArea{start, start + length, prot, flags,
+                               std::move(file), offset});
+  coalesce(inserted.first);
+  return start;
+}
+
+bool VirtualMemoryAreas::unmap(uint64_t addr, uint64_t length) {
+  if (addr % pageSize_ != 0 || length == 0) return false;
+  uint64_t end = addr + alignToBoundary(length, pageSize_);
+
+  auto it = firstAreaAfter(addr);
+  while (it != areas_.end() && it->first < end) {
+    VirtualMemoryArea area = it->second;
+    it = areas_.erase(it);
+    // Keep the parts of the area outside of the range
+    if (area.start < addr) {
+      VirtualMemoryArea head = area;
+      head.end = addr;
+      areas_.emplace_hint(it, area.start, head);
+    }
+    if (area.end > end) {
+      VirtualMemoryArea tail = area;
+      tail.start = end;
+      tail.offset += end - area.start;
+      it = areas_.emplace_hint(it, end, tail);
+    }
+    release(std::max(area.start, addr), std::min(area.end, end));
+  }
+  return true;
+}
+
+bool VirtualMemoryAreas::protect(uint64_t addr, uint64_t length, int prot) {
+  if (addr % pageSize_ != 0 || length == 0) return false;
+  uint64_t end = addr + alignToBoundary(length, pageSize_);
+
+  auto it = firstAreaAfter(addr);
+  while (it != areas_.end() && it->first < end) {
+    // Split off the parts of the area outside of the range
+    if (it->first < addr) {
+      VirtualMemoryArea tail = it->second;
+      tail.start = addr;
+      tail.offset += addr - it->first;
+      it->second.end = addr;
+      it = areas_.emplace_hint(std::next(it), addr, tail);
+    }
+    if (it->second.end > end) {
+      VirtualMemoryArea tail = it->second;
+      tail.start = end;
+      tail.offset += end - it->first;
+      it->second.end = end;
+      areas_.emplace_hint(std::next(it), end, tail);
+    }
+    it->second.prot = prot;
+    it = std::next(coalesce(it));
+  }
+  return true;
+}
+
+bool VirtualMemoryAreas::isFree(uint64_t start, uint64_t end) const {
+  // Areas don't overlap, so the last area starting before `end` ends after
+  // all others which do
+  auto it = areas_.lower_bound(end);
+  if (it == areas_.begin()) return true;
+  return std::prev(it)->second.end <= start;
+}
+
+bool VirtualMemoryAreas::isMapped(uint64_t start, uint64_t end) const {
+  const VirtualMemoryArea* area = find(start);
+  if (area == nullptr) return false;
+
+  auto it = areas_.find(area->start);
+  uint64_t mappedEnd = area->end;
+  while (mappedEnd < end) {
+    it++;
+    if (it == areas_.end() || it->first != mappedEnd) return false;
+    mappedEnd = it->second.end;
+  }
+  return true;
+}
+
+const VirtualMemoryArea* VirtualMemoryAreas::find(uint64_t addr) const {
+  auto it = areas_.upper_bound(addr);
+  if (it == areas_.begin()) return nullptr;
+  it--;
+  return (it->second.end > addr) ? &it->second : nullptr;
+}
+
+std::vector<VirtualMemoryArea> VirtualMemoryAreas::getAreas(
+    uint64_t start, uint64_t end) const {
+  std::vector<VirtualMemoryArea> areas;
+  auto it = areas_.upper_bound(start);
+  if (it != areas_.begin() && std::prev(it)->second.end > start) it--;
+  for (; it != areas_.end() && it->first < end; it++) {
+    areas.push_back(it->second);
+  }
+  return areas;
+}
+
+size_t VirtualMemoryAreas::getAreaCount() const { return areas_.size(); }
+
+VirtualMemoryAreas::AreaIterator VirtualMemoryAreas::firstAreaAfter(
+    uint64_t addr) {
+  auto it = areas_.upper_bound(addr);
+  if (it != areas_.begin() && std::prev(it)->second.end > addr) it--;
+  return it;
+}
+
+VirtualMemoryAreas::AreaIterator VirtualMemoryAreas::coalesce(
+    AreaIterator it) {
+  auto canMerge = [](const VirtualMemoryArea& first,
+                     const VirtualMemoryArea& second) {
+    return first.end == second.start && first.prot == second.prot &&
+           first.flags == second.flags && first.file == second.file &&
+           (!first.file ||
+            first.offset + (first.end - first.start) == second.offset);
+  };
+
+  if (it != areas_.begin()) {
+    auto prev = std::prev(it);
+    if (canMerge(prev->second, it->second)) {
+      prev->second.end = it->second.end;
+      areas_.erase(it);
+      it = prev;
+    }
+  }
+  auto next = std::next(it);
+  if (next != areas_.end() && canMerge(it->second, next->second)) {
+    it->second.end = next->second.end;
+    areas_.erase(next);
+  }
+  return it;
+}
+
+uint64_t VirtualMemoryAreas::findFreeRange(uint64_t from,
+                                           uint64_t length) const {
+  // The range may begin part way through the gap holding `from`
+  int32_t gap = findGap(from);
+  if (gap >= 0 && gaps_[gap].end >= from + length) return from;
+
+  gap = findFit(root_, from, length);
+  return (gap >= 0) ? gaps_[gap].start : 0;
+}
+
+void VirtualMemoryAreas::reserve(uint64_t start, uint64_t end) {
+  // Only memory within the region is tracked by the gaps
+  start = std::max(start, regionStart_);
+  end = std::min(end, regionEnd_);
+  if (start >= end) return;
+
+  int32_t gap = findGap(start);
+  assert(gap >= 0 && gaps_[gap].end >= end &&
+         "Attempted to reserve memory which isn't free");
+  uint64_t gapStart = gaps_[gap].start;
+  uint64_t gapEnd = gaps_[gap].end;
+  eraseGap(gapStart);
+  if (gapStart < start) insertGap(gapStart, start);
+  if (end < gapEnd) insertGap(end, gapEnd);
+}
+
+void VirtualMemoryAreas::release(uint64_t start, uint64_t end) {
+  start = std::max(start, regionStart_);
+  end = std::min(end, regionEnd_);
+  if (start >= end) return;
+
+  // Merge with any gaps directly before or after the released memory
+  int32_t before = findGap(start - 1);
+  if (before >= 0 && gaps_[before].end == start) {
+    start = gaps_[before].start;
+    eraseGap(start);
+  }
+  int32_t after = findGap(end);
+  if (after >= 0 && gaps_[after].start == end) {
+    uint64_t afterStart = gaps_[after].start;
+    end = gaps_[after].end;
+    eraseGap(afterStart);
+  }
+  insertGap(start, end);
+}
+
+int32_t VirtualMemoryAreas::findGap(uint64_t addr) const {
+  int32_t found = -1;
+  int32_t node = root_;
+  while (node >= 0) {
+    if (gaps_[node].start <= addr) {
+      found = node;
+      node = gaps_[node].right;
+    } else {
+      node = gaps_[node].left;
+    }
+  }
+  return found;
+}
+
+int32_t VirtualMemoryAreas::findFit(int32_t node, uint64_t above,
+                                    uint64_t length) const {
+  // Subtrees without a large enough gap are skipped entirely, so only the
+  // path to the first gap above `above` is searched in full
+  if (node < 0 || gaps_[node].maxSize < length) return -1;
+  const Gap& gap = gaps_[node];
+  if (gap.start <= above) return findFit(gap.right, above, length);
+
+  int32_t found = findFit(gap.left, above, length);
+  if (found >= 0) return found;
+  if (gap.end - gap.start >= length) return node;
+  return findFit(gap.right, above, length);
+}
+
+void VirtualMemoryAreas::insertGap(uint64_t start, uint64_t end) {
+  // Generate the node's priority with a xorshift generator
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+
+  int32_t node;
+  if (freeGaps_.empty()) {
+    node = static_cast<int32_t>(gaps_.size());
+    gaps_.emplace_back();
+  } else {
+    node = freeGaps_.back();
+    freeGaps_.pop_back();
+  }
+  gaps_[node] = {start, end, end - start, seed_, -1, -1};
+
+  int32_t left, right;
+  split(root_, start, left, right);
+  root_ = merge(merge(left, node), right);
+}
+
+void VirtualMemoryAreas::eraseGap(uint64_t start) {
+  int32_t left, middle, right;
+  split(root_, start, left, right);
+  split(right, start + 1, middle, right);
+  assert(middle >= 0 && gaps_[middle].left < 0 && gaps_[middle].right < 0 &&
+         "Attempted to erase a gap which doesn't exist");
+  freeGaps_.push_back(middle);
+  root_ = merge(left, right);
+}
+
+void VirtualMemoryAreas::refresh(int32_t node) {
+  Gap& gap = gaps_[node];
+  gap.maxSize = gap.end - gap.start;
+  if (gap.left >= 0) {
+    gap.maxSize = std::max(gap.maxSize, gaps_[gap.left].maxSize);
+  }
+  if (gap.right >= 0) {
+    gap.maxSize = std::max(gap.maxSize, gaps_[gap.right].maxSize);
+  }
+}
+
+void VirtualMemoryAreas::split(int32_t node, uint64_t key, int32_t& left,
+                               int32_t& right) {
+  if (node < 0) {
+    left = -1;
+    right = -1;
+    return;
+  }
+  if (gaps_[node].start < key) {
+    split(gaps_[node].right, key, gaps_[node].right, right);
+    left = node;
+  } else {
+    split(gaps_[node].left, key, left, gaps_[node].left);
+    right = node;
+  }
+  refresh(node);
+}
+
+int32_t VirtualMemoryAreas::merge(int32_t left, int32_t right) {
+  if (left < 0) return right;
+  if (right < 0) return left;
+  if (gaps_[left].priority > gaps_[right].priority) {
+    int32_t merged = merge(gaps_[left].right, right);
+    gaps_[left].right = merged;
+    refresh(left);
+    return left;
+  }
+  int32_t merged = merge(left, gaps_[right].left);
+  gaps_[right].left = merged;
+  refresh(right);
+  return right;
+}
+
+}  // namespace kernel
+}  // namespace simeng
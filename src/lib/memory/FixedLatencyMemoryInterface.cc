@@ -9,24 +9,28 @@ namespace memory {
 FixedLatencyMemoryInterface::FixedLatencyMemoryInterface(char* memory,
                                                          size_t size,
                                                          uint16_t latency)
-    : memory_(memory), size_(size), latency_(latency) {}
+    : memory_(memory),
+      size_(size),
+      pendingRequests_(latency + 1),
+      latency_(latency) {}
 
 void FixedLatencyMemoryInterface::tick() {
   tickCounter_++;
 
-  while (pendingRequests_.size() > 0) {
-    const auto& request = pendingRequests_.front();
-
-    if (request.readyAt > tickCounter_) {
+  while (!pendingRequests_.empty()) {
+    if (pendingRequests_.frontCycle() > tickCounter_) {
       // Head of queue isn't ready yet; end cycle
       break;
     }
 
+    const auto& request = pendingRequests_.front();
     const auto& target = request.target;
 
     if (request.write) {
       // Write: write data directly to memory
-      if (target.address + target.size > size_) {
+      uint64_t writeSize =
+          request.block.empty() ? target.size : request.block.size();
+      if (writeSize > size_ || target.address > size_ - writeSize) {
         std::cerr << "[SimEng:FixedLatencyMemoryInterface] Attempted to write "
                      "beyond memory limit."
                   << std::endl;
@@ -34,8 +38,13 @@ void FixedLatencyMemoryInterface::tick() {
       }
 
       auto ptr = memory_ + target.address;
-      // Copy the data from the RegisterValue to memory
-      memcpy(ptr, request.data.getAsVector<char>(), target.size);
+      if (request.block.empty()) {
+        // Copy the data from the RegisterValue to memory
+        memcpy(ptr, request.data.getAsVector<char>(), target.size);
+      } else {
+        // Copy the whole block to memory at once
+        memcpy(ptr, request.block.data(), writeSize);
+      }
     } else {
       // Read: read data into `completedReads`
       if (target.address + target.size > size_ ||
@@ -52,18 +61,37 @@ void FixedLatencyMemoryInterface::tick() {
     }
 
     // Remove the request from the queue
-    pendingRequests_.pop();
+    pendingRequests_.pop_front();
   }
 }
 
 void FixedLatencyMemoryInterface::requestRead(const MemoryAccessTarget& target,
                                               uint64_t requestId) {
-  pendingRequests_.push({target, tickCounter_ + latency_, requestId});
+  pendingRequests_.push(tickCounter_ + latency_) = {false, target, {},
+                                                   requestId};
 }
 
 void FixedLatencyMemoryInterface::requestWrite(const MemoryAccessTarget& target,
                                                const RegisterValue& data) {
-  pendingRequests_.push({target, data, tickCounter_ + latency_});
+  pendingRequests_.push(tickCounter_ + latency_) = {true, target, data, 0};
+}
+
+void FixedLatencyMemoryInterface::requestBlockWrite(uint64_t address,
+                                                    const char* data,
+                                                    uint64_t size) {
+  if (size == 0) return;
+  pendingRequests_.push(tickCounter_ + latency_) = {
+      true, {address, 0}, {}, 0, std::vector<char>(data, data + size)};
+}
+
+bool FixedLatencyMemoryInterface::readBlock(uint64_t address, char* buffer,
+                                            uint64_t size) {
+  // Queued writes may alter the block before a read requested now completes
+  if (!pendingRequests_.empty()) return false;
+  if (size > size_ || address > size_ - size) return false;
+
+  memcpy(buffer, memory_ + address, size);
+  return true;
 }
 
 const span<MemoryReadResult> FixedLatencyMemoryInterface::getCompletedReads()
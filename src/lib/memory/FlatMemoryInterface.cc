@@ -38,6 +38,26 @@ void FlatMemoryInterface::requestWrite(const MemoryAccessTarget& target,
   memcpy(ptr, data.getAsVector<char>(), target.size);
 }
 
+void FlatMemoryInterface::requestBlockWrite(uint64_t address, const char* data,
+                                            uint64_t size) {
+  if (size > size_ || address > size_ - size) {
+    std::cerr << "[SimEng:FlatLatencyMemoryInterface] Attempted to write "
+                 "beyond memory limit."
+              << std::endl;
+    exit(1);
+  }
+
+  memcpy(memory_ + address, data, size);
+}
+
+bool FlatMemoryInterface::readBlock(uint64_t address, char* buffer,
+                                    uint64_t size) {
+  if (size > size_ || address > size_ - size) return false;
+
+  memcpy(buffer, memory_ + address, size);
+  return true;
+}
+
 const span<MemoryReadResult> FlatMemoryInterface::getCompletedReads() const {
   return {const_cast<MemoryReadResult*>(completedReads_.data()),
           completedReads_.size()};
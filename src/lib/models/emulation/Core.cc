@@ -28,6 +28,19 @@ Core::Core(memory::MemoryInterface& instructionMemory,
       "Emulation core is only compatable with a Flat Instruction Memory "
       "Interface.");
 
+  // Open the branch trace, if requested
+  std::string branchTracePath =
+      config::SimInfo::getConfig()["Core"]["Branch-Trace-File"]
+          .as<std::string>();
+  if (!branchTracePath.empty()) {
+    branchTrace_ = std::make_unique<BranchTraceWriter>(branchTracePath);
+    if (!branchTrace_->isValid()) {
+      std::cerr << "[SimEng:Core] Could not open branch trace file "
+                << branchTracePath << std::endl;
+      exit(1);
+    }
+  }
+
   // Pre-load the first instruction
   instructionMemory_.requestRead({pc_, FETCH_SIZE});
 
@@ -45,7 +58,7 @@ void Core::tick() {
   }
 
   ticks_++;
-  isa_.updateSystemTimerRegisters(&registerFileSet_, ticks_);
+  isa_.updateSystemTimerRegisters(&architecturalRegisterFileSet_, ticks_);
 
   // Fetch & Decode
   assert(macroOp_.empty() &&
@@ -168,6 +181,11 @@ void Core::execute(std::shared_ptr<Instruction>& uop) {
   } else if (uop->isBranch()) {
     pc_ = uop->getBranchAddress();
     branchesExecuted_++;
+    if (branchTrace_) {
+      branchTrace_->record({uop->getInstructionAddress(), pc_,
+                            uop->getKnownOffset(), instructionsExecuted_,
+                            uop->getBranchType(), uop->wasBranchTaken()});
+    }
   }
 
   // Writeback
@@ -41,7 +41,7 @@ void Core::tick() {
   if (hasHalted_) return;
 
   ticks_++;
-  isa_.updateSystemTimerRegisters(&registerFileSet_, ticks_);
+  isa_.updateSystemTimerRegisters(&architecturalRegisterFileSet_, ticks_);
 
   if (exceptionHandler_ != nullptr) {
     processExceptionHandler();
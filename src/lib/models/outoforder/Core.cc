@@ -1,65 +1,93 @@
 #include "simeng/models/outoforder/Core.hh"
 
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <ios>
+#include <iostream>
 #include <sstream>
 #include <string>
 
+#include "simeng/pipeline/FusedInstruction.hh"
+
 namespace simeng {
 namespace models {
 namespace outoforder {
 
-Core::Core(memory::MemoryInterface& instructionMemory,
-           memory::MemoryInterface& dataMemory, uint64_t processMemorySize,
-           uint64_t entryPoint, const arch::Architecture& isa,
-           BranchPredictor& branchPredictor,
-           pipeline::PortAllocator& portAllocator, ryml::ConstNodeRef config)
-    : simeng::Core(dataMemory, isa, config::SimInfo::getPhysRegStruct()),
-      physicalRegisterStructures_(config::SimInfo::getPhysRegStruct()),
-      physicalRegisterQuantities_(config::SimInfo::getPhysRegQuantities()),
-      registerAliasTable_(config::SimInfo::getArchRegStruct(),
-                          physicalRegisterQuantities_),
-      mappedRegisterFileSet_(registerFileSet_, registerAliasTable_),
-      fetchToDecodeBuffer_(config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(),
-                           {}),
-      decodeToRenameBuffer_(
-          config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(), nullptr),
-      renameToDispatchBuffer_(
-          config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(), nullptr),
-      issuePorts_(config["Execution-Units"].num_children(), {1, nullptr}),
-      completionSlots_(
-          config["Execution-Units"].num_children() +
-              config["Pipeline-Widths"]["LSQ-Completion"].as<uint16_t>(),
-          {1, nullptr}),
-      fetchUnit_(fetchToDecodeBuffer_, instructionMemory, processMemorySize,
-                 entryPoint, config["Fetch"]["Fetch-Block-Size"].as<uint16_t>(),
-                 isa, branchPredictor),
-      decodeUnit_(fetchToDecodeBuffer_, decodeToRenameBuffer_, branchPredictor),
-      renameUnit_(decodeToRenameBuffer_, renameToDispatchBuffer_,
-                  reorderBuffer_, registerAliasTable_, loadStoreQueue_,
-                  physicalRegisterStructures_.size()),
-      dispatchIssueUnit_(renameToDispatchBuffer_, issuePorts_, registerFileSet_,
-                         portAllocator, physicalRegisterQuantities_),
-      writebackUnit_(
-          completionSlots_, registerFileSet_,
-          [this](auto insnId) { reorderBuffer_.commitMicroOps(insnId); }),
-      reorderBuffer_(
-          config["Queue-Sizes"]["ROB"].as<uint32_t>(), registerAliasTable_,
-          loadStoreQueue_,
-          [this](auto instruction) { raiseException(instruction); },
+namespace {
+
+/** Scale the physical register file structure to hold a partition of every
+ * register file for each of `threads` hardware threads. */
+std::vector<RegisterFileStructure> scaleRegisterStructures(
+    std::vector<RegisterFileStructure> structures, size_t threads) {
+  for (auto& structure : structures) {
+    structure.quantity = static_cast<uint16_t>(structure.quantity * threads);
+  }
+  return structures;
+}
+
+/** Scale the physical register quantities to hold a partition of every
+ * register file for each of `threads` hardware threads. */
+std::vector<uint16_t> scaleRegisterQuantities(std::vector<uint16_t> quantities,
+                                              size_t threads) {
+  for (auto& quantity : quantities) {
+    quantity = static_cast<uint16_t>(quantity * threads);
+  }
+  return quantities;
+}
+
+}  // namespace
+
+Core::Thread::Thread(Core& core, uint16_t id, const ThreadContext& context,
+                     ryml::ConstNodeRef config)
+    : context(context),
+      registerAliasTable(config::SimInfo::getArchRegStruct(),
+                         config::SimInfo::getPhysRegQuantities(), id),
+      mappedRegisterFileSet(core.registerFileSet_, registerAliasTable),
+      fetchToDecodeBuffer(config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(),
+                          {}),
+      decodeToRenameBuffer(config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(),
+                           nullptr),
+      microOpCache(
+          config["Fetch"]["Micro-Op-Cache-Capacity"].as<uint32_t>(),
+          config["Fetch"]["Micro-Op-Cache-Associativity"].as<uint16_t>(),
+          config["Fetch"]["Micro-Op-Cache-Line-Size"].as<uint16_t>(),
+          config["Fetch"]["Fetch-Block-Size"].as<uint16_t>()),
+      fetchUnit(fetchToDecodeBuffer, context.instructionMemory,
+                context.processMemorySize, context.entryPoint,
+                config["Fetch"]["Fetch-Block-Size"].as<uint16_t>(),
+                context.isa, context.branchPredictor, &microOpCache,
+                config["Fetch"]["Fetch-Target-Queue-Size"].as<uint16_t>()),
+      decodeUnit(fetchToDecodeBuffer, decodeToRenameBuffer,
+                 context.branchPredictor,
+                 config.has_child(ryml::to_csubstr("Macro-Op-Fusion"))
+                     ? &context.isa
+                     : nullptr),
+      renameUnit(decodeToRenameBuffer, core.renameToDispatchBuffer_,
+                 reorderBuffer, registerAliasTable, loadStoreQueue,
+                 core.physicalRegisterStructures_.size()),
+      reorderBuffer(
+          config["Queue-Sizes"]["ROB"].as<uint32_t>(), registerAliasTable,
+          loadStoreQueue,
+          [this](auto instruction) {
+            exceptionGenerated = true;
+            exceptionGeneratingInstruction = instruction;
+          },
           [this](auto branchAddress) {
-            fetchUnit_.registerLoopBoundary(branchAddress);
+            fetchUnit.registerLoopBoundary(branchAddress);
           },
-          branchPredictor, config["Fetch"]["Loop-Buffer-Size"].as<uint16_t>(),
-          config["Fetch"]["Loop-Detection-Threshold"].as<uint16_t>()),
-      loadStoreQueue_(
+          context.branchPredictor, core.storeSetPredictor_,
+          config["Fetch"]["Loop-Buffer-Size"].as<uint16_t>(),
+          config["Fetch"]["Loop-Detection-Threshold"].as<uint16_t>(), id),
+      loadStoreQueue(
           config["Queue-Sizes"]["Load"].as<uint32_t>(),
-          config["Queue-Sizes"]["Store"].as<uint32_t>(), dataMemory,
-          {completionSlots_.data() + config["Execution-Units"].num_children(),
+          config["Queue-Sizes"]["Store"].as<uint32_t>(), context.dataMemory,
+          {core.completionSlots_.data() +
+               config["Execution-Units"].num_children() +
+               id * config["Pipeline-Widths"]["LSQ-Completion"].as<uint16_t>(),
            config["Pipeline-Widths"]["LSQ-Completion"].as<uint16_t>()},
-          [this](auto regs, auto values) {
-            dispatchIssueUnit_.forwardOperands(regs, values);
+          [&core](auto regs, auto values) {
+            core.dispatchIssueUnit_.forwardOperands(regs, values);
           },
           [](auto uop) { uop->setCommitReady(); },
           config["LSQ-L1-Interface"]["Exclusive"].as<bool>(),
@@ -70,10 +98,72 @@ Core::Core(memory::MemoryInterface& instructionMemory,
           config["LSQ-L1-Interface"]["Permitted-Loads-Per-Cycle"]
               .as<uint16_t>(),
           config["LSQ-L1-Interface"]["Permitted-Stores-Per-Cycle"]
-              .as<uint16_t>()),
+              .as<uint16_t>(),
+          config["LSQ-L1-Interface"]["Coalesce-Requests"].as<bool>(),
+          config["LSQ-L1-Interface"]["Cache-Line-Width"].as<uint16_t>(),
+          config["LSQ-L1-Interface"]["Forwarding-Latency"].as<uint16_t>()) {}
+
+Core::Core(memory::MemoryInterface& instructionMemory,
+           memory::MemoryInterface& dataMemory, uint64_t processMemorySize,
+           uint64_t entryPoint, const arch::Architecture& isa,
+           BranchPredictor& branchPredictor,
+           pipeline::PortAllocator& portAllocator, ryml::ConstNodeRef config)
+    : Core({{instructionMemory, dataMemory, processMemorySize, entryPoint, isa,
+             branchPredictor}},
+           portAllocator, config) {}
+
+Core::Core(const std::vector<ThreadContext>& threads,
+           pipeline::PortAllocator& portAllocator, ryml::ConstNodeRef config)
+    : simeng::Core(threads[0].dataMemory, threads[0].isa,
+                   scaleRegisterStructures(config::SimInfo::getPhysRegStruct(),
+                                           threads.size())),
+      physicalRegisterStructures_(scaleRegisterStructures(
+          config::SimInfo::getPhysRegStruct(), threads.size())),
+      physicalRegisterQuantities_(scaleRegisterQuantities(
+          config::SimInfo::getPhysRegQuantities(), threads.size())),
+      renameToDispatchBuffer_(
+          config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>(), nullptr),
+      issuePorts_(config["Execution-Units"].num_children(), {1, nullptr}),
+      completionSlots_(
+          config["Execution-Units"].num_children() +
+              threads.size() *
+                  config["Pipeline-Widths"]["LSQ-Completion"].as<uint16_t>(),
+          {1, nullptr}),
+      storeSetPredictor_(
+          config["Queue-Sizes"]["Store-Set-ID-Table"].as<uint32_t>(),
+          config["Queue-Sizes"]["Last-Fetched-Store-Table"].as<uint32_t>()),
+      dispatchIssueUnit_(renameToDispatchBuffer_, issuePorts_, registerFileSet_,
+                         portAllocator, storeSetPredictor_,
+                         physicalRegisterQuantities_),
+      writebackUnit_(completionSlots_, registerFileSet_,
+                     [this](auto insnId) {
+                       // Instruction IDs are allocated from a range private to
+                       // each thread, identified by their upper bits
+                       threads_[insnId >> 48]->reorderBuffer.commitMicroOps(
+                           insnId);
+                     }),
       portAllocator_(portAllocator),
       commitWidth_(config["Pipeline-Widths"]["Commit"].as<uint16_t>()),
-      branchPredictor_(branchPredictor) {
+      topDown_(config["Pipeline-Widths"]["FrontEnd"].as<uint16_t>()) {
+  // The Hardware-Threads section is optional, leaving the default policies
+  // if omitted
+  ryml::ConstNodeRef threadConfig = config["Hardware-Threads"];
+  bool hasThreadConfig = threadConfig.is_map();
+  if (hasThreadConfig &&
+      threadConfig.has_child(ryml::to_csubstr("Fetch-Policy")) &&
+      threadConfig["Fetch-Policy"].as<std::string>() == "ICount") {
+    fetchPolicy_ = FetchPolicy::ICount;
+  }
+  if (hasThreadConfig &&
+      threadConfig.has_child(ryml::to_csubstr("Commit-Policy")) &&
+      threadConfig["Commit-Policy"].as<std::string>() == "Shared") {
+    commitPolicy_ = CommitPolicy::Shared;
+  }
+
+  for (size_t id = 0; id < threads.size(); id++) {
+    threads_.push_back(std::make_unique<Thread>(*this, id, threads[id], config));
+  }
+
   for (size_t i = 0; i < config["Execution-Units"].num_children(); i++) {
     // Create vector of blocking groups
     std::vector<uint16_t> blockingGroups = {};
@@ -86,8 +176,16 @@ Core::Core(memory::MemoryInterface& instructionMemory,
         [this](auto regs, auto values) {
           dispatchIssueUnit_.forwardOperands(regs, values);
         },
-        [this](auto uop) { loadStoreQueue_.startLoad(uop); },
-        [this](auto uop) { loadStoreQueue_.supplyStoreData(uop); },
+        [this](auto uop) {
+          uop->setLoadStartCycle(ticks_);
+          threads_[uop->getThreadId()]->loadStoreQueue.startLoad(uop);
+        },
+        [this](auto uop) {
+          threads_[uop->getThreadId()]->loadStoreQueue.supplyStoreData(uop);
+          if (uop->isStoreAddress()) {
+            dispatchIssueUnit_.releaseMemoryDependents(uop);
+          }
+        },
         [](auto uop) { uop->setCommitReady(); },
         config["Execution-Units"][i]["Pipelined"].as<bool>(), blockingGroups);
   }
@@ -96,40 +194,156 @@ Core::Core(memory::MemoryInterface& instructionMemory,
     dispatchIssueUnit_.getRSSizes(sizeVec);
   });
 
-  // Query and apply initial state
-  auto state = isa.getInitialState();
-  applyStateChange(state);
+  // Create the hotspot profiler, if requested, notifying it of each
+  // instruction retired
+  profilePath_ = config["Core"]["Profile-File"].as<std::string>();
+  if (!profilePath_.empty()) {
+    if (!std::ofstream(profilePath_).is_open()) {
+      std::cerr << "[SimEng:Core] Could not open profile file " << profilePath_
+                << std::endl;
+      exit(1);
+    }
+    profiler_ = std::make_unique<pipeline::HotspotProfiler>(threads_.size());
+    for (size_t id = 0; id < threads_.size(); id++) {
+      threads_[id]->reorderBuffer.setRetireHandler([this, id](const auto& uop) {
+        bool raisedException = uop->exceptionEncountered();
+        bool mispredicted = !raisedException && uop->isBranch() &&
+                            uop->wasBranchMispredicted();
+        uint8_t instructions =
+            uop->isLastMicroOp() ? (uop->isFused() ? 2 : 1) : 0;
+        profiler_->retire(id, uop->getInstructionAddress(), instructions,
+                          mispredicted, raisedException);
+      });
+    }
+  }
+
+  topDownPath_ = config["Core"]["Top-Down-File"].as<std::string>();
+  if (!topDownPath_.empty() && !std::ofstream(topDownPath_).is_open()) {
+    std::cerr << "[SimEng:Core] Could not open top-down file " << topDownPath_
+              << std::endl;
+    exit(1);
+  }
+
+  // Query and apply each thread's initial state
+  for (size_t id = 0; id < threads_.size(); id++) {
+    activeThread_ = id;
+    auto state = threads_[id]->context.isa.getInitialState();
+    applyStateChange(state, threads_[id]->context.dataMemory);
+  }
+  activeThread_ = 0;
+}
+
+Core::~Core() {
+  if (profiler_ != nullptr) {
+    std::ofstream file(profilePath_);
+    profiler_->write(file);
+  }
+  if (!topDownPath_.empty()) {
+    // The breakdown is written as JSON to files named as such, and as YAML
+    // otherwise
+    const std::string extension = ".json";
+    bool json = topDownPath_.size() >= extension.size() &&
+                topDownPath_.compare(topDownPath_.size() - extension.size(),
+                                     extension.size(), extension) == 0;
+    std::ofstream file(topDownPath_);
+    topDown_.write(file, json);
+  }
 }
 
 void Core::tick() {
   if (hasHalted_) return;
 
   ticks_++;
-  isa_.updateSystemTimerRegisters(&registerFileSet_, ticks_);
 
-  if (exceptionHandler_ != nullptr) {
-    processExceptionHandler();
-    return;
+  // Threads handling an exception sit out the cycle
+  bool anyActive = false;
+  for (size_t id = 0; id < threads_.size(); id++) {
+    auto& thread = *threads_[id];
+    thread.active = false;
+    if (thread.halted) continue;
+
+    thread.context.isa.updateSystemTimerRegisters(
+        &thread.mappedRegisterFileSet, ticks_);
+
+    if (thread.exceptionHandler != nullptr) {
+      processExceptionHandler(id);
+    } else {
+      thread.active = true;
+      anyActive = true;
+    }
+  }
+
+  if (anyActive) {
+    tickPipeline();
+  } else {
+    accountSlots(threads_.size());
   }
+  if (profiler_ != nullptr) profileCycle();
 
+  // The memory interfaces of the first thread are ticked by the simulation
+  // loop, alongside the core
+  for (size_t id = 1; id < threads_.size(); id++) {
+    threads_[id]->context.instructionMemory.tick();
+    threads_[id]->context.dataMemory.tick();
+  }
+}
+
+void Core::tickPipeline() {
   // Tick port allocators internal functionality at start of cycle
   portAllocator_.tick();
 
+  if (profiler_ != nullptr) {
+    // Loads complete as they reach writeback from the completion slots of the
+    // load/store queues
+    for (size_t i = executionUnits_.size(); i < completionSlots_.size(); i++) {
+      const auto& load = completionSlots_[i].getHeadSlots()[0];
+      if (load != nullptr && !load->isFlushed()) {
+        profiler_->completeLoad(load->getInstructionAddress(),
+                                ticks_ - load->getLoadStartCycle());
+      }
+    }
+  }
+
   // Writeback must be ticked at start of cycle, to ensure decode reads the
   // correct values
   writebackUnit_.tick();
 
-  // Tick units
-  fetchUnit_.tick();
-  decodeUnit_.tick();
-  renameUnit_.tick();
+  // Tick units. A single thread fetches and renames each cycle, while every
+  // active thread decodes.
+  uint16_t fetchThread = selectFetchThread();
+  if (fetchThread < threads_.size()) {
+    threads_[fetchThread]->fetchUnit.tick();
+  }
+  for (auto& thread : threads_) {
+    if (thread->active) thread->decodeUnit.tick();
+  }
+  uint16_t renameThread = selectRenameThread();
+  for (size_t id = 0; id < threads_.size(); id++) {
+    auto& thread = *threads_[id];
+    if (id == renameThread) {
+      thread.renameUnit.tick();
+    } else if (thread.active) {
+      // Hold any instructions awaiting rename in place, as if rename had
+      // stalled
+      auto renameSlots = thread.decodeToRenameBuffer.getHeadSlots();
+      thread.decodeToRenameBuffer.stall(std::any_of(
+          renameSlots, renameSlots + thread.decodeToRenameBuffer.getWidth(),
+          [](const auto& uop) { return uop != nullptr; }));
+    }
+  }
+  accountSlots(renameThread);
   dispatchIssueUnit_.tick();
   for (auto& eu : executionUnits_) {
-    // Tick each execution unit
-    eu.tick();
+    // Tick each execution unit with work to do
+    if (!trackActivity_ || eu.isActive()) eu.tick();
   }
 
-  loadStoreQueue_.tick();
+  for (auto& thread : threads_) {
+    if (thread->active &&
+        (!trackActivity_ || thread->loadStoreQueue.isActive())) {
+      thread->loadStoreQueue.tick();
+    }
+  }
 
   // Late tick for the dispatch/issue unit to issue newly ready uops
   dispatchIssueUnit_.issue();
@@ -137,27 +351,130 @@ void Core::tick() {
   // Tick buffers
   // Each unit must have wiped the entries at the head of the buffer after use,
   // as these will now loop around and become the tail.
-  fetchToDecodeBuffer_.tick();
-  decodeToRenameBuffer_.tick();
+  for (auto& thread : threads_) {
+    if (!thread->active) continue;
+    thread->fetchToDecodeBuffer.tick();
+    thread->decodeToRenameBuffer.tick();
+  }
   renameToDispatchBuffer_.tick();
+  // Empty issue ports and completion slots are left untouched, as ticking them
+  // has no effect
   for (auto& issuePort : issuePorts_) {
-    issuePort.tick();
+    if (!trackActivity_ || !issuePort.isEmpty(nullptr)) issuePort.tick();
   }
   for (auto& completionSlot : completionSlots_) {
-    completionSlot.tick();
+    if (!trackActivity_ || !completionSlot.isEmpty(nullptr)) {
+      completionSlot.tick();
+    }
   }
 
   // Commit instructions from ROB
-  reorderBuffer_.commit(commitWidth_);
+  commit();
 
-  if (exceptionGenerated_) {
-    handleException();
-    fetchUnit_.requestFromPC();
-    return;
+  for (size_t id = 0; id < threads_.size(); id++) {
+    auto& thread = *threads_[id];
+    if (!thread.active) continue;
+
+    if (thread.exceptionGenerated) {
+      handleException(id);
+    } else {
+      flushIfNeeded(id);
+    }
+    thread.fetchUnit.requestFromPC();
   }
+}
+
+uint16_t Core::selectFetchThread() {
+  if (threads_.size() == 1) return 0;
 
-  flushIfNeeded();
-  fetchUnit_.requestFromPC();
+  uint16_t selected = threads_.size();
+  uint32_t selectedCount = 0;
+  // Consider threads in turn, starting after the one most recently fetched for
+  for (size_t i = 1; i <= threads_.size(); i++) {
+    uint16_t id = (fetchThread_ + i) % threads_.size();
+    const auto& thread = *threads_[id];
+    if (!thread.active || thread.fetchToDecodeBuffer.isStalled() ||
+        thread.fetchUnit.hasHalted()) {
+      continue;
+    }
+    if (fetchPolicy_ == FetchPolicy::RoundRobin) {
+      selected = id;
+      break;
+    }
+    uint32_t count = getInFlightCount(id);
+    if (selected == threads_.size() || count < selectedCount) {
+      selected = id;
+      selectedCount = count;
+    }
+  }
+
+  if (selected < threads_.size()) fetchThread_ = selected;
+  return selected;
+}
+
+uint16_t Core::selectRenameThread() {
+  if (threads_.size() == 1) return 0;
+
+  for (size_t i = 1; i <= threads_.size(); i++) {
+    uint16_t id = (renameThread_ + i) % threads_.size();
+    const auto& thread = *threads_[id];
+    if (!thread.active) continue;
+    auto renameSlots = thread.decodeToRenameBuffer.getHeadSlots();
+    if (std::any_of(renameSlots,
+                    renameSlots + thread.decodeToRenameBuffer.getWidth(),
+                    [](const auto& uop) { return uop != nullptr; })) {
+      renameThread_ = id;
+      return id;
+    }
+  }
+  return threads_.size();
+}
+
+void Core::commit() {
+  uint64_t width = commitWidth_;
+  // Offer the commit width to each thread in turn, starting after the thread
+  // most recently given priority. Threads left without any width are still
+  // called upon, to clear their flush state for the cycle.
+  uint16_t first = commitThread_;
+  for (size_t i = 1; i <= threads_.size(); i++) {
+    uint16_t id = (first + i) % threads_.size();
+    auto& thread = *threads_[id];
+    if (!thread.active) continue;
+
+    unsigned int committed = thread.reorderBuffer.commit(width);
+    topDown_.retire(committed);
+    if (commitPolicy_ == CommitPolicy::Shared) {
+      width -= committed;
+    } else if (committed > 0 && width > 0) {
+      width = 0;
+      commitThread_ = id;
+    }
+  }
+  if (commitPolicy_ == CommitPolicy::Shared) {
+    commitThread_ = (commitThread_ + 1) % threads_.size();
+  }
+}
+
+uint32_t Core::getInFlightCount(uint16_t id) const {
+  const auto& thread = *threads_[id];
+  uint32_t count = dispatchIssueUnit_.getThreadOccupancy(id);
+
+  auto decodeSlots = thread.fetchToDecodeBuffer.getHeadSlots();
+  for (size_t slot = 0; slot < thread.fetchToDecodeBuffer.getWidth(); slot++) {
+    count += decodeSlots[slot].size();
+  }
+  auto renameSlots = thread.decodeToRenameBuffer.getHeadSlots();
+  for (size_t slot = 0; slot < thread.decodeToRenameBuffer.getWidth(); slot++) {
+    if (renameSlots[slot] != nullptr) count++;
+  }
+  auto dispatchSlots = renameToDispatchBuffer_.getHeadSlots();
+  for (size_t slot = 0; slot < renameToDispatchBuffer_.getWidth(); slot++) {
+    if (dispatchSlots[slot] != nullptr &&
+        dispatchSlots[slot]->getThreadId() == id) {
+      count++;
+    }
+  }
+  return count;
 }
 
 bool Core::hasHalted() const {
@@ -165,232 +482,549 @@ bool Core::hasHalted() const {
     return true;
   }
 
-  // Core is considered to have halted when the fetch unit has halted, there
-  // are no uops at the head of any buffer, and no exception is currently being
-  // handled.
-  if (!fetchUnit_.hasHalted()) {
+  return std::all_of(threads_.begin(), threads_.end(),
+                     [this](const auto& thread) { return hasHalted(*thread); });
+}
+
+bool Core::hasHalted(const Thread& thread) const {
+  if (thread.halted) {
+    return true;
+  }
+
+  // A thread is considered to have halted when its fetch unit has halted,
+  // there are no uops at the head of any of its buffers, and no exception is
+  // currently being handled.
+  if (!thread.fetchUnit.hasHalted()) {
     return false;
   }
 
-  if (reorderBuffer_.size() > 0) {
+  if (thread.reorderBuffer.size() > 0) {
     return false;
   }
 
-  auto decodeSlots = fetchToDecodeBuffer_.getHeadSlots();
-  for (size_t slot = 0; slot < fetchToDecodeBuffer_.getWidth(); slot++) {
+  auto decodeSlots = thread.fetchToDecodeBuffer.getHeadSlots();
+  for (size_t slot = 0; slot < thread.fetchToDecodeBuffer.getWidth(); slot++) {
     if (decodeSlots[slot].size() > 0) {
       return false;
     }
   }
 
-  auto renameSlots = decodeToRenameBuffer_.getHeadSlots();
-  for (size_t slot = 0; slot < decodeToRenameBuffer_.getWidth(); slot++) {
+  auto renameSlots = thread.decodeToRenameBuffer.getHeadSlots();
+  for (size_t slot = 0; slot < thread.decodeToRenameBuffer.getWidth(); slot++) {
     if (renameSlots[slot] != nullptr) {
       return false;
     }
   }
 
-  if (exceptionHandler_ != nullptr) return false;
+  if (thread.exceptionHandler != nullptr) return false;
+
+  // The memory interfaces of the first thread are drained by the simulation
+  // loop; those of any other thread must be drained before the core halts
+  if (&thread != threads_[0].get() &&
+      thread.context.dataMemory.hasPendingRequests()) {
+    return false;
+  }
 
   return true;
 }
 
 const ArchitecturalRegisterFileSet& Core::getArchitecturalRegisterFileSet()
     const {
-  return mappedRegisterFileSet_;
+  return threads_[activeThread_]->mappedRegisterFileSet;
 }
 
+void Core::setActivityTracking(bool enabled) { trackActivity_ = enabled; }
+
 uint64_t Core::getInstructionsRetiredCount() const {
-  return reorderBuffer_.getInstructionsCommittedCount();
+  uint64_t retired = 0;
+  for (const auto& thread : threads_) {
+    retired += thread->reorderBuffer.getInstructionsCommittedCount();
+  }
+  return retired;
 }
 
 std::map<std::string, std::string> Core::getStats() const {
-  auto retired = reorderBuffer_.getInstructionsCommittedCount();
+  uint64_t retired = 0;
+  uint64_t branchStalls = 0;
+  uint64_t earlyFlushes = 0;
+  uint64_t decoded = 0;
+  uint64_t fused = 0;
+  uint64_t allocationStalls = 0;
+  uint64_t robStalls = 0;
+  uint64_t lqStalls = 0;
+  uint64_t sqStalls = 0;
+  uint64_t totalBranchesFetched = 0;
+  uint64_t microOpCacheHits = 0;
+  uint64_t microOpCacheMisses = 0;
+  double ftqOccupancy = 0.0;
+  uint64_t prefetchesIssued = 0;
+  uint64_t prefetchesUsed = 0;
+  uint64_t totalBranchesRetired = 0;
+  uint64_t totalBranchMispredicts = 0;
+  uint64_t indirectBranchesRetired = 0;
+  uint64_t indirectBranchMispredicts = 0;
+  uint64_t loadViolations = 0;
+  uint64_t coalescedAccesses = 0;
+  uint64_t coalescedRequests = 0;
+  uint64_t forwardedAccesses = 0;
+  uint64_t stalledAccesses = 0;
+  for (const auto& thread : threads_) {
+    retired += thread->reorderBuffer.getInstructionsCommittedCount();
+    branchStalls += thread->fetchUnit.getBranchStalls();
+    earlyFlushes += thread->decodeUnit.getEarlyFlushes();
+    decoded += thread->decodeUnit.getDecodedCount();
+    fused += thread->decodeUnit.getFusedCount();
+    allocationStalls += thread->renameUnit.getAllocationStalls();
+    robStalls += thread->renameUnit.getROBStalls();
+    lqStalls += thread->renameUnit.getLoadQueueStalls();
+    sqStalls += thread->renameUnit.getStoreQueueStalls();
+    totalBranchesFetched += thread->fetchUnit.getBranchFetchedCount();
+    microOpCacheHits += thread->fetchUnit.getMicroOpCacheHits();
+    microOpCacheMisses += thread->fetchUnit.getMicroOpCacheMisses();
+    ftqOccupancy += thread->fetchUnit.getAverageFetchTargetQueueOccupancy();
+    prefetchesIssued += thread->fetchUnit.getPrefetchesIssued();
+    prefetchesUsed += thread->fetchUnit.getPrefetchesUsed();
+    totalBranchesRetired += thread->reorderBuffer.getRetiredBranchesCount();
+    totalBranchMispredicts +=
+        thread->reorderBuffer.getBranchMispredictedCount();
+    indirectBranchesRetired +=
+        thread->reorderBuffer.getRetiredIndirectBranchesCount();
+    indirectBranchMispredicts +=
+        thread->reorderBuffer.getIndirectBranchMispredictedCount();
+    loadViolations += thread->reorderBuffer.getViolatingLoadsCount();
+    coalescedAccesses += thread->loadStoreQueue.getCoalescedAccessesCount();
+    coalescedRequests += thread->loadStoreQueue.getCoalescedRequestsCount();
+    forwardedAccesses += thread->loadStoreQueue.getForwardedAccessesCount();
+    stalledAccesses += thread->loadStoreQueue.getStalledAccessesCount();
+  }
+
   auto ipc = retired / static_cast<float>(ticks_);
   std::ostringstream ipcStr;
   ipcStr << std::setprecision(2) << ipc;
 
-  auto branchStalls = fetchUnit_.getBranchStalls();
-
-  auto earlyFlushes = decodeUnit_.getEarlyFlushes();
-
-  auto allocationStalls = renameUnit_.getAllocationStalls();
-  auto robStalls = renameUnit_.getROBStalls();
-  auto lqStalls = renameUnit_.getLoadQueueStalls();
-  auto sqStalls = renameUnit_.getStoreQueueStalls();
-
   auto rsStalls = dispatchIssueUnit_.getRSStalls();
   auto frontendStalls = dispatchIssueUnit_.getFrontendStalls();
   auto backendStalls = dispatchIssueUnit_.getBackendStalls();
   auto portBusyStalls = dispatchIssueUnit_.getPortBusyStalls();
 
-  uint64_t totalBranchesFetched = fetchUnit_.getBranchFetchedCount();
-  uint64_t totalBranchesRetired = reorderBuffer_.getRetiredBranchesCount();
-  uint64_t totalBranchMispredicts = reorderBuffer_.getBranchMispredictedCount();
-
   auto branchMissRate = 100.0 * static_cast<double>(totalBranchMispredicts) /
                         static_cast<double>(totalBranchesRetired);
   std::ostringstream branchMissRateStr;
   branchMissRateStr << std::setprecision(3) << branchMissRate << "%";
 
-  return {{"cycles", std::to_string(ticks_)},
-          {"retired", std::to_string(retired)},
-          {"ipc", ipcStr.str()},
-          {"flushes", std::to_string(flushes_)},
-          {"fetch.branchStalls", std::to_string(branchStalls)},
-          {"decode.earlyFlushes", std::to_string(earlyFlushes)},
-          {"rename.allocationStalls", std::to_string(allocationStalls)},
-          {"rename.robStalls", std::to_string(robStalls)},
-          {"rename.lqStalls", std::to_string(lqStalls)},
-          {"rename.sqStalls", std::to_string(sqStalls)},
-          {"dispatch.rsStalls", std::to_string(rsStalls)},
-          {"issue.frontendStalls", std::to_string(frontendStalls)},
-          {"issue.backendStalls", std::to_string(backendStalls)},
-          {"issue.portBusyStalls", std::to_string(portBusyStalls)},
-          {"branch.fetched", std::to_string(totalBranchesFetched)},
-          {"branch.retired", std::to_string(totalBranchesRetired)},
-          {"branch.mispredicted", std::to_string(totalBranchMispredicts)},
-          {"branch.missrate", branchMissRateStr.str()},
-          {"lsq.loadViolations",
-           std::to_string(reorderBuffer_.getViolatingLoadsCount())}};
+  auto indirectMissRate =
+      indirectBranchesRetired
+          ? 100.0 * static_cast<double>(indirectBranchMispredicts) /
+                static_cast<double>(indirectBranchesRetired)
+          : 0.0;
+  std::ostringstream indirectMissRateStr;
+  indirectMissRateStr << std::setprecision(3) << indirectMissRate << "%";
+
+  // The proportion of decoded instructions which were fused into macro-ops.
+  // Each fused macro-op was decoded as one uop in place of two instructions
+  auto decodedInstructions = decoded + fused;
+  auto fusionRate =
+      decodedInstructions ? 200.0 * static_cast<double>(fused) /
+                                static_cast<double>(decodedInstructions)
+                          : 0.0;
+  std::ostringstream fusionRateStr;
+  fusionRateStr << std::setprecision(3) << fusionRate << "%";
+
+  // The proportion of micro-op cache lookups which supplied instructions
+  auto microOpCacheLookups = microOpCacheHits + microOpCacheMisses;
+  auto microOpCacheHitRate =
+      microOpCacheLookups ? 100.0 * static_cast<double>(microOpCacheHits) /
+                                static_cast<double>(microOpCacheLookups)
+                          : 0.0;
+  std::ostringstream microOpCacheHitRateStr;
+  microOpCacheHitRateStr << std::setprecision(3) << microOpCacheHitRate << "%";
+
+  // The mean fetch target queue occupancy per thread, and the proportion of
+  // prefetched fetch blocks which were used
+  std::ostringstream ftqOccupancyStr;
+  ftqOccupancyStr << std::setprecision(3) << ftqOccupancy / threads_.size();
+  auto prefetchAccuracy =
+      prefetchesIssued ? 100.0 * static_cast<double>(prefetchesUsed) /
+                             static_cast<double>(prefetchesIssued)
+                       : 0.0;
+  std::ostringstream prefetchAccuracyStr;
+  prefetchAccuracyStr << std::setprecision(3) << prefetchAccuracy << "%";
+
+  std::map<std::string, std::string> stats = {
+      {"cycles", std::to_string(ticks_)},
+      {"retired", std::to_string(retired)},
+      {"ipc", ipcStr.str()},
+      {"flushes", std::to_string(flushes_)},
+      {"fetch.branchStalls", std::to_string(branchStalls)},
+      {"fetch.microOpCacheHits", std::to_string(microOpCacheHits)},
+      {"fetch.microOpCacheMisses", std::to_string(microOpCacheMisses)},
+      {"fetch.microOpCacheHitRate", microOpCacheHitRateStr.str()},
+      {"fetch.ftqOccupancy", ftqOccupancyStr.str()},
+      {"fetch.prefetchesIssued", std::to_string(prefetchesIssued)},
+      {"fetch.prefetchesUsed", std::to_string(prefetchesUsed)},
+      {"fetch.prefetchAccuracy", prefetchAccuracyStr.str()},
+      {"decode.earlyFlushes", std::to_string(earlyFlushes)},
+      {"decode.fused", std::to_string(fused)},
+      {"decode.fusionRate", fusionRateStr.str()},
+      {"rename.allocationStalls", std::to_string(allocationStalls)},
+      {"rename.robStalls", std::to_string(robStalls)},
+      {"rename.lqStalls", std::to_string(lqStalls)},
+      {"rename.sqStalls", std::to_string(sqStalls)},
+      {"dispatch.rsStalls", std::to_string(rsStalls)},
+      {"issue.frontendStalls", std::to_string(frontendStalls)},
+      {"issue.backendStalls", std::to_string(backendStalls)},
+      {"issue.portBusyStalls", std::to_string(portBusyStalls)},
+      {"branch.fetched", std::to_string(totalBranchesFetched)},
+      {"branch.retired", std::to_string(totalBranchesRetired)},
+      {"branch.mispredicted", std::to_string(totalBranchMispredicts)},
+      {"branch.missrate", branchMissRateStr.str()},
+      {"branch.indirectRetired", std::to_string(indirectBranchesRetired)},
+      {"branch.indirectMispredicted",
+       std::to_string(indirectBranchMispredicts)},
+      {"branch.indirectMissrate", indirectMissRateStr.str()},
+      {"lsq.loadViolations", std::to_string(loadViolations)},
+      {"lsq.coalescedAccesses", std::to_string(coalescedAccesses)},
+      {"lsq.coalescedRequests", std::to_string(coalescedRequests)},
+      {"lsq.forwardedAccesses", std::to_string(forwardedAccesses)},
+      {"lsq.stalledAccesses", std::to_string(stalledAccesses)},
+      {"lsq.predictedDependencies",
+       std::to_string(storeSetPredictor_.getPredictedDependenciesCount())},
+      {"lsq.storeSetTrainings",
+       std::to_string(storeSetPredictor_.getTrainingsCount())}};
+
+  auto topDownStats = topDown_.getStats();
+  stats.insert(topDownStats.begin(), topDownStats.end());
+
+  if (threads_.size() > 1) {
+    for (size_t id = 0; id < threads_.size(); id++) {
+      auto threadRetired =
+          threads_[id]->reorderBuffer.getInstructionsCommittedCount();
+      std::ostringstream threadIpcStr;
+      threadIpcStr << std::setprecision(2)
+                   << threadRetired / static_cast<float>(ticks_);
+      std::string prefix = "thread." + std::to_string(id) + ".";
+      stats[prefix + "retired"] = std::to_string(threadRetired);
+      stats[prefix + "ipc"] = threadIpcStr.str();
+    }
+  }
+
+  return stats;
+}
+
+void Core::setProfileSymbols(std::vector<ElfSymbol> symbols) {
+  if (profiler_ != nullptr) profiler_->setSymbols(std::move(symbols));
 }
 
-void Core::raiseException(const std::shared_ptr<Instruction>& instruction) {
-  exceptionGenerated_ = true;
-  exceptionGeneratingInstruction_ = instruction;
+const pipeline::HotspotProfiler* Core::getProfiler() const {
+  return profiler_.get();
 }
 
-void Core::handleException() {
+void Core::handleException(uint16_t id) {
+  auto& thread = *threads_[id];
   // Check for branch instructions in buffer, and flush them from the BP.
   // Then empty the buffers
-  branchPredictor_.flushBranchesInBufferFromSelf(fetchToDecodeBuffer_);
-  fetchToDecodeBuffer_.fill({});
-  fetchToDecodeBuffer_.stall(false);
+  thread.context.branchPredictor.flushBranchesInBufferFromSelf(
+      thread.fetchToDecodeBuffer);
+  thread.fetchToDecodeBuffer.fill({});
+  thread.fetchToDecodeBuffer.stall(false);
 
-  branchPredictor_.flushBranchesInBufferFromSelf(decodeToRenameBuffer_);
-  decodeToRenameBuffer_.fill(nullptr);
-  decodeToRenameBuffer_.stall(false);
-
-  // Instructions in this buffer are already accounted for in the ROB so no
-  // need to check for branch instructions in this buffer
-  renameToDispatchBuffer_.fill(nullptr);
-  renameToDispatchBuffer_.stall(false);
+  thread.context.branchPredictor.flushBranchesInBufferFromSelf(
+      thread.decodeToRenameBuffer);
+  thread.decodeToRenameBuffer.fill(nullptr);
+  thread.decodeToRenameBuffer.stall(false);
 
   // Flush everything younger than the exception-generating instruction.
   // This must happen prior to handling the exception to ensure the commit state
   // is up-to-date with the register mapping table
-  reorderBuffer_.flush(exceptionGeneratingInstruction_->getInstructionId());
-  decodeUnit_.purgeFlushed();
+  unsigned int inFlight = thread.reorderBuffer.size();
+  thread.reorderBuffer.flush(
+      thread.exceptionGeneratingInstruction->getInstructionId());
+  topDown_.squash(inFlight - thread.reorderBuffer.size(),
+                  pipeline::SlotStall::MachineClear);
+  thread.recovery = pipeline::SlotStall::MachineClear;
+  // Instructions in the rename/dispatch buffer are already accounted for in
+  // the ROB so no need to check for branch instructions in this buffer
+  purgeRenameToDispatchBuffer();
+  thread.decodeUnit.purgeFlushed();
   dispatchIssueUnit_.purgeFlushed();
-  loadStoreQueue_.purgeFlushed();
+  thread.loadStoreQueue.purgeFlushed();
   for (auto& eu : executionUnits_) {
     eu.purgeFlushed();
   }
 
-  exceptionGenerated_ = false;
-  exceptionHandler_ =
-      isa_.handleException(exceptionGeneratingInstruction_, *this, dataMemory_);
-  processExceptionHandler();
+  // The exception of a fused macro-op is handled as though raised by the
+  // instruction within it which raised it. The renaming of the second's own
+  // destinations is rewound, as though it was flushed. A destination shared
+  // with the first was renamed once for both, and keeps its mapping to hold
+  // the first's result. Should the second have raised the exception, the first
+  // has completed and retires
+  auto exceptionInstruction = thread.exceptionGeneratingInstruction;
+  if (exceptionInstruction->isFused()) {
+    const auto& fused =
+        static_cast<const pipeline::FusedInstruction&>(*exceptionInstruction);
+    const auto& first = fused.getFirst();
+    const auto& firstDestinations = first->getDestinationRegisters();
+    const auto& secondDestinations =
+        fused.getSecond()->getDestinationRegisters();
+    for (int i = secondDestinations.size() - 1; i >= 0; i--) {
+      bool shared =
+          std::find(firstDestinations.begin(), firstDestinations.end(),
+                    secondDestinations[i]) != firstDestinations.end();
+      if (secondDestinations[i].renamed && !shared) {
+        thread.registerAliasTable.rewind(secondDestinations[i]);
+      }
+    }
+
+    if (!first->exceptionEncountered()) {
+      const auto& destinations = first->getDestinationRegisters();
+      const auto& results = first->getResults();
+      for (size_t i = 0; i < destinations.size(); i++) {
+        registerFileSet_.set(destinations[i], results[i]);
+        thread.registerAliasTable.commit(destinations[i]);
+      }
+    }
+    exceptionInstruction = fused.getExceptionInstruction();
+  }
+
+  thread.exceptionGenerated = false;
+  activeThread_ = id;
+  thread.exceptionHandler = thread.context.isa.handleException(
+      exceptionInstruction, *this, thread.context.dataMemory);
+  activeThread_ = 0;
+  processExceptionHandler(id);
 }
 
-void Core::processExceptionHandler() {
-  assert(exceptionHandler_ != nullptr &&
+void Core::processExceptionHandler(uint16_t id) {
+  auto& thread = *threads_[id];
+  assert(thread.exceptionHandler != nullptr &&
          "Attempted to process an exception handler that wasn't present");
-  if (dataMemory_.hasPendingRequests()) {
+  if (thread.context.dataMemory.hasPendingRequests()) {
     // Must wait for all memory requests to complete before processing the
     // exception
     return;
   }
 
-  bool success = exceptionHandler_->tick();
+  activeThread_ = id;
+  bool success = thread.exceptionHandler->tick();
   if (!success) {
     // Exception handler requires further ticks to complete
+    activeThread_ = 0;
     return;
   }
 
-  const auto& result = exceptionHandler_->getResult();
+  const auto& result = thread.exceptionHandler->getResult();
 
   if (result.fatal) {
-    hasHalted_ = true;
-    std::cout << "[SimEng:Core] Halting due to fatal exception" << std::endl;
+    thread.halted = true;
+    if (threads_.size() > 1) {
+      std::cout << "[SimEng:Core] Halting thread " << id
+                << " due to fatal exception" << std::endl;
+    } else {
+      std::cout << "[SimEng:Core] Halting due to fatal exception" << std::endl;
+    }
+    hasHalted_ = std::all_of(threads_.begin(), threads_.end(),
+                             [](const auto& t) { return t->halted; });
   } else {
-    fetchUnit_.flushLoopBuffer();
-    fetchUnit_.updatePC(result.instructionAddress);
-    applyStateChange(result.stateChange);
+    thread.fetchUnit.flushLoopBuffer();
+    thread.fetchUnit.updatePC(result.instructionAddress);
+    applyStateChange(result.stateChange, thread.context.dataMemory);
   }
 
-  exceptionHandler_ = nullptr;
+  thread.exceptionHandler = nullptr;
+  activeThread_ = 0;
 }
 
-void Core::flushIfNeeded() {
+void Core::flushIfNeeded(uint16_t id) {
+  auto& thread = *threads_[id];
   // Check for flush
   bool euFlush = false;
   uint64_t targetAddress = 0;
   uint64_t lowestInsnId = 0;
   for (const auto& eu : executionUnits_) {
-    if (eu.shouldFlush() && (!euFlush || eu.getFlushInsnId() < lowestInsnId)) {
+    if (eu.shouldFlush() && eu.getFlushThreadId() == id &&
+        (!euFlush || eu.getFlushInsnId() < lowestInsnId)) {
       euFlush = true;
       lowestInsnId = eu.getFlushInsnId();
       targetAddress = eu.getFlushAddress();
     }
   }
-  if (euFlush || reorderBuffer_.shouldFlush()) {
+  auto& reorderBuffer = thread.reorderBuffer;
+  if (euFlush || reorderBuffer.shouldFlush()) {
     // Flush was requested in an out-of-order stage.
     // Update PC and wipe in-order buffers (Fetch/Decode, Decode/Rename,
     // Rename/Dispatch)
 
-    if (reorderBuffer_.shouldFlush() &&
-        (!euFlush || reorderBuffer_.getFlushInsnId() < lowestInsnId)) {
+    // Execution units flush on a branch misprediction, and the reorder buffer
+    // on a memory order violation
+    auto cause = pipeline::SlotStall::BranchMispredict;
+    if (reorderBuffer.shouldFlush() &&
+        (!euFlush || reorderBuffer.getFlushInsnId() < lowestInsnId)) {
       // If the reorder buffer found an older instruction to flush up to, do
       // that instead
-      lowestInsnId = reorderBuffer_.getFlushInsnId();
-      targetAddress = reorderBuffer_.getFlushAddress();
+      lowestInsnId = reorderBuffer.getFlushInsnId();
+      targetAddress = reorderBuffer.getFlushAddress();
+      cause = pipeline::SlotStall::MachineClear;
     }
 
     // Check for branch instructions in buffer, and flush them from the BP.
     // Then empty the buffers
-    fetchUnit_.flushLoopBuffer();
-    fetchUnit_.updatePC(targetAddress);
-    branchPredictor_.flushBranchesInBufferFromSelf(fetchToDecodeBuffer_);
-    fetchToDecodeBuffer_.fill({});
-    fetchToDecodeBuffer_.stall(false);
-
-    branchPredictor_.flushBranchesInBufferFromSelf(decodeToRenameBuffer_);
-    decodeToRenameBuffer_.fill(nullptr);
-    decodeToRenameBuffer_.stall(false);
-
-    // Instructions in this buffer are already accounted for in the ROB so no
-    // need to check for branch instructions in this buffer
-    renameToDispatchBuffer_.fill(nullptr);
-    renameToDispatchBuffer_.stall(false);
+    thread.fetchUnit.flushLoopBuffer();
+    thread.fetchUnit.updatePC(targetAddress);
+    thread.context.branchPredictor.flushBranchesInBufferFromSelf(
+        thread.fetchToDecodeBuffer);
+    thread.fetchToDecodeBuffer.fill({});
+    thread.fetchToDecodeBuffer.stall(false);
+
+    thread.context.branchPredictor.flushBranchesInBufferFromSelf(
+        thread.decodeToRenameBuffer);
+    thread.decodeToRenameBuffer.fill(nullptr);
+    thread.decodeToRenameBuffer.stall(false);
 
     // Flush everything younger than the bad instruction from the ROB
-    reorderBuffer_.flush(lowestInsnId);
-    decodeUnit_.purgeFlushed();
+    unsigned int inFlight = reorderBuffer.size();
+    reorderBuffer.flush(lowestInsnId);
+    topDown_.squash(inFlight - reorderBuffer.size(), cause);
+    thread.recovery = cause;
+    // Instructions in the rename/dispatch buffer are already accounted for in
+    // the ROB so no need to check for branch instructions in this buffer
+    purgeRenameToDispatchBuffer();
+    thread.decodeUnit.purgeFlushed();
     dispatchIssueUnit_.purgeFlushed();
-    loadStoreQueue_.purgeFlushed();
+    thread.loadStoreQueue.purgeFlushed();
     for (auto& eu : executionUnits_) {
       eu.purgeFlushed();
     }
 
     flushes_++;
-  } else if (decodeUnit_.shouldFlush()) {
+  } else if (thread.decodeUnit.shouldFlush()) {
     // Flush was requested at decode stage
     // Update PC and wipe Fetch/Decode buffer.
-    targetAddress = decodeUnit_.getFlushAddress();
+    targetAddress = thread.decodeUnit.getFlushAddress();
 
     // Check for branch instructions in buffer, and flush them from the BP.
     // Then empty the buffers
-    fetchUnit_.flushLoopBuffer();
-    fetchUnit_.updatePC(targetAddress);
-    branchPredictor_.flushBranchesInBufferFromSelf(fetchToDecodeBuffer_);
-    fetchToDecodeBuffer_.fill({});
-    fetchToDecodeBuffer_.stall(false);
+    thread.fetchUnit.flushLoopBuffer();
+    thread.fetchUnit.updatePC(targetAddress);
+    thread.context.branchPredictor.flushBranchesInBufferFromSelf(
+        thread.fetchToDecodeBuffer);
+    thread.fetchToDecodeBuffer.fill({});
+    thread.fetchToDecodeBuffer.stall(false);
 
+    thread.recovery = pipeline::SlotStall::BranchMispredict;
     flushes_++;
   }
 }
 
+void Core::purgeRenameToDispatchBuffer() {
+  // The buffer is shared between threads, so only the flushed instructions are
+  // removed
+  auto width = renameToDispatchBuffer_.getWidth();
+  for (auto* slots : {renameToDispatchBuffer_.getHeadSlots(),
+                      renameToDispatchBuffer_.getTailSlots()}) {
+    for (size_t slot = 0; slot < width; slot++) {
+      if (slots[slot] != nullptr && slots[slot]->isFlushed()) {
+        slots[slot] = nullptr;
+      }
+    }
+  }
+  if (renameToDispatchBuffer_.isEmpty(nullptr)) {
+    renameToDispatchBuffer_.stall(false);
+  }
+}
+
+void Core::profileCycle() {
+  using pipeline::StallCause;
+  auto index = [](StallCause cause) { return static_cast<size_t>(cause); };
+
+  // The dispatch/issue unit is shared between the threads, so its stalls are
+  // attributed to the thread of the oldest instruction awaiting dispatch
+  uint16_t dispatchThread = 0;
+  auto dispatchSlots = renameToDispatchBuffer_.getHeadSlots();
+  for (size_t slot = 0; slot < renameToDispatchBuffer_.getWidth(); slot++) {
+    if (dispatchSlots[slot] != nullptr) {
+      dispatchThread = dispatchSlots[slot]->getThreadId();
+      break;
+    }
+  }
+
+  for (size_t id = 0; id < threads_.size(); id++) {
+    auto& thread = *threads_[id];
+    if (thread.halted) continue;
+
+    std::array<uint64_t, pipeline::STALL_CAUSE_COUNT> totals =
+        thread.profiledStalls;
+    totals[index(StallCause::ROB)] = thread.renameUnit.getROBStalls();
+    totals[index(StallCause::LoadQueue)] =
+        thread.renameUnit.getLoadQueueStalls();
+    totals[index(StallCause::StoreQueue)] =
+        thread.renameUnit.getStoreQueueStalls();
+    totals[index(StallCause::Allocation)] =
+        thread.renameUnit.getAllocationStalls();
+
+    std::array<uint64_t, pipeline::STALL_CAUSE_COUNT> stalls = {};
+    for (size_t cause = 0; cause < stalls.size(); cause++) {
+      stalls[cause] = totals[cause] - thread.profiledStalls[cause];
+    }
+    thread.profiledStalls = totals;
+
+    if (id == dispatchThread) {
+      uint64_t rsStalls = dispatchIssueUnit_.getRSStalls();
+      uint64_t portBusyStalls = dispatchIssueUnit_.getPortBusyStalls();
+      stalls[index(StallCause::ReservationStation)] =
+          rsStalls - profiledStalls_[index(StallCause::ReservationStation)];
+      stalls[index(StallCause::PortBusy)] =
+          portBusyStalls - profiledStalls_[index(StallCause::PortBusy)];
+      profiledStalls_[index(StallCause::ReservationStation)] = rsStalls;
+      profiledStalls_[index(StallCause::PortBusy)] = portBusyStalls;
+    }
+
+    bool robEmpty = thread.reorderBuffer.size() == 0;
+    profiler_->endCycle(
+        id, robEmpty,
+        robEmpty ? 0 : thread.reorderBuffer.getHead()->getInstructionAddress(),
+        stalls);
+  }
+}
+
+void Core::accountSlots(uint16_t renameThread) {
+  using pipeline::SlotStall;
+  uint16_t delivered = 0;
+  SlotStall stall = SlotStall::Frontend;
+  if (renameThread < threads_.size()) {
+    auto& thread = *threads_[renameThread];
+    uint64_t renamed = thread.renameUnit.getRenamedCount();
+    uint64_t memoryStalls = thread.renameUnit.getLoadQueueStalls() +
+                            thread.renameUnit.getStoreQueueStalls();
+    delivered = renamed - thread.accountedRenamed;
+
+    if (thread.decodeToRenameBuffer.isStalled()) {
+      // Rename was held up by the back-end. It's bound by memory if it awaited
+      // space in the load/store queue, or a load is blocking retirement.
+      bool memoryBound = memoryStalls != thread.accountedMemoryStalls;
+      if (!memoryBound && thread.reorderBuffer.size() > 0) {
+        const auto& head = thread.reorderBuffer.getHead();
+        memoryBound = head->isLoad() && !head->canCommit();
+      }
+      stall = memoryBound ? SlotStall::MemoryBound : SlotStall::CoreBound;
+    }
+    if (delivered > 0) thread.recovery = SlotStall::Frontend;
+
+    thread.accountedRenamed = renamed;
+    thread.accountedMemoryStalls = memoryStalls;
+  }
+  if (delivered == 0 && stall == SlotStall::Frontend) {
+    // With nothing renamed, the slots are lost to any thread recovering from a
+    // flush
+    for (const auto& thread : threads_) {
+      if (!thread->halted && thread->recovery != SlotStall::Frontend) {
+        stall = thread->recovery;
+        break;
+      }
+    }
+  }
+  topDown_.addCycle(delivered, stall);
+}
+
 }  // namespace outoforder
 }  // namespace models
 }  // namespace simeng
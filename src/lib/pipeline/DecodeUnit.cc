@@ -1,14 +1,18 @@
 #include "simeng/pipeline/DecodeUnit.hh"
 
+#include <algorithm>
 #include <cassert>
 
+#include "simeng/pipeline/FusedInstruction.hh"
+
 namespace simeng {
 namespace pipeline {
 
 DecodeUnit::DecodeUnit(PipelineBuffer<MacroOp>& input,
                        PipelineBuffer<std::shared_ptr<Instruction>>& output,
-                       BranchPredictor& predictor)
-    : input_(input), output_(output), predictor_(predictor) {}
+                       BranchPredictor& predictor,
+                       const arch::Architecture* isa)
+    : input_(input), output_(output), predictor_(predictor), isa_(isa) {}
 
 void DecodeUnit::tick() {
   // Stall if output buffer is stalled
@@ -47,6 +51,17 @@ void DecodeUnit::tick() {
     // If there's no more uops to decode, exit loop early
     if (!microOps_.size()) break;
 
+    // Fuse the uop with the next if the pair matches a fusion rule
+    ExecutionInfo fusedInfo;
+    if (isa_ != nullptr && microOps_.size() > 1 &&
+        canFuse(*microOps_[0], *microOps_[1], fusedInfo)) {
+      microOps_[1] = std::make_shared<FusedInstruction>(
+          std::move(microOps_[0]), std::move(microOps_[1]), fusedInfo);
+      microOps_.pop_front();
+      fused_++;
+    }
+    decoded_++;
+
     // Move uop to output buffer and remove from internal buffer
     auto& uop = (output_.getTailSlots()[slot] = std::move(microOps_.front()));
     microOps_.pop_front();
@@ -92,6 +107,8 @@ void DecodeUnit::tick() {
 bool DecodeUnit::shouldFlush() const { return shouldFlush_; }
 uint64_t DecodeUnit::getFlushAddress() const { return pc_; }
 uint64_t DecodeUnit::getEarlyFlushes() const { return earlyFlushes_; }
+uint64_t DecodeUnit::getDecodedCount() const { return decoded_; }
+uint64_t DecodeUnit::getFusedCount() const { return fused_; }
 
 void DecodeUnit::purgeFlushed() {
   while (!microOps_.empty()) {
@@ -101,5 +118,31 @@ void DecodeUnit::purgeFlushed() {
   }
 }
 
+bool DecodeUnit::canFuse(const Instruction& first, const Instruction& second,
+                         ExecutionInfo& info) const {
+  // Only single-uop, non-memory instructions free of exceptions and early
+  // branch mispredictions may be fused, and only the second may be a branch
+  for (const Instruction* insn : {&first, &second}) {
+    if (insn->exceptionEncountered() || insn->isMicroOp() || insn->isLoad() ||
+        insn->isStoreAddress() || insn->isStoreData() ||
+        std::get<0>(insn->checkEarlyBranchMisprediction()))
+      return false;
+  }
+  if (first.isBranch()) return false;
+
+  // The second instruction must read a result of the first
+  const auto& destinations = first.getDestinationRegisters();
+  const auto& sources = second.getSourceRegisters();
+  bool dependent = false;
+  for (size_t i = 0; i < sources.size() && !dependent; i++) {
+    dependent = !second.isOperandReady(i) &&
+                std::find(destinations.begin(), destinations.end(),
+                          sources[i]) != destinations.end();
+  }
+  if (!dependent) return false;
+
+  return isa_->getFusionInfo(first, second, info);
+}
+
 }  // namespace pipeline
 }  // namespace simeng
@@ -10,21 +10,29 @@ DispatchIssueUnit::DispatchIssueUnit(
     PipelineBuffer<std::shared_ptr<Instruction>>& fromRename,
     std::vector<PipelineBuffer<std::shared_ptr<Instruction>>>& issuePorts,
     const RegisterFileSet& registerFileSet, PortAllocator& portAllocator,
+    StoreSetPredictor& storeSetPredictor,
     const std::vector<uint16_t>& physicalRegisterStructure,
     ryml::ConstNodeRef config)
     : input_(fromRename),
       issuePorts_(issuePorts),
       registerFileSet_(registerFileSet),
-      scoreboard_(physicalRegisterStructure.size()),
-      dependencyMatrix_(physicalRegisterStructure.size()),
-      portAllocator_(portAllocator) {
-  // Initialise scoreboard
+      registerOffsets_(physicalRegisterStructure.size()),
+      dispatchOrder_(1),
+      threadOccupancy_(1),
+      portAllocator_(portAllocator),
+      storeSetPredictor_(storeSetPredictor) {
+  // Flatten the physical registers of all types into a single index
+  uint32_t registerCount = 0;
   for (size_t type = 0; type < physicalRegisterStructure.size(); type++) {
-    scoreboard_[type].assign(physicalRegisterStructure[type], true);
-    dependencyMatrix_[type].resize(physicalRegisterStructure[type]);
+    registerOffsets_[type] = registerCount;
+    registerCount += physicalRegisterStructure[type];
   }
+  // Initialise scoreboard
+  scoreboard_.assign((registerCount + 63) / 64, ~0ull);
+
   // Create set of reservation station structs with correct issue port
   // mappings
+  uint32_t slotCount = 0;
   for (size_t i = 0; i < config["Reservation-Stations"].num_children(); i++) {
     // Iterate over each reservation station in config
     auto reservation_station = config["Reservation-Stations"][i];
@@ -33,6 +41,8 @@ DispatchIssueUnit::DispatchIssueUnit(
         reservation_station["Size"].as<uint32_t>(),
         reservation_station["Dispatch-Rate"].as<uint16_t>(),
         0ul,
+        {},
+        slotCount,
         {}};
     // Resize rs port attribute to match what's defined in config file
     rs.ports.resize(reservation_station["Port-Nums"].num_children());
@@ -41,16 +51,25 @@ DispatchIssueUnit::DispatchIssueUnit(
       // Iterate over issue ports in config
       uint16_t issue_port = reservation_station["Port-Nums"][j].as<uint16_t>();
       rs.ports[j].issuePort = issue_port;
+      rs.ports[j].ready.assign((rs.capacity + 63) / 64, 0);
+      rs.ports[j].readyCount = 0;
       // Add port mapping entry, resizing vector if needed
       if ((size_t)(issue_port + 1) > portMapping_.size()) {
         portMapping_.resize((issue_port + 1));
       }
       portMapping_[issue_port] = {i, j};
     }
+    // Populate the free slots such that the lowest slot is allocated first
+    for (uint32_t slot = slotCount + rs.capacity; slot > slotCount; slot--) {
+      rs.freeSlots.push_back(slot - 1);
+    }
+    slotCount += rs.capacity;
     reservationStations_.push_back(rs);
   }
-  for (uint16_t i = 0; i < reservationStations_.size(); i++)
-    flushed_.emplace(i, std::initializer_list<std::shared_ptr<Instruction>>{});
+
+  entries_.resize(slotCount);
+  rowWords_ = (slotCount + 63) / 64;
+  wakeupMatrix_.assign(registerCount * rowWords_, 0);
 
   dispatches_ = std::make_unique<uint16_t[]>(reservationStations_.size());
 }
@@ -77,7 +96,6 @@ void DispatchIssueUnit::tick() {
     // Allocate issue port to uop
     uint16_t port = portAllocator_.allocate(supportedPorts);
     uint16_t RS_Index = portMapping_[port].first;
-    uint16_t RS_Port = portMapping_[port].second;
     assert(RS_Index < reservationStations_.size() &&
            "Allocated port inaccessible");
     ReservationStation& rs = reservationStations_[RS_Index];
@@ -92,8 +110,17 @@ void DispatchIssueUnit::tick() {
       return;
     }
 
-    // Assume the uop will be ready
-    bool ready = true;
+    // Claim a free reservation station slot for the uop
+    uint32_t rsSlot = rs.freeSlots.back();
+    rs.freeSlots.pop_back();
+    auto& entry = entries_[rsSlot];
+    entry.port = port;
+    entry.age = dispatched_++;
+    entry.held = false;
+    entry.pendingOperands.clear();
+
+    uint64_t slotBit = 1ull << (rsSlot % 64);
+    size_t slotWord = rsSlot / 64;
 
     // Register read
     // Identify remaining missing registers and supply values
@@ -103,30 +130,54 @@ void DispatchIssueUnit::tick() {
 
       if (!uop->isOperandReady(i)) {
         // The operand hasn't already been supplied
-        if (scoreboard_[reg.type][reg.tag]) {
+        uint32_t index = getRegisterIndex(reg);
+        if (scoreboard_[index / 64] & (1ull << (index % 64))) {
           // The scoreboard says it's ready; read and supply the register value
           uop->supplyOperand(i, registerFileSet_.get(reg));
         } else {
-          // This register isn't ready yet. Register this uop to the dependency
-          // matrix for a more efficient lookup later
-          dependencyMatrix_[reg.type][reg.tag].push_back({uop, port, i});
-          ready = false;
+          // This register isn't ready yet. Register this uop's slot in the
+          // wakeup matrix row of the register
+          wakeupMatrix_[index * rowWords_ + slotWord] |= slotBit;
+          entry.pendingOperands.push_back({index, i});
         }
       }
     }
 
+    // Hold back loads predicted to depend on an in-flight store until that
+    // store has generated its addresses
+    if (uop->isLoad()) {
+      auto store = storeSetPredictor_.predictDependency(uop);
+      if (store != nullptr) {
+        storeDependents_[store->getSequenceId()].push_back(rsSlot);
+        entry.held = true;
+        entry.storeSeqId = store->getSequenceId();
+      }
+    } else if (uop->isStoreAddress()) {
+      storeSetPredictor_.dispatchStore(uop);
+    }
+
     // Set scoreboard for all destination registers as not ready
     auto& destinationRegisters = uop->getDestinationRegisters();
     for (const auto& reg : destinationRegisters) {
-      scoreboard_[reg.type][reg.tag] = false;
+      uint32_t index = getRegisterIndex(reg);
+      scoreboard_[index / 64] &= ~(1ull << (index % 64));
     }
 
     // Increment dispatches made and RS occupied entries size
     dispatches_[RS_Index]++;
     rs.currentSize++;
 
-    if (ready) {
-      rs.ports[RS_Port].ready.push_back(std::move(uop));
+    uint16_t thread = uop->getThreadId();
+    if (thread >= dispatchOrder_.size()) {
+      dispatchOrder_.resize(thread + 1);
+      threadOccupancy_.resize(thread + 1, 0);
+    }
+    dispatchOrder_[thread].push_back({rsSlot, entry.age});
+    threadOccupancy_[thread]++;
+
+    entry.uop = std::move(uop);
+    if (entry.pendingOperands.empty() && !entry.held) {
+      setReady(rsSlot);
     }
 
     input_.getHeadSlots()[slot] = nullptr;
@@ -135,22 +186,23 @@ void DispatchIssueUnit::tick() {
 
 void DispatchIssueUnit::issue() {
   int issued = 0;
-  // Check the ready queues, and issue an instruction from each if the
+  // Check the ready bitmaps, and issue the oldest instruction from each if the
   // corresponding port isn't blocked
   for (size_t i = 0; i < issuePorts_.size(); i++) {
     ReservationStation& rs = reservationStations_[portMapping_[i].first];
-    auto& queue = rs.ports[portMapping_[i].second].ready;
+    auto& rsPort = rs.ports[portMapping_[i].second];
     if (issuePorts_[i].isStalled()) {
-      if (queue.size() > 0) {
+      if (rsPort.readyCount > 0) {
         portBusyStalls_++;
       }
       continue;
     }
 
-    if (queue.size() > 0) {
-      auto& uop = queue.front();
-      issuePorts_[i].getTailSlots()[0] = std::move(uop);
-      queue.pop_front();
+    if (rsPort.readyCount > 0) {
+      uint32_t rsSlot = selectOldest(rs, rsPort);
+      threadOccupancy_[entries_[rsSlot].uop->getThreadId()]--;
+      issuePorts_[i].getTailSlots()[0] = std::move(entries_[rsSlot].uop);
+      rs.freeSlots.push_back(rsSlot);
 
       // Inform the port allocator that an instruction issued
       portAllocator_.issued(i);
@@ -161,6 +213,16 @@ void DispatchIssueUnit::issue() {
     }
   }
 
+  // Discard the records of issued instructions from the front of each thread's
+  // dispatch order
+  for (auto& order : dispatchOrder_) {
+    while (!order.empty()) {
+      const auto& [rsSlot, age] = order.front();
+      if (entries_[rsSlot].uop != nullptr && entries_[rsSlot].age == age) break;
+      order.pop_front();
+    }
+  }
+
   if (issued == 0) {
     for (const auto& rs : reservationStations_) {
       if (rs.currentSize != 0) {
@@ -178,74 +240,108 @@ void DispatchIssueUnit::forwardOperands(const span<Register>& registers,
          "Mismatched register and value vector sizes");
 
   for (size_t i = 0; i < registers.size(); i++) {
-    const auto& reg = registers[i];
+    uint32_t index = getRegisterIndex(registers[i]);
     // Flag scoreboard as ready now result is available
-    scoreboard_[reg.type][reg.tag] = true;
-
-    // Supply the value to all dependent uops
-    auto& dependents = dependencyMatrix_[reg.type][reg.tag];
-    for (auto& entry : dependents) {
-      entry.uop->supplyOperand(entry.operandIndex, values[i]);
-      if (entry.uop->canExecute()) {
-        // Add the now-ready instruction to the relevant ready queue
-        auto rsInfo = portMapping_[entry.port];
-        reservationStations_[rsInfo.first].ports[rsInfo.second].ready.push_back(
-            std::move(entry.uop));
+    scoreboard_[index / 64] |= 1ull << (index % 64);
+
+    // Supply the value to all dependent uops, clearing the wakeup matrix row
+    uint64_t* row = wakeupMatrix_.data() + index * rowWords_;
+    for (size_t word = 0; word < rowWords_; word++) {
+      uint64_t dependents = row[word];
+      row[word] = 0;
+      while (dependents != 0) {
+        uint32_t rsSlot = word * 64 + __builtin_ctzll(dependents);
+        dependents &= dependents - 1;
+
+        auto& entry = entries_[rsSlot];
+        auto& pending = entry.pendingOperands;
+        for (size_t j = 0; j < pending.size();) {
+          if (pending[j].first == index) {
+            entry.uop->supplyOperand(pending[j].second, values[i]);
+            pending[j] = pending.back();
+            pending.pop_back();
+          } else {
+            j++;
+          }
+        }
+
+        if (!entry.held && entry.uop->canExecute()) {
+          // Mark the now-ready instruction as ready to issue
+          setReady(rsSlot);
+        }
       }
     }
+  }
+}
+
+void DispatchIssueUnit::releaseMemoryDependents(
+    const std::shared_ptr<Instruction>& store) {
+  storeSetPredictor_.storeExecuted(store);
+
+  auto it = storeDependents_.find(store->getSequenceId());
+  if (it == storeDependents_.end()) return;
 
-    // Clear the dependency list
-    dependencyMatrix_[reg.type][reg.tag].clear();
+  for (uint32_t rsSlot : it->second) {
+    auto& entry = entries_[rsSlot];
+    entry.held = false;
+    if (entry.uop->canExecute()) {
+      // Mark the now-ready load as ready to issue
+      setReady(rsSlot);
+    }
   }
+  storeDependents_.erase(it);
 }
 
 void DispatchIssueUnit::purgeFlushed() {
-  for (size_t i = 0; i < reservationStations_.size(); i++) {
-    // Search the ready queues for flushed instructions and remove them
-    auto& rs = reservationStations_[i];
-    for (auto& port : rs.ports) {
-      // Ready queue
-      auto readyIter = port.ready.begin();
-      while (readyIter != port.ready.end()) {
-        auto& uop = *readyIter;
-        if (uop->isFlushed()) {
-          portAllocator_.deallocate(port.issuePort);
-          readyIter = port.ready.erase(readyIter);
-          assert(rs.currentSize > 0);
-          rs.currentSize--;
-        } else {
-          readyIter++;
+  // Instructions are dispatched in program order, so flushed instructions are
+  // the youngest of their thread. Remove them, along with any ready or wakeup
+  // matrix bits they hold, until the youngest remaining instruction is found
+  for (size_t thread = 0; thread < dispatchOrder_.size(); thread++) {
+    auto& order = dispatchOrder_[thread];
+    while (!order.empty()) {
+      const auto [rsSlot, age] = order.back();
+      auto& entry = entries_[rsSlot];
+      if (entry.uop != nullptr && entry.age == age) {
+        if (!entry.uop->isFlushed()) break;
+
+        uint64_t slotBit = 1ull << (rsSlot % 64);
+        for (const auto& [index, operand] : entry.pendingOperands) {
+          wakeupMatrix_[index * rowWords_ + rsSlot / 64] &= ~slotBit;
         }
-      }
-    }
-  }
+        entry.pendingOperands.clear();
 
-  // Collect flushed instructions and remove them from the dependency matrix
-  for (auto& it : flushed_) it.second.clear();
-  for (auto& registerType : dependencyMatrix_) {
-    for (auto& dependencyList : registerType) {
-      auto it = dependencyList.begin();
-      while (it != dependencyList.end()) {
-        auto& entry = *it;
-        if (entry.uop->isFlushed()) {
-          auto rsIndex = portMapping_[entry.port].first;
-          if (!flushed_[rsIndex].count(entry.uop)) {
-            flushed_[rsIndex].insert(entry.uop);
-            portAllocator_.deallocate(entry.port);
-          }
-          it = dependencyList.erase(it);
-        } else {
-          it++;
+        if (entry.held) {
+          // Remove the load from the dependents of the store it's waiting on
+          auto it = storeDependents_.find(entry.storeSeqId);
+          auto& dependents = it->second;
+          dependents.erase(
+              std::find(dependents.begin(), dependents.end(), rsSlot));
+          if (dependents.empty()) storeDependents_.erase(it);
+        }
+
+        auto& rs = reservationStations_[portMapping_[entry.port].first];
+        auto& rsPort = rs.ports[portMapping_[entry.port].second];
+        uint32_t local = rsSlot - rs.slotOffset;
+        uint64_t& readyWord = rsPort.ready[local / 64];
+        if (readyWord & (1ull << (local % 64))) {
+          readyWord &= ~(1ull << (local % 64));
+          rsPort.readyCount--;
         }
+
+        portAllocator_.deallocate(entry.port);
+        entry.uop = nullptr;
+        rs.freeSlots.push_back(rsSlot);
+        assert(rs.currentSize > 0);
+        rs.currentSize--;
+        threadOccupancy_[thread]--;
       }
+      order.pop_back();
     }
   }
+}
 
-  // Update reservation station size
-  for (uint8_t i = 0; i < reservationStations_.size(); i++) {
-    assert(reservationStations_[i].currentSize >= flushed_[i].size());
-    reservationStations_[i].currentSize -= flushed_[i].size();
-  }
+uint32_t DispatchIssueUnit::getThreadOccupancy(uint16_t threadId) const {
+  return threadId < threadOccupancy_.size() ? threadOccupancy_[threadId] : 0;
 }
 
 uint64_t DispatchIssueUnit::getRSStalls() const { return rsStalls_; }
@@ -263,5 +359,40 @@ void DispatchIssueUnit::getRSSizes(std::vector<uint32_t>& sizes) const {
   }
 }
 
+uint32_t DispatchIssueUnit::getRegisterIndex(const Register& reg) const {
+  return registerOffsets_[reg.type] + reg.tag;
+}
+
+void DispatchIssueUnit::setReady(uint32_t slot) {
+  const auto& rsInfo = portMapping_[entries_[slot].port];
+  auto& rs = reservationStations_[rsInfo.first];
+  auto& rsPort = rs.ports[rsInfo.second];
+  uint32_t local = slot - rs.slotOffset;
+  rsPort.ready[local / 64] |= 1ull << (local % 64);
+  rsPort.readyCount++;
+}
+
+uint32_t DispatchIssueUnit::selectOldest(const ReservationStation& rs,
+                                         ReservationStationPort& port) {
+  uint32_t oldest = 0;
+  uint64_t oldestAge = UINT64_MAX;
+  for (size_t word = 0; word < port.ready.size(); word++) {
+    uint64_t ready = port.ready[word];
+    while (ready != 0) {
+      uint32_t local = word * 64 + __builtin_ctzll(ready);
+      ready &= ready - 1;
+      uint64_t age = entries_[rs.slotOffset + local].age;
+      if (age < oldestAge) {
+        oldestAge = age;
+        oldest = local;
+      }
+    }
+  }
+
+  port.ready[oldest / 64] &= ~(1ull << (oldest % 64));
+  port.readyCount--;
+  return rs.slotOffset + oldest;
+}
+
 }  // namespace pipeline
 }  // namespace simeng
@@ -42,15 +42,14 @@ void ExecuteUnit::tick() {
                       uop->getGroup()) != blockingGroups_.end()) {
           if (operationsStalled_.size() == 0) {
             // Add uop to pipeline
-            pipeline_.push_back({nullptr, tickCounter_ + latency - 1});
-            pipeline_.back().insn = std::move(uop);
-            operationsStalled_.push_back(pipeline_.back().insn);
+            operationsStalled_.push_back(uop);
+            addToPipeline(std::move(uop), tickCounter_ + latency - 1);
           } else {
             // Stall execution start cycle
             operationsStalled_.push_back(nullptr);
             operationsStalled_.back() = std::move(uop);
           }
-        } else if (latency == 1 && pipeline_.size() == 0) {
+        } else if (latency == 1 && pipeline_.empty()) {
           // Pipeline is empty and insn will execute this cycle; bypass
           execute(uop);
         } else {
@@ -65,38 +64,45 @@ void ExecuteUnit::tick() {
           }
 
           // Add insn to pipeline
-          pipeline_.push_back({nullptr, tickCounter_ + latency - 1});
-          pipeline_.back().insn = std::move(uop);
+          addToPipeline(std::move(uop), tickCounter_ + latency - 1);
         }
       }
       input_.getHeadSlots()[0] = nullptr;
     }
   }
 
-  if (pipeline_.size() == 0) {
+  if (pipeline_.empty()) {
     return;
   }
 
-  auto& head = pipeline_.front();
-  if (head.readyAt <= tickCounter_) {
+  if (pipeline_.frontCycle() <= tickCounter_) {
+    // Remove the head from the pipeline before any stalled operation is added
+    auto head = std::move(pipeline_.front().insn);
+    pipeline_.pop_front();
     // Check if the completion of an operation would unblock
     // another stalled operation.
     if (std::find(blockingGroups_.begin(), blockingGroups_.end(),
-                  head.insn->getGroup()) != blockingGroups_.end()) {
+                  head->getGroup()) != blockingGroups_.end()) {
       operationsStalled_.pop_front();
       if (operationsStalled_.size() > 0) {
         // Add uop to pipeline
         auto& uop = operationsStalled_.front();
-        pipeline_.push_back({nullptr, tickCounter_ + uop->getLatency() - 1});
-        pipeline_.back().insn = std::move(uop);
-        operationsStalled_.front() = pipeline_.back().insn;
+        addToPipeline(uop, tickCounter_ + uop->getLatency() - 1);
       }
     }
-    execute(head.insn);
-    pipeline_.pop_front();
+    execute(head);
   }
 }
 
+void ExecuteUnit::addToPipeline(std::shared_ptr<Instruction> uop,
+                                uint64_t readyAt) {
+  // The uop can't leave the pipeline before the one ahead of it
+  lastScheduled_ = std::max(readyAt, lastScheduled_ + 1);
+  auto& entry = pipeline_.push(lastScheduled_);
+  entry.insn = std::move(uop);
+  entry.readyAt = readyAt;
+}
+
 void ExecuteUnit::execute(std::shared_ptr<Instruction>& uop) {
   assert(uop->canExecute() &&
          "Attempted to execute an instruction before it was ready");
@@ -143,6 +149,7 @@ void ExecuteUnit::execute(std::shared_ptr<Instruction>& uop) {
       // Misprediction; flush the pipeline
       shouldFlush_ = true;
       flushAfter_ = uop->getInstructionId();
+      flushThreadId_ = uop->getThreadId();
     }
   }
 
@@ -155,26 +162,34 @@ void ExecuteUnit::execute(std::shared_ptr<Instruction>& uop) {
 bool ExecuteUnit::shouldFlush() const { return shouldFlush_; }
 uint64_t ExecuteUnit::getFlushAddress() const { return pc_; }
 uint64_t ExecuteUnit::getFlushInsnId() const { return flushAfter_; }
+uint16_t ExecuteUnit::getFlushThreadId() const { return flushThreadId_; }
 
 void ExecuteUnit::purgeFlushed() {
-  if (pipeline_.size() == 0) {
+  if (pipeline_.empty()) {
     return;
   }
 
+  // Drain the pipeline, keeping only those instructions which weren't flushed
+  purgeBuffer_.clear();
+  bool newestFlushed = false;
+  while (!pipeline_.empty()) {
+    auto& entry = pipeline_.front();
+    newestFlushed = entry.insn->isFlushed();
+    if (!newestFlushed) purgeBuffer_.push_back(std::move(entry));
+    entry.insn = nullptr;
+    pipeline_.pop_front();
+  }
+
   // If the newest instruction has been flushed, clear any stalls.
-  if (pipeline_.back().insn->isFlushed()) {
+  if (newestFlushed) {
     stallUntil_ = tickCounter_;
   }
 
-  // Iterate over the pipeline and remove flushed instructions
-  auto it = pipeline_.begin();
-  while (it != pipeline_.end()) {
-    auto& entry = *it;
-    if (entry.insn->isFlushed()) {
-      it = pipeline_.erase(it);
-    } else {
-      it++;
-    }
+  // Refill the pipeline with the remaining instructions, which may now leave it
+  // sooner, from the next tick
+  lastScheduled_ = tickCounter_;
+  for (auto& entry : purgeBuffer_) {
+    addToPipeline(std::move(entry.insn), entry.readyAt);
   }
 
   // If first blocking in-flight instruction is flushed, ensure another
@@ -198,9 +213,7 @@ void ExecuteUnit::purgeFlushed() {
   if (replace && operationsStalled_.size() > 0) {
     // Add uop to pipeline
     auto& uop = operationsStalled_.front();
-    pipeline_.push_back({nullptr, tickCounter_ + uop->getLatency() - 1});
-    pipeline_.back().insn = std::move(uop);
-    operationsStalled_.front() = pipeline_.back().insn;
+    addToPipeline(uop, tickCounter_ + uop->getLatency() - 1);
   }
 }
 
@@ -209,11 +222,16 @@ uint64_t ExecuteUnit::getCycles() const { return cycles_; }
 bool ExecuteUnit::isEmpty() const {
   // Execution unit is considered empty if no instructions are present in the
   // pipeline_ and operationsStalled_ queues
-  if (pipeline_.size() != 0 || operationsStalled_.size() != 0) {
+  if (!pipeline_.empty() || operationsStalled_.size() != 0) {
     return false;
   }
   return true;
 }
 
+bool ExecuteUnit::isActive() const {
+  return shouldFlush_ || !isEmpty() || input_.isStalled() ||
+         input_.getHeadSlots()[0] != nullptr;
+}
+
 }  // namespace pipeline
 }  // namespace simeng
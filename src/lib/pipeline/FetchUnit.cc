@@ -7,7 +7,8 @@ FetchUnit::FetchUnit(PipelineBuffer<MacroOp>& output,
                      memory::MemoryInterface& instructionMemory,
                      uint64_t programByteLength, uint64_t entryPoint,
                      uint16_t blockSize, const arch::Architecture& isa,
-                     BranchPredictor& branchPredictor)
+                     BranchPredictor& branchPredictor,
+                     MicroOpCache* microOpCache, uint16_t fetchTargetQueueSize)
     : output_(output),
       pc_(entryPoint),
       instructionMemory_(instructionMemory),
@@ -15,10 +16,14 @@ FetchUnit::FetchUnit(PipelineBuffer<MacroOp>& output,
       isa_(isa),
       branchPredictor_(branchPredictor),
       blockSize_(blockSize),
-      blockMask_(~(blockSize_ - 1)) {
+      blockMask_(~(blockSize_ - 1)),
+      microOpCache_(microOpCache && microOpCache->isEnabled() ? microOpCache
+                                                               : nullptr),
+      fetchTargetQueueSize_(fetchTargetQueueSize) {
   assert(blockSize_ >= isa_.getMaxInstructionSize() &&
          "fetch block size must be larger than the largest instruction");
   fetchBuffer_ = new uint8_t[2 * blockSize_];
+  if (fetchTargetQueueSize_ > 0) nextBlockTable_.resize(nextBlockTableSize_);
   requestFromPC();
 }
 
@@ -33,8 +38,13 @@ void FetchUnit::tick() {
     return;
   }
 
+  // Capture any fetch blocks read for the fetch target queue, before any are
+  // cleared by the loop buffer or micro-op cache supplying instructions
+  if (fetchTargetQueueSize_ > 0) receiveFetchTargets();
+
   // If loop buffer has been filled, fill buffer to decode
   if (loopBufferState_ == LoopBufferState::SUPPLYING) {
+    hasLastFetchedBlock_ = false;
     auto outputSlots = output_.getTailSlots();
     for (size_t slot = 0; slot < output_.getWidth(); slot++) {
       auto& macroOp = outputSlots[slot];
@@ -72,6 +82,13 @@ void FetchUnit::tick() {
     return;
   }
 
+  // Supply instructions held by the micro-op cache, bypassing instruction
+  // memory. The loop buffer takes priority whilst it's in use
+  if (microOpCache_ && loopBufferState_ == LoopBufferState::IDLE &&
+      supplyFromMicroOpCache()) {
+    return;
+  }
+
   // Const pointer to the instruction data to decode from
   const uint8_t* buffer;
   uint16_t bufferOffset;
@@ -91,33 +108,35 @@ void FetchUnit::tick() {
       bufferOffset = pc_ - blockAddress;
     }
 
-    // Find fetched memory that matches the desired block
-    const auto& fetched = instructionMemory_.getCompletedReads();
-
-    size_t fetchIndex;
-    for (fetchIndex = 0; fetchIndex < fetched.size(); fetchIndex++) {
-      if (fetched[fetchIndex].target.address == blockAddress) {
-        break;
+    // Find fetched memory that matches the desired block, either at the head
+    // of the fetch target queue or amongst the completed reads
+    const uint8_t* fetchData = nullptr;
+    if (fetchTargetQueueSize_ > 0) {
+      fetchData = getFetchTargetData(blockAddress);
+    } else {
+      const auto& fetched = instructionMemory_.getCompletedReads();
+      for (size_t fetchIndex = 0; fetchIndex < fetched.size(); fetchIndex++) {
+        if (fetched[fetchIndex].target.address == blockAddress) {
+          // TODO: Handle memory faults
+          assert(fetched[fetchIndex].data && "Memory read failed");
+          fetchData = fetched[fetchIndex].data.getAsVector<uint8_t>();
+          break;
+        }
       }
     }
     // Decide how to progress based on status of fetched data and buffer. Allow
     // progression if minimal data is in the buffer no matter state of fetched
     // data
-    if (fetchIndex == fetched.size() &&
-        bufferedBytes_ < isa_.getMinInstructionSize()) {
+    if (fetchData == nullptr && bufferedBytes_ < isa_.getMinInstructionSize()) {
       // Relevant data has not been fetched and not enough data already in the
       // buffer. Need to wait for fetched instructions
       return;
-    } else if (fetchIndex != fetched.size()) {
-      // Data has been successfully read, move into fetch buffer
-      // TODO: Handle memory faults
-      assert(fetched[fetchIndex].data && "Memory read failed");
-      const uint8_t* fetchData =
-          fetched[fetchIndex].data.getAsVector<uint8_t>();
-
-      // Copy fetched data to fetch buffer after existing data
+    } else if (fetchData != nullptr) {
+      // Data has been successfully read, move into fetch buffer after existing
+      // data
       std::memcpy(fetchBuffer_ + bufferedBytes_, fetchData + bufferOffset,
                   blockSize_ - bufferOffset);
+      if (fetchTargetQueueSize_ > 0) consumeFetchTarget(blockAddress);
 
       bufferedBytes_ += blockSize_ - bufferOffset;
       buffer = fetchBuffer_;
@@ -161,6 +180,17 @@ void FetchUnit::tick() {
       macroOp[0]->setBranchPrediction(prediction);
     }
 
+    if (microOpCache_) {
+      // Record the predecoded instruction in the micro-op cache. The lookup
+      // which missed is counted once, with the first instruction predecoded
+      uint32_t encoding;
+      memcpy(&encoding, buffer + bufferOffset, sizeof(uint32_t));
+      microOpCache_->fill(
+          {encoding, bytesRead, pc_, static_cast<uint16_t>(macroOp.size())},
+          prediction.isTaken);
+      if (slot == 0) microOpCacheMisses_++;
+    }
+
     if (loopBufferState_ == LoopBufferState::FILLING) {
       // Record instruction fetch information in loop body
       uint32_t encoding;
@@ -258,19 +288,35 @@ void FetchUnit::updatePC(uint64_t address) {
   pc_ = address;
   bufferedBytes_ = 0;
   hasHalted_ = (pc_ >= programByteLength_);
+
+  // Fetch has been redirected, so the queued fetch blocks are on the wrong path
+  fetchTargetQueue_.clear();
+  hasLastFetchedBlock_ = false;
 }
 
 void FetchUnit::requestFromPC() {
   // Do nothing if supplying fetch stream from loop buffer
   if (loopBufferState_ == LoopBufferState::SUPPLYING) return;
 
-  // Do nothing if buffer already contains enough data
-  if (bufferedBytes_ >= isa_.getMaxInstructionSize()) return;
-
   // Do nothing if unit has halted to avoid invalid speculative memory reads
   // beyond the programByteLength_
   if (hasHalted_) return;
 
+  // Do nothing if the micro-op cache will supply the instructions at the PC
+  if (microOpCache_ && loopBufferState_ == LoopBufferState::IDLE &&
+      microOpCache_->probe(pc_)) {
+    return;
+  }
+
+  // The fetch target queue requests blocks ahead of fetch requiring them
+  if (fetchTargetQueueSize_ > 0) {
+    fillFetchTargetQueue();
+    return;
+  }
+
+  // Do nothing if buffer already contains enough data
+  if (bufferedBytes_ >= isa_.getMaxInstructionSize()) return;
+
   uint64_t blockAddress;
   if (bufferedBytes_ > 0) {
     // There's already some data in the buffer, so fetch the next block
@@ -294,5 +340,166 @@ void FetchUnit::flushLoopBuffer() {
 
 uint64_t FetchUnit::getBranchFetchedCount() const { return branchesFetched_; }
 
+uint64_t FetchUnit::getMicroOpCacheHits() const { return microOpCacheHits_; }
+
+uint64_t FetchUnit::getMicroOpCacheMisses() const {
+  return microOpCacheMisses_;
+}
+
+double FetchUnit::getAverageFetchTargetQueueOccupancy() const {
+  if (fetchTargetQueueCycles_ == 0) return 0.0;
+  return static_cast<double>(fetchTargetQueueOccupancy_) /
+         static_cast<double>(fetchTargetQueueCycles_);
+}
+
+uint64_t FetchUnit::getPrefetchesIssued() const { return prefetchesIssued_; }
+
+uint64_t FetchUnit::getPrefetchesUsed() const { return prefetchesUsed_; }
+
+bool FetchUnit::supplyFromMicroOpCache() {
+  auto [line, index] = microOpCache_->lookup(pc_);
+  if (line == nullptr) return false;
+  microOpCacheHits_++;
+
+  // The cached instructions supersede any data in the fetch buffer
+  bufferedBytes_ = 0;
+  hasLastFetchedBlock_ = false;
+
+  // Supply instructions from the single line holding the PC, in program order
+  auto outputSlots = output_.getTailSlots();
+  for (size_t slot = 0; slot < output_.getWidth() && index < line->size();
+       slot++, index++) {
+    const auto& entry = (*line)[index];
+    auto& macroOp = outputSlots[slot];
+    auto bytesRead = isa_.predecode(
+        reinterpret_cast<const uint8_t*>(&entry.encoding),
+        entry.instructionSize, entry.address, macroOp);
+    assert(bytesRead == entry.instructionSize &&
+           "unexpected predecode failure of a cached instruction");
+
+    // Predict branches afresh, as the path taken may differ from that when
+    // the line was filled
+    BranchPrediction prediction = {false, 0};
+    if (macroOp[0]->isBranch()) {
+      prediction = branchPredictor_.predict(pc_, macroOp[0]->getBranchType(),
+                                            macroOp[0]->getKnownOffset());
+      branchesFetched_++;
+      macroOp[0]->setBranchPrediction(prediction);
+    }
+
+    if (prediction.isTaken) {
+      pc_ = prediction.target;
+    } else {
+      pc_ += bytesRead;
+    }
+
+    if (pc_ >= programByteLength_) {
+      hasHalted_ = true;
+      break;
+    }
+
+    if (prediction.isTaken) {
+      if (slot + 1 < output_.getWidth()) {
+        branchStalls_++;
+      }
+      break;
+    }
+  }
+
+  instructionMemory_.clearCompletedReads();
+  return true;
+}
+
+void FetchUnit::receiveFetchTargets() {
+  const auto& fetched = instructionMemory_.getCompletedReads();
+  for (size_t fetchIndex = 0; fetchIndex < fetched.size(); fetchIndex++) {
+    // Reads of blocks discarded from the queue are ignored
+    for (auto& target : fetchTargetQueue_) {
+      if (!target.ready &&
+          target.address == fetched[fetchIndex].target.address) {
+        target.ready = true;
+        target.data = fetched[fetchIndex].data;
+        break;
+      }
+    }
+  }
+  instructionMemory_.clearCompletedReads();
+}
+
+const uint8_t* FetchUnit::getFetchTargetData(uint64_t blockAddress) {
+  if (!fetchTargetQueue_.empty() &&
+      fetchTargetQueue_.front().address != blockAddress) {
+    // The queue ran ahead down a different path to fetch, so discard it
+    fetchTargetQueue_.clear();
+  }
+  if (fetchTargetQueue_.empty() || !fetchTargetQueue_.front().ready) {
+    return nullptr;
+  }
+
+  // TODO: Handle memory faults
+  assert(fetchTargetQueue_.front().data && "Memory read failed");
+  return fetchTargetQueue_.front().data.getAsVector<uint8_t>();
+}
+
+void FetchUnit::consumeFetchTarget(uint64_t blockAddress) {
+  if (fetchTargetQueue_.front().prefetched) prefetchesUsed_++;
+  fetchTargetQueue_.pop_front();
+
+  if (hasLastFetchedBlock_) trainNextBlock(lastFetchedBlock_, blockAddress);
+  lastFetchedBlock_ = blockAddress;
+  hasLastFetchedBlock_ = true;
+}
+
+void FetchUnit::fillFetchTargetQueue() {
+  // Find the block fetch will next read, following any data already buffered
+  uint64_t demandBlock =
+      (bufferedBytes_ > 0) ? pc_ + bufferedBytes_ : pc_ & blockMask_;
+
+  // The head of the queue must be the block fetch requires; otherwise the
+  // queue ran ahead down a different path to fetch
+  if (!fetchTargetQueue_.empty() &&
+      fetchTargetQueue_.front().address != demandBlock) {
+    fetchTargetQueue_.clear();
+  }
+  if (fetchTargetQueue_.empty()) {
+    fetchTargetQueue_.push_back({demandBlock, false, false, {}});
+    instructionMemory_.requestRead({demandBlock, blockSize_});
+  }
+
+  // Run ahead of fetch by a single predicted block each cycle, prefetching it
+  // so that its read overlaps with the fetch of the blocks before it
+  if (fetchTargetQueue_.size() < fetchTargetQueueSize_) {
+    uint64_t nextBlock = predictNextBlock(fetchTargetQueue_.back().address);
+    // Avoid invalid speculative memory reads beyond the programByteLength_
+    if (nextBlock < programByteLength_) {
+      fetchTargetQueue_.push_back({nextBlock, true, false, {}});
+      instructionMemory_.requestRead({nextBlock, blockSize_});
+      prefetchesIssued_++;
+    }
+  }
+
+  fetchTargetQueueOccupancy_ += fetchTargetQueue_.size();
+  fetchTargetQueueCycles_++;
+}
+
+uint64_t FetchUnit::predictNextBlock(uint64_t blockAddress) const {
+  const auto& entry =
+      nextBlockTable_[(blockAddress / blockSize_) % nextBlockTableSize_];
+  if (entry.valid && entry.block == blockAddress) return entry.next;
+  // Without a recorded redirection, fetch continues to the sequential block
+  return blockAddress + blockSize_;
+}
+
+void FetchUnit::trainNextBlock(uint64_t blockAddress, uint64_t nextBlock) {
+  auto& entry =
+      nextBlockTable_[(blockAddress / blockSize_) % nextBlockTableSize_];
+  if (nextBlock == blockAddress + blockSize_) {
+    // Sequential blocks are predicted without an entry
+    if (entry.block == blockAddress) entry.valid = false;
+    return;
+  }
+  entry = {true, blockAddress, nextBlock};
+}
+
 }  // namespace pipeline
 }  // namespace simeng
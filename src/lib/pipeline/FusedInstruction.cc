@@ -0,0 +1,229 @@
+#include "simeng/pipeline/FusedInstruction.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace simeng {
+namespace pipeline {
+
+FusedInstruction::FusedInstruction(std::shared_ptr<Instruction> first,
+                                   std::shared_ptr<Instruction> second,
+                                   const ExecutionInfo& info)
+    : first_(std::move(first)), second_(std::move(second)) {
+  isFused_ = true;
+  // Branch predictions and updates are keyed on the address of the branch
+  instructionAddress_ = second_->isBranch()
+                            ? second_->getInstructionAddress()
+                            : first_->getInstructionAddress();
+  prediction_ = second_->getBranchPrediction();
+  branchType_ = second_->getBranchType();
+  knownOffset_ = second_->getKnownOffset();
+
+  const auto& firstSources = first_->getSourceRegisters();
+  for (uint16_t i = 0; i < firstSources.size(); i++) {
+    sourceRegisters_.push_back(firstSources[i]);
+    sourceOwners_.push_back({false, i});
+  }
+  const auto& firstDestinations = first_->getDestinationRegisters();
+  const auto& secondSources = second_->getSourceRegisters();
+  for (uint16_t i = 0; i < secondSources.size(); i++) {
+    // Operands of the second instruction produced by the first are forwarded
+    // internally rather than read from the register file
+    bool forwarded = false;
+    if (!second_->isOperandReady(i)) {
+      for (uint16_t j = 0; j < firstDestinations.size(); j++) {
+        if (secondSources[i] == firstDestinations[j]) {
+          forwardedOperands_.push_back({i, j});
+          forwarded = true;
+          break;
+        }
+      }
+    }
+    if (!forwarded) {
+      sourceRegisters_.push_back(secondSources[i]);
+      sourceOwners_.push_back({true, i});
+    }
+  }
+  for (size_t i = 0; i < sourceRegisters_.size(); i++) {
+    const auto& [isSecond, index] = sourceOwners_[i];
+    const auto& owner = isSecond ? second_ : first_;
+    if (owner->isOperandReady(index)) {
+      sourceValues_.push_back(owner->getSourceOperands()[index]);
+    } else {
+      sourceValues_.push_back({});
+      sourceOperandsPending_++;
+    }
+  }
+
+  // A destination written by both instructions is only renamed once, for the
+  // second; the value of the first is kept within the macro-op
+  const auto& secondDestinations = second_->getDestinationRegisters();
+  for (uint16_t i = 0; i < firstDestinations.size(); i++) {
+    auto shared = std::find(secondDestinations.begin(),
+                            secondDestinations.end(), firstDestinations[i]);
+    if (shared == secondDestinations.end()) {
+      destinationRegisters_.push_back(firstDestinations[i]);
+      firstDestinationIndices_.push_back(i);
+    } else {
+      sharedDestinations_.push_back(
+          {i, static_cast<uint16_t>(shared - secondDestinations.begin())});
+    }
+  }
+  firstDestinationCount_ = destinationRegisters_.size();
+  destinationRegisters_.insert(destinationRegisters_.end(),
+                               secondDestinations.begin(),
+                               secondDestinations.end());
+  results_.resize(destinationRegisters_.size());
+
+  setExecutionInfo(info);
+}
+
+const span<Register> FusedInstruction::getSourceRegisters() const {
+  return {const_cast<Register*>(sourceRegisters_.data()),
+          sourceRegisters_.size()};
+}
+
+const span<RegisterValue> FusedInstruction::getSourceOperands() const {
+  return {const_cast<RegisterValue*>(sourceValues_.data()),
+          sourceValues_.size()};
+}
+
+const span<Register> FusedInstruction::getDestinationRegisters() const {
+  return {const_cast<Register*>(destinationRegisters_.data()),
+          destinationRegisters_.size()};
+}
+
+void FusedInstruction::renameSource(uint16_t i, Register renamed) {
+  sourceRegisters_[i] = renamed;
+  const auto& [isSecond, index] = sourceOwners_[i];
+  (isSecond ? second_ : first_)->renameSource(index, renamed);
+}
+
+void FusedInstruction::renameDestination(uint16_t i, Register renamed) {
+  destinationRegisters_[i] = renamed;
+  if (i < firstDestinationCount_) {
+    first_->renameDestination(firstDestinationIndices_[i], renamed);
+    return;
+  }
+  uint16_t index = i - firstDestinationCount_;
+  second_->renameDestination(index, renamed);
+  // The first instruction's value of a shared destination is held in the same
+  // physical register, should the second raise an exception
+  for (const auto& [firstIndex, secondIndex] : sharedDestinations_) {
+    if (secondIndex == index) first_->renameDestination(firstIndex, renamed);
+  }
+}
+
+void FusedInstruction::supplyOperand(uint16_t i, const RegisterValue& value) {
+  assert(!canExecute() &&
+         "Attempted to provide an operand to a ready-to-execute instruction");
+  sourceValues_[i] = value;
+  sourceOperandsPending_--;
+  const auto& [isSecond, index] = sourceOwners_[i];
+  (isSecond ? second_ : first_)->supplyOperand(index, value);
+}
+
+bool FusedInstruction::isOperandReady(int i) const {
+  return static_cast<bool>(sourceValues_[i]);
+}
+
+const span<RegisterValue> FusedInstruction::getResults() const {
+  return {const_cast<RegisterValue*>(results_.data()), results_.size()};
+}
+
+span<const memory::MemoryAccessTarget> FusedInstruction::generateAddresses() {
+  return {};
+}
+
+span<const memory::MemoryAccessTarget>
+FusedInstruction::getGeneratedAddresses() const {
+  return {};
+}
+
+void FusedInstruction::supplyData(uint64_t address,
+                                  const RegisterValue& data) {}
+
+span<const RegisterValue> FusedInstruction::getData() const { return {}; }
+
+std::tuple<bool, uint64_t> FusedInstruction::checkEarlyBranchMisprediction()
+    const {
+  return second_->checkEarlyBranchMisprediction();
+}
+
+BranchType FusedInstruction::getBranchType() const { return branchType_; }
+
+int64_t FusedInstruction::getKnownOffset() const { return knownOffset_; }
+
+bool FusedInstruction::isStoreAddress() const { return false; }
+
+bool FusedInstruction::isStoreData() const { return false; }
+
+bool FusedInstruction::isLoad() const { return false; }
+
+bool FusedInstruction::isBranch() const { return second_->isBranch(); }
+
+uint16_t FusedInstruction::getGroup() const { return second_->getGroup(); }
+
+bool FusedInstruction::canExecute() const {
+  return (sourceOperandsPending_ == 0);
+}
+
+void FusedInstruction::execute() {
+  assert(canExecute() &&
+         "Attempted to execute an instruction before it was ready");
+  // Identify the constituents as this macro-op, so that any exception they
+  // raise is handled as though it was raised by the macro-op
+  for (const auto& insn : {first_, second_}) {
+    insn->setSequenceId(sequenceId_);
+    insn->setInstructionId(instructionId_);
+    insn->setThreadId(threadId_);
+  }
+
+  executed_ = true;
+  first_->execute();
+  if (first_->exceptionEncountered()) {
+    exceptionEncountered_ = true;
+    return;
+  }
+  const auto& firstResults = first_->getResults();
+  for (const auto& [operand, result] : forwardedOperands_) {
+    second_->supplyOperand(operand, firstResults[result]);
+  }
+  second_->execute();
+
+  const auto& secondResults = second_->getResults();
+  for (uint16_t i = 0; i < firstDestinationCount_; i++) {
+    results_[i] = firstResults[firstDestinationIndices_[i]];
+  }
+  std::copy(secondResults.begin(), secondResults.end(),
+            results_.begin() + firstDestinationCount_);
+  exceptionEncountered_ = second_->exceptionEncountered();
+  branchTaken_ = second_->wasBranchTaken();
+  branchAddress_ = second_->getBranchAddress();
+}
+
+const std::vector<uint16_t>& FusedInstruction::getSupportedPorts() {
+  return supportedPorts_;
+}
+
+void FusedInstruction::setExecutionInfo(const ExecutionInfo& info) {
+  latency_ = info.latency;
+  stallCycles_ = info.stallCycles;
+  supportedPorts_ = info.ports;
+}
+
+const std::shared_ptr<Instruction>& FusedInstruction::getFirst() const {
+  return first_;
+}
+
+const std::shared_ptr<Instruction>& FusedInstruction::getSecond() const {
+  return second_;
+}
+
+const std::shared_ptr<Instruction>& FusedInstruction::getExceptionInstruction()
+    const {
+  return first_->exceptionEncountered() ? first_ : second_;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,227 @@
+#include "simeng/pipeline/HotspotProfiler.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+namespace simeng {
+namespace pipeline {
+
+namespace {
+
+/** The column headings of the stall causes, in order. */
+const std::array<const char*, STALL_CAUSE_COUNT> stallCauseNames = {
+    "Frontend", "Recovery", "ROB", "LQ", "SQ", "Alloc", "RS", "PortBusy"};
+
+/** Write the statistics columns of `entry` to `out`, with cycles expressed as
+ * a percentage of `totalCycles`. */
+void writeColumns(std::ostream& out, const ProfileEntry& entry,
+                  double totalCycles) {
+  double share = totalCycles > 0.0 ? 100.0 * entry.cycles / totalCycles : 0.0;
+  out << std::setw(12) << static_cast<uint64_t>(entry.cycles + 0.5)
+      << std::setw(8) << std::fixed << std::setprecision(2) << share
+      << std::setw(12) << entry.retired << std::setw(8);
+  if (entry.retired > 0) {
+    out << entry.cycles / static_cast<double>(entry.retired);
+  } else {
+    out << "-";
+  }
+  out << std::setw(10) << entry.mispredicts << std::setw(10) << entry.loads
+      << std::setw(10);
+  if (entry.loads > 0) {
+    out << static_cast<double>(entry.loadLatency) /
+               static_cast<double>(entry.loads);
+  } else {
+    out << "-";
+  }
+  for (auto stalls : entry.stalls) out << std::setw(10) << stalls;
+}
+
+/** Write the column headings to `out`, naming the final column `name`. */
+void writeHeadings(std::ostream& out, const char* name) {
+  out << std::setw(12) << "Cycles" << std::setw(8) << "%" << std::setw(12)
+      << "Retired" << std::setw(8) << "CPI" << std::setw(10) << "Mispred"
+      << std::setw(10) << "Loads" << std::setw(10) << "LoadLat";
+  for (const auto* cause : stallCauseNames) out << std::setw(10) << cause;
+  out << "  " << name << "\n";
+}
+
+}  // namespace
+
+HotspotProfiler::HotspotProfiler(uint16_t threads) : threads_(threads) {}
+
+void HotspotProfiler::retire(uint16_t thread, uint64_t address,
+                             uint8_t instructions, bool mispredicted,
+                             bool raisedException) {
+  auto& state = threads_[thread];
+  auto& entry = entries_[address];
+  entry.retired += instructions;
+  if (mispredicted) entry.mispredicts++;
+
+  // The first instruction to retire takes the cycles spent awaiting it
+  addStalls(entry, state.pending);
+  state.pending = {};
+  state.retired.push_back(address);
+
+  if (mispredicted || raisedException) {
+    state.flushAddress = address;
+    state.recovering = true;
+  }
+}
+
+void HotspotProfiler::completeLoad(uint64_t address, uint64_t latency) {
+  auto& entry = entries_[address];
+  entry.loads++;
+  entry.loadLatency += latency;
+}
+
+void HotspotProfiler::endCycle(
+    uint16_t thread, bool robEmpty, uint64_t headAddress,
+    const std::array<uint64_t, STALL_CAUSE_COUNT>& stalls) {
+  auto& state = threads_[thread];
+  bool retired = !state.retired.empty();
+  if (retired) {
+    double share = 1.0 / static_cast<double>(state.retired.size());
+    for (auto address : state.retired) entries_[address].cycles += share;
+    state.retired.clear();
+  }
+
+  bool stalled = false;
+  for (size_t cause = static_cast<size_t>(StallCause::ROB);
+       cause < STALL_CAUSE_COUNT; cause++) {
+    stalled |= stalls[cause] != 0;
+  }
+  if (!robEmpty) state.recovering = false;
+  if (retired && !stalled) return;
+
+  ProfileEntry* blamed;
+  StallCause emptyCause = StallCause::Frontend;
+  if (!robEmpty) {
+    blamed = &entries_[headAddress];
+  } else if (state.recovering) {
+    blamed = &entries_[state.flushAddress];
+    emptyCause = StallCause::Recovery;
+  } else {
+    blamed = &state.pending;
+  }
+
+  if (!retired) {
+    blamed->cycles += 1.0;
+    if (robEmpty) blamed->stalls[static_cast<size_t>(emptyCause)]++;
+  }
+  for (size_t cause = static_cast<size_t>(StallCause::ROB);
+       cause < STALL_CAUSE_COUNT; cause++) {
+    blamed->stalls[cause] += stalls[cause];
+  }
+}
+
+void HotspotProfiler::setSymbols(std::vector<ElfSymbol> symbols) {
+  symbols_ = std::move(symbols);
+}
+
+std::string HotspotProfiler::symbolise(uint64_t address) const {
+  const ElfSymbol* symbol = findSymbol(address);
+  if (symbol == nullptr) return "";
+  std::ostringstream name;
+  name << symbol->name;
+  if (address != symbol->address) {
+    name << "+0x" << std::hex << address - symbol->address;
+  }
+  return name.str();
+}
+
+const std::unordered_map<uint64_t, ProfileEntry>&
+HotspotProfiler::getEntries() const {
+  return entries_;
+}
+
+void HotspotProfiler::write(std::ostream& out) const {
+  auto flags = out.flags();
+  auto precision = out.precision();
+
+  ProfileEntry total;
+  std::map<std::string, ProfileEntry> functions;
+  for (const auto& [address, entry] : entries_) {
+    addStalls(total, entry);
+    total.retired += entry.retired;
+
+    const ElfSymbol* symbol = findSymbol(address);
+    auto& function = functions[symbol ? symbol->name : "[unknown]"];
+    addStalls(function, entry);
+    function.retired += entry.retired;
+    function.mispredicts += entry.mispredicts;
+    function.loads += entry.loads;
+    function.loadLatency += entry.loadLatency;
+  }
+
+  out << "# Hotspot profile: " << static_cast<uint64_t>(total.cycles + 0.5)
+      << " cycles, " << total.retired << " instructions retired\n\n";
+
+  std::vector<std::pair<std::string, const ProfileEntry*>> sortedFunctions;
+  for (const auto& [name, entry] : functions) {
+    sortedFunctions.push_back({name, &entry});
+  }
+  std::stable_sort(sortedFunctions.begin(), sortedFunctions.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second->cycles > b.second->cycles;
+                   });
+  out << "# Functions\n";
+  writeHeadings(out, "Function");
+  for (const auto& [name, entry] : sortedFunctions) {
+    writeColumns(out, *entry, total.cycles);
+    out << "  " << name << "\n";
+  }
+
+  std::vector<std::pair<uint64_t, const ProfileEntry*>> sortedAddresses;
+  for (const auto& [address, entry] : entries_) {
+    sortedAddresses.push_back({address, &entry});
+  }
+  std::sort(sortedAddresses.begin(), sortedAddresses.end(),
+            [](const auto& a, const auto& b) {
+              if (a.second->cycles != b.second->cycles) {
+                return a.second->cycles > b.second->cycles;
+              }
+              return a.first < b.first;
+            });
+  out << "\n# Instructions\n";
+  writeHeadings(out, "Address");
+  for (const auto& [address, entry] : sortedAddresses) {
+    writeColumns(out, *entry, total.cycles);
+    out << "  0x" << std::hex << address << std::dec;
+    std::string name = symbolise(address);
+    if (!name.empty()) out << " " << name;
+    out << "\n";
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void HotspotProfiler::addStalls(ProfileEntry& to, const ProfileEntry& from) {
+  to.cycles += from.cycles;
+  for (size_t cause = 0; cause < STALL_CAUSE_COUNT; cause++) {
+    to.stalls[cause] += from.stalls[cause];
+  }
+}
+
+const ElfSymbol* HotspotProfiler::findSymbol(uint64_t address) const {
+  // Find the last function starting at or before the address. Functions of an
+  // unknown size are taken to extend up to the next function
+  auto it = std::upper_bound(
+      symbols_.begin(), symbols_.end(), address,
+      [](uint64_t addr, const ElfSymbol& symbol) {
+        return addr < symbol.address;
+      });
+  if (it == symbols_.begin()) return nullptr;
+  const ElfSymbol& symbol = *std::prev(it);
+  if (symbol.size != 0 && address >= symbol.address + symbol.size) {
+    return nullptr;
+  }
+  if (symbol.size == 0 && it == symbols_.end()) return nullptr;
+  return &symbol;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
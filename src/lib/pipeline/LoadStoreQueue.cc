@@ -1,5 +1,6 @@
 #include "simeng/pipeline/LoadStoreQueue.hh"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstring>
@@ -17,6 +18,45 @@ bool requestsOverlap(memory::MemoryAccessTarget a,
   return !(a.address + a.size <= b.address || b.address + b.size <= a.address);
 }
 
+/** Group the accesses in `targets` which fall within the same cache line of
+ * width `lineWidth` into requests no larger than `maxSize` bytes. Accesses
+ * which cross a cache line boundary are placed in a request of their own. */
+std::vector<coalescedRequest> coalesceAccesses(
+    std::vector<memory::MemoryAccessTarget> targets, uint16_t lineWidth,
+    uint16_t maxSize) {
+  // Order the accesses by address such that those sharing a cache line are
+  // adjacent
+  std::sort(targets.begin(), targets.end(),
+            [](const memory::MemoryAccessTarget& a,
+               const memory::MemoryAccessTarget& b) {
+              return (a.address < b.address) ||
+                     (a.address == b.address && a.size < b.size);
+            });
+
+  std::vector<coalescedRequest> requests;
+  size_t i = 0;
+  while (i < targets.size()) {
+    const uint64_t line = targets[i].address / lineWidth;
+    coalescedRequest request = {targets[i], {targets[i]}};
+    // Only accesses contained within a single cache line can be merged
+    if ((targets[i].address + targets[i].size - 1) / lineWidth == line) {
+      for (size_t j = i + 1; j < targets.size(); j++) {
+        const auto& next = targets[j];
+        uint64_t end = std::max(request.target.address + request.target.size,
+                                next.address + next.size);
+        if ((end - 1) / lineWidth != line ||
+            end - request.target.address > maxSize)
+          break;
+        request.target.size = end - request.target.address;
+        request.elements.push_back(next);
+      }
+    }
+    i += request.elements.size();
+    requests.push_back(std::move(request));
+  }
+  return requests;
+}
+
 LoadStoreQueue::LoadStoreQueue(
     unsigned int maxCombinedSpace, memory::MemoryInterface& memory,
     span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots,
@@ -24,7 +64,8 @@ LoadStoreQueue::LoadStoreQueue(
     std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
     bool exclusive, uint16_t loadBandwidth, uint16_t storeBandwidth,
     uint16_t permittedRequests, uint16_t permittedLoads,
-    uint16_t permittedStores)
+    uint16_t permittedStores, bool coalesceRequests, uint16_t cacheLineWidth,
+    uint16_t forwardingLatency)
     : completionSlots_(completionSlots),
       forwardOperands_(forwardOperands),
       raiseException_(raiseException),
@@ -36,7 +77,10 @@ LoadStoreQueue::LoadStoreQueue(
       storeBandwidth_(storeBandwidth),
       totalLimit_(permittedRequests),
       // Set per-cycle limits for each request type
-      reqLimits_{permittedLoads, permittedStores} {}
+      reqLimits_{permittedLoads, permittedStores},
+      coalesceRequests_(coalesceRequests),
+      cacheLineWidth_(cacheLineWidth),
+      forwardingLatency_(forwardingLatency) {}
 
 LoadStoreQueue::LoadStoreQueue(
     unsigned int maxLoadQueueSpace, unsigned int maxStoreQueueSpace,
@@ -46,7 +90,8 @@ LoadStoreQueue::LoadStoreQueue(
     std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
     bool exclusive, uint16_t loadBandwidth, uint16_t storeBandwidth,
     uint16_t permittedRequests, uint16_t permittedLoads,
-    uint16_t permittedStores)
+    uint16_t permittedStores, bool coalesceRequests, uint16_t cacheLineWidth,
+    uint16_t forwardingLatency)
     : completionSlots_(completionSlots),
       forwardOperands_(forwardOperands),
       raiseException_(raiseException),
@@ -59,7 +104,10 @@ LoadStoreQueue::LoadStoreQueue(
       storeBandwidth_(storeBandwidth),
       totalLimit_(permittedRequests),
       // Set per-cycle limits for each request type
-      reqLimits_{permittedLoads, permittedStores} {}
+      reqLimits_{permittedLoads, permittedStores},
+      coalesceRequests_(coalesceRequests),
+      cacheLineWidth_(cacheLineWidth),
+      forwardingLatency_(forwardingLatency) {}
 
 unsigned int LoadStoreQueue::getLoadQueueSpace() const {
   if (combined_) {
@@ -114,65 +162,266 @@ void LoadStoreQueue::startLoad(const std::shared_ptr<Instruction>& insn) {
 
     completedLoads_.push(insn);
   } else {
-    // Create a speculative entry for the load
-    requestLoadQueue_[tickCounter_ + insn->getLSQLatency()].push_back(
-        {{}, insn});
-    // Store a reference to the reqAddresses queue for easy access
-    auto& reqAddrQueue = requestLoadQueue_[tickCounter_ + insn->getLSQLatency()]
-                             .back()
-                             .reqAddresses;
-    // Store load addresses temporarily so that conflictions are
-    // only registered once on most recent (program order) store
-    std::list<simeng::memory::MemoryAccessTarget> temp_load_addr(
-        ld_addresses.begin(), ld_addresses.end());
-
-    // Detect reordering conflicts
-    if (storeQueue_.size() > 0) {
-      uint64_t seqId = insn->getSequenceId();
-      for (auto itSt = storeQueue_.rbegin(); itSt != storeQueue_.rend();
-           itSt++) {
-        const auto& store = itSt->first;
-        // If entry is earlier in the program order than load, detect conflicts
-        if (store->getSequenceId() < seqId) {
-          const auto& str_addresses = store->getGeneratedAddresses();
-          // Iterate over possible matches between store and load addresses
-          for (const auto& str : str_addresses) {
-            auto itLd = temp_load_addr.begin();
-            while (itLd != temp_load_addr.end()) {
-              // If conflict exists, register in conflictionMap_ and delay
-              // load request(s) until conflicting store retires
-              if (itLd->address == str.address) {
-                // Load access size must be no larger than the store access size
-                // to ensure all data is encapsulated in the later forwarding
-                if (itLd->size <= str.size) {
-                  conflictionMap_[store->getSequenceId()][str.address]
-                      .push_back({insn, itLd->size});
-                } else {
-                  // To ensure load doesn't match on an earlier store, generate
-                  // load request for address
-                  reqAddrQueue.push(*itLd);
-                }
-                // Remove from temporary vector so the confliction can't be
-                // registered again
-                itLd = temp_load_addr.erase(itLd);
-              } else {
-                itLd++;
-              }
-            }
-          }
-        }
+    // Create a speculative entry for the load, storing a reference to its
+    // addresses for easy access
+    auto& reqAddrQueue = scheduleRequest(requestLoadQueue_, insn).reqAddresses;
+    // Store load addresses which don't conflict with an older store
+    // temporarily so that they can be requested from memory
+    std::list<simeng::memory::MemoryAccessTarget> temp_load_addr;
+
+    // Detect reordering conflicts with the most recent (program order) store
+    // overlapping each address, registering each address for later memory
+    // order violation checks
+    uint64_t seqId = insn->getSequenceId();
+    for (const auto& ld_addr : ld_addresses) {
+      auto store = findConflictingStore(seqId, ld_addr);
+      if (store == nullptr) {
+        temp_load_addr.push_back(ld_addr);
+        indexAccess(loadAddressIndex_, {insn, ld_addr});
+      } else {
+        registerConfliction(insn, ld_addr, store);
+        indexAccess(loadAddressIndex_,
+                    {insn, ld_addr, true, store->getSequenceId()});
       }
     }
+
     // If addresses remain that had no conflictions, generate those load
     // request(s)
-    for (const auto& ld_addr : temp_load_addr) reqAddrQueue.emplace(ld_addr);
+    if (coalesceRequests_ && temp_load_addr.size() > 1) {
+      coalesceLoadRequests(insn, temp_load_addr, reqAddrQueue);
+    } else {
+      for (const auto& ld_addr : temp_load_addr) {
+        reqAddrQueue.push_back(ld_addr);
+      }
+    }
 
     // Register active load
     requestedLoads_.emplace(insn->getSequenceId(), insn);
   }
 }
 
+void LoadStoreQueue::indexAccess(
+    std::unordered_map<uint64_t, std::vector<indexedAccess>>& index,
+    const indexedAccess& access) {
+  const uint64_t end = access.target.address + access.target.size;
+  for (uint64_t line = access.target.address / cacheLineWidth_;
+       line * cacheLineWidth_ < end; line++) {
+    index[line].push_back(access);
+  }
+}
+
+void LoadStoreQueue::unindexAccesses(
+    std::unordered_map<uint64_t, std::vector<indexedAccess>>& index,
+    const std::shared_ptr<Instruction>& insn,
+    span<const memory::MemoryAccessTarget> targets) {
+  for (const auto& target : targets) {
+    const uint64_t end = target.address + target.size;
+    for (uint64_t line = target.address / cacheLineWidth_;
+         line * cacheLineWidth_ < end; line++) {
+      const auto& itLine = index.find(line);
+      if (itLine == index.end()) continue;
+      auto& accesses = itLine->second;
+      accesses.erase(std::remove_if(accesses.begin(), accesses.end(),
+                                    [&insn](const indexedAccess& access) {
+                                      return access.insn == insn;
+                                    }),
+                     accesses.end());
+      if (accesses.size() == 0) index.erase(itLine);
+    }
+  }
+}
+
+std::shared_ptr<Instruction> LoadStoreQueue::findConflictingStore(
+    uint64_t seqId, const simeng::memory::MemoryAccessTarget& target) const {
+  std::shared_ptr<Instruction> youngest = nullptr;
+  // Only stores which access the same cache line(s) as the target can overlap
+  const uint64_t end = target.address + target.size;
+  for (uint64_t line = target.address / cacheLineWidth_;
+       line * cacheLineWidth_ < end; line++) {
+    const auto& itLine = storeAddressIndex_.find(line);
+    if (itLine == storeAddressIndex_.end()) continue;
+    for (const auto& str : itLine->second) {
+      // Only stores earlier in the program order than the load conflict
+      uint64_t strSeqId = str.insn->getSequenceId();
+      if (strSeqId >= seqId || !requestsOverlap(str.target, target)) continue;
+      if (youngest == nullptr || strSeqId > youngest->getSequenceId()) {
+        youngest = str.insn;
+      }
+    }
+  }
+  return youngest;
+}
+
+void LoadStoreQueue::registerConfliction(
+    const std::shared_ptr<Instruction>& load,
+    const simeng::memory::MemoryAccessTarget& target,
+    const std::shared_ptr<Instruction>& store) {
+  // Data can only be forwarded if a single access of the store overlaps the
+  // load access and contains it entirely
+  const auto& strAddresses = store->getGeneratedAddresses();
+  size_t overlaps = 0;
+  size_t index = 0;
+  for (size_t i = 0; i < strAddresses.size(); i++) {
+    if (requestsOverlap(strAddresses[i], target)) {
+      overlaps++;
+      index = i;
+    }
+  }
+  const auto& str = strAddresses[index];
+  if (overlaps != 1 || target.address < str.address ||
+      target.address + target.size > str.address + str.size) {
+    // Partial overlap; the load access must wait for the store to commit
+    // before it can be requested from memory
+    conflictionMap_[store->getSequenceId()].push_back(
+        {load, target, false, 0});
+    stalledAccesses_++;
+    return;
+  }
+
+  forwardedAccesses_++;
+  // Forward the store's data now if it's available, otherwise wait for it to be
+  // supplied. The store queue is held in program order
+  auto itSt = std::lower_bound(
+      storeQueue_.begin(), storeQueue_.end(), store->getSequenceId(),
+      [](const auto& entry, uint64_t seqId) {
+        return entry.first->getSequenceId() < seqId;
+      });
+  if (itSt != storeQueue_.end() && itSt->first == store &&
+      itSt->second.size() > index) {
+    forwardData(load, target, str, itSt->second[index]);
+  } else {
+    conflictionMap_[store->getSequenceId()].push_back(
+        {load, target, true, index});
+  }
+}
+
+void LoadStoreQueue::forwardStoreData(const std::shared_ptr<Instruction>& store,
+                                      span<const simeng::RegisterValue> data) {
+  const auto& itSt = conflictionMap_.find(store->getSequenceId());
+  if (itSt == conflictionMap_.end()) return;
+
+  const auto& strAddresses = store->getGeneratedAddresses();
+  auto& entries = itSt->second;
+  auto itEntry = entries.begin();
+  while (itEntry != entries.end()) {
+    if (itEntry->load->isFlushed()) {
+      itEntry = entries.erase(itEntry);
+    } else if (itEntry->forwardable && itEntry->storeIndex < data.size()) {
+      forwardData(itEntry->load, itEntry->target,
+                  strAddresses[itEntry->storeIndex],
+                  data[itEntry->storeIndex]);
+      itEntry = entries.erase(itEntry);
+    } else {
+      itEntry++;
+    }
+  }
+  if (entries.size() == 0) conflictionMap_.erase(itSt);
+}
+
+void LoadStoreQueue::forwardData(
+    const std::shared_ptr<Instruction>& load,
+    const simeng::memory::MemoryAccessTarget& target,
+    const simeng::memory::MemoryAccessTarget& storeTarget,
+    const RegisterValue& data) {
+  // Extract the bytes read by the load, zero extending if the store's data
+  // doesn't cover all of them
+  const uint64_t offset = target.address - storeTarget.address;
+  const uint16_t available =
+      data.size() > offset
+          ? std::min<uint64_t>(target.size, data.size() - offset)
+          : 0;
+  pendingForwards_.push_back(
+      {load, target.address,
+       RegisterValue(data.getAsVector<char>() + offset, available,
+                     target.size),
+       tickCounter_ + forwardingLatency_});
+}
+
+void LoadStoreQueue::completeLoad(const std::shared_ptr<Instruction>& load) {
+  load->execute();
+
+  if (load->exceptionEncountered()) {
+    // Exception; don't pass load to completedLoads_
+    raiseException_(load);
+    return;
+  }
+
+  if (load->isStoreData()) {
+    supplyStoreData(load);
+  }
+  completedLoads_.push(load);
+}
+
+requestEntry& LoadStoreQueue::scheduleRequest(
+    TimingWheel<requestEntry>& queue,
+    const std::shared_ptr<Instruction>& insn) {
+  auto& entry = queue.push(tickCounter_ + insn->getLSQLatency());
+  entry.reqAddresses.clear();
+  entry.nextAddress = 0;
+  entry.insn = insn;
+  return entry;
+}
+
+void LoadStoreQueue::coalesceLoadRequests(
+    const std::shared_ptr<Instruction>& insn,
+    const std::list<simeng::memory::MemoryAccessTarget>& targets,
+    std::vector<simeng::memory::MemoryAccessTarget>& reqAddresses) {
+  auto requests =
+      coalesceAccesses({targets.begin(), targets.end()}, cacheLineWidth_,
+                       std::min(cacheLineWidth_, loadBandwidth_));
+
+  std::vector<coalescedRequest> coalesced;
+  for (auto& request : requests) {
+    reqAddresses.push_back(request.target);
+    // Only record those requests which service more than one element access
+    // so that their data can be scattered on completion
+    if (request.elements.size() > 1) {
+      coalescedAccesses_ += request.elements.size();
+      coalescedRequests_++;
+      coalesced.push_back(std::move(request));
+    }
+  }
+  if (coalesced.size() > 0)
+    coalescedLoads_[insn->getSequenceId()] = std::move(coalesced);
+}
+
+bool LoadStoreQueue::supplyCoalescedData(
+    const std::shared_ptr<Instruction>& load,
+    const memory::MemoryReadResult& response) {
+  const auto& itLoad = coalescedLoads_.find(response.requestId);
+  if (itLoad == coalescedLoads_.end()) return false;
+
+  auto& requests = itLoad->second;
+  for (auto itReq = requests.begin(); itReq != requests.end(); itReq++) {
+    if (itReq->target != response.target) continue;
+    // Supply each element access with its portion of the returned data. A
+    // failed read is propagated to all elements as an empty value
+    for (const auto& element : itReq->elements) {
+      if (response.data) {
+        load->supplyData(
+            element.address,
+            RegisterValue(response.data.getAsVector<char>() +
+                              (element.address - itReq->target.address),
+                          element.size));
+      } else {
+        load->supplyData(element.address, RegisterValue());
+      }
+    }
+    requests.erase(itReq);
+    if (requests.size() == 0) coalescedLoads_.erase(itLoad);
+    return true;
+  }
+  return false;
+}
+
 void LoadStoreQueue::supplyStoreData(const std::shared_ptr<Instruction>& insn) {
+  // The store's addresses are now known, so register them for later loads to
+  // detect conflicts against
+  if (insn->isStoreAddress() && !insn->isFlushed()) {
+    for (const auto& target : insn->getGeneratedAddresses()) {
+      indexAccess(storeAddressIndex_, {insn, target});
+    }
+  }
   if (!insn->isStoreData()) return;
   // Get identifier values
   const uint64_t macroOpNum = insn->getInstructionId();
@@ -189,8 +438,10 @@ void LoadStoreQueue::supplyStoreData(const std::shared_ptr<Instruction>& insn) {
     // microOp index value pre-determined in microDecoder
     if (entry->getInstructionId() == macroOpNum &&
         entry->getMicroOpIndex() == microOpNum) {
-      // Supply data to be stored by operations
+      // Supply data to be stored by operations, and forward it to any loads
+      // awaiting it
       itSt->second = data;
+      forwardStoreData(entry, data);
       break;
     } else {
       itSt++;
@@ -214,68 +465,78 @@ bool LoadStoreQueue::commitStore(const std::shared_ptr<Instruction>& uop) {
     return false;
   }
 
-  requestStoreQueue_[tickCounter_ + uop->getLSQLatency()].push_back({{}, uop});
+  auto& reqAddrQueue = scheduleRequest(requestStoreQueue_, uop).reqAddresses;
   // Submit request write to memory interface early as the architectural state
   // considers the store to be retired and thus its operation complete
   for (size_t i = 0; i < addresses.size(); i++) {
     memory_.requestWrite(addresses[i], data[i]);
-    // Still add addresses to requestQueue_ to ensure contention of resources is
-    // correctly simulated
-    requestStoreQueue_[tickCounter_ + uop->getLSQLatency()]
-        .back()
-        .reqAddresses.push(addresses[i]);
+  }
+  // Still add addresses to requestQueue_ to ensure contention of resources is
+  // correctly simulated. When coalescing, element writes falling within the
+  // same cache line only contend for resources once
+  if (coalesceRequests_ && addresses.size() > 1) {
+    auto requests =
+        coalesceAccesses({addresses.begin(), addresses.end()}, cacheLineWidth_,
+                         std::min(cacheLineWidth_, storeBandwidth_));
+    for (const auto& request : requests) {
+      reqAddrQueue.push_back(request.target);
+      if (request.elements.size() > 1) {
+        coalescedAccesses_ += request.elements.size();
+        coalescedRequests_++;
+      }
+    }
+  } else {
+    for (size_t i = 0; i < addresses.size(); i++) {
+      reqAddrQueue.push_back(addresses[i]);
+    }
   }
 
-  // Check all loads that have requested memory
+  // Check loads that have requested memory from the cache lines written to by
+  // the store
   violatingLoad_ = nullptr;
-  for (const auto& load : requestedLoads_) {
-    // Skip loads that are younger than the oldest violating load
-    if (violatingLoad_ &&
-        load.second->getSequenceId() > violatingLoad_->getSequenceId())
-      continue;
-    // Violation invalid if the load and store entries are generated by the same
-    // uop
-    if (load.second->getSequenceId() != uop->getSequenceId()) {
-      const auto& loadedAddresses = load.second->getGeneratedAddresses();
-      // Iterate over store addresses
-      for (const auto& storeReq : addresses) {
-        // Iterate over load addresses
-        for (const auto& loadReq : loadedAddresses) {
-          // Check for overlapping requests, and flush if discovered
-          if (requestsOverlap(storeReq, loadReq)) {
-            violatingLoad_ = load.second;
-          }
+  for (const auto& storeReq : addresses) {
+    const uint64_t end = storeReq.address + storeReq.size;
+    for (uint64_t line = storeReq.address / cacheLineWidth_;
+         line * cacheLineWidth_ < end; line++) {
+      const auto& itLine = loadAddressIndex_.find(line);
+      if (itLine == loadAddressIndex_.end()) continue;
+      for (const auto& loadReq : itLine->second) {
+        const auto& load = loadReq.insn;
+        // Skip loads that are younger than the oldest violating load
+        if (violatingLoad_ &&
+            load->getSequenceId() > violatingLoad_->getSequenceId())
+          continue;
+        // Violation invalid if the load and store entries are generated by the
+        // same uop
+        if (load->getSequenceId() == uop->getSequenceId()) continue;
+        // Accesses which took their data from this store, or a younger store,
+        // can't have violated memory ordering with it
+        if (loadReq.dependsOnStore &&
+            loadReq.storeSeqId >= uop->getSequenceId())
+          continue;
+        // Check for overlapping requests, and flush if discovered
+        if (requestsOverlap(storeReq, loadReq.target)) {
+          violatingLoad_ = load;
         }
       }
     }
   }
 
-  // Resolve any conflicts caused by this store instruction
+  // Resolve any conflicts caused by this store instruction. Data is forwarded
+  // to loads still awaiting it, and the accesses of loads which only partially
+  // overlapped the store can now be requested from memory
+  forwardStoreData(uop, data);
   const auto& itSt = conflictionMap_.find(uop->getSequenceId());
   if (itSt != conflictionMap_.end()) {
-    for (size_t i = 0; i < addresses.size(); i++) {
-      const auto& itAddr = itSt->second.find(addresses[i].address);
-      if (itAddr != itSt->second.end()) {
-        for (const auto& pair : itAddr->second) {
-          const auto& load = pair.first;
-          load->supplyData(addresses[i].address,
-                           data[i].zeroExtend(
-                               std::min(pair.second, (uint16_t)data[i].size()),
-                               pair.second));
-          if (load->hasAllData()) {
-            // This load has completed
-            load->execute();
-            if (load->isStoreData()) {
-              supplyStoreData(load);
-            }
-            completedLoads_.push(load);
-          }
-        }
-      }
+    for (const auto& entry : itSt->second) {
+      if (entry.load->isFlushed()) continue;
+      scheduleRequest(requestLoadQueue_, entry.load)
+          .reqAddresses.push_back(entry.target);
     }
     conflictionMap_.erase(itSt);
   }
 
+  unindexAccesses(storeAddressIndex_, uop, addresses);
   storeQueue_.pop_front();
 
   return violatingLoad_ != nullptr;
@@ -293,6 +554,9 @@ void LoadStoreQueue::commitLoad(const std::shared_ptr<Instruction>& uop) {
     const auto& entry = *it;
     if (entry->isLoad()) {
       requestedLoads_.erase(entry->getSequenceId());
+      unindexAccesses(loadAddressIndex_, entry,
+                      entry->getGeneratedAddresses());
+      coalescedLoads_.erase(entry->getSequenceId());
       it = loadQueue_.erase(it);
       break;
     } else {
@@ -302,82 +566,30 @@ void LoadStoreQueue::commitLoad(const std::shared_ptr<Instruction>& uop) {
 }
 
 void LoadStoreQueue::purgeFlushed() {
-  // Remove flushed loads from load queue
-  auto itLd = loadQueue_.begin();
-  while (itLd != loadQueue_.end()) {
-    const auto& entry = *itLd;
-    if (entry->isFlushed()) {
-      requestedLoads_.erase(entry->getSequenceId());
-      itLd = loadQueue_.erase(itLd);
-    } else {
-      itLd++;
-    }
+  // Loads and stores are added to their queues in program order, so flushed
+  // instructions are always the youngest entries. Truncate each queue at the
+  // first instruction which remains, such that the cost of a flush depends only
+  // on the number of instructions squashed
+  while (loadQueue_.size() > 0 && loadQueue_.back()->isFlushed()) {
+    const auto& entry = loadQueue_.back();
+    requestedLoads_.erase(entry->getSequenceId());
+    unindexAccesses(loadAddressIndex_, entry, entry->getGeneratedAddresses());
+    coalescedLoads_.erase(entry->getSequenceId());
+    loadQueue_.pop_back();
   }
-
-  // Remove flushed stores from store queue and confliction queue if an entry
-  // exists
-  auto itSt = storeQueue_.begin();
-  while (itSt != storeQueue_.end()) {
-    const auto& entry = itSt->first;
-    if (entry->isFlushed()) {
-      conflictionMap_.erase(entry->getSequenceId());
-      itSt = storeQueue_.erase(itSt);
-    } else {
-      itSt++;
-    }
-  }
-
-  // Remove flushed loads from confliction queue
-  for (auto itCnflct = conflictionMap_.begin();
-       itCnflct != conflictionMap_.end(); itCnflct++) {
-    // Iterate over addresses of store
-    for (auto itAddr = itCnflct->second.begin();
-         itAddr != itCnflct->second.end(); itAddr++) {
-      // Iterate over vector of instructions conflicting with store address
-      auto pair = itAddr->second.begin();
-      while (pair != itAddr->second.end()) {
-        if (pair->first->isFlushed()) {
-          pair = itAddr->second.erase(pair);
-        } else {
-          pair++;
-        }
-      }
-    }
+  while (storeQueue_.size() > 0 && storeQueue_.back().first->isFlushed()) {
+    const auto& entry = storeQueue_.back().first;
+    conflictionMap_.erase(entry->getSequenceId());
+    unindexAccesses(storeAddressIndex_, entry,
+                    entry->getGeneratedAddresses());
+    storeQueue_.pop_back();
   }
 
-  // Remove flushed loads and stores from request queues
-  auto itLdReq = requestLoadQueue_.begin();
-  while (itLdReq != requestLoadQueue_.end()) {
-    auto itInsn = itLdReq->second.begin();
-    while (itInsn != itLdReq->second.end()) {
-      if (itInsn->insn->isFlushed()) {
-        itInsn = itLdReq->second.erase(itInsn);
-      } else {
-        itInsn++;
-      }
-    }
-    if (itLdReq->second.size() == 0) {
-      itLdReq = requestLoadQueue_.erase(itLdReq);
-    } else {
-      itLdReq++;
-    }
-  }
-  auto itStReq = requestStoreQueue_.begin();
-  while (itStReq != requestStoreQueue_.end()) {
-    auto itInsn = itStReq->second.begin();
-    while (itInsn != itStReq->second.end()) {
-      if (itInsn->insn->isFlushed()) {
-        itInsn = itStReq->second.erase(itInsn);
-      } else {
-        itInsn++;
-      }
-    }
-    if (itStReq->second.size() == 0) {
-      itStReq = requestStoreQueue_.erase(itStReq);
-    } else {
-      itStReq++;
-    }
-  }
+  // Flushed loads may still be registered against an older store in the
+  // confliction map, and have requests or forwarded data pending. As finding
+  // these would require searching every entry, they are instead discarded as
+  // they are reached. Store requests are only made once a store has committed,
+  // so are never flushed
 }
 
 void LoadStoreQueue::tick() {
@@ -388,24 +600,29 @@ void LoadStoreQueue::tick() {
   std::array<uint16_t, 2> reqCounts = {0, 0};
   std::array<uint64_t, 2> dataTransferred = {0, 0};
   std::array<bool, 2> exceededLimits = {false, false};
-  auto itLoad = requestLoadQueue_.begin();
-  auto itStore = requestStoreQueue_.begin();
-  while (requestLoadQueue_.size() + requestStoreQueue_.size() > 0) {
+  while (!requestLoadQueue_.empty() || !requestStoreQueue_.empty()) {
     // Choose which request type to schedule next
     bool chooseLoad = false;
     std::pair<bool, uint64_t> earliestLoad;
     std::pair<bool, uint64_t> earliestStore;
+    // Discard the requests of flushed loads from the front of the queue, so
+    // that they don't take part in scheduling
+    while (!requestLoadQueue_.empty() &&
+           requestLoadQueue_.front().insn->isFlushed()) {
+      requestLoadQueue_.front().insn = nullptr;
+      requestLoadQueue_.pop_front();
+    }
     // Determine if a load request can be scheduled
-    if (requestLoadQueue_.size() == 0 || exceededLimits[accessType::LOAD]) {
+    if (requestLoadQueue_.empty() || exceededLimits[accessType::LOAD]) {
       earliestLoad = {false, 0};
     } else {
-      earliestLoad = {true, itLoad->first};
+      earliestLoad = {true, requestLoadQueue_.frontCycle()};
     }
     // Determine if a store request can be scheduled
-    if (requestStoreQueue_.size() == 0 || exceededLimits[accessType::STORE]) {
+    if (requestStoreQueue_.empty() || exceededLimits[accessType::STORE]) {
       earliestStore = {false, 0};
     } else {
-      earliestStore = {true, itStore->first};
+      earliestStore = {true, requestStoreQueue_.frontCycle()};
     }
     // Choose between available requests favouring those constructed earlier
     // (store requests on a tie)
@@ -417,12 +634,13 @@ void LoadStoreQueue::tick() {
     }
 
     // Get next request to schedule
-    auto& itReq = chooseLoad ? itLoad : itStore;
-    auto itInsn = itReq->second.begin();
+    auto& queue = chooseLoad ? requestLoadQueue_ : requestStoreQueue_;
+    const uint64_t cycle =
+        chooseLoad ? earliestLoad.second : earliestStore.second;
     auto bandwidth = chooseLoad ? loadBandwidth_ : storeBandwidth_;
 
     // Check if earliest request is ready
-    if (itReq->first <= tickCounter_) {
+    if (cycle <= tickCounter_) {
       // Identify request type
       uint8_t isStore = 0;
       if (!chooseLoad) {
@@ -433,14 +651,22 @@ void LoadStoreQueue::tick() {
       if (exclusive_) exceededLimits[!isStore] = true;
 
       // Iterate over requests ready this cycle
-      while (itInsn != itReq->second.end()) {
-        // Schedule requests from the queue of addresses in
+      bool limited = false;
+      while (!limited && !queue.empty() && queue.frontCycle() == cycle) {
+        auto& entry = queue.front();
+        if (entry.insn->isFlushed()) {
+          // Requests of flushed loads are discarded unscheduled
+          entry.insn = nullptr;
+          queue.pop_front();
+          continue;
+        }
+        // Schedule requests from the addresses in the
         // request[Load|Store]Queue_ entry
-        auto& addressQueue = itInsn->reqAddresses;
-        while (addressQueue.size()) {
+        auto& addresses = entry.reqAddresses;
+        while (entry.nextAddress < addresses.size()) {
           const simeng::memory::MemoryAccessTarget req =
-              addressQueue.front();  // Speculatively increment count of this
-                                     // request type
+              addresses[entry.nextAddress];
+          // Speculatively increment count of this request type
           reqCounts[isStore]++;
 
           // Ensure the limit on the number of permitted operations is adhered
@@ -448,7 +674,7 @@ void LoadStoreQueue::tick() {
           if (reqCounts[isStore] + reqCounts[!isStore] > totalLimit_) {
             // No more requests can be scheduled this cycle
             exceededLimits = {true, true};
-            itInsn = itReq->second.end();
+            limited = true;
             break;
           } else if (reqCounts[isStore] > reqLimits_[isStore]) {
             // No more requests of this type can be scheduled this cycle
@@ -456,7 +682,7 @@ void LoadStoreQueue::tick() {
             // Remove speculative increment to ensure it doesn't count for
             // comparisons against the totalLimit_
             reqCounts[isStore]--;
-            itInsn = itReq->second.end();
+            limited = true;
             break;
           }
 
@@ -468,33 +694,24 @@ void LoadStoreQueue::tick() {
           if (dataTransferred[isStore] > bandwidth) {
             // No more requests can be scheduled this cycle
             exceededLimits[isStore] = true;
-            itInsn = itReq->second.end();
+            limited = true;
             break;
           }
 
           // Request a read from the memory interface if the requestQueue_
           // entry represents a read
           if (!isStore) {
-            memory_.requestRead(req, itInsn->insn->getSequenceId());
+            memory_.requestRead(req, entry.insn->getSequenceId());
           }
 
-          // Remove processed address from queue
-          addressQueue.pop();
+          // Move on to the next address
+          entry.nextAddress++;
         }
-        // Remove entry from vector if all of its requests have been
+        // Remove entry from the queue if all of its requests have been
         // scheduled
-        if (addressQueue.size() == 0) {
-          itInsn = itReq->second.erase(itInsn);
-        }
-      }
-
-      // If all uops for currently selected cycle in request[Load|Store]Queue_
-      // have been scheduled, erase entry
-      if (itReq->second.size() == 0) {
-        if (chooseLoad) {
-          itReq = requestLoadQueue_.erase(itReq);
-        } else {
-          itReq = requestStoreQueue_.erase(itReq);
+        if (!limited) {
+          entry.insn = nullptr;
+          queue.pop_front();
         }
       }
     } else {
@@ -515,27 +732,33 @@ void LoadStoreQueue::tick() {
       continue;
     }
 
-    // Supply data to the instruction and execute if it is ready
+    // Supply data to the instruction and execute if it is ready. Data returned
+    // for a coalesced request is scattered to each of its element accesses
     const auto& load = itr->second;
-    load->supplyData(address, data);
+    if (!supplyCoalescedData(load, response)) load->supplyData(address, data);
     if (load->hasAllData()) {
       // This load has completed
-      load->execute();
-
-      if (load->exceptionEncountered()) {
-        // Exception; don't pass load to completedLoads_
-        raiseException_(load);
-        continue;
-      }
-
-      if (load->isStoreData()) {
-        supplyStoreData(load);
-      }
-      completedLoads_.push(load);
+      completeLoad(load);
     }
   }
   memory_.clearCompletedReads();
 
+  // Supply data forwarded from stores once the forwarding latency has elapsed
+  while (pendingForwards_.size() > 0 &&
+         pendingForwards_.front().readyAt <= tickCounter_) {
+    const auto& forward = pendingForwards_.front();
+    if (forward.load->isFlushed()) {
+      pendingForwards_.pop_front();
+      continue;
+    }
+    forward.load->supplyData(forward.address, forward.data);
+    if (forward.load->hasAllData()) {
+      // This load has completed
+      completeLoad(forward.load);
+    }
+    pendingForwards_.pop_front();
+  }
+
   // Pop from the front of the completed loads queue and send to writeback
   size_t count = 0;
   while (completedLoads_.size() > 0 && count < completionSlots_.size()) {
@@ -564,5 +787,27 @@ std::shared_ptr<Instruction> LoadStoreQueue::getViolatingLoad() const {
 
 bool LoadStoreQueue::isCombined() const { return combined_; }
 
+bool LoadStoreQueue::isActive() const {
+  return !requestLoadQueue_.empty() || !requestStoreQueue_.empty() ||
+         pendingForwards_.size() > 0 || completedLoads_.size() > 0 ||
+         memory_.getCompletedReads().size() > 0;
+}
+
+uint64_t LoadStoreQueue::getCoalescedAccessesCount() const {
+  return coalescedAccesses_;
+}
+
+uint64_t LoadStoreQueue::getCoalescedRequestsCount() const {
+  return coalescedRequests_;
+}
+
+uint64_t LoadStoreQueue::getForwardedAccessesCount() const {
+  return forwardedAccesses_;
+}
+
+uint64_t LoadStoreQueue::getStalledAccessesCount() const {
+  return stalledAccesses_;
+}
+
 }  // namespace pipeline
 }  // namespace simeng
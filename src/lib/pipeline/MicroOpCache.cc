@@ -0,0 +1,108 @@
+#include "simeng/pipeline/MicroOpCache.hh"
+
+#include <cassert>
+
+namespace simeng {
+namespace pipeline {
+
+MicroOpCache::MicroOpCache(uint32_t capacity, uint16_t associativity,
+                           uint16_t microOpsPerLine, uint16_t blockSize)
+    : associativity_(associativity),
+      microOpsPerLine_(microOpsPerLine),
+      blockSize_(blockSize),
+      setCount_(capacity / (associativity * microOpsPerLine)),
+      lines_(setCount_ * associativity_) {
+  assert((capacity == 0 || setCount_ > 0) &&
+         "micro-op cache capacity must hold at least one set");
+}
+
+bool MicroOpCache::isEnabled() const { return setCount_ > 0; }
+
+bool MicroOpCache::probe(uint64_t address) const {
+  if (!isEnabled()) return false;
+  return find(getSet(address), address).first != associativity_;
+}
+
+std::pair<const std::vector<MicroOpCacheEntry>*, size_t> MicroOpCache::lookup(
+    uint64_t address) {
+  if (!isEnabled()) return {nullptr, 0};
+
+  size_t set = getSet(address);
+  auto [way, index] = find(set, address);
+  if (way == associativity_) return {nullptr, 0};
+
+  Line& line = lines_[set * associativity_ + way];
+  line.lastUsed = ++useCounter_;
+  return {&line.entries, index};
+}
+
+void MicroOpCache::fill(const MicroOpCacheEntry& entry, bool taken) {
+  if (!isEnabled()) return;
+
+  if (!pending_.empty()) {
+    const auto& last = pending_.back();
+    // End the line if the instruction doesn't sequentially follow it, belongs
+    // to another fetch block, or would overflow it
+    if (entry.address != last.address + last.instructionSize ||
+        entry.address / blockSize_ != pending_.front().address / blockSize_ ||
+        pendingMicroOps_ + entry.microOpCount > microOpsPerLine_) {
+      insertPending();
+    }
+  }
+
+  // Instructions which decode into more micro-ops than fit in a line are
+  // never cached
+  if (entry.microOpCount > microOpsPerLine_) return;
+
+  pending_.push_back(entry);
+  pendingMicroOps_ += entry.microOpCount;
+  if (taken) insertPending();
+}
+
+size_t MicroOpCache::getSet(uint64_t address) const {
+  return (address / blockSize_) % setCount_;
+}
+
+std::pair<uint16_t, size_t> MicroOpCache::find(size_t set,
+                                               uint64_t address) const {
+  for (uint16_t way = 0; way < associativity_; way++) {
+    const Line& line = lines_[set * associativity_ + way];
+    if (!line.valid) continue;
+    for (size_t i = 0; i < line.entries.size(); i++) {
+      if (line.entries[i].address == address) return {way, i};
+    }
+  }
+  return {associativity_, 0};
+}
+
+void MicroOpCache::insertPending() {
+  if (pending_.empty()) return;
+
+  size_t set = getSet(pending_.front().address);
+  // Replace a line starting at the same address, otherwise the least recently
+  // used line of the set
+  uint16_t victim = 0;
+  for (uint16_t way = 0; way < associativity_; way++) {
+    const Line& line = lines_[set * associativity_ + way];
+    if (line.valid &&
+        line.entries.front().address == pending_.front().address) {
+      victim = way;
+      break;
+    }
+    const Line& current = lines_[set * associativity_ + victim];
+    if (!line.valid || (current.valid && line.lastUsed < current.lastUsed)) {
+      victim = way;
+    }
+  }
+
+  Line& line = lines_[set * associativity_ + victim];
+  line.valid = true;
+  line.lastUsed = ++useCounter_;
+  line.entries = std::move(pending_);
+
+  pending_.clear();
+  pendingMicroOps_ = 0;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
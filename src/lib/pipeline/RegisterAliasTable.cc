@@ -7,11 +7,12 @@ namespace pipeline {
 
 RegisterAliasTable::RegisterAliasTable(
     std::vector<RegisterFileStructure> architecturalStructure,
-    std::vector<uint16_t> physicalRegisterCounts)
+    std::vector<uint16_t> physicalRegisterCounts, uint16_t partition)
     : mappingTable_(architecturalStructure.size()),
       historyTable_(architecturalStructure.size()),
       destinationTable_(architecturalStructure.size()),
-      freeQueues_(architecturalStructure.size()) {
+      freeQueues_(architecturalStructure.size()),
+      tagOffsets_(architecturalStructure.size()) {
   assert(architecturalStructure.size() == physicalRegisterCounts.size() &&
          "The number of physical register types does not match the number of "
          "architectural register types");
@@ -22,17 +23,20 @@ RegisterAliasTable::RegisterAliasTable(
     assert(archCount <= physCount &&
            "Cannot have fewer physical registers than architectural registers");
 
+    uint16_t offset = partition * physCount;
+    tagOffsets_[type] = offset;
+
     // Set up the initial mapping table state for this register type
     mappingTable_[type].resize(archCount);
 
     for (size_t tag = 0; tag < archCount; tag++) {
       // Pre-assign a physical register to each architectural register
-      mappingTable_[type][tag] = tag;
+      mappingTable_[type][tag] = offset + tag;
     }
 
     // Add remaining physical registers to free queue
     for (size_t tag = archCount; tag < physCount; tag++) {
-      freeQueues_[type].push(tag);
+      freeQueues_[type].push(offset + tag);
     }
 
     // Set up history/destination tables
@@ -74,15 +78,16 @@ Register RegisterAliasTable::allocate(Register architectural) {
 
   auto tag = freeQueue.front();
   freeQueue.pop();
+  uint16_t index = tag - tagOffsets_[architectural.type];
 
   // Keep the old physical register in the history table
-  historyTable_[architectural.type][tag] =
+  historyTable_[architectural.type][index] =
       mappingTable_[architectural.type][architectural.tag];
 
   // Update the mapping table with the new tag, and mark the architectural
   // register it replaces in the destination table
   mappingTable_[architectural.type][architectural.tag] = tag;
-  destinationTable_[architectural.type][tag] = architectural.tag;
+  destinationTable_[architectural.type][index] = architectural.tag;
 
   return {architectural.type, tag, true};
 }
@@ -90,7 +95,8 @@ Register RegisterAliasTable::allocate(Register architectural) {
 void RegisterAliasTable::commit(Register physical) {
   // Find the register previously mapped to the same architectural register and
   // free it
-  auto oldTag = historyTable_[physical.type][physical.tag];
+  auto oldTag =
+      historyTable_[physical.type][physical.tag - tagOffsets_[physical.type]];
   freeQueues_[physical.type].push(oldTag);
 }
 
@@ -98,11 +104,12 @@ void RegisterAliasTable::rewind(Register physical) {
   assert(physical.renamed &&
          "Attempted to rewind a physical register which hasn't been subject to "
          "the register renaming scheme");
+  uint16_t index = physical.tag - tagOffsets_[physical.type];
   // Find which architectural tag this referred to
-  auto destinationTag = destinationTable_[physical.type][physical.tag];
+  auto destinationTag = destinationTable_[physical.type][index];
   // Rewind the mapping table to the old physical tag
   mappingTable_[physical.type][destinationTag] =
-      historyTable_[physical.type][physical.tag];
+      historyTable_[physical.type][index];
   // Add the rewound physical tag back to the free queue
   freeQueues_[physical.type].push(physical.tag);
 }
@@ -43,6 +43,7 @@ void RenameUnit::tick() {
     if (uop->exceptionEncountered()) {
       // Exception; place in ROB, mark as ready, and remove from pipeline
       reorderBuffer_.reserve(uop);
+      renamed_++;
       uop->setCommitReady();
       input_.getHeadSlots()[slot] = nullptr;
       input_.stall(false);
@@ -114,6 +115,7 @@ void RenameUnit::tick() {
 
     // Reserve a slot in the ROB for this uop
     reorderBuffer_.reserve(uop);
+    renamed_++;
 
     // Add to the load/store queue if appropriate
     if (isLoad) {
@@ -133,5 +135,7 @@ uint64_t RenameUnit::getROBStalls() const { return robStalls_; }
 uint64_t RenameUnit::getLoadQueueStalls() const { return lqStalls_; }
 uint64_t RenameUnit::getStoreQueueStalls() const { return sqStalls_; }
 
+uint64_t RenameUnit::getRenamedCount() const { return renamed_; }
+
 }  // namespace pipeline
 }  // namespace simeng
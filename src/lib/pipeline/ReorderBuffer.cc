@@ -11,85 +11,95 @@ ReorderBuffer::ReorderBuffer(
     uint32_t maxSize, RegisterAliasTable& rat, LoadStoreQueue& lsq,
     std::function<void(const std::shared_ptr<Instruction>&)> raiseException,
     std::function<void(uint64_t branchAddress)> sendLoopBoundary,
-    BranchPredictor& predictor, uint16_t loopBufSize,
-    uint16_t loopDetectionThreshold)
+    BranchPredictor& predictor, StoreSetPredictor& storeSetPredictor,
+    uint16_t loopBufSize, uint16_t loopDetectionThreshold, uint16_t threadId)
     : rat_(rat),
       lsq_(lsq),
       maxSize_(maxSize),
       raiseException_(raiseException),
       sendLoopBoundary_(sendLoopBoundary),
       predictor_(predictor),
+      storeSetPredictor_(storeSetPredictor),
+      buffer_(maxSize),
       loopBufSize_(loopBufSize),
-      loopDetectionThreshold_(loopDetectionThreshold) {}
+      loopDetectionThreshold_(loopDetectionThreshold),
+      threadId_(threadId),
+      seqId_(static_cast<uint64_t>(threadId) << 48),
+      insnId_(seqId_) {}
 
 void ReorderBuffer::reserve(const std::shared_ptr<Instruction>& insn) {
-  assert(buffer_.size() < maxSize_ &&
+  assert(count_ < maxSize_ &&
          "Attempted to reserve entry in reorder buffer when already full");
+  insn->setThreadId(threadId_);
   insn->setSequenceId(seqId_);
   seqId_++;
   insn->setInstructionId(insnId_);
+  // The ID only advances once a macro-op's last micro-op is reserved. Should a
+  // flush remove a macro-op before then, its ID is taken by the next one.
   if (insn->isLastMicroOp()) insnId_++;
 
-  buffer_.push_back(insn);
+  uint32_t index = (head_ + count_) % maxSize_;
+  // Record where the first micro-op of each macro-op resides
+  if (insn->isMicroOp()) {
+    microOpGroups_.emplace(insn->getInstructionId(), index);
+  }
+
+  buffer_[index] = insn;
+  count_++;
 }
 
 void ReorderBuffer::commitMicroOps(uint64_t insnId) {
-  if (buffer_.size()) {
-    size_t index = 0;
-    uint64_t firstOp = UINT64_MAX;
-    bool validForCommit = false;
-    bool foundFirstInstance = false;
-
-    // Find first instance of uop belonging to macro-op instruction
-    for (; index < buffer_.size(); index++) {
-      if (buffer_[index]->getInstructionId() == insnId) {
-        firstOp = index;
-        foundFirstInstance = true;
-        break;
-      }
+  auto group = microOpGroups_.find(insnId);
+  if (group == microOpGroups_.end()) return;
+
+  // Offset of the macro-op's first micro-op from the head of the ROB
+  uint32_t first = (group->second + maxSize_ - head_) % maxSize_;
+  bool validForCommit = false;
+
+  // See if all uops are committable
+  uint32_t offset = first;
+  for (; offset < count_; offset++) {
+    const auto& uop = at(offset);
+    if (uop->getInstructionId() != insnId) break;
+    if (!uop->isWaitingCommit()) {
+      return;
+    } else if (uop->isLastMicroOp()) {
+      // all microOps must be in ROB for the commit to be valid
+      validForCommit = true;
     }
+  }
+  if (!validForCommit) return;
 
-    if (foundFirstInstance) {
-      // If found, see if all uops are committable
-      for (; index < buffer_.size(); index++) {
-        if (buffer_[index]->getInstructionId() != insnId) break;
-        if (!buffer_[index]->isWaitingCommit()) {
-          return;
-        } else if (buffer_[index]->isLastMicroOp()) {
-          // all microOps must be in ROB for the commit to be valid
-          validForCommit = true;
-        }
-      }
-      if (!validForCommit) return;
-
-      assert(firstOp != UINT64_MAX && "firstOp hasn't been populated");
-      // No early return thus all uops are committable
-      for (; firstOp < buffer_.size(); firstOp++) {
-        if (buffer_[firstOp]->getInstructionId() != insnId) break;
-        buffer_[firstOp]->setCommitReady();
-      }
-    }
+  // No early return thus all uops are committable
+  for (; first < offset; first++) {
+    at(first)->setCommitReady();
   }
-  return;
+}
+
+void ReorderBuffer::setRetireHandler(
+    std::function<void(const std::shared_ptr<Instruction>&)> retireHandler) {
+  retireHandler_ = std::move(retireHandler);
 }
 
 unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
   shouldFlush_ = false;
   size_t maxCommits =
-      std::min(static_cast<size_t>(maxCommitSize), buffer_.size());
+      std::min(static_cast<size_t>(maxCommitSize), static_cast<size_t>(count_));
 
   unsigned int n;
   for (n = 0; n < maxCommits; n++) {
-    auto& uop = buffer_[0];
+    auto& uop = at(0);
     if (!uop->canCommit()) {
       break;
     }
 
-    if (uop->isLastMicroOp()) instructionsCommitted_++;
+    // A fused macro-op retires both of the instructions it replaced
+    if (uop->isLastMicroOp()) instructionsCommitted_ += uop->isFused() ? 2 : 1;
+    if (retireHandler_) retireHandler_(uop);
 
     if (uop->exceptionEncountered()) {
       raiseException_(uop);
-      buffer_.pop_front();
+      popFront();
       return n + 1;
     }
 
@@ -108,11 +118,12 @@ unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
         loadViolations_++;
         // Memory order violation found; aborting commits and flushing
         auto load = lsq_.getViolatingLoad();
+        storeSetPredictor_.update(load, uop);
         shouldFlush_ = true;
         flushAfter_ = load->getInstructionId() - 1;
         pc_ = load->getInstructionAddress();
 
-        buffer_.pop_front();
+        popFront();
         return n + 1;
       }
     }
@@ -161,10 +172,19 @@ unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
                         uop->getInstructionId());
       // Update the branches retired and mispredicted counters
       retiredBranches_++;
-      if (uop->wasBranchMispredicted()) branchMispredicts_++;
+      bool mispredicted = uop->wasBranchMispredicted();
+      if (mispredicted) branchMispredicts_++;
+      // Register-indirect branches are also counted separately, as their
+      // targets can't be determined from the instruction alone
+      if (uop->getKnownOffset() == 0 &&
+          (uop->getBranchType() == BranchType::Unconditional ||
+           uop->getBranchType() == BranchType::SubroutineCall)) {
+        retiredIndirectBranches_++;
+        if (mispredicted) indirectBranchMispredicts_++;
+      }
     }
 
-    buffer_.pop_front();
+    popFront();
   }
 
   return n;
@@ -173,8 +193,8 @@ unsigned int ReorderBuffer::commit(uint64_t maxCommitSize) {
 void ReorderBuffer::flush(uint64_t afterInsnId) {
   // Iterate backwards from the tail of the queue to find and remove ops newer
   // than `afterInsnId`
-  while (!buffer_.empty()) {
-    auto& uop = buffer_.back();
+  while (count_ > 0) {
+    auto& uop = at(count_ - 1);
     if (uop->getInstructionId() <= afterInsnId) {
       break;
     }
@@ -192,7 +212,7 @@ void ReorderBuffer::flush(uint64_t afterInsnId) {
     if (uop->isBranch()) {
       predictor_.flush(uop->getInstructionAddress());
     }
-    buffer_.pop_back();
+    popBack();
   }
 
   // Reset branch counter and loop detection
@@ -200,11 +220,9 @@ void ReorderBuffer::flush(uint64_t afterInsnId) {
   loopDetected_ = false;
 }
 
-unsigned int ReorderBuffer::size() const { return buffer_.size(); }
+unsigned int ReorderBuffer::size() const { return count_; }
 
-unsigned int ReorderBuffer::getFreeSpace() const {
-  return maxSize_ - buffer_.size();
-}
+unsigned int ReorderBuffer::getFreeSpace() const { return maxSize_ - count_; }
 
 bool ReorderBuffer::shouldFlush() const { return shouldFlush_; }
 uint64_t ReorderBuffer::getFlushAddress() const { return pc_; }
@@ -225,5 +243,54 @@ uint64_t ReorderBuffer::getBranchMispredictedCount() const {
 uint64_t ReorderBuffer::getRetiredBranchesCount() const {
   return retiredBranches_;
 }
+
+uint64_t ReorderBuffer::getIndirectBranchMispredictedCount() const {
+  return indirectBranchMispredicts_;
+}
+
+uint64_t ReorderBuffer::getRetiredIndirectBranchesCount() const {
+  return retiredIndirectBranches_;
+}
+
+const std::shared_ptr<Instruction>& ReorderBuffer::getHead() const {
+  assert(count_ > 0 && "Attempted to retrieve the head of an empty ROB");
+  return buffer_[head_];
+}
+
+std::shared_ptr<Instruction>& ReorderBuffer::at(uint32_t offset) {
+  return buffer_[(head_ + offset) % maxSize_];
+}
+
+void ReorderBuffer::popFront() {
+  auto& uop = buffer_[head_];
+  if (uop->isMicroOp()) {
+    // Move the group's index onto its next micro-op, if still in the ROB
+    auto group = microOpGroups_.find(uop->getInstructionId());
+    assert(group != microOpGroups_.end() &&
+           "Micro-op retired without an entry in the micro-op group index");
+    if (count_ > 1 && at(1)->getInstructionId() == uop->getInstructionId()) {
+      group->second = (head_ + 1) % maxSize_;
+    } else {
+      microOpGroups_.erase(group);
+    }
+  }
+  uop = nullptr;
+  head_ = (head_ + 1) % maxSize_;
+  count_--;
+}
+
+void ReorderBuffer::popBack() {
+  auto& uop = at(count_ - 1);
+  // Remove the group's index once its first micro-op has been removed
+  if (uop->isMicroOp() && (count_ == 1 || at(count_ - 2)->getInstructionId() !=
+                                              uop->getInstructionId())) {
+    [[maybe_unused]] auto erased =
+        microOpGroups_.erase(uop->getInstructionId());
+    assert(erased == 1 &&
+           "Micro-op flushed without an entry in the micro-op group index");
+  }
+  uop = nullptr;
+  count_--;
+}
 }  // namespace pipeline
 }  // namespace simeng
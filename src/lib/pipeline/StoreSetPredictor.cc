@@ -0,0 +1,93 @@
+#include "simeng/pipeline/StoreSetPredictor.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace simeng {
+namespace pipeline {
+
+StoreSetPredictor::StoreSetPredictor(uint32_t ssitSize, uint32_t lfstSize)
+    : ssit_(ssitSize, invalidSet_), lfst_(ssitSize > 0 ? lfstSize : 0) {
+  assert((ssitSize == 0 || lfstSize > 0) &&
+         "Store set predictor requires at least one LFST entry");
+}
+
+bool StoreSetPredictor::isEnabled() const { return !ssit_.empty(); }
+
+std::shared_ptr<Instruction> StoreSetPredictor::predictDependency(
+    const std::shared_ptr<Instruction>& load) {
+  if (ssit_.empty()) return nullptr;
+
+  uint32_t set = ssit_[getIndex(load->getInstructionAddress())];
+  if (set == invalidSet_ || lfst_[set] == nullptr) return nullptr;
+  if (lfst_[set]->isFlushed()) {
+    // Flushed stores are left in the LFST until found, rather than searching
+    // for them on every flush
+    lfst_[set] = nullptr;
+    return nullptr;
+  }
+  // Store sets are shared between hardware threads, but a load may only wait
+  // on a store of its own thread
+  if (lfst_[set]->getThreadId() != load->getThreadId()) return nullptr;
+
+  predictedDependencies_++;
+  return lfst_[set];
+}
+
+void StoreSetPredictor::dispatchStore(
+    const std::shared_ptr<Instruction>& store) {
+  if (ssit_.empty()) return;
+
+  uint32_t set = ssit_[getIndex(store->getInstructionAddress())];
+  if (set != invalidSet_) lfst_[set] = store;
+}
+
+void StoreSetPredictor::storeExecuted(
+    const std::shared_ptr<Instruction>& store) {
+  if (ssit_.empty()) return;
+
+  uint32_t set = ssit_[getIndex(store->getInstructionAddress())];
+  // Only clear the entry if a younger store of the set hasn't replaced it
+  if (set != invalidSet_ && lfst_[set] == store) lfst_[set] = nullptr;
+}
+
+void StoreSetPredictor::update(const std::shared_ptr<Instruction>& load,
+                               const std::shared_ptr<Instruction>& store) {
+  if (ssit_.empty()) return;
+  trainings_++;
+
+  uint32_t loadIndex = getIndex(load->getInstructionAddress());
+  uint32_t storeIndex = getIndex(store->getInstructionAddress());
+  uint32_t loadSet = ssit_[loadIndex];
+  uint32_t storeSet = ssit_[storeIndex];
+
+  if (loadSet == invalidSet_ && storeSet == invalidSet_) {
+    // Neither has a store set; allocate one derived from the load's index
+    uint32_t set = loadIndex % lfst_.size();
+    ssit_[loadIndex] = set;
+    ssit_[storeIndex] = set;
+  } else if (loadSet == invalidSet_) {
+    ssit_[loadIndex] = storeSet;
+  } else if (storeSet == invalidSet_) {
+    ssit_[storeIndex] = loadSet;
+  } else {
+    // Both belong to a store set; merge them by favouring the smaller ID
+    uint32_t set = std::min(loadSet, storeSet);
+    ssit_[loadIndex] = set;
+    ssit_[storeIndex] = set;
+  }
+}
+
+uint64_t StoreSetPredictor::getPredictedDependenciesCount() const {
+  return predictedDependencies_;
+}
+
+uint64_t StoreSetPredictor::getTrainingsCount() const { return trainings_; }
+
+uint32_t StoreSetPredictor::getIndex(uint64_t address) const {
+  // Instructions are at least 2-byte aligned, so discard the lowest bit
+  return static_cast<uint32_t>((address >> 1) % ssit_.size());
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,171 @@
+#include "simeng/pipeline/TablePortAllocator.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace simeng {
+namespace pipeline {
+
+namespace {
+
+/** Read a sequence of reservation station indices from the config, omitting
+ * the UINT16_MAX placeholder injected when the option isn't supplied. */
+std::vector<uint16_t> readStations(ryml::ConstNodeRef node) {
+  std::vector<uint16_t> stations;
+  for (size_t i = 0; i < node.num_children(); i++) {
+    uint16_t station = node[i].as<uint16_t>();
+    if (station != UINT16_MAX) stations.push_back(station);
+  }
+  return stations;
+}
+
+}  // namespace
+
+TablePortAllocator::TablePortAllocator(
+    const std::vector<std::vector<uint16_t>>& portArrangement,
+    ryml::ConstNodeRef config)
+    : weights_(portArrangement.size(), 0) {
+  // Map each port to its reservation station
+  std::vector<uint16_t> portToRS(portArrangement.size(), 0);
+  auto stationsConfig = config["Reservation-Stations"];
+  for (size_t rs = 0; rs < stationsConfig.num_children(); rs++) {
+    auto portNums = stationsConfig[rs]["Port-Nums"];
+    for (size_t i = 0; i < portNums.num_children(); i++) {
+      portToRS[portNums[i].as<uint16_t>()] = rs;
+    }
+  }
+
+  auto rulesConfig = config["Port-Allocator"]["Rules"];
+  for (size_t r = 0; r < rulesConfig.num_children(); r++) {
+    auto ruleConfig = rulesConfig[r];
+    rule newRule;
+    newRule.stationPorts.resize(stationsConfig.num_children());
+
+    uint64_t mask = 0;
+    auto portNums = ruleConfig["Port-Nums"];
+    for (size_t i = 0; i < portNums.num_children(); i++) {
+      uint16_t port = portNums[i].as<uint16_t>();
+      mask |= 1ull << port;
+      newRule.stationPorts[portToRS[port]].push_back(port);
+    }
+
+    auto casesConfig = ruleConfig["Cases"];
+    for (size_t c = 0; c < casesConfig.num_children(); c++) {
+      ruleCase newCase;
+      auto conditionsConfig = casesConfig[c]["Conditions"];
+      for (size_t i = 0; i < conditionsConfig.num_children(); i++) {
+        auto cond = conditionsConfig[i];
+        newCase.conditions.push_back({readStations(cond["Stations"]),
+                                      readStations(cond["Minus"]),
+                                      cond["At-Least"].as<int32_t>(),
+                                      cond["At-Most"].as<int32_t>(),
+                                      readStations(cond["Most-Free"]),
+                                      readStations(cond["In"])});
+      }
+      auto tableConfig = casesConfig[c]["Table"];
+      for (size_t i = 0; i < tableConfig.num_children(); i++) {
+        newCase.table.push_back({readStations(tableConfig[i]["Stations"]),
+                                 tableConfig[i]["Rank"].as<uint16_t>()});
+      }
+      newRule.cases.push_back(std::move(newCase));
+    }
+
+    // Later rules for the same set of ports take precedence
+    ruleLookup_[mask] = rules_.size();
+    rules_.push_back(std::move(newRule));
+  }
+}
+
+uint16_t TablePortAllocator::allocate(const std::vector<uint16_t>& ports) {
+  assert(ports.size() &&
+         "No supported ports supplied; cannot allocate from a empty set");
+  uint16_t slot = dispatchSlot_++;
+
+  uint16_t port = 0;
+  uint64_t mask = 0;
+  for (uint16_t option : ports) mask |= 1ull << option;
+  auto found = ruleLookup_.find(mask);
+  if (found != ruleLookup_.end() && rules_[found->second].resolved.size()) {
+    const auto& applied = rules_[found->second];
+    uint16_t rs = applied.resolved[slot % applied.resolved.size()];
+    port = lowestWeight(applied.stationPorts[rs]);
+  } else {
+    // No rule applies, so fall back to load-balancing across all ports
+    port = lowestWeight(ports);
+  }
+
+  weights_[port]++;
+  return port;
+}
+
+void TablePortAllocator::issued(uint16_t port) {
+  assert(weights_[port] > 0);
+  weights_[port]--;
+}
+
+void TablePortAllocator::deallocate(uint16_t port) { issued(port); }
+
+void TablePortAllocator::setRSSizeGetter(
+    std::function<void(std::vector<uint32_t>&)> rsSizes) {
+  rsSizes_ = rsSizes;
+}
+
+void TablePortAllocator::tick() {
+  freeEntries_.clear();
+  rsSizes_(freeEntries_);
+  dispatchSlot_ = 0;
+
+  // Resolve the table of the first applicable case of each rule
+  for (auto& current : rules_) {
+    current.resolved.clear();
+    for (const auto& candidate : current.cases) {
+      if (!std::all_of(candidate.conditions.begin(),
+                       candidate.conditions.end(),
+                       [this](const condition& cond) { return holds(cond); }))
+        continue;
+      for (const auto& entry : candidate.table) {
+        current.resolved.push_back(select(entry));
+      }
+      break;
+    }
+  }
+}
+
+bool TablePortAllocator::holds(const condition& cond) const {
+  if (cond.stations.size() || cond.minus.size()) {
+    int64_t value = 0;
+    for (uint16_t rs : cond.stations) value += freeEntries_[rs];
+    for (uint16_t rs : cond.minus) value -= freeEntries_[rs];
+    if (value < cond.atLeast || value > cond.atMost) return false;
+  }
+  if (cond.mostFree.size()) {
+    uint16_t most = cond.mostFree[0];
+    for (uint16_t rs : cond.mostFree) {
+      if (freeEntries_[rs] > freeEntries_[most]) most = rs;
+    }
+    if (std::find(cond.in.begin(), cond.in.end(), most) == cond.in.end())
+      return false;
+  }
+  return true;
+}
+
+uint16_t TablePortAllocator::select(const tableEntry& entry) {
+  ranked_.assign(entry.stations.begin(), entry.stations.end());
+  std::stable_sort(ranked_.begin(), ranked_.end(),
+                   [this](uint16_t a, uint16_t b) {
+                     return freeEntries_[a] > freeEntries_[b];
+                   });
+  return ranked_[entry.rank];
+}
+
+uint16_t TablePortAllocator::lowestWeight(
+    const std::vector<uint16_t>& ports) const {
+  uint16_t bestPort = ports[0];
+  for (uint16_t port : ports) {
+    if (weights_[port] < weights_[bestPort]) bestPort = port;
+  }
+  return bestPort;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
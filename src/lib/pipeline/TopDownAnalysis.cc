@@ -0,0 +1,144 @@
+#include "simeng/pipeline/TopDownAnalysis.hh"
+
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+#include "simeng/config/yaml/ryml.hh"
+
+namespace simeng {
+namespace pipeline {
+
+namespace {
+
+/** Retrieve `slots` as a fraction of `total`. */
+double getFraction(uint64_t slots, uint64_t total) {
+  return total ? static_cast<double>(slots) / static_cast<double>(total) : 0.0;
+}
+
+/** Add the statistics of `node` and its subcategories to `stats`, keyed by
+ * their path beneath `prefix`. */
+void addStats(std::map<std::string, std::string>& stats,
+              const std::string& prefix, const TopDownNode& node,
+              uint64_t total) {
+  std::string key = prefix + node.name;
+  std::ostringstream share;
+  share << std::setprecision(3) << 100.0 * getFraction(node.slots, total)
+        << "%";
+  stats[key] = share.str();
+  for (const auto& child : node.children) {
+    addStats(stats, key + ".", child, total);
+  }
+}
+
+/** Add `node` and its subcategories to the map `parent`. */
+void addNode(ryml::NodeRef parent, const TopDownNode& node, uint64_t total) {
+  ryml::NodeRef ref = parent.append_child();
+  ref << ryml::key(node.name);
+  ref |= ryml::MAP;
+  ref.append_child() << ryml::key("slots") << node.slots;
+  ref.append_child() << ryml::key("fraction")
+                     << ryml::fmt::real(getFraction(node.slots, total), 4);
+  for (const auto& child : node.children) addNode(ref, child, total);
+}
+
+}  // namespace
+
+TopDownAnalysis::TopDownAnalysis(uint16_t width) : width_(width) {}
+
+void TopDownAnalysis::addCycle(uint16_t delivered, SlotStall stall) {
+  assert(delivered <= width_ && "More micro-ops delivered than slots");
+  cycles_++;
+  uint64_t unfilled = width_ - delivered;
+  switch (stall) {
+    case SlotStall::Frontend:
+      if (delivered == 0) {
+        frontendLatencySlots_ += unfilled;
+      } else {
+        frontendBandwidthSlots_ += unfilled;
+      }
+      break;
+    case SlotStall::BranchMispredict:
+      mispredictSlots_ += unfilled;
+      break;
+    case SlotStall::MachineClear:
+      clearSlots_ += unfilled;
+      break;
+    case SlotStall::CoreBound:
+      coreBoundSlots_ += unfilled;
+      break;
+    case SlotStall::MemoryBound:
+      memoryBoundSlots_ += unfilled;
+      break;
+  }
+}
+
+void TopDownAnalysis::retire(uint64_t uops) { retired_ += uops; }
+
+void TopDownAnalysis::squash(uint64_t uops, SlotStall cause) {
+  assert((cause == SlotStall::BranchMispredict ||
+          cause == SlotStall::MachineClear) &&
+         "Micro-ops squashed by a cause other than bad speculation");
+  if (cause == SlotStall::BranchMispredict) {
+    mispredictSquashed_ += uops;
+  } else {
+    clearSquashed_ += uops;
+  }
+}
+
+uint64_t TopDownAnalysis::getCycles() const { return cycles_; }
+
+std::vector<TopDownNode> TopDownAnalysis::getBreakdown() const {
+  uint64_t mispredicts = mispredictSquashed_ + mispredictSlots_;
+  uint64_t clears = clearSquashed_ + clearSlots_;
+  return {
+      {"retiring", retired_, {}},
+      {"frontendBound",
+       frontendLatencySlots_ + frontendBandwidthSlots_,
+       {{"latency", frontendLatencySlots_, {}},
+        {"bandwidth", frontendBandwidthSlots_, {}}}},
+      {"badSpeculation",
+       mispredicts + clears,
+       {{"branchMispredicts", mispredicts, {}},
+        {"machineClears", clears, {}}}},
+      {"backendBound",
+       memoryBoundSlots_ + coreBoundSlots_,
+       {{"memoryBound", memoryBoundSlots_, {}},
+        {"coreBound", coreBoundSlots_, {}}}}};
+}
+
+std::map<std::string, std::string> TopDownAnalysis::getStats() const {
+  uint64_t total = getTotalSlots();
+  std::map<std::string, std::string> stats = {
+      {"topdown.slots", std::to_string(total)}};
+  for (const auto& node : getBreakdown()) {
+    addStats(stats, "topdown.", node, total);
+  }
+  return stats;
+}
+
+void TopDownAnalysis::write(std::ostream& out, bool json) const {
+  uint64_t total = getTotalSlots();
+  ryml::Tree tree;
+  ryml::NodeRef root = tree.rootref();
+  root |= ryml::MAP;
+  root.append_child() << ryml::key("width") << width_;
+  root.append_child() << ryml::key("cycles") << cycles_;
+  root.append_child() << ryml::key("slots") << total;
+  for (const auto& node : getBreakdown()) addNode(root, node, total);
+
+  if (json) {
+    out << ryml::emitrs_json<std::string>(tree) << "\n";
+  } else {
+    out << ryml::emitrs_yaml<std::string>(tree);
+  }
+}
+
+uint64_t TopDownAnalysis::getTotalSlots() const {
+  uint64_t total = 0;
+  for (const auto& node : getBreakdown()) total += node.slots;
+  return total;
+}
+
+}  // namespace pipeline
+}  // namespace simeng
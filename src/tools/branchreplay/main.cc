@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "simeng/branchpredictors/BranchTrace.hh"
+#include "simeng/branchpredictors/GenericPredictor.hh"
+#include "simeng/branchpredictors/PerceptronPredictor.hh"
+#include "simeng/branchpredictors/TagePredictor.hh"
+#include "simeng/config/ModelConfig.hh"
+#include "simeng/version.hh"
+
+/** The number of branches listed in each table of the most mispredicted
+ * branches. */
+const size_t tableLength = 10;
+
+/** The outcome of replaying a branch trace through a predictor. */
+struct ReplayResult {
+  /** The number of branches mispredicted. */
+  uint64_t mispredicts = 0;
+
+  /** The time taken to replay the trace, in seconds. */
+  double duration = 0;
+
+  /** The most mispredicted branches, as tuples of their address, the number
+   * of times they were executed, and the number of times they were
+   * mispredicted. */
+  std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> worstBranches;
+};
+
+/** Construct the branch predictor described by the `Branch-Predictor` options
+ * of `config`. */
+std::unique_ptr<simeng::BranchPredictor> makePredictor(
+    ryml::ConstNodeRef config) {
+  std::string predictorType =
+      config["Branch-Predictor"]["Type"].as<std::string>();
+  if (predictorType == "Generic") {
+    return std::make_unique<simeng::GenericPredictor>(config);
+  } else if (predictorType == "Perceptron") {
+    return std::make_unique<simeng::PerceptronPredictor>(config);
+  } else if (predictorType == "TAGE") {
+    return std::make_unique<simeng::TagePredictor>(config);
+  }
+  return nullptr;
+}
+
+/** Replay the branches of `records` through `predictor` in commit order,
+ * predicting each branch and then immediately updating the predictor with its
+ * outcome. */
+ReplayResult replay(simeng::BranchPredictor& predictor,
+                    const std::vector<simeng::BranchTraceRecord>& records) {
+  ReplayResult result;
+  std::vector<bool> mispredicted(records.size());
+
+  auto startTime = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < records.size(); i++) {
+    const auto& record = records[i];
+    auto prediction =
+        predictor.predict(record.address, record.type, record.knownOffset);
+    // Flag as mispredicted as the core would; if the direction was wrongly
+    // predicted, or the predicted target is wrong
+    mispredicted[i] = (prediction.isTaken != record.taken) ||
+                      (prediction.target != record.target);
+    predictor.update(record.address, record.taken, record.target, record.type,
+                     i);
+  }
+  auto endTime = std::chrono::high_resolution_clock::now();
+  result.duration =
+      std::chrono::duration<double>(endTime - startTime).count();
+
+  // Tally the executions and mispredictions of each branch
+  std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> branches;
+  for (size_t i = 0; i < records.size(); i++) {
+    auto& [executed, branchMispredicts] = branches[records[i].address];
+    executed++;
+    if (mispredicted[i]) {
+      branchMispredicts++;
+      result.mispredicts++;
+    }
+  }
+
+  for (const auto& [address, counts] : branches) {
+    if (counts.second == 0) continue;
+    result.worstBranches.emplace_back(address, counts.first, counts.second);
+  }
+  auto byMispredicts = [](const auto& a, const auto& b) {
+    if (std::get<2>(a) != std::get<2>(b)) {
+      return std::get<2>(a) > std::get<2>(b);
+    }
+    return std::get<0>(a) < std::get<0>(b);
+  };
+  size_t length = std::min(tableLength, result.worstBranches.size());
+  std::partial_sort(result.worstBranches.begin(),
+                    result.worstBranches.begin() + length,
+                    result.worstBranches.end(), byMispredicts);
+  result.worstBranches.resize(length);
+
+  return result;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <branch trace> <config file> [<config file> ...]"
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "[SimEng:BranchReplay] Version: " SIMENG_VERSION << std::endl;
+
+  // Load the trace
+  std::string tracePath = argv[1];
+  simeng::BranchTraceReader trace(tracePath);
+  if (!trace.isValid()) {
+    std::cerr << "[SimEng:BranchReplay] Could not read branch trace "
+              << tracePath << std::endl;
+    return 1;
+  }
+  const auto& records = trace.getRecords();
+  uint64_t instructions = trace.getInstructionCount();
+  std::cout << "[SimEng:BranchReplay] Trace: " << tracePath << " ("
+            << records.size() << " branches, " << instructions
+            << " instructions)" << std::endl;
+
+  // Load and validate each config file up front, as config validation exits
+  // on failure
+  std::vector<std::string> configPaths(argv + 2, argv + argc);
+  std::vector<ryml::Tree> configs;
+  for (const auto& path : configPaths) {
+    configs.push_back(simeng::config::ModelConfig(path).getConfig());
+  }
+
+  // Replay the trace through each config's predictor, spread across as many
+  // threads as the host supports
+  std::vector<ReplayResult> results(configs.size());
+  std::atomic<size_t> nextConfig(0);
+  auto worker = [&]() {
+    for (size_t i = nextConfig++; i < configs.size(); i = nextConfig++) {
+      auto predictor = makePredictor(configs[i].crootref());
+      results[i] = replay(*predictor, records);
+    }
+  };
+  size_t threadCount = std::min<size_t>(
+      configs.size(), std::max(1u, std::thread::hardware_concurrency()));
+  std::cout << "[SimEng:BranchReplay] Replaying " << configs.size()
+            << " configs on " << threadCount << " threads\n"
+            << std::endl;
+  auto startTime = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < threadCount; i++) threads.emplace_back(worker);
+  for (auto& thread : threads) thread.join();
+  auto endTime = std::chrono::high_resolution_clock::now();
+
+  // Print the results of each config in turn
+  for (size_t i = 0; i < configs.size(); i++) {
+    const auto& result = results[i];
+    double missRate = records.empty() ? 0.0
+                                      : 100.0 * result.mispredicts /
+                                            static_cast<double>(records.size());
+    double mpki = instructions == 0 ? 0.0
+                                    : 1000.0 * result.mispredicts /
+                                          static_cast<double>(instructions);
+    double throughput = result.duration == 0
+                            ? 0.0
+                            : records.size() / result.duration / 1000000.0;
+
+    std::cout << "[SimEng:BranchReplay] Config: " << configPaths[i]
+              << std::endl;
+    std::cout << "[SimEng:BranchReplay] \tPredictor: "
+              << configs[i]["Branch-Predictor"]["Type"].as<std::string>()
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[SimEng:BranchReplay] \tMispredicted: " << result.mispredicts
+              << " (" << missRate << "%)" << std::endl;
+    std::cout << "[SimEng:BranchReplay] \tMPKI: " << mpki << std::endl;
+    std::cout << "[SimEng:BranchReplay] \tThroughput: " << throughput
+              << " M branches/s" << std::endl;
+    std::cout << "[SimEng:BranchReplay] \tMost mispredicted branches:"
+              << std::endl;
+    for (const auto& [address, executed, mispredicts] : result.worstBranches) {
+      std::cout << "[SimEng:BranchReplay] \t\t0x" << std::hex << address
+                << std::dec << ": " << mispredicts << "/" << executed
+                << " mispredicted (" << (100.0 * mispredicts / executed)
+                << "%)" << std::endl;
+    }
+    std::cout << std::defaultfloat << std::endl;
+  }
+
+  auto duration =
+      std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime)
+          .count();
+  std::cout << "[SimEng:BranchReplay] Finished " << configs.size()
+            << " configs in " << duration << "ms" << std::endl;
+
+  return 0;
+}
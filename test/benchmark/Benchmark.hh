@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace simeng {
+namespace benchmark {
+
+/** A microbenchmark body. Runs `iterations` iterations of the benchmarked
+ * operation. */
+using BenchmarkFunction = std::function<void(uint64_t iterations)>;
+
+/** Register the microbenchmark `function` under `name`, to be run by the
+ * benchmark driver with `iterations` iterations. Returns true, such that
+ * benchmarks may be registered through the initialisation of a static. */
+bool registerBenchmark(const std::string& name, uint64_t iterations,
+                       BenchmarkFunction function);
+
+}  // namespace benchmark
+}  // namespace simeng
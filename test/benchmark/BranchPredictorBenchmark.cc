@@ -0,0 +1,137 @@
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hh"
+#include "simeng/branchpredictors/GenericPredictor.hh"
+#include "simeng/branchpredictors/PerceptronPredictor.hh"
+#include "simeng/branchpredictors/TagePredictor.hh"
+#include "simeng/config/SimInfo.hh"
+
+namespace simeng {
+namespace benchmark {
+
+namespace {
+
+/** A branch of the synthetic branch stream. */
+struct Branch {
+  uint64_t address;
+  BranchType type;
+  int64_t knownOffset;
+  bool taken;
+  uint64_t target;
+};
+
+/** Generate a stream of `count` branches drawn from a program of 512 static
+ * branches, mostly conditional with a mix of biased and history-correlated
+ * directions, alongside calls, returns and unconditional branches. */
+std::vector<Branch> generateBranches(size_t count) {
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<uint16_t> staticDist(0, 511);
+  std::uniform_int_distribution<uint16_t> percentDist(0, 99);
+
+  std::vector<Branch> branches;
+  bool lastTaken = false;
+  for (size_t i = 0; i < count; i++) {
+    uint16_t index = staticDist(rng);
+    uint64_t address = 0x10000 + index * 0x40;
+    uint16_t kind = index % 10;
+    if (kind < 7) {
+      // Conditional branches, half biased and half following the direction
+      // of the previous branch
+      bool taken =
+          (index % 2) ? (percentDist(rng) < 90) : (lastTaken != (index % 4));
+      branches.push_back(
+          {address, BranchType::Conditional, 0x20, taken, address + 0x20});
+    } else if (kind == 7) {
+      branches.push_back(
+          {address, BranchType::SubroutineCall, 0x800, true, address + 0x800});
+    } else if (kind == 8) {
+      branches.push_back(
+          {address, BranchType::Return, 0, true, address + 0x104});
+    } else {
+      branches.push_back(
+          {address, BranchType::Unconditional, 0x40, true, address + 0x40});
+    }
+    lastTaken = branches.back().taken;
+  }
+  return branches;
+}
+
+/** Predict `count` branches through `predictor` as a fetch unit would, with
+ * up to 48 branches in flight, updating the oldest in program order as they
+ * retire. Every 64 branches, the 8 youngest in flight are flushed in reverse
+ * program order, as for a misprediction. */
+void predictBranches(BranchPredictor& predictor, uint64_t count) {
+  static const std::vector<Branch> branches = generateBranches(1 << 16);
+
+  std::deque<std::pair<const Branch*, uint64_t>> inFlight;
+  uint64_t instructionId = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    const Branch& branch = branches[i % branches.size()];
+    predictor.predict(branch.address, branch.type, branch.knownOffset);
+    inFlight.emplace_back(&branch, instructionId++);
+
+    if (inFlight.size() > 48) {
+      const auto& [oldest, id] = inFlight.front();
+      predictor.update(oldest->address, oldest->taken, oldest->target,
+                       oldest->type, id);
+      inFlight.pop_front();
+    }
+
+    if (i % 64 == 63) {
+      for (uint16_t j = 0; j < 8 && !inFlight.empty(); j++) {
+        predictor.flush(inFlight.back().first->address);
+        inFlight.pop_back();
+      }
+    }
+  }
+
+  while (!inFlight.empty()) {
+    const auto& [oldest, id] = inFlight.front();
+    predictor.update(oldest->address, oldest->taken, oldest->target,
+                     oldest->type, id);
+    inFlight.pop_front();
+  }
+}
+
+/** The Branch-Predictor configuration shared by the benchmarked predictors. */
+const std::string predictorConfig =
+    "BTB-Tag-Bits: 11, Saturating-Count-Bits: 2, Global-History-Length: 32, "
+    "RAS-entries: 16, Fallback-Static-Predictor: Always-Taken";
+
+const bool registeredGeneric = registerBenchmark(
+    "BranchPredictor/Generic", 2000000, [](uint64_t count) {
+      config::SimInfo::generateDefault(config::ISA::AArch64, true);
+      config::SimInfo::addToConfig("{Branch-Predictor: {Type: Generic, " +
+                                   predictorConfig + "}}");
+      GenericPredictor predictor;
+      predictBranches(predictor, count);
+    });
+
+const bool registeredPerceptron = registerBenchmark(
+    "BranchPredictor/Perceptron", 2000000, [](uint64_t count) {
+      config::SimInfo::generateDefault(config::ISA::AArch64, true);
+      config::SimInfo::addToConfig("{Branch-Predictor: {Type: Perceptron, " +
+                                   predictorConfig + "}}");
+      PerceptronPredictor predictor;
+      predictBranches(predictor, count);
+    });
+
+const bool registeredTage = registerBenchmark(
+    "BranchPredictor/TAGE", 2000000, [](uint64_t count) {
+      config::SimInfo::generateDefault(config::ISA::AArch64, true);
+      config::SimInfo::addToConfig(
+          "{Branch-Predictor: {Type: TAGE, Tagged-Table-Count: 4, "
+          "Tagged-Table-Index-Bits: 10, Tagged-Table-Tag-Bits: 9, "
+          "Min-History-Length: 4, Max-History-Length: 64, " +
+          predictorConfig + "}}");
+      TagePredictor predictor;
+      predictBranches(predictor, count);
+    });
+
+}  // namespace
+
+}  // namespace benchmark
+}  // namespace simeng
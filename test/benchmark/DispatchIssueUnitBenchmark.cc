@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <random>
+
+#include "Benchmark.hh"
+#include "simeng/Instruction.hh"
+#include "simeng/config/SimInfo.hh"
+#include "simeng/pipeline/BalancedPortAllocator.hh"
+#include "simeng/pipeline/DispatchIssueUnit.hh"
+#include "simeng/pipeline/StoreSetPredictor.hh"
+
+namespace simeng {
+namespace benchmark {
+
+namespace {
+
+/** A minimal instruction with two source operands and one destination, whose
+ * operand readiness is tracked without any ISA-specific decoding overhead. */
+class BenchmarkInstruction : public Instruction {
+ public:
+  BenchmarkInstruction(const std::vector<uint16_t>& ports, Register src0,
+                       Register src1, Register dest)
+      : sources_({src0, src1}), destination_(dest), ports_(ports) {}
+
+  const span<Register> getSourceRegisters() const override {
+    return {const_cast<Register*>(sources_.data()), sources_.size()};
+  }
+  const span<RegisterValue> getSourceOperands() const override { return {}; }
+  const span<Register> getDestinationRegisters() const override {
+    return {const_cast<Register*>(&destination_), 1};
+  }
+  void renameSource(uint16_t i, Register renamed) override {
+    sources_[i] = renamed;
+  }
+  void renameDestination(uint16_t i, Register renamed) override {
+    destination_ = renamed;
+  }
+  void supplyOperand(uint16_t i, const RegisterValue& value) override {
+    operandsReady_ |= 1 << i;
+  }
+  bool isOperandReady(int i) const override {
+    return operandsReady_ & (1 << i);
+  }
+  const span<RegisterValue> getResults() const override { return {}; }
+  span<const memory::MemoryAccessTarget> generateAddresses() override {
+    return {};
+  }
+  span<const memory::MemoryAccessTarget> getGeneratedAddresses()
+      const override {
+    return {};
+  }
+  void supplyData(uint64_t address, const RegisterValue& data) override {}
+  span<const RegisterValue> getData() const override { return {}; }
+  std::tuple<bool, uint64_t> checkEarlyBranchMisprediction() const override {
+    return {false, 0};
+  }
+  BranchType getBranchType() const override { return BranchType::Unknown; }
+  int64_t getKnownOffset() const override { return 0; }
+  bool isStoreAddress() const override { return false; }
+  bool isStoreData() const override { return false; }
+  bool isLoad() const override { return false; }
+  bool isBranch() const override { return false; }
+  uint16_t getGroup() const override { return 0; }
+  bool canExecute() const override { return operandsReady_ == 0b11; }
+  void execute() override {}
+  const std::vector<uint16_t>& getSupportedPorts() override { return ports_; }
+  void setExecutionInfo(const ExecutionInfo& info) override {}
+
+ private:
+  std::array<Register, 2> sources_;
+  Register destination_;
+  uint8_t operandsReady_ = 0;
+  const std::vector<uint16_t>& ports_;
+};
+
+/** A wide out-of-order core configuration, with five reservation stations
+ * feeding ten issue ports. */
+const char* wideModel = R"YAML({
+  Ports: {
+    '0': {Portname: P0, Instruction-Group-Support: [ALL]},
+    '1': {Portname: P1, Instruction-Group-Support: [ALL]},
+    '2': {Portname: P2, Instruction-Group-Support: [ALL]},
+    '3': {Portname: P3, Instruction-Group-Support: [ALL]},
+    '4': {Portname: P4, Instruction-Group-Support: [ALL]},
+    '5': {Portname: P5, Instruction-Group-Support: [ALL]},
+    '6': {Portname: P6, Instruction-Group-Support: [ALL]},
+    '7': {Portname: P7, Instruction-Group-Support: [ALL]},
+    '8': {Portname: P8, Instruction-Group-Support: [ALL]},
+    '9': {Portname: P9, Instruction-Group-Support: [ALL]}
+  },
+  Reservation-Stations: {
+    '0': {Size: 60, Dispatch-Rate: 4, Ports: [P0, P1]},
+    '1': {Size: 60, Dispatch-Rate: 4, Ports: [P2, P3]},
+    '2': {Size: 60, Dispatch-Rate: 4, Ports: [P4, P5]},
+    '3': {Size: 60, Dispatch-Rate: 4, Ports: [P6, P7]},
+    '4': {Size: 60, Dispatch-Rate: 4, Ports: [P8, P9]}
+  },
+  Execution-Units: {
+    '0': {Pipelined: True}, '1': {Pipelined: True}, '2': {Pipelined: True},
+    '3': {Pipelined: True}, '4': {Pipelined: True}, '5': {Pipelined: True},
+    '6': {Pipelined: True}, '7': {Pipelined: True}, '8': {Pipelined: True},
+    '9': {Pipelined: True}
+  }
+})YAML";
+
+/** Simulate `cycles` cycles of dispatch, operand forwarding, issue, and
+ * flushing through a wide DispatchIssueUnit. A stream of dependent
+ * instructions executes with a random latency of one to eight cycles, and the
+ * youngest `flushCount` instructions are flushed every `flushInterval` cycles,
+ * as for a branch misprediction. */
+void dispatchIssue(uint64_t cycles, uint16_t flushInterval,
+                   uint16_t flushCount) {
+  config::SimInfo::generateDefault(config::ISA::AArch64, true);
+  config::SimInfo::addToConfig(wideModel);
+
+  const uint16_t width = 8;
+  const uint16_t portCount = 10;
+  const uint16_t physicalRegisters = 512;
+  const std::vector<uint16_t> physRegQuantities = {physicalRegisters};
+  RegisterFileSet registerFileSet({{8, physicalRegisters}});
+
+  pipeline::PipelineBuffer<std::shared_ptr<Instruction>> input(width, nullptr);
+  std::vector<pipeline::PipelineBuffer<std::shared_ptr<Instruction>>>
+      issuePorts(portCount, {1, nullptr});
+  const std::vector<std::vector<uint16_t>> portArrangement(portCount);
+  pipeline::BalancedPortAllocator portAllocator(portArrangement);
+  pipeline::StoreSetPredictor storeSetPredictor(0, 1);
+  pipeline::DispatchIssueUnit dispatchIssueUnit(
+      input, issuePorts, registerFileSet, portAllocator, storeSetPredictor,
+      physRegQuantities);
+
+  std::vector<uint16_t> ports;
+  for (uint16_t port = 0; port < portCount; port++) ports.push_back(port);
+
+  // Pre-generate the random register distances and latencies used, so that
+  // random number generation isn't measured
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<uint16_t> distanceDist(1, 32);
+  std::uniform_int_distribution<uint16_t> latencyDist(1, 8);
+  std::vector<uint16_t> distances(4096);
+  std::vector<uint16_t> latencies(4096);
+  for (auto& distance : distances) distance = distanceDist(rng);
+  for (auto& latency : latencies) latency = latencyDist(rng);
+  size_t nextDistance = 0;
+  size_t nextLatency = 0;
+
+  // The most recently created instructions, oldest first
+  std::deque<std::shared_ptr<Instruction>> window;
+  // Instructions in execution, bucketed by their completion cycle modulo the
+  // number of buckets
+  std::array<std::vector<std::shared_ptr<Instruction>>, 9> executing;
+  uint16_t nextTag = 0;
+  const RegisterValue result(0, 8);
+
+  for (uint64_t cycle = 1; cycle <= cycles; cycle++) {
+    // Refill the dispatch input with instructions reading recent results
+    for (size_t slot = 0; slot < width && !input.isStalled(); slot++) {
+      auto& head = input.getHeadSlots()[slot];
+      if (head != nullptr) continue;
+      uint16_t src0 = (nextTag + physicalRegisters -
+                       distances[nextDistance++ % distances.size()]) %
+                      physicalRegisters;
+      uint16_t src1 = (nextTag + physicalRegisters -
+                       distances[nextDistance++ % distances.size()]) %
+                      physicalRegisters;
+      head = std::make_shared<BenchmarkInstruction>(
+          ports, Register{0, src0}, Register{0, src1}, Register{0, nextTag});
+      nextTag = (nextTag + 1) % physicalRegisters;
+      window.push_back(head);
+      if (window.size() > 1024) window.pop_front();
+    }
+
+    dispatchIssueUnit.tick();
+
+    // Forward the results of completed instructions
+    auto& completed = executing[cycle % executing.size()];
+    for (auto& insn : completed) {
+      std::array<RegisterValue, 1> values = {result};
+      dispatchIssueUnit.forwardOperands(insn->getDestinationRegisters(),
+                                        values);
+    }
+    completed.clear();
+
+    dispatchIssueUnit.issue();
+    for (auto& port : issuePorts) {
+      auto& issued = port.getTailSlots()[0];
+      if (issued == nullptr) continue;
+      uint16_t latency = latencies[nextLatency++ % latencies.size()];
+      executing[(cycle + latency) % executing.size()].push_back(
+          std::move(issued));
+      issued = nullptr;
+    }
+
+    if (cycle % flushInterval == 0) {
+      // Flush the youngest instructions, reallocating their destination
+      // registers to the instructions which follow
+      for (uint16_t i = 0; i < flushCount; i++) {
+        window.back()->setFlushed();
+        window.pop_back();
+      }
+      nextTag = (nextTag + physicalRegisters - flushCount) % physicalRegisters;
+      for (size_t slot = 0; slot < width; slot++) {
+        input.getHeadSlots()[slot] = nullptr;
+      }
+      for (auto& bucket : executing) {
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                    [](const auto& insn) {
+                                      return insn->isFlushed();
+                                    }),
+                     bucket.end());
+      }
+      dispatchIssueUnit.purgeFlushed();
+    }
+  }
+}
+
+const bool registeredRareFlush = registerBenchmark(
+    "DispatchIssueUnit/rareFlush", 200000,
+    [](uint64_t cycles) { dispatchIssue(cycles, 100, 48); });
+
+const bool registeredFrequentFlush = registerBenchmark(
+    "DispatchIssueUnit/frequentFlush", 200000,
+    [](uint64_t cycles) { dispatchIssue(cycles, 10, 16); });
+
+}  // namespace
+
+}  // namespace benchmark
+}  // namespace simeng
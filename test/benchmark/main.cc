@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hh"
+
+namespace simeng {
+namespace benchmark {
+
+/** A registered microbenchmark. */
+struct registeredBenchmark {
+  /** The name of the benchmark. */
+  std::string name;
+  /** The default number of iterations to run. */
+  uint64_t iterations;
+  /** The benchmark body. */
+  BenchmarkFunction function;
+};
+
+/** Retrieve the list of registered benchmarks. */
+std::vector<registeredBenchmark>& getBenchmarks() {
+  static std::vector<registeredBenchmark> benchmarks;
+  return benchmarks;
+}
+
+bool registerBenchmark(const std::string& name, uint64_t iterations,
+                       BenchmarkFunction function) {
+  getBenchmarks().push_back({name, iterations, function});
+  return true;
+}
+
+}  // namespace benchmark
+}  // namespace simeng
+
+/** Run all registered microbenchmarks whose name contains the optional first
+ * argument, reporting the host time taken per iteration. An optional second
+ * argument scales the number of iterations run. */
+int main(int argc, char** argv) {
+  using namespace simeng::benchmark;
+  std::string filter = argc > 1 ? argv[1] : "";
+  double scale = argc > 2 ? std::stod(argv[2]) : 1.0;
+
+  for (const auto& benchmark : getBenchmarks()) {
+    if (benchmark.name.find(filter) == std::string::npos) continue;
+
+    uint64_t iterations =
+        std::max<uint64_t>(1, static_cast<uint64_t>(benchmark.iterations *
+                                                    scale));
+    auto start = std::chrono::steady_clock::now();
+    benchmark.function(iterations);
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << std::left << std::setw(40) << benchmark.name << std::right
+              << std::setw(12) << iterations << " iterations"
+              << std::setw(12) << std::fixed << std::setprecision(2)
+              << ns / iterations << " ns/iteration" << std::endl;
+  }
+  return 0;
+}
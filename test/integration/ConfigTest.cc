@@ -42,27 +42,42 @@ TEST(ConfigTest, Default) {
       "Core:\n  ISA: AArch64\n  'Simulation-Mode': emulation\n  "
       "'Clock-Frequency-GHz': 1\n  'Timer-Frequency-MHz': 100\n  "
       "'Micro-Operations': 0\n  'Vector-Length': 128\n  "
-      "'Streaming-Vector-Length': 128\nFetch:\n  'Fetch-Block-Size': 32\n  "
+      "'Streaming-Vector-Length': 128\n  'Branch-Trace-File': ''\n  "
+      "'Profile-File': ''\n  'Top-Down-File': ''\nFetch:\n  "
+      "'Fetch-Block-Size': 32\n  "
       "'Loop-Buffer-Size': 32\n  'Loop-Detection-Threshold': "
-      "5\n'Process-Image':\n  'Heap-Size': 100000\n  'Stack-Size': "
-      "100000\n'Register-Set':\n  'GeneralPurpose-Count': 38\n  "
+      "5\n  'Micro-Op-Cache-Capacity': 0\n  'Micro-Op-Cache-Associativity': "
+      "8\n  'Micro-Op-Cache-Line-Size': 6\n  'Fetch-Target-Queue-Size': "
+      "0\n'Process-Image':\n  'Heap-Size': "
+      "100000\n  'Stack-Size': "
+      "100000\n  'OpenMP-Threads': 1\n  'Input-Overlay-Dir': ''\n"
+      "'Register-Set':\n  "
+      "'GeneralPurpose-Count': 38\n  "
       "'FloatingPoint/SVE-Count': 38\n  'Predicate-Count': 17\n  "
       "'Conditional-Count': 1\n  'Matrix-Count': 1\n'Pipeline-Widths':\n  "
       "Commit: 1\n  FrontEnd: 1\n  'LSQ-Completion': 1\n'Queue-Sizes':\n  ROB: "
-      "32\n  Load: 16\n  Store: 16\n'Branch-Predictor':\n  Type: Perceptron\n  "
-      "'BTB-Tag-Bits': 8\n  'Global-History-Length': 8\n  'RAS-entries': "
-      "8\n'L1-Data-Memory':\n  'Interface-Type': "
+      "32\n  Load: 16\n  Store: 16\n  'Store-Set-ID-Table': 0\n  "
+      "'Last-Fetched-Store-Table': 128\n'Branch-Predictor':\n  Type: "
+      "Perceptron\n  'BTB-Tag-Bits': 8\n  'Global-History-Length': 8\n  "
+      "'RAS-entries': 8\n  'Indirect-Table-Count': 0\n  "
+      "'Indirect-Table-Index-Bits': 9\n  'Indirect-Table-Tag-Bits': 9\n  "
+      "'Indirect-History-Length': 16\n'L1-Data-Memory':\n  'Interface-Type': "
       "Flat\n'L1-Instruction-Memory':\n  'Interface-Type': "
       "Flat\n'LSQ-L1-Interface':\n  'Access-Latency': 4\n  Exclusive: 0\n  "
       "'Load-Bandwidth': 32\n  'Store-Bandwidth': 32\n  "
       "'Permitted-Requests-Per-Cycle': 1\n  'Permitted-Loads-Per-Cycle': 1\n  "
-      "'Permitted-Stores-Per-Cycle': 1\nPorts:\n  0:\n    Portname: 0\n    "
+      "'Permitted-Stores-Per-Cycle': 1\n  'Cache-Line-Width': 64\n  "
+      "'Coalesce-Requests': 0\n  'Forwarding-Latency': 4\nPorts:\n  0:\n    "
+      "Portname: 0\n    "
       "'Instruction-Group-Support':\n      - ALL\n    "
       "'Instruction-Opcode-Support':\n      - 6343\n    "
       "'Instruction-Group-Support-Nums':\n      - "
       "86\n'Reservation-Stations':\n  0:\n    Size: 32\n    'Dispatch-Rate': "
       "4\n    Ports:\n      - 0\n    'Port-Nums':\n      - "
-      "0\n'Execution-Units':\n  0:\n    Pipelined: 1\n    'Blocking-Groups':\n "
+      "0\n'Port-Allocator':\n  Type: Balanced\n'Hardware-Threads':\n  Count: "
+      "1\n  'Fetch-Policy': RoundRobin\n  'Commit-Policy': "
+      "RoundRobin\n'Execution-Units':\n  0:\n    "
+      "Pipelined: 1\n    'Blocking-Groups':\n "
       "     - NONE\n    'Blocking-Group-Nums':\n      - 87\nLatencies:\n  0:\n "
       "   'Instruction-Groups':\n      - NONE\n    'Instruction-Opcodes':\n    "
       "  - 6343\n    'Execution-Latency': 1\n    'Execution-Throughput': 1\n   "
@@ -97,26 +112,41 @@ TEST(ConfigTest, Default) {
   expectedValues =
       "Core:\n  ISA: rv64\n  Compressed: 0\n  'Simulation-Mode': emulation\n  "
       "'Clock-Frequency-GHz': 1\n  'Timer-Frequency-MHz': 100\n  "
-      "'Micro-Operations': 0\nFetch:\n  'Fetch-Block-Size': 32\n  "
+      "'Micro-Operations': 0\n  'Branch-Trace-File': ''\n  "
+      "'Profile-File': ''\n  'Top-Down-File': ''\nFetch:\n  "
+      "'Fetch-Block-Size': 32\n  "
       "'Loop-Buffer-Size': 32\n  'Loop-Detection-Threshold': "
-      "5\n'Process-Image':\n  'Heap-Size': 100000\n  'Stack-Size': "
-      "100000\n'Register-Set':\n  'GeneralPurpose-Count': 38\n  "
+      "5\n  'Micro-Op-Cache-Capacity': 0\n  'Micro-Op-Cache-Associativity': "
+      "8\n  'Micro-Op-Cache-Line-Size': 6\n  'Fetch-Target-Queue-Size': "
+      "0\n'Process-Image':\n  'Heap-Size': "
+      "100000\n  'Stack-Size': "
+      "100000\n  'OpenMP-Threads': 1\n  'Input-Overlay-Dir': ''\n"
+      "'Register-Set':\n  "
+      "'GeneralPurpose-Count': 38\n  "
       "'FloatingPoint-Count': 38\n'Pipeline-Widths':\n  Commit: 1\n  FrontEnd: "
       "1\n  'LSQ-Completion': 1\n'Queue-Sizes':\n  ROB: 32\n  Load: 16\n  "
-      "Store: 16\n'Branch-Predictor':\n  Type: Perceptron\n  'BTB-Tag-Bits': "
+      "Store: 16\n  'Store-Set-ID-Table': 0\n  'Last-Fetched-Store-Table': "
+      "128\n'Branch-Predictor':\n  Type: Perceptron\n  'BTB-Tag-Bits': "
       "8\n  'Global-History-Length': 8\n  'RAS-entries': "
-      "8\n'L1-Data-Memory':\n  'Interface-Type': "
+      "8\n  'Indirect-Table-Count': 0\n  'Indirect-Table-Index-Bits': 9\n  "
+      "'Indirect-Table-Tag-Bits': 9\n  'Indirect-History-Length': "
+      "16\n'L1-Data-Memory':\n  'Interface-Type': "
       "Flat\n'L1-Instruction-Memory':\n  'Interface-Type': "
       "Flat\n'LSQ-L1-Interface':\n  'Access-Latency': 4\n  Exclusive: 0\n  "
       "'Load-Bandwidth': 32\n  'Store-Bandwidth': 32\n  "
       "'Permitted-Requests-Per-Cycle': 1\n  'Permitted-Loads-Per-Cycle': 1\n  "
-      "'Permitted-Stores-Per-Cycle': 1\nPorts:\n  0:\n    Portname: 0\n    "
+      "'Permitted-Stores-Per-Cycle': 1\n  'Cache-Line-Width': 64\n  "
+      "'Coalesce-Requests': 0\n  'Forwarding-Latency': 4\nPorts:\n  0:\n    "
+      "Portname: 0\n    "
       "'Instruction-Group-Support':\n      - ALL\n    "
       "'Instruction-Opcode-Support':\n      - 450\n    "
       "'Instruction-Group-Support-Nums':\n      - "
       "23\n'Reservation-Stations':\n  0:\n    Size: 32\n    'Dispatch-Rate': "
       "4\n    Ports:\n      - 0\n    'Port-Nums':\n      - "
-      "0\n'Execution-Units':\n  0:\n    Pipelined: 1\n    'Blocking-Groups':\n "
+      "0\n'Port-Allocator':\n  Type: Balanced\n'Hardware-Threads':\n  Count: "
+      "1\n  'Fetch-Policy': RoundRobin\n  'Commit-Policy': "
+      "RoundRobin\n'Execution-Units':\n  0:\n    "
+      "Pipelined: 1\n    'Blocking-Groups':\n "
       "     - NONE\n    'Blocking-Group-Nums':\n      - 24\nLatencies:\n  0:\n "
       "   'Instruction-Groups':\n      - NONE\n    'Instruction-Opcodes':\n    "
       "  - 450\n    'Execution-Latency': 1\n    'Execution-Throughput': 1\n    "
@@ -169,6 +199,24 @@ TEST(ConfigTest, AddConfigValues) {
   EXPECT_EQ(config["Execution-Units"].num_children(), 2);
 }
 
+// Test that the groups of macro-op fusion rules are expanded to include the
+// groups which inherit from them
+TEST(ConfigTest, MacroOpFusion) {
+  simeng::config::SimInfo::addToConfig(
+      "{Macro-Op-Fusion: {0: {First-Instruction-Groups: [INT_SIMPLE_ARTH], "
+      "Second-Instruction-Groups: [BRANCH]}}}");
+
+  ryml::ConstNodeRef rule =
+      simeng::config::SimInfo::getConfig()["Macro-Op-Fusion"][0];
+  ASSERT_EQ(rule["First-Instruction-Group-Nums"].num_children(), 2);
+  EXPECT_EQ(rule["First-Instruction-Group-Nums"][0].as<uint16_t>(), 2);
+  EXPECT_EQ(rule["First-Instruction-Group-Nums"][1].as<uint16_t>(), 3);
+  ASSERT_EQ(rule["Second-Instruction-Group-Nums"].num_children(), 1);
+  EXPECT_EQ(rule["Second-Instruction-Group-Nums"][0].as<uint16_t>(), 71);
+  EXPECT_EQ(rule["Shared-Destination"].as<bool>(), false);
+  EXPECT_EQ(rule["Execution-Latency"].as<uint16_t>(), 0);
+}
+
 // Test that adding an invalid entry fails the config validation
 TEST(ConfigTest, FailedExpectation) {
   simeng::config::SimInfo::generateDefault(simeng::config::ISA::AArch64, true);
@@ -215,6 +263,21 @@ TEST(ConfigTest, FailedExpectation) {
             ": False}}}");
       },
       "- Port 1 has no associated reservation station");
+  ASSERT_DEATH(
+      {
+        simeng::config::SimInfo::addToConfig(
+            "{Port-Allocator: {Type: Table, Rules: {0: {Ports: ['0'], Cases: "
+            "{0: {Table: {0: {Stations: [1]}}}}}}}}");
+      },
+      "- Port-Allocator:Rules:0 has a table entry with reservation station 1 "
+      "which holds none of the rule's ports");
+  ASSERT_DEATH(
+      {
+        simeng::config::SimInfo::addToConfig(
+            "{Core: {Simulation-Mode: inorder}, Hardware-Threads: {Count: 2}}");
+      },
+      "- Only the outoforder Simulation-Mode supports more than one hardware "
+      "thread");
 }
 
 // Test that ExpectationNode validation checks work as expected
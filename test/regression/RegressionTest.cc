@@ -1,7 +1,9 @@
 #include "RegressionTest.hh"
 
+#include <cstring>
 #include <string>
 
+#include "simeng/SpecialFileDirGen.hh"
 #include "simeng/branchpredictors/GenericPredictor.hh"
 #include "simeng/branchpredictors/PerceptronPredictor.hh"
 #include "simeng/config/SimInfo.hh"
@@ -67,30 +69,40 @@ void RegressionTest::createArchitecture(const char* source, const char* triple,
 
   ASSERT_TRUE(process_ != nullptr);
 
-  // Create the OS kernel and the process
+  // Create the OS kernel and the process, serving the generated special files
+  // from memory
+  auto fileSystem = std::make_shared<simeng::kernel::VirtualFileSystem>();
+  simeng::SpecialFileDirGen().GenerateSFDir(*fileSystem);
   kernel_ = std::make_unique<simeng::kernel::Linux>(
       simeng::config::SimInfo::getConfig()["CPU-Info"]["Special-File-Dir-Path"]
-          .as<std::string>());
+          .as<std::string>(),
+      fileSystem);
   kernel_->createProcess(*process_);
 
   // Create the architecture
   architecture_ = instantiateArchitecture(*kernel_);
 }
 
-void RegressionTest::createCore(const char* source, const char* triple,
-                                const char* extensions) {
-  // Create the architecture, kernel and process
-  createArchitecture(source, triple, extensions);
-
-  // Create a branch predictor for a pipelined core
+std::unique_ptr<simeng::BranchPredictor>
+RegressionTest::createBranchPredictor() const {
   std::string predictorType =
       simeng::config::SimInfo::getConfig()["Branch-Predictor"]["Type"]
           .as<std::string>();
   if (predictorType == "Generic") {
-    predictor_ = std::make_unique<simeng::GenericPredictor>();
+    return std::make_unique<simeng::GenericPredictor>();
   } else if (predictorType == "Perceptron") {
-    predictor_ = std::make_unique<simeng::PerceptronPredictor>();
+    return std::make_unique<simeng::PerceptronPredictor>();
   }
+  return nullptr;
+}
+
+void RegressionTest::createCore(const char* source, const char* triple,
+                                const char* extensions) {
+  // Create the architecture, kernel and process
+  createArchitecture(source, triple, extensions);
+
+  // Create a branch predictor for a pipelined core
+  predictor_ = createBranchPredictor();
 
   // Create memory interfaces for instruction and data access.
   // For each memory interface, a dereferenced shared_ptr to the
@@ -156,6 +168,130 @@ void RegressionTest::run(const char* source, const char* triple,
   programFinished_ = true;
 }
 
+void RegressionTest::runLockstep(const char* source, const char* triple,
+                                 const char* extensions) {
+  testing::internal::CaptureStdout();
+
+  // Create the core, memory interfaces, kernel and process
+  createCore(source, triple, extensions);
+  if (HasFatalFailure()) return;
+  ASSERT_EQ(std::get<0>(GetParam()), OUTOFORDER)
+      << "Lockstep runs require an out-of-order core.";
+
+  // Create a reference core, which ticks every unit and buffer each cycle,
+  // operating on a copy of the process memory
+  std::vector<char> referenceMemory(processMemory_,
+                                    processMemory_ + processMemorySize_);
+  simeng::memory::FlatMemoryInterface referenceInstructionMemory(
+      referenceMemory.data(), processMemorySize_);
+  simeng::memory::FixedLatencyMemoryInterface referenceDataMemory(
+      referenceMemory.data(), processMemorySize_, 4);
+  auto referencePredictor = createBranchPredictor();
+  auto referencePortAllocator = createPortAllocator();
+  simeng::models::outoforder::Core referenceCore(
+      referenceInstructionMemory, referenceDataMemory, processMemorySize_,
+      entryPoint_, *architecture_, *referencePredictor,
+      *referencePortAllocator);
+  referenceCore.setActivityTracking(false);
+
+  // Run both cores until the program is complete, checking they don't diverge
+  while (!core_->hasHalted() || dataMemory_->hasPendingRequests()) {
+    ASSERT_LT(numTicks_, maxTicks_) << "Maximum tick count exceeded.";
+    core_->tick();
+    instructionMemory_->tick();
+    dataMemory_->tick();
+    referenceCore.tick();
+    referenceInstructionMemory.tick();
+    referenceDataMemory.tick();
+    numTicks_++;
+
+    ASSERT_EQ(core_->getStats(), referenceCore.getStats())
+        << "Cores diverged on cycle " << numTicks_ << ".";
+    ASSERT_EQ(core_->hasHalted(), referenceCore.hasHalted())
+        << "Cores diverged on cycle " << numTicks_ << ".";
+  }
+  EXPECT_EQ(std::memcmp(processMemory_, referenceMemory.data(),
+                        processMemorySize_),
+            0)
+      << "Process memory diverged.";
+
+  stdout_ = testing::internal::GetCapturedStdout();
+  std::cout << stdout_;
+
+  programFinished_ = true;
+}
+
+void RegressionTest::runHardwareThreads(const char* source,
+                                        const char* triple,
+                                        const char* extensions) {
+  testing::internal::CaptureStdout();
+
+  // Create the first thread's core, memory interfaces, kernel and process
+  createCore(source, triple, extensions);
+  if (HasFatalFailure()) return;
+  ASSERT_EQ(std::get<0>(GetParam()), OUTOFORDER)
+      << "Hardware threads require an out-of-order core.";
+
+  ryml::ConstNodeRef config = simeng::config::SimInfo::getConfig();
+  uint16_t threadCount = config["Hardware-Threads"]["Count"].as<uint16_t>();
+
+  // Give every other thread its own kernel, process, and memory interfaces
+  hardwareThreads_.clear();
+  for (uint16_t id = 1; id < threadCount; id++) {
+    HardwareThread thread;
+    auto fileSystem = std::make_shared<simeng::kernel::VirtualFileSystem>();
+    simeng::SpecialFileDirGen().GenerateSFDir(*fileSystem);
+    thread.kernel = std::make_unique<simeng::kernel::Linux>(
+        config["CPU-Info"]["Special-File-Dir-Path"].as<std::string>(),
+        fileSystem);
+    thread.process = std::make_unique<simeng::kernel::LinuxProcess>(
+        simeng::span(reinterpret_cast<const uint8_t*>(code_), codeSize_));
+    ASSERT_TRUE(thread.process->isValid());
+    thread.kernel->createProcess(*thread.process);
+    thread.architecture = instantiateArchitecture(*thread.kernel);
+    thread.predictor = createBranchPredictor();
+
+    char* memory = thread.process->getProcessImage().get();
+    uint64_t size = thread.process->getProcessImageSize();
+    thread.instructionMemory =
+        std::make_unique<simeng::memory::FlatMemoryInterface>(memory, size);
+    thread.dataMemory =
+        std::make_unique<simeng::memory::FixedLatencyMemoryInterface>(
+            memory, size, 4);
+    hardwareThreads_.push_back(std::move(thread));
+  }
+
+  // Replace the single-threaded core with one running every thread
+  core_.reset();
+  portAllocator_ = createPortAllocator();
+  std::vector<simeng::models::outoforder::Core::ThreadContext> threads = {
+      {*instructionMemory_, *dataMemory_, processMemorySize_, entryPoint_,
+       *architecture_, *predictor_}};
+  for (const auto& thread : hardwareThreads_) {
+    threads.push_back({*thread.instructionMemory, *thread.dataMemory,
+                       thread.process->getProcessImageSize(),
+                       thread.process->getEntryPoint(), *thread.architecture,
+                       *thread.predictor});
+  }
+  core_ = std::make_unique<simeng::models::outoforder::Core>(threads,
+                                                              *portAllocator_);
+
+  // Run the core model until every thread's program is complete. The core
+  // ticks the memory interfaces of all but the first thread
+  while (!core_->hasHalted() || dataMemory_->hasPendingRequests()) {
+    ASSERT_LT(numTicks_, maxTicks_) << "Maximum tick count exceeded.";
+    core_->tick();
+    instructionMemory_->tick();
+    dataMemory_->tick();
+    numTicks_++;
+  }
+
+  stdout_ = testing::internal::GetCapturedStdout();
+  std::cout << stdout_;
+
+  programFinished_ = true;
+}
+
 void RegressionTest::checkGroup(const char* source, const char* triple,
                                 const char* extensions,
                                 const std::vector<uint16_t>& expectedGroups) {
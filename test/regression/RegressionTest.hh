@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -89,6 +90,19 @@ class RegressionTest
    * extensions. */
   void run(const char* source, const char* triple, const char* extensions);
 
+  /** Run the assembly in `source` on two out-of-order cores in lockstep, one
+   * of which ticks every unit and buffer every cycle, and check that their
+   * state matches after each cycle. */
+  void runLockstep(const char* source, const char* triple,
+                   const char* extensions);
+
+  /** Run the assembly in `source` on an out-of-order core simulating the
+   * number of hardware threads given by the Hardware-Threads:Count config
+   * option, each running its own copy of the program in its own process
+   * memory. */
+  void runHardwareThreads(const char* source, const char* triple,
+                          const char* extensions);
+
   /** Predecode the first instruction in source and check the assigned group
    * matches the expectation. */
   void checkGroup(const char* source, const char* triple,
@@ -107,6 +121,11 @@ class RegressionTest
     return core_->getArchitecturalRegisterFileSet().get(reg).getAsVector<T>();
   }
 
+  /** Get the statistics reported by the core. */
+  std::map<std::string, std::string> getStats() const {
+    return core_->getStats();
+  }
+
   /** Get a value from process memory at `address`. */
   template <typename T>
   T getMemoryValue(uint64_t address) const {
@@ -116,6 +135,18 @@ class RegressionTest
     return dest;
   }
 
+  /** Get a value at `address` from the process memory of hardware thread
+   * `id`, as run by `runHardwareThreads`. */
+  template <typename T>
+  T getThreadMemoryValue(uint16_t id, uint64_t address) const {
+    if (id == 0) return getMemoryValue<T>(address);
+    const auto& process = *hardwareThreads_.at(id - 1).process;
+    EXPECT_LE(address + sizeof(T), process.getProcessImageSize());
+    T dest{};
+    std::memcpy(&dest, process.getProcessImage().get() + address, sizeof(T));
+    return dest;
+  }
+
   /** The initial data to populate the heap with. */
   std::vector<uint8_t> initialHeapData_;
 
@@ -141,10 +172,24 @@ class RegressionTest
   std::unique_ptr<simeng::arch::Architecture> architecture_ = nullptr;
 
  private:
+  /** The state of a hardware thread other than the first, run by
+   * `runHardwareThreads`. */
+  struct HardwareThread {
+    std::unique_ptr<simeng::kernel::Linux> kernel;
+    std::unique_ptr<simeng::kernel::LinuxProcess> process;
+    std::unique_ptr<simeng::arch::Architecture> architecture;
+    std::unique_ptr<simeng::BranchPredictor> predictor;
+    std::unique_ptr<simeng::memory::MemoryInterface> instructionMemory;
+    std::unique_ptr<simeng::memory::MemoryInterface> dataMemory;
+  };
+
   /** Assemble test source to a flat binary for the given triple and ISA
    * extensions. */
   void assemble(const char* source, const char* triple, const char* extensions);
 
+  /** Create the branch predictor specified by the config. */
+  std::unique_ptr<simeng::BranchPredictor> createBranchPredictor() const;
+
   /** Instantiate the core according to the config. */
   void createCore(const char* source, const char* triple,
                   const char* extensions);
@@ -170,6 +215,9 @@ class RegressionTest
   /** Pointer to be instantiated for the instruction memory interface. */
   std::unique_ptr<simeng::memory::MemoryInterface> instructionMemory_ = nullptr;
 
+  /** The hardware threads beyond the first, run by `runHardwareThreads`. */
+  std::vector<HardwareThread> hardwareThreads_;
+
   /** Pointer to be instantiated for the core. */
   std::unique_ptr<simeng::Core> core_ = nullptr;
 
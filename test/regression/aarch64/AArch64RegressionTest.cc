@@ -12,6 +12,21 @@ void AArch64RegressionTest::run(const char* source) {
   RegressionTest::run(source, "aarch64", subtargetFeatures.c_str());
 }
 
+void AArch64RegressionTest::runLockstep(const char* source) {
+  initialiseLLVM();
+  std::string subtargetFeatures = getSubtargetFeaturesString();
+
+  RegressionTest::runLockstep(source, "aarch64", subtargetFeatures.c_str());
+}
+
+void AArch64RegressionTest::runHardwareThreads(const char* source) {
+  initialiseLLVM();
+  std::string subtargetFeatures = getSubtargetFeaturesString();
+
+  RegressionTest::runHardwareThreads(source, "aarch64",
+                                     subtargetFeatures.c_str());
+}
+
 void AArch64RegressionTest::checkGroup(
     const char* source, const std::vector<uint16_t>& expectedGroups) {
   initialiseLLVM();
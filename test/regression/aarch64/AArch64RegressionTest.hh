@@ -113,6 +113,31 @@ inline std::vector<std::tuple<CoreType, std::string>> genCoreTypeSVLPairs(
   }                                            \
   if (HasFatalFailure()) return
 
+/** A helper macro to run a snippet of Armv9.2-a assembly code on two
+ * out-of-order cores in lockstep, returning from the calling function if a
+ * fatal error occurs. One core only ticks its active units and buffers, and the
+ * other ticks all of them every cycle. As with `RUN_AARCH64`, four bytes
+ * containing zeros are appended to the source to terminate the program. */
+#define RUN_AARCH64_LOCKSTEP(source)           \
+  {                                            \
+    std::string sourceWithTerminator = source; \
+    sourceWithTerminator += "\n.word 0";       \
+    runLockstep(sourceWithTerminator.c_str()); \
+  }                                            \
+  if (HasFatalFailure()) return
+
+/** A helper macro to run a snippet of Armv9.2-a assembly code on every
+ * hardware thread of an out-of-order core, returning from the calling function
+ * if a fatal error occurs. As with `RUN_AARCH64`, four bytes containing zeros
+ * are appended to the source to terminate each thread's program. */
+#define RUN_AARCH64_HARDWARE_THREADS(source)          \
+  {                                                   \
+    std::string sourceWithTerminator = source;        \
+    sourceWithTerminator += "\n.word 0";              \
+    runHardwareThreads(sourceWithTerminator.c_str()); \
+  }                                                   \
+  if (HasFatalFailure()) return
+
 /** Check each element of a Neon register against expected values.
  *
  * The `tag` argument is the register index, and the `type` argument is the C++
@@ -212,6 +237,14 @@ class AArch64RegressionTest : public RegressionTest {
   /** Run the assembly code in `source`. */
   void run(const char* source);
 
+  /** Run the assembly code in `source` on two out-of-order cores in lockstep.
+   */
+  void runLockstep(const char* source);
+
+  /** Run the assembly code in `source` on each hardware thread of an
+   * out-of-order core. */
+  void runHardwareThreads(const char* source);
+
   /** Run the first instruction in source through predecode and check the
    * groups. */
   void checkGroup(const char* source,
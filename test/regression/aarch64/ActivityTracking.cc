@@ -0,0 +1,86 @@
+#include "AArch64RegressionTest.hh"
+
+namespace {
+
+using ActivityTracking = AArch64RegressionTest;
+
+// Test that skipping idle units and buffers doesn't alter execution across
+// frequent branch mispredictions and stalling, unpipelined execution units.
+TEST_P(ActivityTracking, BranchMispredictions) {
+  RUN_AARCH64_LOCKSTEP(R"(
+    sub sp, sp, #64
+    str xzr, [sp]
+    mov x0, #0
+    mov x1, #0
+    mov x2, #1000
+    mov x4, #7
+
+  loop:
+    # Conditionally update the stored accumulator in an irregular pattern
+    mul x3, x0, x4
+    and x3, x3, #6
+    cmp x3, #4
+    b.lt skip
+    add x1, x1, x0
+    str x1, [sp]
+  skip:
+    ldr x5, [sp]
+    udiv x6, x5, x4
+    add x1, x1, x6
+    add x0, x0, #1
+    cmp x0, x2
+    b.ne loop
+  )");
+
+  uint64_t accumulator = 0;
+  uint64_t stored = 0;
+  for (uint64_t i = 0; i < 1000; i++) {
+    if (((i * 7) & 6) >= 4) {
+      accumulator += i;
+      stored = accumulator;
+    }
+    accumulator += stored / 7;
+  }
+  EXPECT_EQ(getGeneralRegister<uint64_t>(0), 1000u);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(1), accumulator);
+}
+
+// Test that skipping idle units and buffers doesn't alter execution across
+// repeated memory order violations.
+TEST_P(ActivityTracking, MemoryOrderViolations) {
+  RUN_AARCH64_LOCKSTEP(R"(
+    sub sp, sp, #64
+    mov x6, sp
+    mov x0, #0
+    mov x1, #100
+    mov x4, #1
+    mov x8, #0
+
+  loop:
+    # Delay generation of the store address so the load executes first
+    udiv x2, x6, x4
+    str x0, [x2]
+    ldr x3, [x6]
+    add x8, x8, x3
+    add x0, x0, #1
+    cmp x0, x1
+    b.ne loop
+  )");
+  EXPECT_EQ(getGeneralRegister<uint64_t>(0), 100u);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(8), 4950u);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AArch64, ActivityTracking,
+    ::testing::Values(std::make_tuple(
+        OUTOFORDER,
+        "{Ports: {'1': {Portname: 1, Instruction-Group-Support: "
+        "[INT_DIV_OR_SQRT]}}, Reservation-Stations: {'1': {Size: 8, "
+        "Dispatch-Rate: 1, Ports: [1]}}, Execution-Units: {'1': {Pipelined: "
+        "False}}, Latencies: {'0': {Instruction-Groups: [INT_DIV_OR_SQRT], "
+        "Execution-Latency: 12, Execution-Throughput: 12}, '1': "
+        "{Instruction-Groups: [INT_MUL], Execution-Latency: 4, "
+        "Execution-Throughput: 1}}}")),
+    paramToString);
+
+}  // namespace
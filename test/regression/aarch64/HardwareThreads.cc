@@ -0,0 +1,87 @@
+#include "AArch64RegressionTest.hh"
+
+namespace {
+
+using HardwareThreads = AArch64RegressionTest;
+
+/** Name each instantiation after its fetch and commit policies. */
+std::string policiesToString(
+    const testing::TestParamInfo<std::tuple<CoreType, std::string>> val) {
+  ryml::Tree tree =
+      ryml::parse_in_arena(ryml::to_csubstr(std::get<1>(val.param)));
+  return tree["Hardware-Threads"]["Fetch-Policy"].as<std::string>() +
+         "Fetch" +
+         tree["Hardware-Threads"]["Commit-Policy"].as<std::string>() +
+         "Commit";
+}
+
+// Test that two hardware threads each run their own copy of a program to
+// completion, hiding each other's latency under every fetch and commit policy
+TEST_P(HardwareThreads, IndependentPrograms) {
+  const char* source = R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x4, x0
+
+    # Form a chain of dependent, long-latency multiplications
+    mov x1, #1
+    mov x2, #0
+    mov x3, #3
+  loop:
+    mul x1, x1, x3
+    add x2, x2, #1
+    cmp x2, #200
+    b.ne loop
+    str x1, [x4]
+    str x2, [x4, #8]
+  )";
+
+  uint64_t power = 1;
+  for (int i = 0; i < 200; i++) power *= 3;
+
+  RUN_AARCH64(source);
+  uint64_t singleThreadTicks = numTicks_;
+  numTicks_ = 0;
+
+  RUN_AARCH64_HARDWARE_THREADS(source);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(1), power);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(2), 200u);
+  for (uint16_t id = 0; id < 2; id++) {
+    uint64_t heapStart = process_->getHeapStart();
+    EXPECT_EQ(getThreadMemoryValue<uint64_t>(id, heapStart), power)
+        << "Thread " << id;
+    EXPECT_EQ(getThreadMemoryValue<uint64_t>(id, heapStart + 8), 200u)
+        << "Thread " << id;
+  }
+
+  // Each thread retires the same instructions, and the threads' progress is
+  // interleaved rather than serialised
+  auto stats = getStats();
+  EXPECT_EQ(stats["thread.0.retired"], stats["thread.1.retired"]);
+  EXPECT_NE(stats["thread.0.retired"], "0");
+  EXPECT_LT(numTicks_, singleThreadTicks * 3 / 2);
+}
+
+/** Generate a two-thread configuration for each fetch and commit policy. */
+std::vector<std::tuple<CoreType, std::string>> genPolicyPairs() {
+  std::vector<std::tuple<CoreType, std::string>> pairs;
+  for (const char* fetch : {"RoundRobin", "ICount"}) {
+    for (const char* commit : {"RoundRobin", "Shared"}) {
+      pairs.push_back(std::make_tuple(
+          OUTOFORDER,
+          std::string("{Hardware-Threads: {Count: 2, Fetch-Policy: ") + fetch +
+              ", Commit-Policy: " + commit +
+              "}, Latencies: {'0': {Instruction-Groups: [INT_MUL], "
+              "Execution-Latency: 8, Execution-Throughput: 1}}}"));
+    }
+  }
+  return pairs;
+}
+
+INSTANTIATE_TEST_SUITE_P(AArch64, HardwareThreads,
+                         ::testing::ValuesIn(genPolicyPairs()),
+                         policiesToString);
+
+}  // namespace
@@ -1158,4 +1158,34 @@ INSTANTIATE_TEST_SUITE_P(
                         "{Interface-Type: Fixed}}")),
     paramToString);
 
+using MacroOpFusion = AArch64RegressionTest;
+
+// Test that, of the pairs the rules match, only the AArch64 fusion idioms are
+// fused, and that the register written by both halves holds the second's result
+TEST_P(MacroOpFusion, idioms) {
+  RUN_AARCH64(R"(
+    movz x0, #1
+    movk x0, #2, lsl #16
+    add x1, x0, #1
+    add x1, x1, #1
+    cmp x1, #0
+    b.ne #8
+    mov x2, #5
+    mov x3, #7
+  )");
+  EXPECT_EQ(getStats()["decode.fused"], "2");
+  EXPECT_EQ(getGeneralRegister<uint64_t>(0), 0x20001);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(1), 0x20003);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(2), 0);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(3), 7);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AArch64, MacroOpFusion,
+    ::testing::Values(std::make_tuple(
+        OUTOFORDER,
+        "{Macro-Op-Fusion: {'0': {First-Instruction-Groups: [INT], "
+        "Second-Instruction-Groups: [INT, BRANCH]}}}")),
+    paramToString);
+
 }  // namespace
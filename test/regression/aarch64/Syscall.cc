@@ -1,11 +1,14 @@
+#include <dirent.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <cstring>
 #include <fstream>
+#include <iterator>
 #include <string>
 
 #include "AArch64RegressionTest.hh"
@@ -591,6 +594,135 @@ TEST_P(Syscall, filenotfound) {
   EXPECT_EQ(getGeneralRegister<int64_t>(0), -1);
 }
 
+// Tests that the generated special files are served from memory by the openat,
+// read, lseek, fstat, getdents64 and close syscalls
+TEST_P(Syscall, special_files) {
+  const char onlinePath[] = "/sys/devices/system/cpu/online";
+  const char cpuPath[] = "/sys/devices/system/cpu";
+
+  // Reserve 64 bytes for file contents, 256 bytes for directory entries, and
+  // 128 bytes for file status
+  initialHeapData_.resize(640);
+  memcpy(initialHeapData_.data() + 512, onlinePath, strlen(onlinePath) + 1);
+  memcpy(initialHeapData_.data() + 576, cpuPath, strlen(cpuPath) + 1);
+
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # openat(AT_FDCWD, onlinePath, O_WRONLY, 0)
+    mov x0, -100
+    add x1, x20, #512
+    mov x2, #1
+    mov x3, #0
+    mov x8, #56
+    svc #0
+    mov x21, x0
+
+    # <online> = openat(AT_FDCWD, onlinePath, O_RDONLY, 0)
+    mov x0, -100
+    add x1, x20, #512
+    mov x2, #0
+    mov x3, #0
+    mov x8, #56
+    svc #0
+    mov x22, x0
+
+    # read(fd=<online>, buf=x20, count=64)
+    mov x0, x22
+    mov x1, x20
+    mov x2, #64
+    mov x8, #63
+    svc #0
+    mov x23, x0
+
+    # lseek(fd=<online>, offset=2, whence=SEEK_SET)
+    mov x0, x22
+    mov x1, #2
+    mov x2, #0
+    mov x8, #62
+    svc #0
+    # read(fd=<online>, buf=x20+8, count=64)
+    mov x0, x22
+    add x1, x20, #8
+    mov x2, #64
+    mov x8, #63
+    svc #0
+    mov x24, x0
+
+    # fstat(fd=<online>, statbuf=x20+384)
+    mov x0, x22
+    add x1, x20, #384
+    mov x8, #80
+    svc #0
+    mov x25, x0
+
+    # close(fd=<online>)
+    mov x0, x22
+    mov x8, #57
+    svc #0
+    mov x26, x0
+
+    # <cpu> = openat(AT_FDCWD, cpuPath, O_RDONLY|O_DIRECTORY, 0)
+    mov x0, -100
+    add x1, x20, #576
+    mov x2, #0x10000
+    mov x3, #0
+    mov x8, #56
+    svc #0
+    mov x27, x0
+
+    # getdents64(fd=<cpu>, buf=x20+64, count=256), until the end of the
+    # directory is reached
+    mov x0, x27
+    add x1, x20, #64
+    mov x2, #256
+    mov x8, #61
+    svc #0
+    mov x28, x0
+    mov x0, x27
+    add x1, x20, #64
+    mov x2, #256
+    mov x8, #61
+    svc #0
+    mov x19, x0
+  )");
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), -EACCES);
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), 3);
+  EXPECT_EQ(getGeneralRegister<int64_t>(23), 4);
+  EXPECT_EQ(getGeneralRegister<int64_t>(24), 2);
+  EXPECT_EQ(getGeneralRegister<int64_t>(25), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(26), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(27), 3);
+  EXPECT_EQ(getGeneralRegister<int64_t>(28), 104);
+  EXPECT_EQ(getGeneralRegister<int64_t>(19), 0);
+
+  // File contents
+  const uint64_t heap = process_->getHeapStart();
+  EXPECT_EQ(std::string(processMemory_ + heap, 4), "0-0\n");
+  EXPECT_EQ(std::string(processMemory_ + heap + 8, 2), "0\n");
+
+  // File status
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap + 384 + 16),
+            static_cast<uint32_t>(S_IFREG | 0444));
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 384 + 48), 4);
+
+  // Directory entries, of 24, 24, 24 and 32 bytes
+  const std::vector<std::pair<std::string, uint8_t>> entries = {
+      {".", DT_DIR}, {"..", DT_DIR}, {"cpu0", DT_DIR}, {"online", DT_REG}};
+  uint64_t entry = heap + 64;
+  for (const auto& [name, type] : entries) {
+    uint16_t reclen = getMemoryValue<uint16_t>(entry + 16);
+    EXPECT_EQ(getMemoryValue<uint8_t>(entry + 18), type);
+    EXPECT_EQ(std::string(processMemory_ + entry + 19), name);
+    entry += reclen;
+  }
+  EXPECT_EQ(entry, heap + 64 + 104);
+}
+
 // Test that readlinkat works for supported cases
 TEST_P(Syscall, readlinkat) {
   const char path[] = "/proc/self/exe";
@@ -938,10 +1070,124 @@ TEST_P(Syscall, set_tid_address) {
     svc #0
     mov x21, x0
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(21), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), 100);
+}
+
+TEST_P(Syscall, clone_futex) {
+  // Reserve space for the thread IDs, futex, child results, and child stack
+  initialHeapData_.resize(1024);
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # clone(flags=CLONE_VM|CLONE_FS|CLONE_FILES|CLONE_SIGHAND|CLONE_THREAD|
+    #       CLONE_SYSVSEM|CLONE_SETTLS|CLONE_PARENT_SETTID|
+    #       CLONE_CHILD_CLEARTID|CLONE_CHILD_SETTID, stack=x20+1024,
+    #       ptid=x20, tls=0x1234, ctid=x20+4)
+    movz x0, #0x0f00
+    movk x0, #0x13d, lsl #16
+    add x1, x20, #1024
+    mov x2, x20
+    mov x3, #0x1234
+    add x4, x20, #4
+    mov x8, #220
+    svc #0
+    cbnz x0, parent
+
+    # Child: record the stack pointer, thread pointer, and thread ID
+    mov x9, sp
+    str x9, [x20, #16]
+    mrs x9, TPIDR_EL0
+    str x9, [x20, #24]
+    mov x8, #178
+    svc #0
+    str x0, [x20, #32]
+    # Set the futex, and wake the parent waiting on it
+    mov w9, #1
+    str w9, [x20, #8]
+    # futex(uaddr=x20+8, futex_op=FUTEX_WAKE_PRIVATE, val=1)
+    add x0, x20, #8
+    mov x1, #129
+    mov x2, #1
+    mov x8, #98
+    svc #0
+    str x0, [x20, #40]
+    # sched_yield()
+    mov x8, #124
+    svc #0
+    str x0, [x20, #48]
+    # exit(status=0)
+    mov x0, #0
+    mov x8, #93
+    svc #0
+
+  parent:
+    mov x21, x0
+    # futex(uaddr=x20+8, futex_op=FUTEX_WAIT_PRIVATE, val=0, timeout=NULL)
+    add x0, x20, #8
+    mov x1, #128
+    mov x2, #0
+    mov x3, #0
+    mov x8, #98
+    svc #0
+    mov x22, x0
+
+    # Join the child, waiting until its exit clears its thread ID at x20+4
+  join:
+    ldr w2, [x20, #4]
+    cbz w2, joined
+    # futex(uaddr=x20+4, futex_op=FUTEX_WAIT_PRIVATE, val=w2, timeout=NULL)
+    add x0, x20, #4
+    mov x1, #128
+    mov x3, #0
+    mov x8, #98
+    svc #0
+    b join
+
+  joined:
+    # futex(uaddr=x20+8, futex_op=FUTEX_WAIT_PRIVATE, val=0), with the futex
+    # no longer 0
+    add x0, x20, #8
+    mov x1, #128
+    mov x2, #0
+    mov x3, #0
+    mov x8, #98
+    svc #0
+    mov x23, x0
+    # futex(uaddr=x20+8, futex_op=FUTEX_WAKE_PRIVATE, val=1), with no waiters
+    add x0, x20, #8
+    mov x1, #129
+    mov x2, #1
+    mov x8, #98
+    svc #0
+    mov x24, x0
+    mrs x25, TPIDR_EL0
+    mov x8, #178
+    svc #0
+    mov x26, x0
+  )");
+  const uint64_t heap = process_->getHeapStart();
+  // The parent's view, where the process and its first thread have ID 100
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), 101);
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(23), -EAGAIN);
+  EXPECT_EQ(getGeneralRegister<int64_t>(24), 0);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(25), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(26), 100);
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap), 101);
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap + 4), 0);
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap + 8), 1);
+  // The child's view
+  EXPECT_EQ(getMemoryValue<uint64_t>(heap + 16), heap + 1024);
+  EXPECT_EQ(getMemoryValue<uint64_t>(heap + 24), 0x1234);
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 32), 101);
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 40), 1);
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 48), 0);
 }
 
-// TODO: write futex test
 // TODO: write set_robust_list test
 
 TEST_P(Syscall, clock_gettime) {
@@ -1266,7 +1512,7 @@ TEST_P(Syscall, gettid) {
     mov x8, #178
     svc #0
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(0), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(0), 100);
 }
 
 TEST_P(Syscall, getpid) {
@@ -1275,7 +1521,7 @@ TEST_P(Syscall, getpid) {
     mov x8, #172
     svc #0
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(0), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(0), 100);
 }
 
 TEST_P(Syscall, getuid) {
@@ -1318,16 +1564,67 @@ TEST_P(Syscall, getegid) {
 // TODO: write shutdown test
 
 TEST_P(Syscall, mprotect) {
-  // Check mprotect returns placeholder value as currently not implemented
+  // Check mprotect succeeds for mapped page-aligned memory, including the
+  // untracked process image, and fails for unmapped memory and unaligned
+  // addresses
   RUN_AARCH64(R"(
-    # mprotect(addr=47472, len=4096, prot=1) = 0
-    mov x0, #47472
+    # mprotect(addr=49152, len=4096, prot=1) = -ENOMEM
+    mov x0, #49152
+    mov x1, #4096
+    mov x2, #1
+    mov x8, #226
+    svc #0
+    mov x9, x0
+
+    # mmap(addr=NULL, length=16384, prot=3, flags=34, fd=-1, offset=0)
+    mov x0, #0
+    mov x1, #16384
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x10, x0
+
+    # mprotect(addr=x10+4096, len=4096, prot=1) = 0
+    add x0, x10, #4096
     mov x1, #4096
     mov x2, #1
     mov x8, #226
     svc #0
+    mov x11, x0
+
+    # mprotect(addr=x10+1024, len=4096, prot=1) = -EINVAL
+    add x0, x10, #1024
+    mov x1, #4096
+    mov x2, #1
+    mov x8, #226
+    svc #0
+    mov x12, x0
+
+    # mprotect(addr=x10+8192, len=16384, prot=1) = -ENOMEM
+    add x0, x10, #8192
+    mov x1, #16384
+    mov x2, #1
+    mov x8, #226
+    svc #0
+    mov x13, x0
+
+    # mprotect(addr=0, len=4096, prot=5) = 0
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #5
+    mov x8, #226
+    svc #0
+    mov x14, x0
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(0), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(9), -ENOMEM);
+  EXPECT_EQ(getGeneralRegister<int64_t>(10), process_->getMmapStart());
+  EXPECT_EQ(getGeneralRegister<int64_t>(11), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(12), -EINVAL);
+  EXPECT_EQ(getGeneralRegister<int64_t>(13), -ENOMEM);
+  EXPECT_EQ(getGeneralRegister<int64_t>(14), 0);
 }
 
 // TODO: write mbind test
@@ -1366,7 +1663,8 @@ TEST_P(Syscall, munmap) {
   EXPECT_EQ(getGeneralRegister<int64_t>(10), 0);
   EXPECT_EQ(getGeneralRegister<int64_t>(11), 0);
 
-  // Test that EINVAL error types trigger
+  // Test that unmapping a partially mapped range succeeds, while an
+  // unaligned address gives an error
   RUN_AARCH64(R"(
     # mmap(addr=NULL, length=1024, prot=3, flags=34, fd=-1, offset=0)
     mov x0, #0
@@ -1395,7 +1693,7 @@ TEST_P(Syscall, munmap) {
     mov x11, x0
   )");
   EXPECT_EQ(getGeneralRegister<int64_t>(9), process_->getMmapStart() + 1024);
-  EXPECT_EQ(getGeneralRegister<int64_t>(10), -1);
+  EXPECT_EQ(getGeneralRegister<int64_t>(10), 0);
   EXPECT_EQ(getGeneralRegister<int64_t>(11), -1);
 }
 
@@ -1525,6 +1823,424 @@ TEST_P(Syscall, mmap) {
   EXPECT_EQ(getGeneralRegister<int64_t>(13), process_->getMmapStart() + 20480);
   EXPECT_EQ(getGeneralRegister<int64_t>(14), process_->getMmapStart() + 4096);
   EXPECT_EQ(getGeneralRegister<int64_t>(15), process_->getMmapStart() + 8192);
+
+  // Test for mmap allocations at hint and fixed addresses
+  RUN_AARCH64(R"(
+    # mmap(addr=NULL, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x9, x0
+
+    # Hint at a free address
+    # mmap(addr=x9+65536, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    add x0, x9, #16, lsl #12
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x10, x0
+
+    # Hint at an address already mapped, placing the allocation above it
+    # mmap(addr=x9, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    mov x0, x9
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x11, x0
+
+    # Replace the first allocation
+    # mmap(addr=x9, length=4096, prot=1, flags=50, fd=-1, offset=0)
+    mov x0, x9
+    mov x1, #4096
+    mov x2, #1
+    mov x3, #50
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x12, x0
+  )");
+  EXPECT_EQ(getGeneralRegister<int64_t>(9), process_->getMmapStart());
+  EXPECT_EQ(getGeneralRegister<int64_t>(10), process_->getMmapStart() + 65536);
+  EXPECT_EQ(getGeneralRegister<int64_t>(11), process_->getMmapStart() + 4096);
+  EXPECT_EQ(getGeneralRegister<int64_t>(12), process_->getMmapStart());
+}
+
+TEST_P(Syscall, mmap_zeroed) {
+  const char inputPath[] = SIMENG_AARCH64_TEST_ROOT "/data/input.txt";
+
+  // Copy filepath to heap
+  initialHeapData_.resize(strlen(inputPath) + 1);
+  memcpy(initialHeapData_.data(), inputPath, strlen(inputPath) + 1);
+
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # mmap(addr=NULL, length=12288, prot=3, flags=34, fd=-1, offset=0)
+    mov x0, #0
+    mov x1, #12288
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x9, x0
+
+    # Write to each part of the memory to be reused
+    mov w0, #255
+    strb w0, [x9]
+    mov x1, #4196
+    strb w0, [x9, x1]
+    mov x1, #8192
+    strb w0, [x9, x1]
+
+    # munmap(addr=x9, length=12288)
+    mov x0, x9
+    mov x1, #12288
+    mov x8, #215
+    svc #0
+
+    # mmap(addr=x9, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    mov x0, x9
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x10, x0
+
+    # <input> = openat(AT_FDCWD, inputPath, O_RDONLY, S_IRUSR)
+    mov x0, -100
+    mov x1, x20
+    mov x2, 0x0000
+    mov x3, 400
+    mov x8, #56
+    svc #0
+    mov x21, x0
+
+    # The file ends within the first page of the mapping
+    # mmap(addr=x9+4096, length=8192, prot=1, flags=2, fd=<input>, offset=0)
+    add x0, x9, #4096
+    mov x1, #8192
+    mov x2, #1
+    mov x3, #2
+    mov x4, x21
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x11, x0
+  )");
+  // Memory reused by a new mapping is zeroed, besides the file contents
+  const uint64_t start = process_->getMmapStart();
+  EXPECT_EQ(getGeneralRegister<uint64_t>(10), start);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(11), start + 4096);
+  EXPECT_EQ(getMemoryValue<uint8_t>(start), 0);
+  EXPECT_EQ(getMemoryValue<uint8_t>(start + 4096), 'A');
+  EXPECT_EQ(getMemoryValue<uint8_t>(start + 4196), 0);
+  EXPECT_EQ(getMemoryValue<uint8_t>(start + 8192), 0);
+}
+
+TEST_P(Syscall, file_mmap) {
+  const char str[] = "Hello, World!\n";
+  const char inputPath[] = SIMENG_AARCH64_TEST_ROOT "/data/input.txt";
+  const char sharedPath[] = "./simeng-mmap-test.txt";
+
+  // Create the file to be mapped as shared
+  {
+    std::ofstream sharedFile(sharedPath, std::ios::trunc);
+    sharedFile << str;
+  }
+
+  // Copy filepaths to heap
+  initialHeapData_.resize(strlen(sharedPath) + strlen(inputPath) + 2);
+  memcpy(initialHeapData_.data(), sharedPath, strlen(sharedPath) + 1);
+  memcpy(initialHeapData_.data() + strlen(sharedPath) + 1, inputPath,
+         strlen(inputPath) + 1);
+
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # <input> = openat(AT_FDCWD, inputPath, O_RDONLY, S_IRUSR)
+    mov x0, -100
+    add x1, x20, #23
+    mov x2, 0x0000
+    mov x3, 400
+    mov x8, #56
+    svc #0
+    mov x21, x0
+
+    # mmap(addr=NULL, length=4096, prot=1, flags=2, fd=<input>, offset=0)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #1
+    mov x3, #2
+    mov x4, x21
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x22, x0
+
+    # The mapping remains valid once the file is closed
+    # close(fd=<input>)
+    mov x0, x21
+    mov x8, #57
+    svc #0
+
+    # <shared> = openat(AT_FDCWD, sharedPath, O_RDWR, S_IRUSR)
+    mov x0, -100
+    mov x1, x20
+    mov x2, 0x0002
+    mov x3, 400
+    mov x8, #56
+    svc #0
+    mov x21, x0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=0)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #1
+    mov x4, x21
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x23, x0
+
+    # mmap with an unaligned offset fails
+    # mmap(addr=NULL, length=4096, prot=1, flags=2, fd=<shared>, offset=1)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #1
+    mov x3, #2
+    mov x4, x21
+    mov x5, #1
+    mov x8, #222
+    svc #0
+    mov x26, x0
+
+    # close(fd=<shared>)
+    mov x0, x21
+    mov x8, #57
+    svc #0
+
+    # Replace the first character of the shared mapping with 'h'
+    mov w0, #104
+    strb w0, [x23]
+
+    # msync(addr=x23, length=4096, flags=MS_SYNC)
+    mov x0, x23
+    mov x1, #4096
+    mov x2, #4
+    mov x8, #227
+    svc #0
+    mov x24, x0
+
+    # munmap(addr=x23, length=4096)
+    mov x0, x23
+    mov x1, #4096
+    mov x8, #215
+    svc #0
+    mov x25, x0
+  )");
+
+  // Check the private mapping holds the contents of the input file
+  const char reference[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  char* data = processMemory_ + getGeneralRegister<uint64_t>(22);
+  for (size_t i = 0; i < strlen(reference); i++) {
+    EXPECT_EQ(data[i], reference[i]) << "at index i=" << i << '\n';
+  }
+
+  EXPECT_EQ(getGeneralRegister<int64_t>(24), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(25), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(26), -1);
+
+  // Check the change to the shared mapping was written back, without
+  // extending the file
+  char outdata[16];
+  std::ifstream sharedFile(sharedPath);
+  ASSERT_TRUE(sharedFile.good());
+  sharedFile.read(outdata, 16);
+  EXPECT_EQ(sharedFile.gcount(), strlen(str));
+  EXPECT_EQ(strncmp("hello, World!\n", outdata, strlen(str)), 0);
+}
+
+TEST_P(Syscall, file_mmap_exit) {
+  const char sharedPath[] = "./simeng-mmap-exit-test.txt";
+
+  // Create a file of three pages to be mapped as shared
+  {
+    std::ofstream sharedFile(sharedPath, std::ios::trunc);
+    sharedFile << std::string(12288, '.');
+  }
+
+  // Copy filepath to heap
+  initialHeapData_.resize(strlen(sharedPath) + 1);
+  memcpy(initialHeapData_.data(), sharedPath, strlen(sharedPath) + 1);
+
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # <shared> = openat(AT_FDCWD, sharedPath, O_RDWR, S_IRUSR)
+    mov x0, -100
+    mov x1, x20
+    mov x2, 0x0002
+    mov x3, 400
+    mov x8, #56
+    svc #0
+    mov x21, x0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=0)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #1
+    mov x4, x21
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x22, x0
+
+    # An anonymous mapping separates the shared mappings
+    # mmap(addr=NULL, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #34
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=8192)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #1
+    mov x4, x21
+    mov x5, #8192
+    mov x8, #222
+    svc #0
+    mov x23, x0
+
+    # Replace the first character of each shared mapping
+    mov w0, #65
+    strb w0, [x22]
+    mov w0, #66
+    strb w0, [x23]
+
+    # exit_group(0)
+    mov x0, #0
+    mov x8, #94
+    svc #0
+  )");
+
+  // Check each shared mapping was written back to its own offset of the file
+  // on exit, leaving the page between them unchanged
+  std::ifstream sharedFile(sharedPath);
+  ASSERT_TRUE(sharedFile.good());
+  std::string contents((std::istreambuf_iterator<char>(sharedFile)),
+                       std::istreambuf_iterator<char>());
+  ASSERT_EQ(contents.size(), 12288u);
+  EXPECT_EQ(contents[0], 'A');
+  EXPECT_EQ(contents[1], '.');
+  EXPECT_EQ(contents[4096], '.');
+  EXPECT_EQ(contents[8192], 'B');
+}
+
+TEST_P(Syscall, file_mmap_fixed) {
+  const char sharedPath[] = "./simeng-mmap-fixed-test.txt";
+
+  // Create a file of one page to be mapped as shared
+  {
+    std::ofstream sharedFile(sharedPath, std::ios::trunc);
+    sharedFile << std::string(4096, '.');
+  }
+
+  // Copy filepath to heap
+  initialHeapData_.resize(strlen(sharedPath) + 1);
+  memcpy(initialHeapData_.data(), sharedPath, strlen(sharedPath) + 1);
+
+  RUN_AARCH64(R"(
+    # Get heap address
+    mov x0, 0
+    mov x8, 214
+    svc #0
+    mov x20, x0
+
+    # <shared> = openat(AT_FDCWD, sharedPath, O_RDWR, S_IRUSR)
+    mov x0, -100
+    mov x1, x20
+    mov x2, 0x0002
+    mov x3, 400
+    mov x8, #56
+    svc #0
+    mov x21, x0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=0)
+    mov x0, #0
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #1
+    mov x4, x21
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x22, x0
+
+    # Replace the first character of the shared mapping
+    mov w0, #65
+    strb w0, [x22]
+
+    # Replace the shared mapping with an anonymous one
+    # mmap(addr=x22, length=4096, prot=3, flags=50, fd=-1, offset=0)
+    mov x0, x22
+    mov x1, #4096
+    mov x2, #3
+    mov x3, #50
+    mov x4, #-1
+    mov x5, #0
+    mov x8, #222
+    svc #0
+    mov x23, x0
+  )");
+  EXPECT_EQ(getGeneralRegister<uint64_t>(23), getGeneralRegister<uint64_t>(22));
+
+  // Check the shared mapping was written back before being replaced
+  std::ifstream sharedFile(sharedPath);
+  ASSERT_TRUE(sharedFile.good());
+  std::string contents((std::istreambuf_iterator<char>(sharedFile)),
+                       std::istreambuf_iterator<char>());
+  ASSERT_EQ(contents.size(), 4096u);
+  EXPECT_EQ(contents[0], 'A');
+  EXPECT_EQ(contents[1], '.');
 }
 
 TEST_P(Syscall, getrandom) {
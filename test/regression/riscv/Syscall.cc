@@ -1,11 +1,14 @@
+#include <dirent.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <cstring>
 #include <fstream>
+#include <iterator>
 #include <string>
 
 #include "RISCVRegressionTest.hh"
@@ -603,6 +606,135 @@ TEST_P(Syscall, filenotfound) {
   EXPECT_EQ(getGeneralRegister<int64_t>(10), -1);
 }
 
+// Tests that the generated special files are served from memory by the openat,
+// read, lseek, fstat, getdents64 and close syscalls
+TEST_P(Syscall, special_files) {
+  const char onlinePath[] = "/sys/devices/system/cpu/online";
+  const char cpuPath[] = "/sys/devices/system/cpu";
+
+  // Reserve 64 bytes for file contents, 256 bytes for directory entries, and
+  // 128 bytes for file status
+  initialHeapData_.resize(640);
+  memcpy(initialHeapData_.data() + 512, onlinePath, strlen(onlinePath) + 1);
+  memcpy(initialHeapData_.data() + 576, cpuPath, strlen(cpuPath) + 1);
+
+  RUN_RISCV(R"(
+    # Get heap address
+    li a0, 0
+    li a7, 214
+    ecall
+    mv s2, a0
+
+    # openat(AT_FDCWD, onlinePath, O_WRONLY, 0)
+    li a0, -100
+    addi a1, s2, 512
+    li a2, 1
+    li a3, 0
+    li a7, 56
+    ecall
+    mv s3, a0
+
+    # <online> = openat(AT_FDCWD, onlinePath, O_RDONLY, 0)
+    li a0, -100
+    addi a1, s2, 512
+    li a2, 0
+    li a3, 0
+    li a7, 56
+    ecall
+    mv s4, a0
+
+    # read(fd=<online>, buf=s2, count=64)
+    mv a0, s4
+    mv a1, s2
+    li a2, 64
+    li a7, 63
+    ecall
+    mv s5, a0
+
+    # lseek(fd=<online>, offset=2, whence=SEEK_SET)
+    mv a0, s4
+    li a1, 2
+    li a2, 0
+    li a7, 62
+    ecall
+    # read(fd=<online>, buf=s2+8, count=64)
+    mv a0, s4
+    addi a1, s2, 8
+    li a2, 64
+    li a7, 63
+    ecall
+    mv s6, a0
+
+    # fstat(fd=<online>, statbuf=s2+384)
+    mv a0, s4
+    addi a1, s2, 384
+    li a7, 80
+    ecall
+    mv s7, a0
+
+    # close(fd=<online>)
+    mv a0, s4
+    li a7, 57
+    ecall
+    mv s8, a0
+
+    # <cpu> = openat(AT_FDCWD, cpuPath, O_RDONLY|O_DIRECTORY, 0)
+    li a0, -100
+    addi a1, s2, 576
+    li a2, 0x10000
+    li a3, 0
+    li a7, 56
+    ecall
+    mv s9, a0
+
+    # getdents64(fd=<cpu>, buf=s2+64, count=256), until the end of the
+    # directory is reached
+    mv a0, s9
+    addi a1, s2, 64
+    li a2, 256
+    li a7, 61
+    ecall
+    mv s10, a0
+    mv a0, s9
+    addi a1, s2, 64
+    li a2, 256
+    li a7, 61
+    ecall
+    mv s11, a0
+  )");
+  EXPECT_EQ(getGeneralRegister<int64_t>(19), -EACCES);
+  EXPECT_EQ(getGeneralRegister<int64_t>(20), 3);
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), 4);
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), 2);
+  EXPECT_EQ(getGeneralRegister<int64_t>(23), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(24), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(25), 3);
+  EXPECT_EQ(getGeneralRegister<int64_t>(26), 104);
+  EXPECT_EQ(getGeneralRegister<int64_t>(27), 0);
+
+  // File contents
+  const uint64_t heap = process_->getHeapStart();
+  EXPECT_EQ(std::string(processMemory_ + heap, 4), "0-0\n");
+  EXPECT_EQ(std::string(processMemory_ + heap + 8, 2), "0\n");
+
+  // File status
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap + 384 + 16),
+            static_cast<uint32_t>(S_IFREG | 0444));
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 384 + 48), 4);
+
+  // Directory entries, of 24, 24, 24 and 32 bytes
+  const std::vector<std::pair<std::string, uint8_t>> entries = {
+      {".", DT_DIR}, {"..", DT_DIR}, {"cpu0", DT_DIR}, {"online", DT_REG}};
+  uint64_t entry = heap + 64;
+  for (const auto& [name, type] : entries) {
+    uint16_t reclen = getMemoryValue<uint16_t>(entry + 16);
+    EXPECT_EQ(getMemoryValue<uint8_t>(entry + 18), type);
+    EXPECT_EQ(std::string(processMemory_ + entry + 19), name);
+    entry += reclen;
+  }
+  EXPECT_EQ(entry, heap + 64 + 104);
+}
+
 // Test that readlinkat works for supported cases
 TEST_P(Syscall, readlinkat) {
   const char path[] = "/proc/self/exe";
@@ -963,10 +1095,121 @@ TEST_P(Syscall, set_tid_address) {
     ecall
     mv t1, a0
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(6), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(6), 100);
+}
+
+TEST_P(Syscall, clone_futex) {
+  // Reserve space for the thread IDs, futex, child results, and child stack
+  initialHeapData_.resize(1024);
+  RUN_RISCV(R"(
+    # Get heap address
+    li a0, 0
+    li a7, 214
+    ecall
+    mv s2, a0
+
+    # clone(flags=CLONE_VM|CLONE_FS|CLONE_FILES|CLONE_SIGHAND|CLONE_THREAD|
+    #       CLONE_SYSVSEM|CLONE_SETTLS|CLONE_PARENT_SETTID|
+    #       CLONE_CHILD_CLEARTID|CLONE_CHILD_SETTID, stack=s2+1024,
+    #       ptid=s2, tls=0x1234, ctid=s2+4)
+    li a0, 0x13d0f00
+    addi a1, s2, 1024
+    mv a2, s2
+    li a3, 0x1234
+    addi a4, s2, 4
+    li a7, 220
+    ecall
+    bnez a0, parent
+
+    # Child: record the stack pointer, thread pointer, and thread ID
+    sd sp, 16(s2)
+    sd tp, 24(s2)
+    li a7, 178
+    ecall
+    sd a0, 32(s2)
+    # Set the futex, and wake the parent waiting on it
+    li t0, 1
+    sw t0, 8(s2)
+    # futex(uaddr=s2+8, futex_op=FUTEX_WAKE_PRIVATE, val=1)
+    addi a0, s2, 8
+    li a1, 129
+    li a2, 1
+    li a7, 98
+    ecall
+    sd a0, 40(s2)
+    # sched_yield()
+    li a7, 124
+    ecall
+    sd a0, 48(s2)
+    # exit(status=0)
+    li a0, 0
+    li a7, 93
+    ecall
+
+  parent:
+    mv s3, a0
+    # futex(uaddr=s2+8, futex_op=FUTEX_WAIT_PRIVATE, val=0, timeout=NULL)
+    addi a0, s2, 8
+    li a1, 128
+    li a2, 0
+    li a3, 0
+    li a7, 98
+    ecall
+    mv s4, a0
+
+    # Join the child, waiting until its exit clears its thread ID at s2+4
+  join:
+    lw a2, 4(s2)
+    beqz a2, joined
+    # futex(uaddr=s2+4, futex_op=FUTEX_WAIT_PRIVATE, val=a2, timeout=NULL)
+    addi a0, s2, 4
+    li a1, 128
+    li a3, 0
+    li a7, 98
+    ecall
+    j join
+
+  joined:
+    # futex(uaddr=s2+8, futex_op=FUTEX_WAIT_PRIVATE, val=0), with the futex
+    # no longer 0
+    addi a0, s2, 8
+    li a1, 128
+    li a2, 0
+    li a3, 0
+    li a7, 98
+    ecall
+    mv s5, a0
+    # futex(uaddr=s2+8, futex_op=FUTEX_WAKE_PRIVATE, val=1), with no waiters
+    addi a0, s2, 8
+    li a1, 129
+    li a2, 1
+    li a7, 98
+    ecall
+    mv s6, a0
+    mv s7, tp
+    li a7, 178
+    ecall
+    mv s8, a0
+  )");
+  const uint64_t heap = process_->getHeapStart();
+  // The parent's view, where the process and its first thread have ID 100
+  EXPECT_EQ(getGeneralRegister<int64_t>(19), 101);
+  EXPECT_EQ(getGeneralRegister<int64_t>(20), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(21), -EAGAIN);
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), 0);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(23), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(24), 100);
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap), 101);
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap + 4), 0);
+  EXPECT_EQ(getMemoryValue<uint32_t>(heap + 8), 1);
+  // The child's view
+  EXPECT_EQ(getMemoryValue<uint64_t>(heap + 16), heap + 1024);
+  EXPECT_EQ(getMemoryValue<uint64_t>(heap + 24), 0x1234);
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 32), 101);
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 40), 1);
+  EXPECT_EQ(getMemoryValue<int64_t>(heap + 48), 0);
 }
 
-// TODO: write futex test
 // TODO: write set_robust_list test
 
 TEST_P(Syscall, clock_gettime) {
@@ -1301,7 +1544,7 @@ TEST_P(Syscall, gettid) {
     li a7, 178
     ecall
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(10), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(10), 100);
 }
 
 TEST_P(Syscall, getpid) {
@@ -1310,7 +1553,7 @@ TEST_P(Syscall, getpid) {
     li a7, 172
     ecall
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(10), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(10), 100);
 }
 
 TEST_P(Syscall, getuid) {
@@ -1353,16 +1596,69 @@ TEST_P(Syscall, getegid) {
 // TODO: write shutdown test
 
 TEST_P(Syscall, mprotect) {
-  // Check mprotect returns placeholder value as currently not implemented
+  // Check mprotect succeeds for mapped page-aligned memory, including the
+  // untracked process image, and fails for unmapped memory and unaligned
+  // addresses
   RUN_RISCV(R"(
-    # mprotect(addr=47472, len=4096, prot=1) = 0
-    li a0, 47472
+    # mprotect(addr=49152, len=4096, prot=1) = -ENOMEM
+    li a0, 49152
+    li a1, 4096
+    li a2, 1
+    li a7, 226
+    ecall
+    mv t0, a0
+
+    # mmap(addr=NULL, length=16384, prot=3, flags=34, fd=-1, offset=0)
+    li a0, 0
+    li a1, 16384
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv t1, a0
+
+    # mprotect(addr=t1+4096, len=4096, prot=1) = 0
+    li t3, 4096
+    add a0, t1, t3
     li a1, 4096
     li a2, 1
     li a7, 226
     ecall
+    mv t2, a0
+
+    # mprotect(addr=t1+1024, len=4096, prot=1) = -EINVAL
+    addi a0, t1, 1024
+    li a1, 4096
+    li a2, 1
+    li a7, 226
+    ecall
+    mv t4, a0
+
+    # mprotect(addr=t1+8192, len=16384, prot=1) = -ENOMEM
+    li t3, 8192
+    add a0, t1, t3
+    li a1, 16384
+    li a2, 1
+    li a7, 226
+    ecall
+    mv t5, a0
+
+    # mprotect(addr=0, len=4096, prot=5) = 0
+    li a0, 0
+    li a1, 4096
+    li a2, 5
+    li a7, 226
+    ecall
+    mv t6, a0
   )");
-  EXPECT_EQ(getGeneralRegister<int64_t>(10), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(5), -ENOMEM);
+  EXPECT_EQ(getGeneralRegister<int64_t>(6), process_->getMmapStart());
+  EXPECT_EQ(getGeneralRegister<int64_t>(7), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(29), -EINVAL);
+  EXPECT_EQ(getGeneralRegister<int64_t>(30), -ENOMEM);
+  EXPECT_EQ(getGeneralRegister<int64_t>(31), 0);
 }
 
 // TODO: write mbind test
@@ -1401,7 +1697,8 @@ TEST_P(Syscall, munmap) {
   EXPECT_EQ(getGeneralRegister<int64_t>(6), 0);
   EXPECT_EQ(getGeneralRegister<int64_t>(7), 0);
 
-  // Test that EINVAL error types trigger
+  // Test that unmapping a partially mapped range succeeds, while an
+  // unaligned address gives an error
   RUN_RISCV(R"(
     # mmap(addr=NULL, length=1024, prot=3, flags=34, fd=-1, offset=0)
     li a0, 0
@@ -1430,7 +1727,7 @@ TEST_P(Syscall, munmap) {
     mv t2, a0
   )");
   EXPECT_EQ(getGeneralRegister<int64_t>(5), process_->getMmapStart() + 1024);
-  EXPECT_EQ(getGeneralRegister<int64_t>(6), -1);
+  EXPECT_EQ(getGeneralRegister<int64_t>(6), 0);
   EXPECT_EQ(getGeneralRegister<int64_t>(7), -1);
 }
 
@@ -1560,6 +1857,428 @@ TEST_P(Syscall, mmap) {
   EXPECT_EQ(getGeneralRegister<int64_t>(29), process_->getMmapStart() + 20480);
   EXPECT_EQ(getGeneralRegister<int64_t>(30), process_->getMmapStart() + 4096);
   EXPECT_EQ(getGeneralRegister<int64_t>(31), process_->getMmapStart() + 8192);
+
+  // Test for mmap allocations at hint and fixed addresses
+  RUN_RISCV(R"(
+    # mmap(addr=NULL, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    li a0, 0
+    li a1, 4096
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv t0, a0
+
+    # Hint at a free address
+    # mmap(addr=t0+65536, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    li t3, 65536
+    add a0, t0, t3
+    li a1, 4096
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv t1, a0
+
+    # Hint at an address already mapped, placing the allocation above it
+    # mmap(addr=t0, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    mv a0, t0
+    li a1, 4096
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv t2, a0
+
+    # Replace the first allocation
+    # mmap(addr=t0, length=4096, prot=1, flags=50, fd=-1, offset=0)
+    mv a0, t0
+    li a1, 4096
+    li a2, 1
+    li a3, 50
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv t4, a0
+  )");
+  EXPECT_EQ(getGeneralRegister<int64_t>(5), process_->getMmapStart());
+  EXPECT_EQ(getGeneralRegister<int64_t>(6), process_->getMmapStart() + 65536);
+  EXPECT_EQ(getGeneralRegister<int64_t>(7), process_->getMmapStart() + 4096);
+  EXPECT_EQ(getGeneralRegister<int64_t>(29), process_->getMmapStart());
+}
+
+TEST_P(Syscall, mmap_zeroed) {
+  const char inputPath[] = SIMENG_RISCV_TEST_ROOT "/data/input.txt";
+
+  // Copy filepath to heap
+  initialHeapData_.resize(strlen(inputPath) + 1);
+  memcpy(initialHeapData_.data(), inputPath, strlen(inputPath) + 1);
+
+  RUN_RISCV(R"(
+    # Get heap address
+    li a0, 0
+    li a7, 214
+    ecall
+    mv s2, a0
+
+    # mmap(addr=NULL, length=12288, prot=3, flags=34, fd=-1, offset=0)
+    li a0, 0
+    li a1, 12288
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s4, a0
+
+    # Write to each part of the memory to be reused
+    li t0, 255
+    sb t0, 0(s4)
+    li t1, 4196
+    add t1, s4, t1
+    sb t0, 0(t1)
+    li t1, 8192
+    add t1, s4, t1
+    sb t0, 0(t1)
+
+    # munmap(addr=s4, length=12288)
+    mv a0, s4
+    li a1, 12288
+    li a7, 215
+    ecall
+
+    # mmap(addr=s4, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    mv a0, s4
+    li a1, 4096
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s5, a0
+
+    # <input> = openat(AT_FDCWD, inputPath, O_RDONLY, S_IRUSR)
+    li a0, -100
+    mv a1, s2
+    li a2, 0x0000
+    li a3, 400
+    li a7, 56
+    ecall
+    mv s3, a0
+
+    # The file ends within the first page of the mapping
+    # mmap(addr=s4+4096, length=8192, prot=1, flags=2, fd=<input>, offset=0)
+    li t1, 4096
+    add a0, s4, t1
+    li a1, 8192
+    li a2, 1
+    li a3, 2
+    mv a4, s3
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s6, a0
+  )");
+  // Memory reused by a new mapping is zeroed, besides the file contents
+  const uint64_t start = process_->getMmapStart();
+  EXPECT_EQ(getGeneralRegister<uint64_t>(21), start);
+  EXPECT_EQ(getGeneralRegister<uint64_t>(22), start + 4096);
+  EXPECT_EQ(getMemoryValue<uint8_t>(start), 0);
+  EXPECT_EQ(getMemoryValue<uint8_t>(start + 4096), 'A');
+  EXPECT_EQ(getMemoryValue<uint8_t>(start + 4196), 0);
+  EXPECT_EQ(getMemoryValue<uint8_t>(start + 8192), 0);
+}
+
+TEST_P(Syscall, file_mmap) {
+  const char str[] = "Hello, World!\n";
+  const char inputPath[] = SIMENG_RISCV_TEST_ROOT "/data/input.txt";
+  const char sharedPath[] = "./simeng-mmap-test.txt";
+
+  // Create the file to be mapped as shared
+  {
+    std::ofstream sharedFile(sharedPath, std::ios::trunc);
+    sharedFile << str;
+  }
+
+  // Copy filepaths to heap
+  initialHeapData_.resize(strlen(sharedPath) + strlen(inputPath) + 2);
+  memcpy(initialHeapData_.data(), sharedPath, strlen(sharedPath) + 1);
+  memcpy(initialHeapData_.data() + strlen(sharedPath) + 1, inputPath,
+         strlen(inputPath) + 1);
+
+  RUN_RISCV(R"(
+    # Get heap address
+    li a0, 0
+    li a7, 214
+    ecall
+    mv s2, a0
+
+    # <input> = openat(AT_FDCWD, inputPath, O_RDONLY, S_IRUSR)
+    li a0, -100
+    addi a1, s2, 23
+    li a2, 0x0000
+    li a3, 400
+    li a7, 56
+    ecall
+    mv s3, a0
+
+    # mmap(addr=NULL, length=4096, prot=1, flags=2, fd=<input>, offset=0)
+    li a0, 0
+    li a1, 4096
+    li a2, 1
+    li a3, 2
+    mv a4, s3
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s4, a0
+
+    # The mapping remains valid once the file is closed
+    # close(fd=<input>)
+    mv a0, s3
+    li a7, 57
+    ecall
+
+    # <shared> = openat(AT_FDCWD, sharedPath, O_RDWR, S_IRUSR)
+    li a0, -100
+    mv a1, s2
+    li a2, 0x0002
+    li a3, 400
+    li a7, 56
+    ecall
+    mv s3, a0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=0)
+    li a0, 0
+    li a1, 4096
+    li a2, 3
+    li a3, 1
+    mv a4, s3
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s5, a0
+
+    # mmap with an unaligned offset fails
+    # mmap(addr=NULL, length=4096, prot=1, flags=2, fd=<shared>, offset=1)
+    li a0, 0
+    li a1, 4096
+    li a2, 1
+    li a3, 2
+    mv a4, s3
+    li a5, 1
+    li a7, 222
+    ecall
+    mv s8, a0
+
+    # close(fd=<shared>)
+    mv a0, s3
+    li a7, 57
+    ecall
+
+    # Replace the first character of the shared mapping with 'h'
+    li t0, 104
+    sb t0, 0(s5)
+
+    # msync(addr=s5, length=4096, flags=MS_SYNC)
+    mv a0, s5
+    li a1, 4096
+    li a2, 4
+    li a7, 227
+    ecall
+    mv s6, a0
+
+    # munmap(addr=s5, length=4096)
+    mv a0, s5
+    li a1, 4096
+    li a7, 215
+    ecall
+    mv s7, a0
+  )");
+
+  // Check the private mapping holds the contents of the input file
+  const char reference[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  char* data = processMemory_ + getGeneralRegister<uint64_t>(20);
+  for (size_t i = 0; i < strlen(reference); i++) {
+    EXPECT_EQ(data[i], reference[i]) << "at index i=" << i << '\n';
+  }
+
+  EXPECT_EQ(getGeneralRegister<int64_t>(22), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(23), 0);
+  EXPECT_EQ(getGeneralRegister<int64_t>(24), -1);
+
+  // Check the change to the shared mapping was written back, without
+  // extending the file
+  char outdata[16];
+  std::ifstream sharedFile(sharedPath);
+  ASSERT_TRUE(sharedFile.good());
+  sharedFile.read(outdata, 16);
+  EXPECT_EQ(sharedFile.gcount(), strlen(str));
+  EXPECT_EQ(strncmp("hello, World!\n", outdata, strlen(str)), 0);
+}
+
+TEST_P(Syscall, file_mmap_exit) {
+  const char sharedPath[] = "./simeng-mmap-exit-test.txt";
+
+  // Create a file of three pages to be mapped as shared
+  {
+    std::ofstream sharedFile(sharedPath, std::ios::trunc);
+    sharedFile << std::string(12288, '.');
+  }
+
+  // Copy filepath to heap
+  initialHeapData_.resize(strlen(sharedPath) + 1);
+  memcpy(initialHeapData_.data(), sharedPath, strlen(sharedPath) + 1);
+
+  RUN_RISCV(R"(
+    # Get heap address
+    li a0, 0
+    li a7, 214
+    ecall
+    mv s2, a0
+
+    # <shared> = openat(AT_FDCWD, sharedPath, O_RDWR, S_IRUSR)
+    li a0, -100
+    mv a1, s2
+    li a2, 0x0002
+    li a3, 400
+    li a7, 56
+    ecall
+    mv s3, a0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=0)
+    li a0, 0
+    li a1, 4096
+    li a2, 3
+    li a3, 1
+    mv a4, s3
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s4, a0
+
+    # An anonymous mapping separates the shared mappings
+    # mmap(addr=NULL, length=4096, prot=3, flags=34, fd=-1, offset=0)
+    li a0, 0
+    li a1, 4096
+    li a2, 3
+    li a3, 34
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=8192)
+    li a0, 0
+    li a1, 4096
+    li a2, 3
+    li a3, 1
+    mv a4, s3
+    li a5, 8192
+    li a7, 222
+    ecall
+    mv s5, a0
+
+    # Replace the first character of each shared mapping
+    li t0, 65
+    sb t0, 0(s4)
+    li t0, 66
+    sb t0, 0(s5)
+
+    # exit_group(0)
+    li a0, 0
+    li a7, 94
+    ecall
+  )");
+
+  // Check each shared mapping was written back to its own offset of the file
+  // on exit, leaving the page between them unchanged
+  std::ifstream sharedFile(sharedPath);
+  ASSERT_TRUE(sharedFile.good());
+  std::string contents((std::istreambuf_iterator<char>(sharedFile)),
+                       std::istreambuf_iterator<char>());
+  ASSERT_EQ(contents.size(), 12288u);
+  EXPECT_EQ(contents[0], 'A');
+  EXPECT_EQ(contents[1], '.');
+  EXPECT_EQ(contents[4096], '.');
+  EXPECT_EQ(contents[8192], 'B');
+}
+
+TEST_P(Syscall, file_mmap_fixed) {
+  const char sharedPath[] = "./simeng-mmap-fixed-test.txt";
+
+  // Create a file of one page to be mapped as shared
+  {
+    std::ofstream sharedFile(sharedPath, std::ios::trunc);
+    sharedFile << std::string(4096, '.');
+  }
+
+  // Copy filepath to heap
+  initialHeapData_.resize(strlen(sharedPath) + 1);
+  memcpy(initialHeapData_.data(), sharedPath, strlen(sharedPath) + 1);
+
+  RUN_RISCV(R"(
+    # Get heap address
+    li a0, 0
+    li a7, 214
+    ecall
+    mv s2, a0
+
+    # <shared> = openat(AT_FDCWD, sharedPath, O_RDWR, S_IRUSR)
+    li a0, -100
+    mv a1, s2
+    li a2, 0x0002
+    li a3, 400
+    li a7, 56
+    ecall
+    mv s3, a0
+
+    # mmap(addr=NULL, length=4096, prot=3, flags=1, fd=<shared>, offset=0)
+    li a0, 0
+    li a1, 4096
+    li a2, 3
+    li a3, 1
+    mv a4, s3
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s4, a0
+
+    # Replace the first character of the shared mapping
+    li t0, 65
+    sb t0, 0(s4)
+
+    # Replace the shared mapping with an anonymous one
+    # mmap(addr=s4, length=4096, prot=3, flags=50, fd=-1, offset=0)
+    mv a0, s4
+    li a1, 4096
+    li a2, 3
+    li a3, 50
+    li a4, -1
+    li a5, 0
+    li a7, 222
+    ecall
+    mv s5, a0
+  )");
+  EXPECT_EQ(getGeneralRegister<uint64_t>(21), getGeneralRegister<uint64_t>(20));
+
+  // Check the shared mapping was written back before being replaced
+  std::ifstream sharedFile(sharedPath);
+  ASSERT_TRUE(sharedFile.good());
+  std::string contents((std::istreambuf_iterator<char>(sharedFile)),
+                       std::istreambuf_iterator<char>());
+  ASSERT_EQ(contents.size(), 4096u);
+  EXPECT_EQ(contents[0], 'A');
+  EXPECT_EQ(contents[1], '.');
 }
 
 TEST_P(Syscall, getrandom) {
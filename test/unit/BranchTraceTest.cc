@@ -0,0 +1,77 @@
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "simeng/branchpredictors/BranchTrace.hh"
+#include "simeng/version.hh"
+
+namespace simeng {
+
+#define TEST_TRACE_FILE SIMENG_BUILD_DIR "/branchTraceTest.trace"
+
+class BranchTraceTest : public testing::Test {
+ public:
+  ~BranchTraceTest() { std::remove(TEST_TRACE_FILE); }
+};
+
+// Tests that records written to a trace are read back unchanged, in order
+TEST_F(BranchTraceTest, RoundTrip) {
+  std::vector<BranchTraceRecord> records;
+  // Write enough records that the writer's buffer is flushed several times
+  for (uint64_t i = 0; i < 10000; i++) {
+    BranchType type = static_cast<BranchType>(i % 5);
+    records.push_back({0x1000 + (i % 64) * 4, 0x8000 + i * 4,
+                       (i % 3) ? static_cast<int64_t>(i * 4) - 0x100 : 0, i * 7,
+                       type, (i % 2) == 0});
+  }
+
+  {
+    BranchTraceWriter writer(TEST_TRACE_FILE);
+    ASSERT_TRUE(writer.isValid());
+    for (const auto& record : records) writer.record(record);
+  }
+
+  BranchTraceReader reader(TEST_TRACE_FILE);
+  ASSERT_TRUE(reader.isValid());
+  const auto& readRecords = reader.getRecords();
+  ASSERT_EQ(readRecords.size(), records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    EXPECT_EQ(readRecords[i].address, records[i].address);
+    EXPECT_EQ(readRecords[i].target, records[i].target);
+    EXPECT_EQ(readRecords[i].knownOffset, records[i].knownOffset);
+    EXPECT_EQ(readRecords[i].instructionCount, records[i].instructionCount);
+    EXPECT_EQ(readRecords[i].type, records[i].type);
+    EXPECT_EQ(readRecords[i].taken, records[i].taken);
+  }
+  EXPECT_EQ(reader.getInstructionCount(), 9999 * 7 + 1);
+}
+
+// Tests that an empty trace is valid, and that missing, foreign and truncated
+// files are rejected
+TEST_F(BranchTraceTest, InvalidTraces) {
+  { BranchTraceWriter writer(TEST_TRACE_FILE); }
+  BranchTraceReader empty(TEST_TRACE_FILE);
+  EXPECT_TRUE(empty.isValid());
+  EXPECT_EQ(empty.getRecords().size(), 0);
+  EXPECT_EQ(empty.getInstructionCount(), 0);
+
+  std::remove(TEST_TRACE_FILE);
+  EXPECT_FALSE(BranchTraceReader(TEST_TRACE_FILE).isValid());
+
+  {
+    std::ofstream file(TEST_TRACE_FILE, std::ios::binary);
+    file << "\x7f" "ELF and some more bytes";
+  }
+  EXPECT_FALSE(BranchTraceReader(TEST_TRACE_FILE).isValid());
+
+  {
+    BranchTraceWriter writer(TEST_TRACE_FILE);
+    writer.record({0x1000, 0x2000, 0x1000, 0, BranchType::Unconditional, true});
+  }
+  {
+    std::ofstream file(TEST_TRACE_FILE, std::ios::binary | std::ios::app);
+    file << "trunc";
+  }
+  EXPECT_FALSE(BranchTraceReader(TEST_TRACE_FILE).isValid());
+}
+
+}  // namespace simeng
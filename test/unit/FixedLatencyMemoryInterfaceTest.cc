@@ -134,6 +134,47 @@ TEST_P(FixedLatencyMemoryInterfaceTest, OutofBoundsWrite_2) {
   ASSERT_DEATH(memory.tick(), writeOverflowStr);
 }
 
+// Test that blocks of data are written after n cycles, and can only be read
+// immediately once no requests are pending.
+TEST_P(FixedLatencyMemoryInterfaceTest, BlockTransfers) {
+  const char block[3] = {0x11, 0x22, 0x33};
+  memory.requestBlockWrite(1, block, 3);
+  EXPECT_TRUE(memory.hasPendingRequests());
+
+  // Block reads aren't serviced while the write is pending
+  char buffer[4] = {};
+  EXPECT_FALSE(memory.readBlock(0, buffer, 4));
+
+  uint16_t latency = GetParam();
+  for (int n = 0; n < latency - 1; n++) {
+    memory.tick();
+    EXPECT_TRUE(memory.hasPendingRequests());
+  }
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(memoryData.data())[0], 0xABBACAFE);
+
+  memory.tick();
+  EXPECT_FALSE(memory.hasPendingRequests());
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(memoryData.data())[0], 0x332211FE);
+
+  EXPECT_TRUE(memory.readBlock(0, buffer, 4));
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(buffer)[0], 0x332211FE);
+  EXPECT_FALSE(memory.readBlock(2, buffer, 4));
+}
+
+// Test that out-of-bounds block writes are correctly handled.
+TEST_P(FixedLatencyMemoryInterfaceTest, OutofBoundsBlockWrite) {
+  const char block[3] = {0x11, 0x22, 0x33};
+  memory.requestBlockWrite(2, block, 3);
+
+  uint16_t latency = GetParam();
+  for (int n = 0; n < latency - 1; n++) {
+    memory.tick();
+    EXPECT_TRUE(memory.hasPendingRequests());
+  }
+
+  ASSERT_DEATH(memory.tick(), writeOverflowStr);
+}
+
 INSTANTIATE_TEST_SUITE_P(FixedLatencyMemoryInterfaceTests,
                          FixedLatencyMemoryInterfaceTest,
                          ::testing::Values<uint16_t>(2, 4));
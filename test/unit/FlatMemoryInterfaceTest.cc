@@ -78,4 +78,23 @@ TEST_F(FlatMemoryInterfaceTest, OutofBoundsWrite_2) {
                writeOverflowStr);
 }
 
+// Test that blocks of data can be written and read with a single copy.
+TEST_F(FlatMemoryInterfaceTest, BlockTransfers) {
+  const char block[3] = {0x11, 0x22, 0x33};
+  memory.requestBlockWrite(1, block, 3);
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(memoryData.data())[0], 0x332211FE);
+
+  char buffer[4] = {};
+  EXPECT_TRUE(memory.readBlock(0, buffer, 4));
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(buffer)[0], 0x332211FE);
+
+  // Out-of-bounds block reads fail, leaving the buffer unchanged
+  EXPECT_FALSE(memory.readBlock(2, buffer, 4));
+  EXPECT_FALSE(memory.readBlock(UINT64_MAX, buffer, 2));
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(buffer)[0], 0x332211FE);
+
+  // Out-of-bounds block writes halt the simulation
+  ASSERT_DEATH(memory.requestBlockWrite(2, block, 3), writeOverflowStr);
+}
+
 }  // namespace
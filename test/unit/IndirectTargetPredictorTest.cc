@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "simeng/branchpredictors/GenericPredictor.hh"
+#include "simeng/branchpredictors/IndirectTargetPredictor.hh"
+
+namespace simeng {
+
+class IndirectTargetPredictorTest : public testing::Test {
+ public:
+  IndirectTargetPredictorTest() {
+    simeng::config::SimInfo::addToConfig(
+        "{Branch-Predictor: {Type: Generic, BTB-Tag-Bits: 11, "
+        "Saturating-Count-Bits: 2, Global-History-Length: 10, RAS-entries: 5, "
+        "Fallback-Static-Predictor: Always-Taken, Indirect-Table-Count: 4, "
+        "Indirect-Table-Index-Bits: 8, Indirect-Table-Tag-Bits: 8, "
+        "Indirect-History-Length: 8}}");
+  }
+
+  // Disable the predictor again so as not to affect other tests
+  ~IndirectTargetPredictorTest() {
+    simeng::config::SimInfo::addToConfig(
+        "{Branch-Predictor: {Indirect-Table-Count: 0}}");
+  }
+
+ protected:
+  /** Predict and resolve the indirect branch at `address` with target
+   * `target`, supplying the BTB's prediction as the previous target in
+   * `btbTarget`. Returns whether the target was predicted correctly. */
+  bool resolve(IndirectTargetPredictor& predictor, uint64_t address,
+               uint64_t target, uint64_t& btbTarget) {
+    uint64_t predicted = predictor.predict(address, btbTarget);
+    predictor.update(address, target);
+    btbTarget = target;
+    return predicted == target;
+  }
+};
+
+// Tests that the history lengths of the tagged tables form a geometric series
+TEST_F(IndirectTargetPredictorTest, HistoryLengths) {
+  auto predictor = IndirectTargetPredictor();
+  EXPECT_TRUE(predictor.isEnabled());
+  EXPECT_EQ(predictor.getHistoryLengths(),
+            std::vector<uint16_t>({1, 2, 4, 8}));
+}
+
+// Tests that a predictor with no tables is disabled and defers to the BTB
+TEST_F(IndirectTargetPredictorTest, Disabled) {
+  simeng::config::SimInfo::addToConfig(
+      "{Branch-Predictor: {Indirect-Table-Count: 0}}");
+  auto predictor = IndirectTargetPredictor();
+  EXPECT_FALSE(predictor.isEnabled());
+  EXPECT_EQ(predictor.predict(0x100, 0x400), 0x400);
+  predictor.update(0x100, 0x800);
+  EXPECT_EQ(predictor.predict(0x100, 0x400), 0x400);
+}
+
+// Tests that a branch whose tag is 0 isn't predicted a target by tagged table
+// entries which were never allocated, so takes that of the BTB
+TEST_F(IndirectTargetPredictorTest, UnallocatedEntriesDontMatch) {
+  auto predictor = IndirectTargetPredictor();
+  // With an empty path history, the branch at 0 has a tag of 0
+  EXPECT_EQ(predictor.predict(0, 0x400), 0x400);
+}
+
+// Tests that targets correlated with the path of preceding indirect branches
+// are learnt, where the BTB would always mispredict
+TEST_F(IndirectTargetPredictorTest, PathCorrelation) {
+  auto predictor = IndirectTargetPredictor();
+  uint64_t btbA = 0;
+  uint64_t btbB = 0;
+  int correct = 0;
+  for (int i = 0; i < 64; i++) {
+    // The branch at 0x300 jumps to a target following that of 0x200, which
+    // alternates between two targets
+    uint64_t target = (i % 2) ? 0x1000 : 0x2000;
+    resolve(predictor, 0x200, target, btbA);
+    bool hit = resolve(predictor, 0x300, target + 4, btbB);
+    if (i >= 48) correct += hit;
+  }
+  EXPECT_EQ(correct, 16);
+}
+
+// Tests that flushing a prediction rolls back the path history, and that
+// updates for branches not predicted are ignored
+TEST_F(IndirectTargetPredictorTest, Flush) {
+  auto predictor = IndirectTargetPredictor();
+  uint64_t btbA = 0;
+  uint64_t btbB = 0;
+  for (int i = 0; i < 64; i++) {
+    uint64_t target = (i % 2) ? 0x1000 : 0x2000;
+    resolve(predictor, 0x200, target, btbA);
+    resolve(predictor, 0x300, target + 4, btbB);
+  }
+
+  // Speculatively predict a wrong-path branch, then flush it
+  predictor.predict(0x200, btbA);
+  predictor.flush(0x200);
+  predictor.update(0x200, 0x3000);
+
+  // The last target of 0x200 was 0x1000, so 0x2000 follows
+  EXPECT_TRUE(resolve(predictor, 0x200, 0x2000, btbA));
+  EXPECT_TRUE(resolve(predictor, 0x300, 0x2004, btbB));
+}
+
+// Tests that the GenericPredictor uses the indirect target predictor for
+// register-indirect branches only
+TEST_F(IndirectTargetPredictorTest, GenericPredictor) {
+  auto predictor = simeng::GenericPredictor();
+  uint64_t id = 0;
+  int correct = 0;
+  for (int i = 0; i < 64; i++) {
+    uint64_t target = (i % 2) ? 0x1000 : 0x2000;
+    predictor.predict(0x200, BranchType::Unconditional, 0);
+    predictor.update(0x200, true, target, BranchType::Unconditional, id++);
+    auto prediction = predictor.predict(0x300, BranchType::SubroutineCall, 0);
+    predictor.update(0x300, true, target + 4, BranchType::SubroutineCall,
+                     id++);
+    if (i >= 48) correct += (prediction.target == target + 4);
+  }
+  EXPECT_EQ(correct, 16);
+
+  // Branches with a known offset are unaffected
+  auto prediction = predictor.predict(0x400, BranchType::Unconditional, 0x40);
+  EXPECT_EQ(prediction.target, 0x440);
+}
+
+}  // namespace simeng
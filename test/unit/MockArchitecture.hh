@@ -22,7 +22,11 @@ class MockArchitecture : public arch::Architecture {
   MOCK_CONST_METHOD0(getMaxInstructionSize, uint8_t());
   MOCK_CONST_METHOD0(getMinInstructionSize, uint8_t());
   MOCK_CONST_METHOD2(updateSystemTimerRegisters,
-                     void(RegisterFileSet* regFile, const uint64_t iterations));
+                     void(ArchitecturalRegisterFileSet* regFile,
+                          const uint64_t iterations));
+  MOCK_CONST_METHOD3(getFusionInfo,
+                     bool(const Instruction& first, const Instruction& second,
+                          ExecutionInfo& info));
 };
 
 }  // namespace simeng
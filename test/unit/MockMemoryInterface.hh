@@ -14,6 +14,11 @@ class MockMemoryInterface : public memory::MemoryInterface {
   MOCK_METHOD2(requestWrite, void(const memory::MemoryAccessTarget& target,
                                   const RegisterValue& data));
 
+  MOCK_METHOD3(requestBlockWrite,
+               void(uint64_t address, const char* data, uint64_t size));
+
+  MOCK_METHOD3(readBlock, bool(uint64_t address, char* buffer, uint64_t size));
+
   MOCK_CONST_METHOD0(getCompletedReads, const span<memory::MemoryReadResult>());
 
   MOCK_METHOD0(clearCompletedReads, void());
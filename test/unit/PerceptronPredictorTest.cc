@@ -210,6 +210,25 @@ TEST_F(PerceptronPredictorTest, GlobalIndexing) {
   predictor.update(0x7C, true, 0xBA, BranchType::Conditional, 43);
 }
 
+// Tests that the PerceptronPredictor learns a pattern correlated with the
+// global history when using the longest history supported
+TEST_F(PerceptronPredictorTest, LongHistory) {
+  simeng::config::SimInfo::addToConfig(
+      "{Branch-Predictor: {Type: Perceptron, BTB-Tag-Bits: 11, "
+      "Global-History-Length: 32, RAS-entries: 5}}");
+  auto predictor = simeng::PerceptronPredictor();
+  // An alternating branch, whose direction is the opposite of that of the
+  // previous branch
+  uint64_t correct = 0;
+  for (uint64_t i = 0; i < 200; i++) {
+    bool taken = (i % 2) == 0;
+    auto prediction = predictor.predict(0, BranchType::Conditional, 0);
+    predictor.update(0, taken, 16, BranchType::Conditional, i);
+    if (i >= 150 && prediction.isTaken == taken) correct++;
+  }
+  EXPECT_EQ(correct, 50);
+}
+
 // Test Flush of RAS functionality
 TEST_F(PerceptronPredictorTest, flush) {
   simeng::config::SimInfo::addToConfig(
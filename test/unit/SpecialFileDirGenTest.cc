@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include "ConfigInit.hh"
 #include "gmock/gmock.h"
 #include "simeng/SpecialFileDirGen.hh"
@@ -114,6 +116,42 @@ TEST_F(SpecialFileDirGenTest, genAndDelete) {
   }
 }
 
+// Test that the special files can be generated in memory, at the paths they're
+// opened from, without creating the special files directory
+TEST_F(SpecialFileDirGenTest, genInMemory) {
+  kernel::VirtualFileSystem fileSystem;
+  specFile.GenerateSFDir(fileSystem);
+
+  for (size_t i = 0; i < allFiles_names_Lines.size(); i++) {
+    const kernel::VirtualFile* file =
+        fileSystem.find("/" + std::get<0>(allFiles_names_Lines[i]));
+    ASSERT_NE(file, nullptr);
+    ASSERT_FALSE(file->isDirectory);
+    std::istringstream contents(*file->contents);
+    const std::vector<std::string>& knownLines =
+        std::get<1>(allFiles_names_Lines[i]);
+    std::string line;
+    size_t numOfLines = 0;
+    while (std::getline(contents, line)) {
+      if (numOfLines >= knownLines.size()) {
+        break;
+      }
+      EXPECT_EQ(line, knownLines[numOfLines]);
+      numOfLines++;
+    }
+    EXPECT_EQ(numOfLines, knownLines.size());
+
+    EXPECT_FALSE(
+        std::ifstream(TEST_SPEC_FILE_DIR + std::get<0>(allFiles_names_Lines[i]))
+            .good());
+  }
+
+  // Only the CPU directory is held in full
+  EXPECT_EQ(fileSystem.find("/proc"), nullptr);
+  EXPECT_EQ(fileSystem.find("/sys/devices/system/cpu")->entries,
+            (std::set<std::string>{"cpu0", "online"}));
+}
+
 // Test that a non-existant non-default special file directory causes the user
 // to be notified when generation is set to False
 TEST_F(SpecialFileDirGenTest, doesntExist) {
@@ -0,0 +1,125 @@
+#include "MockInstruction.hh"
+#include "gtest/gtest.h"
+#include "simeng/branchpredictors/TagePredictor.hh"
+
+namespace simeng {
+
+class TagePredictorTest : public testing::Test {
+ public:
+  TagePredictorTest() {
+    simeng::config::SimInfo::addToConfig(
+        "{Branch-Predictor: {Type: TAGE, BTB-Tag-Bits: 10, "
+        "Global-History-Length: 10, RAS-entries: 5, Tagged-Table-Count: 5, "
+        "Tagged-Table-Index-Bits: 8, Tagged-Table-Tag-Bits: 8, "
+        "Min-History-Length: 4, Max-History-Length: 64}}");
+  }
+};
+
+// Tests that the history lengths of the tagged tables form a geometric series
+TEST_F(TagePredictorTest, HistoryLengths) {
+  auto predictor = simeng::TagePredictor();
+  EXPECT_EQ(predictor.getHistoryLengths(),
+            std::vector<uint16_t>({4, 8, 16, 32, 64}));
+}
+
+// Tests that the TagePredictor will predict taken on a miss, and a previously
+// encountered branch's target once trained
+TEST_F(TagePredictorTest, Hit) {
+  auto predictor = simeng::TagePredictor();
+  auto prediction = predictor.predict(0, BranchType::Conditional, 0);
+  EXPECT_TRUE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 0);
+  predictor.update(0, true, 16, BranchType::Conditional, 0);
+  prediction = predictor.predict(8, BranchType::Unconditional, 0);
+  EXPECT_TRUE(prediction.isTaken);
+  predictor.update(8, true, 32, BranchType::Unconditional, 1);
+
+  prediction = predictor.predict(0, BranchType::Conditional, 0);
+  EXPECT_TRUE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 16);
+}
+
+// Tests that the TagePredictor will predict branch-and-link return pairs
+// correctly
+TEST_F(TagePredictorTest, RAS) {
+  auto predictor = simeng::TagePredictor();
+  auto prediction = predictor.predict(8, BranchType::SubroutineCall, 8);
+  EXPECT_TRUE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 16);
+  prediction = predictor.predict(24, BranchType::SubroutineCall, 8);
+  EXPECT_TRUE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 32);
+
+  prediction = predictor.predict(36, BranchType::Return, 0);
+  EXPECT_TRUE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 28);
+  prediction = predictor.predict(20, BranchType::Return, 0);
+  EXPECT_TRUE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 12);
+}
+
+// Tests that the TagePredictor learns a pattern which depends on the global
+// history, and which a bimodal predictor alone would mispredict
+TEST_F(TagePredictorTest, GlobalPattern) {
+  auto predictor = simeng::TagePredictor();
+  uint64_t id = 0;
+  // Train on a branch alternating between taken and not-taken
+  for (int i = 0; i < 64; i++) {
+    predictor.predict(0x40, BranchType::Conditional, 16);
+    predictor.update(0x40, i % 2 == 0, 0x50, BranchType::Conditional, id++);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    auto prediction = predictor.predict(0x40, BranchType::Conditional, 16);
+    EXPECT_EQ(prediction.isTaken, i % 2 == 0);
+    predictor.update(0x40, i % 2 == 0, 0x50, BranchType::Conditional, id++);
+  }
+}
+
+// Tests that flushing speculative predictions restores the global history, and
+// so the predictions made after them
+TEST_F(TagePredictorTest, Flush) {
+  auto predictor = simeng::TagePredictor();
+  uint64_t id = 0;
+  for (int i = 0; i < 64; i++) {
+    predictor.predict(0x40, BranchType::Conditional, 16);
+    predictor.update(0x40, i % 2 == 0, 0x50, BranchType::Conditional, id++);
+  }
+
+  // Speculatively predict a wrong path of branches, and then flush them
+  predictor.predict(0x80, BranchType::Conditional, 16);
+  predictor.predict(0x90, BranchType::Conditional, 16);
+  predictor.predict(0xA0, BranchType::Conditional, 16);
+  predictor.flush(0xA0);
+  predictor.flush(0x90);
+  predictor.flush(0x80);
+
+  auto prediction = predictor.predict(0x40, BranchType::Conditional, 16);
+  EXPECT_TRUE(prediction.isTaken);
+  predictor.update(0x40, true, 0x50, BranchType::Conditional, id++);
+  prediction = predictor.predict(0x40, BranchType::Conditional, 16);
+  EXPECT_FALSE(prediction.isTaken);
+  EXPECT_EQ(prediction.target, 0x44);
+}
+
+// Tests that a branch whose tag is 0 isn't provided a prediction by tagged
+// table entries which were never allocated, so falls back on the base predictor
+TEST_F(TagePredictorTest, UnallocatedEntriesDontMatch) {
+  auto predictor = simeng::TagePredictor();
+  uint64_t id = 0;
+  // With an empty global history, the branch at 0x1000 has a tag of 0. Being
+  // not-taken trains its base predictor counter, and allocates a tagged entry
+  for (int i = 0; i < 2; i++) {
+    predictor.predict(0x1000, BranchType::Conditional, 16);
+    predictor.update(0x1000, false, 0x1010, BranchType::Conditional, id++);
+  }
+
+  // Under a different history, the branch has a non-zero tag matching no
+  // allocated entry, so the trained base predictor provides the prediction
+  predictor.predict(0x2000, BranchType::Unconditional, 16);
+  predictor.update(0x2000, true, 0x2010, BranchType::Unconditional, id++);
+  auto prediction = predictor.predict(0x1000, BranchType::Conditional, 16);
+  EXPECT_FALSE(prediction.isTaken);
+}
+
+}  // namespace simeng
@@ -0,0 +1,74 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "simeng/TimingWheel.hh"
+
+namespace {
+
+// Tests that entries are popped in order of their cycle, and in the order they
+// were pushed within a cycle
+TEST(TimingWheelTest, Ordering) {
+  simeng::TimingWheel<int> wheel(8);
+  EXPECT_TRUE(wheel.empty());
+
+  wheel.push(5) = 1;
+  wheel.push(3) = 2;
+  wheel.push(5) = 3;
+  wheel.push(4) = 4;
+  EXPECT_EQ(wheel.size(), 4);
+
+  std::vector<std::pair<uint64_t, int>> popped;
+  while (!wheel.empty()) {
+    popped.push_back({wheel.frontCycle(), wheel.front()});
+    wheel.pop_front();
+  }
+  std::vector<std::pair<uint64_t, int>> expected = {
+      {3, 2}, {4, 4}, {5, 1}, {5, 3}};
+  EXPECT_EQ(popped, expected);
+}
+
+// Tests that the wheel grows when entries are pushed beyond its window, keeping
+// pending entries in order
+TEST(TimingWheelTest, Grow) {
+  simeng::TimingWheel<int> wheel(4);
+  wheel.push(10) = 1;
+  wheel.push(11) = 2;
+  // Beyond the initial window of 4 cycles
+  wheel.push(20) = 3;
+  // Before the earliest pending cycle
+  wheel.push(6) = 4;
+
+  EXPECT_EQ(wheel.frontCycle(), 6);
+  EXPECT_EQ(wheel.front(), 4);
+  wheel.pop_front();
+  EXPECT_EQ(wheel.frontCycle(), 10);
+  EXPECT_EQ(wheel.front(), 1);
+  wheel.pop_front();
+  EXPECT_EQ(wheel.frontCycle(), 11);
+  EXPECT_EQ(wheel.front(), 2);
+  wheel.pop_front();
+  EXPECT_EQ(wheel.frontCycle(), 20);
+  EXPECT_EQ(wheel.front(), 3);
+  wheel.pop_front();
+  EXPECT_TRUE(wheel.empty());
+}
+
+// Tests that popped entries, and the storage they own, are reused by later
+// pushes
+TEST(TimingWheelTest, EntriesReused) {
+  simeng::TimingWheel<std::vector<int>> wheel(4);
+  auto& entry = wheel.push(1);
+  entry.assign(16, 0);
+  const int* data = entry.data();
+  wheel.pop_front();
+
+  // Pushing to the same bucket returns the popped entry
+  auto& reused = wheel.push(5);
+  EXPECT_EQ(&reused, &entry);
+  reused.clear();
+  reused.push_back(1);
+  EXPECT_EQ(reused.data(), data);
+  EXPECT_EQ(wheel.frontCycle(), 5);
+}
+
+}  // namespace
@@ -0,0 +1,107 @@
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "simeng/kernel/VirtualFileSystem.hh"
+#include "simeng/version.hh"
+
+namespace {
+
+using simeng::kernel::VirtualFileSystem;
+
+#define TEST_OVERLAY_DIR SIMENG_BUILD_DIR "/virtualFileSystemTest"
+
+// Tests that paths are normalised lexically
+TEST(VirtualFileSystemTest, Normalise) {
+  EXPECT_EQ(VirtualFileSystem::normalise("/"), "/");
+  EXPECT_EQ(VirtualFileSystem::normalise("//proc//stat"), "/proc/stat");
+  EXPECT_EQ(VirtualFileSystem::normalise("/sys/./devices/"), "/sys/devices");
+  EXPECT_EQ(VirtualFileSystem::normalise("/a/b/../../c/.."), "/");
+  EXPECT_EQ(VirtualFileSystem::normalise("/../proc/../proc/cpuinfo"),
+            "/proc/cpuinfo");
+}
+
+// Tests that directories list the files added within them, and that only the
+// files and directories added are held
+TEST(VirtualFileSystemTest, FilesAndDirectories) {
+  VirtualFileSystem fileSystem;
+  EXPECT_TRUE(fileSystem.empty());
+  fileSystem.addFile("/proc/stat", "cpu  0\n");
+  fileSystem.addDirectory("/sys/devices/system/cpu/");
+  fileSystem.addFile("/sys/devices/system/cpu/online", "0-0\n");
+  fileSystem.addDirectory("/sys/devices/system/cpu/cpu0");
+  EXPECT_FALSE(fileSystem.empty());
+
+  // Parents which weren't added aren't held
+  EXPECT_EQ(fileSystem.find("/proc"), nullptr);
+  EXPECT_EQ(fileSystem.find("/sys/devices/system"), nullptr);
+  EXPECT_EQ(fileSystem.find("/proc/cpuinfo"), nullptr);
+
+  const auto* cpu = fileSystem.find("/sys/devices/system/cpu");
+  ASSERT_NE(cpu, nullptr);
+  EXPECT_TRUE(cpu->isDirectory);
+  EXPECT_EQ(cpu->entries, (std::set<std::string>{"cpu0", "online"}));
+
+  const auto* online = fileSystem.find("/sys/devices/system/cpu/./online");
+  ASSERT_NE(online, nullptr);
+  EXPECT_FALSE(online->isDirectory);
+  EXPECT_EQ(*online->contents, "0-0\n");
+  EXPECT_NE(online->inode, cpu->inode);
+
+  // Adding a file again replaces its contents but keeps its inode, while
+  // adding a directory again keeps its entries
+  uint64_t inode = online->inode;
+  fileSystem.addFile("/sys/devices/system/cpu/online", "0-3\n");
+  online = fileSystem.find("/sys/devices/system/cpu/online");
+  EXPECT_EQ(*online->contents, "0-3\n");
+  EXPECT_EQ(online->inode, inode);
+  fileSystem.addDirectory("/sys/devices/system/cpu");
+  EXPECT_EQ(fileSystem.find("/sys/devices/system/cpu")->entries.size(), 2);
+
+  // Directories precede the files they hold
+  std::vector<std::string> paths;
+  for (const auto& [path, file] : fileSystem.getFiles()) paths.push_back(path);
+  EXPECT_EQ(paths, (std::vector<std::string>{
+                       "/proc/stat", "/sys/devices/system/cpu",
+                       "/sys/devices/system/cpu/cpu0",
+                       "/sys/devices/system/cpu/online"}));
+}
+
+// Tests that host directories are snapshotted in full at their absolute path,
+// such that later changes to the host files aren't seen
+TEST(VirtualFileSystemTest, HostDirectory) {
+  ASSERT_EQ(::mkdir(TEST_OVERLAY_DIR, 0755), 0);
+  ASSERT_EQ(::mkdir(TEST_OVERLAY_DIR "/inputs", 0755), 0);
+  std::ofstream(TEST_OVERLAY_DIR "/config.txt") << "size=4\n";
+  std::ofstream(TEST_OVERLAY_DIR "/inputs/matrix.bin", std::ios::binary)
+      << std::string("\0\1\2\3", 4);
+
+  VirtualFileSystem fileSystem;
+  EXPECT_TRUE(fileSystem.addHostDirectory(TEST_OVERLAY_DIR "/./"));
+  std::ofstream(TEST_OVERLAY_DIR "/config.txt") << "size=8\n";
+
+  char absolutePath[4096];
+  ASSERT_NE(::realpath(TEST_OVERLAY_DIR, absolutePath), nullptr);
+  std::string root = absolutePath;
+  const auto* directory = fileSystem.find(root);
+  ASSERT_NE(directory, nullptr);
+  EXPECT_EQ(directory->entries,
+            (std::set<std::string>{"config.txt", "inputs"}));
+  EXPECT_EQ(*fileSystem.find(root + "/config.txt")->contents, "size=4\n");
+  EXPECT_TRUE(fileSystem.find(root + "/inputs")->isDirectory);
+  EXPECT_EQ(*fileSystem.find(root + "/inputs/matrix.bin")->contents,
+            std::string("\0\1\2\3", 4));
+
+  std::remove(TEST_OVERLAY_DIR "/inputs/matrix.bin");
+  std::remove(TEST_OVERLAY_DIR "/config.txt");
+  ::rmdir(TEST_OVERLAY_DIR "/inputs");
+  ::rmdir(TEST_OVERLAY_DIR);
+
+  // Missing directories can't be added
+  EXPECT_FALSE(fileSystem.addHostDirectory(TEST_OVERLAY_DIR));
+}
+
+}  // namespace
@@ -0,0 +1,225 @@
+#include <fcntl.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "simeng/kernel/VirtualMemoryAreas.hh"
+
+namespace {
+
+using simeng::kernel::MappedFile;
+using simeng::kernel::VirtualMemoryAreas;
+
+const uint64_t pageSize = 4096;
+const uint64_t regionStart = 0x100000;
+const uint64_t regionEnd = 0x200000;
+
+// Tests that areas are rounded up to whole pages and placed in the first gap
+// large enough to hold them
+TEST(VirtualMemoryAreasTest, FirstFit) {
+  VirtualMemoryAreas areas(regionStart, regionEnd, pageSize);
+  EXPECT_EQ(areas.map(0, 1024, 3, 0x22, false), regionStart);
+  EXPECT_EQ(areas.map(0, 12288, 1, 0x22, false), regionStart + 0x1000);
+  EXPECT_EQ(areas.map(0, 1024, 3, 0x22, false), regionStart + 0x4000);
+  EXPECT_EQ(areas.getAreaCount(), 3);
+
+  // Free the middle area, leaving a 3 page gap
+  EXPECT_TRUE(areas.unmap(regionStart + 0x1000, 12288));
+  EXPECT_TRUE(areas.isFree(regionStart + 0x1000, regionStart + 0x4000));
+  EXPECT_EQ(areas.map(0, 16384, 3, 0x22, false), regionStart + 0x5000);
+  EXPECT_EQ(areas.map(0, 4096, 1, 0x22, false), regionStart + 0x1000);
+  EXPECT_EQ(areas.map(0, 8192, 1, 0x22, false), regionStart + 0x2000);
+  EXPECT_TRUE(areas.isMapped(regionStart, regionStart + 0x9000));
+
+  // Zero-length areas and those larger than the region can't be placed
+  EXPECT_EQ(areas.map(0, 0, 3, 0x22, false), 0);
+  EXPECT_EQ(areas.map(0, regionEnd - regionStart, 3, 0x22, false), 0);
+}
+
+// Tests that free hint addresses are used, and that otherwise areas are placed
+// in the first gap above the hint
+TEST(VirtualMemoryAreasTest, Hints) {
+  VirtualMemoryAreas areas(regionStart, regionEnd, pageSize);
+  EXPECT_EQ(areas.map(regionStart + 0x10000, 4096, 3, 0x22, false),
+            regionStart + 0x10000);
+  // Unaligned hints are rounded up to the next page
+  EXPECT_EQ(areas.map(regionStart + 0x20010, 4096, 3, 0x22, false),
+            regionStart + 0x21000);
+  EXPECT_EQ(areas.map(regionStart + 0x10000, 8192, 3, 0x22, false),
+            regionStart + 0x11000);
+  // A hint too close to the end of the region falls back to the first gap of
+  // the region
+  EXPECT_EQ(areas.map(regionEnd - 0x1000, 8192, 3, 0x22, false), regionStart);
+  // Hints outside of the region are ignored
+  EXPECT_EQ(areas.map(0x1000, 4096, 3, 0x22, false), regionStart + 0x2000);
+}
+
+// Tests that fixed areas replace those they overlap, splitting them as needed
+TEST(VirtualMemoryAreasTest, Fixed) {
+  VirtualMemoryAreas areas(regionStart, regionEnd, pageSize);
+  EXPECT_EQ(areas.map(0, 0x8000, 3, 0x22, false), regionStart);
+  EXPECT_EQ(areas.map(regionStart + 0x2000, 0x2000, 1, 0x32, true),
+            regionStart + 0x2000);
+  ASSERT_EQ(areas.getAreaCount(), 3);
+  EXPECT_EQ(areas.find(regionStart + 0x1fff)->end, regionStart + 0x2000);
+  EXPECT_EQ(areas.find(regionStart + 0x2000)->prot, 1);
+  EXPECT_EQ(areas.find(regionStart + 0x3fff)->end, regionStart + 0x4000);
+  EXPECT_EQ(areas.find(regionStart + 0x4000)->prot, 3);
+  EXPECT_EQ(areas.find(regionStart + 0x4000)->end, regionStart + 0x8000);
+
+  // Fixed areas must be page-aligned
+  EXPECT_EQ(areas.map(regionStart + 0x10010, 0x1000, 3, 0x32, true), 0);
+
+  // Fixed areas may lie outside of the region
+  EXPECT_EQ(areas.map(0x1000, 0x1000, 3, 0x32, true), 0x1000);
+  EXPECT_NE(areas.find(0x1000), nullptr);
+  EXPECT_EQ(areas.map(0, 0x1000, 3, 0x22, false), regionStart + 0x8000);
+}
+
+// Tests that unmapping part of an area splits it, and that unmapping a range
+// spanning several areas removes them all
+TEST(VirtualMemoryAreasTest, PartialUnmap) {
+  VirtualMemoryAreas areas(regionStart, regionEnd, pageSize);
+  EXPECT_EQ(areas.map(0, 0x6000, 3, 0x22, false), regionStart);
+  EXPECT_TRUE(areas.unmap(regionStart + 0x2000, 0x1000));
+  ASSERT_EQ(areas.getAreaCount(), 2);
+  EXPECT_EQ(areas.find(regionStart + 0x2000), nullptr);
+  EXPECT_EQ(areas.find(regionStart)->end, regionStart + 0x2000);
+  EXPECT_EQ(areas.find(regionStart + 0x3000)->start, regionStart + 0x3000);
+  EXPECT_FALSE(areas.isMapped(regionStart, regionStart + 0x6000));
+
+  // The single page gap is reused
+  EXPECT_EQ(areas.map(0, 0x1000, 1, 0x22, false), regionStart + 0x2000);
+  EXPECT_EQ(areas.getAreaCount(), 3);
+
+  // Unmapping across all three areas leaves the ends of the outer two
+  EXPECT_TRUE(areas.unmap(regionStart + 0x1000, 0x4000));
+  EXPECT_EQ(areas.getAreaCount(), 2);
+  EXPECT_TRUE(areas.isFree(regionStart + 0x1000, regionStart + 0x5000));
+  EXPECT_EQ(areas.map(0, 0x4000, 3, 0x22, false), regionStart + 0x1000);
+
+  // Unaligned or empty ranges are rejected
+  EXPECT_FALSE(areas.unmap(regionStart + 0x10, 0x1000));
+  EXPECT_FALSE(areas.unmap(regionStart, 0));
+}
+
+// Tests that protecting part of an area splits it, and that adjacent areas are
+// merged once their protections match
+TEST(VirtualMemoryAreasTest, Protect) {
+  VirtualMemoryAreas areas(regionStart, regionEnd, pageSize);
+  EXPECT_EQ(areas.map(0, 0x4000, 3, 0x22, false), regionStart);
+  EXPECT_EQ(areas.getAreaCount(), 1);
+
+  EXPECT_TRUE(areas.protect(regionStart + 0x1000, 0x2000, 1));
+  ASSERT_EQ(areas.getAreaCount(), 3);
+  EXPECT_EQ(areas.find(regionStart)->prot, 3);
+  EXPECT_EQ(areas.find(regionStart + 0x1000)->prot, 1);
+  EXPECT_EQ(areas.find(regionStart + 0x1000)->end, regionStart + 0x3000);
+  EXPECT_EQ(areas.find(regionStart + 0x3000)->prot, 3);
+
+  EXPECT_TRUE(areas.protect(regionStart + 0x1000, 0x2000, 3));
+  ASSERT_EQ(areas.getAreaCount(), 1);
+  EXPECT_EQ(areas.find(regionStart)->end, regionStart + 0x4000);
+
+  // Unmapped memory is left untouched
+  EXPECT_TRUE(areas.protect(regionStart + 0x3000, 0x4000, 1));
+  EXPECT_EQ(areas.getAreaCount(), 2);
+  EXPECT_EQ(areas.find(regionStart + 0x4000), nullptr);
+  EXPECT_FALSE(areas.protect(regionStart + 0x10, 0x1000, 1));
+}
+
+// Tests that the file offsets of file-backed areas follow them as they're
+// split, and that only areas continuing the same mapping are merged
+TEST(VirtualMemoryAreasTest, FileOffsets) {
+  VirtualMemoryAreas areas(regionStart, regionEnd, pageSize);
+  auto file = std::make_shared<MappedFile>(::open("/dev/null", O_RDONLY));
+  EXPECT_EQ(areas.map(0, 0x4000, 3, 0x1, false, file, 0x2000), regionStart);
+
+  EXPECT_TRUE(areas.unmap(regionStart + 0x1000, 0x1000));
+  EXPECT_TRUE(areas.protect(regionStart + 0x3000, 0x1000, 1));
+  ASSERT_EQ(areas.getAreaCount(), 3);
+  EXPECT_EQ(areas.find(regionStart)->offset, 0x2000);
+  EXPECT_EQ(areas.find(regionStart + 0x2000)->offset, 0x4000);
+  EXPECT_EQ(areas.find(regionStart + 0x3000)->offset, 0x5000);
+  EXPECT_EQ(areas.find(regionStart + 0x3000)->file, file);
+
+  // Remapping the unmapped page at the offset it held rejoins the area,
+  // whereas a different offset or file doesn't
+  EXPECT_EQ(areas.map(regionStart + 0x1000, 0x1000, 3, 0x1, true, file, 0),
+            regionStart + 0x1000);
+  EXPECT_EQ(areas.getAreaCount(), 4);
+  EXPECT_EQ(areas.map(regionStart + 0x1000, 0x1000, 3, 0x1, true, nullptr),
+            regionStart + 0x1000);
+  EXPECT_EQ(areas.getAreaCount(), 4);
+  EXPECT_EQ(areas.map(regionStart + 0x1000, 0x1000, 3, 0x1, true, file,
+                      0x3000),
+            regionStart + 0x1000);
+  EXPECT_EQ(areas.getAreaCount(), 2);
+  EXPECT_EQ(areas.find(regionStart)->end, regionStart + 0x3000);
+
+  // Areas only keep the file open while they map it
+  EXPECT_EQ(file.use_count(), 3);
+  EXPECT_TRUE(areas.unmap(regionStart, 0x4000));
+  EXPECT_EQ(file.use_count(), 1);
+}
+
+// Tests a long random sequence of operations against a page-by-page model of
+// the region
+TEST(VirtualMemoryAreasTest, RandomOperations) {
+  const uint64_t pages = 256;
+  VirtualMemoryAreas areas(regionStart, regionStart + pages * pageSize,
+                           pageSize);
+  // The protection of each page of the region, or -1 if it's unmapped
+  std::vector<int> model(pages, -1);
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<uint64_t> pageDist(0, pages - 1);
+  std::uniform_int_distribution<uint64_t> lengthDist(1, 8);
+  std::uniform_int_distribution<int> opDist(0, 3);
+  for (int i = 0; i < 20000; i++) {
+    uint64_t page = pageDist(rng);
+    uint64_t length = std::min(lengthDist(rng), pages - page);
+    uint64_t addr = regionStart + page * pageSize;
+    int op = opDist(rng);
+    if (op == 0) {
+      // Find the first fit in the model
+      uint64_t expected = 0;
+      for (uint64_t start = 0; start + length <= pages && !expected;
+           start++) {
+        bool free = true;
+        for (uint64_t j = start; j < start + length && free; j++) {
+          free = model[j] < 0;
+        }
+        if (free) expected = regionStart + start * pageSize;
+      }
+      ASSERT_EQ(areas.map(0, length * pageSize, 3, 0x22, false), expected);
+      if (expected) {
+        uint64_t start = (expected - regionStart) / pageSize;
+        for (uint64_t j = start; j < start + length; j++) model[j] = 3;
+      }
+    } else if (op == 1) {
+      ASSERT_EQ(areas.map(addr, length * pageSize, 1, 0x22, true), addr);
+      for (uint64_t j = page; j < page + length; j++) model[j] = 1;
+    } else if (op == 2) {
+      ASSERT_TRUE(areas.unmap(addr, length * pageSize));
+      for (uint64_t j = page; j < page + length; j++) model[j] = -1;
+    } else {
+      ASSERT_TRUE(areas.protect(addr, length * pageSize, 7));
+      for (uint64_t j = page; j < page + length; j++) {
+        if (model[j] >= 0) model[j] = 7;
+      }
+    }
+
+    for (uint64_t j = 0; j < pages; j++) {
+      auto area = areas.find(regionStart + j * pageSize);
+      ASSERT_EQ(area == nullptr, model[j] < 0);
+      if (area) {
+        ASSERT_EQ(area->prot, model[j]);
+      }
+    }
+  }
+}
+
+}  // namespace
@@ -187,6 +187,7 @@ TEST_F(AArch64ArchitectureTest, getStreamingVectorLength) {
 
 TEST_F(AArch64ArchitectureTest, updateSystemTimerRegisters) {
   RegisterFileSet regFile = config::SimInfo::getArchRegStruct();
+  ArchitecturalRegisterFileSet archRegFile(regFile);
 
   uint8_t vctCount = 0;
   // In A64FX, Timer frequency = (2.5 * 1e9) / (100 * 1e6) = 18
@@ -198,7 +199,7 @@ TEST_F(AArch64ArchitectureTest, updateSystemTimerRegisters) {
        1e6);
   for (int i = 0; i < 30; i++) {
     vctCount += (i % vctModulo) == 0 ? 1 : 0;
-    arch->updateSystemTimerRegisters(&regFile, i);
+    arch->updateSystemTimerRegisters(&archRegFile, i);
     EXPECT_EQ(
         regFile
             .get({RegisterType::SYSTEM, (uint16_t)arch->getSystemRegisterTag(
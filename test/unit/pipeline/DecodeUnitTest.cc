@@ -1,17 +1,21 @@
 #include <memory>
 
+#include "../MockArchitecture.hh"
 #include "../MockBranchPredictor.hh"
 #include "../MockInstruction.hh"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "simeng/pipeline/DecodeUnit.hh"
+#include "simeng/pipeline/FusedInstruction.hh"
 
 namespace simeng {
 namespace pipeline {
 
 using ::testing::_;
+using ::testing::DoAll;
 using ::testing::Property;
 using ::testing::Return;
+using ::testing::SetArgReferee;
 
 class PipelineDecodeUnitTest : public testing::Test {
  public:
@@ -20,6 +24,10 @@ class PipelineDecodeUnitTest : public testing::Test {
         output(1, nullptr),
         registerFileSet({{8, 1}}),
         decodeUnit(input, output, predictor),
+        linux(config::SimInfo::getConfig()["CPU-Info"]["Special-File-Dir-Path"]
+                  .as<std::string>()),
+        isa(linux),
+        fusingDecodeUnit(input, output, predictor, &isa),
         uop(new MockInstruction),
         uopPtr(uop),
         uop2(new MockInstruction),
@@ -32,6 +40,9 @@ class PipelineDecodeUnitTest : public testing::Test {
   RegisterFileSet registerFileSet;
   MockBranchPredictor predictor;
   DecodeUnit decodeUnit;
+  kernel::Linux linux;
+  MockArchitecture isa;
+  DecodeUnit fusingDecodeUnit;
 
   MockInstruction* uop;
   std::shared_ptr<Instruction> uopPtr;
@@ -112,5 +123,58 @@ TEST_F(PipelineDecodeUnitTest, purgeFlushed) {
   EXPECT_EQ(input.getHeadSlots()[0].size(), 0);
 }
 
+// Tests that a uop reading a result of the uop before it is fused with it when
+// the pair matches a fusion rule
+TEST_F(PipelineDecodeUnitTest, Fuse) {
+  input.getHeadSlots()[0] = {uopPtr, uop2Ptr};
+
+  std::array<Register, 1> destinations = {{{0, 1}}};
+  ON_CALL(*uop, getDestinationRegisters())
+      .WillByDefault(Return(span<Register>(destinations)));
+  ON_CALL(*uop2, getSourceRegisters())
+      .WillByDefault(Return(span<Register>(destinations)));
+  ON_CALL(*uop2, isOperandReady(0)).WillByDefault(Return(false));
+
+  ExecutionInfo info = {2, 1, {3}};
+  EXPECT_CALL(isa, getFusionInfo(_, _, _))
+      .WillOnce(DoAll(SetArgReferee<2>(info), Return(true)));
+
+  fusingDecodeUnit.tick();
+
+  // Check a single macro-op holding both uops was produced
+  auto result = output.getTailSlots()[0];
+  ASSERT_TRUE(result->isFused());
+  auto& fused = static_cast<FusedInstruction&>(*result);
+  EXPECT_EQ(fused.getFirst().get(), uop);
+  EXPECT_EQ(fused.getSecond().get(), uop2);
+  EXPECT_EQ(fused.getLatency(), 2);
+  EXPECT_EQ(fused.getSupportedPorts(), std::vector<uint16_t>{3});
+
+  // The result of the first uop is forwarded rather than read
+  EXPECT_EQ(fused.getSourceRegisters().size(), 0);
+  EXPECT_EQ(fused.getDestinationRegisters().size(), 1);
+
+  EXPECT_EQ(fusingDecodeUnit.getFusedCount(), 1);
+  EXPECT_EQ(fusingDecodeUnit.getDecodedCount(), 1);
+}
+
+// Tests that a uop which doesn't read a result of the uop before it isn't fused
+// with it
+TEST_F(PipelineDecodeUnitTest, NoFuseIndependent) {
+  input.getHeadSlots()[0] = {uopPtr, uop2Ptr};
+
+  std::array<Register, 1> destinations = {{{0, 1}}};
+  ON_CALL(*uop, getDestinationRegisters())
+      .WillByDefault(Return(span<Register>(destinations)));
+  std::array<Register, 1> sources = {{{0, 0}}};
+  ON_CALL(*uop2, getSourceRegisters())
+      .WillByDefault(Return(span<Register>(sources)));
+  EXPECT_CALL(isa, getFusionInfo(_, _, _)).Times(0);
+
+  fusingDecodeUnit.tick();
+  EXPECT_EQ(output.getTailSlots()[0].get(), uop);
+  EXPECT_EQ(fusingDecodeUnit.getFusedCount(), 0);
+}
+
 }  // namespace pipeline
 }  // namespace simeng
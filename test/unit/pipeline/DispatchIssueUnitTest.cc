@@ -19,7 +19,8 @@ class PipelineDispatchIssueUnitTest : public testing::Test {
         input(1, nullptr),
         output(config::SimInfo::getConfig()["Execution-Units"].num_children(),
                {1, nullptr}),
-        diUnit(input, output, regFile, portAlloc, physRegQuants),
+        storeSets(64, 8),
+        diUnit(input, output, regFile, portAlloc, storeSets, physRegQuants),
         uop(new MockInstruction),
         uopPtr(uop),
         uop2(new MockInstruction),
@@ -70,6 +71,8 @@ class PipelineDispatchIssueUnitTest : public testing::Test {
 
   MockPortAllocator portAlloc;
 
+  StoreSetPredictor storeSets;
+
   simeng::pipeline::DispatchIssueUnit diUnit;
 
   MockInstruction* uop;
@@ -559,6 +562,275 @@ TEST_F(PipelineDispatchIssueUnitTest, purgeFlushed) {
   EXPECT_EQ(diUnit.getRSStalls(), 0);
 }
 
+// Only the youngest, flushed instructions are removed from the reservation
+// stations, including those dispatched after an older instruction has issued
+TEST_F(PipelineDispatchIssueUnitTest, purgeFlushedYoungest) {
+  std::array<Register, 0> noRegs = {};
+  const std::vector<uint16_t> suppPorts = {EAGA};
+  EXPECT_CALL(portAlloc, allocate(suppPorts)).WillRepeatedly(Return(EAGA));
+
+  // Dispatch and issue an instruction, freeing its slot
+  MockInstruction* uop3 = new MockInstruction;
+  std::shared_ptr<Instruction> uop3Ptr(uop3);
+  EXPECT_CALL(*uop3, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop3, getSourceRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  EXPECT_CALL(*uop3, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  input.getHeadSlots()[0] = uop3Ptr;
+  diUnit.tick();
+  EXPECT_CALL(portAlloc, issued(EAGA));
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uop3Ptr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+
+  // Dispatch an older and a younger instruction
+  EXPECT_CALL(*uop, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop, getSourceRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  EXPECT_CALL(*uop, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  input.getHeadSlots()[0] = uopPtr;
+  diUnit.tick();
+  EXPECT_CALL(*uop2, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop2, getSourceRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  EXPECT_CALL(*uop2, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  input.getHeadSlots()[0] = uop2Ptr;
+  diUnit.tick();
+
+  // Flush only the younger instruction
+  EXPECT_CALL(portAlloc, deallocate(EAGA)).Times(1);
+  uop2Ptr->setFlushed();
+  diUnit.purgeFlushed();
+
+  std::vector<uint32_t> rsSizes;
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes[RS_EAGA], refRsSizes[RS_EAGA] - 1);
+
+  // The older instruction remains and issues, followed by nothing
+  EXPECT_CALL(portAlloc, issued(EAGA));
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uopPtr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], nullptr);
+
+  rsSizes.clear();
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes, refRsSizes);
+}
+
+// Flushed instructions of one hardware thread are removed from the reservation
+// stations, even when younger instructions of another thread remain
+TEST_F(PipelineDispatchIssueUnitTest, purgeFlushedThread) {
+  std::array<Register, 0> noRegs = {};
+  const std::vector<uint16_t> suppPorts = {EAGA};
+  EXPECT_CALL(portAlloc, allocate(suppPorts)).WillRepeatedly(Return(EAGA));
+
+  // Dispatch instructions of threads 0, 1, and 0 in turn
+  MockInstruction* uop3 = new MockInstruction;
+  std::shared_ptr<Instruction> uop3Ptr(uop3);
+  uop2Ptr->setThreadId(1);
+  for (auto* insn : {uop, uop2, uop3}) {
+    EXPECT_CALL(*insn, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+    EXPECT_CALL(*insn, getSourceRegisters())
+        .WillOnce(Return(span<Register>(noRegs)));
+    EXPECT_CALL(*insn, getDestinationRegisters())
+        .WillOnce(Return(span<Register>(noRegs)));
+  }
+  for (const auto& insn : {uopPtr, uop2Ptr, uop3Ptr}) {
+    input.getHeadSlots()[0] = insn;
+    diUnit.tick();
+  }
+  EXPECT_EQ(diUnit.getThreadOccupancy(0), 2);
+  EXPECT_EQ(diUnit.getThreadOccupancy(1), 1);
+
+  // Flush the instruction of thread 1
+  EXPECT_CALL(portAlloc, deallocate(EAGA)).Times(1);
+  uop2Ptr->setFlushed();
+  diUnit.purgeFlushed();
+  EXPECT_EQ(diUnit.getThreadOccupancy(0), 2);
+  EXPECT_EQ(diUnit.getThreadOccupancy(1), 0);
+
+  // Only the instructions of thread 0 issue
+  EXPECT_CALL(portAlloc, issued(EAGA)).Times(2);
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uopPtr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uop3Ptr);
+  EXPECT_EQ(diUnit.getThreadOccupancy(0), 0);
+
+  std::vector<uint32_t> rsSizes;
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes, refRsSizes);
+}
+
+// Instructions ready to issue to the same port are issued oldest first,
+// regardless of the order in which they became ready
+TEST_F(PipelineDispatchIssueUnitTest, issueOldestFirst) {
+  std::array<Register, 0> noRegs = {};
+  std::array<Register, 1> srcRegs = {r1};
+  std::array<Register, 1> destRegs = {r1};
+  const std::vector<uint16_t> suppPorts = {EAGA};
+  EXPECT_CALL(portAlloc, allocate(suppPorts)).WillRepeatedly(Return(EAGA));
+
+  // Oldest instruction writes r1
+  EXPECT_CALL(*uop, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop, getSourceRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  EXPECT_CALL(*uop, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(destRegs)));
+  input.getHeadSlots()[0] = uopPtr;
+  diUnit.tick();
+
+  // Second instruction reads r1, so must wait
+  EXPECT_CALL(*uop2, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop2, getSourceRegisters())
+      .WillOnce(Return(span<Register>(srcRegs)));
+  EXPECT_CALL(*uop2, isOperandReady(0)).WillOnce(Return(false));
+  EXPECT_CALL(*uop2, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  input.getHeadSlots()[0] = uop2Ptr;
+  diUnit.tick();
+
+  // Youngest instruction is immediately ready
+  MockInstruction* uop3 = new MockInstruction;
+  std::shared_ptr<Instruction> uop3Ptr(uop3);
+  EXPECT_CALL(*uop3, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop3, getSourceRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  EXPECT_CALL(*uop3, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(noRegs)));
+  input.getHeadSlots()[0] = uop3Ptr;
+  diUnit.tick();
+
+  // Wake up the second instruction after the youngest became ready
+  std::array<RegisterValue, 1> vals = {RegisterValue(6)};
+  EXPECT_CALL(*uop2, supplyOperand(0, vals[0]));
+  EXPECT_CALL(*uop2, canExecute()).WillOnce(Return(true));
+  diUnit.forwardOperands(span<Register>(destRegs), vals);
+
+  EXPECT_CALL(portAlloc, issued(EAGA)).Times(3);
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uopPtr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uop2Ptr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uop3Ptr);
+
+  std::vector<uint32_t> rsSizes;
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes, refRsSizes);
+}
+
+// Load predicted to depend on an in-flight store is held in the reservation
+// station until the store has generated its addresses
+TEST_F(PipelineDispatchIssueUnitTest, memoryDependence) {
+  const std::vector<uint16_t> suppPorts = {EAGA};
+  std::array<Register, 0> regs = {};
+
+  // Train the predictor such that the load depends on the store
+  uopPtr->setSequenceId(0);
+  uopPtr->setInstructionAddress(0x80);
+  uop2Ptr->setSequenceId(1);
+  uop2Ptr->setInstructionAddress(0x100);
+  storeSets.update(uop2Ptr, uopPtr);
+
+  // Dispatch the store
+  EXPECT_CALL(*uop, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop, getSourceRegisters())
+      .WillOnce(Return(span<Register>(regs)));
+  EXPECT_CALL(*uop, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(regs)));
+  EXPECT_CALL(*uop, isLoad()).WillOnce(Return(false));
+  EXPECT_CALL(*uop, isStoreAddress()).WillOnce(Return(true));
+  EXPECT_CALL(portAlloc, allocate(suppPorts)).WillRepeatedly(Return(EAGA));
+  input.getHeadSlots()[0] = uopPtr;
+  diUnit.tick();
+
+  // Dispatch the load
+  EXPECT_CALL(*uop2, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop2, getSourceRegisters())
+      .WillOnce(Return(span<Register>(regs)));
+  EXPECT_CALL(*uop2, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(regs)));
+  EXPECT_CALL(*uop2, isLoad()).WillOnce(Return(true));
+  input.getHeadSlots()[0] = uop2Ptr;
+  diUnit.tick();
+  EXPECT_EQ(storeSets.getPredictedDependenciesCount(), 1);
+
+  // Only the store can be issued
+  EXPECT_CALL(portAlloc, issued(EAGA)).Times(2);
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uopPtr);
+  output[EAGA].getTailSlots()[0] = nullptr;
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], nullptr);
+  EXPECT_EQ(diUnit.getBackendStalls(), 1);
+
+  // Release the load once the store has generated its addresses
+  EXPECT_CALL(*uop2, canExecute()).WillOnce(Return(true));
+  diUnit.releaseMemoryDependents(uopPtr);
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], uop2Ptr);
+
+  std::vector<uint32_t> rsSizes;
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes, refRsSizes);
+}
+
+// Flushed load held on a predicted store dependence is removed from the
+// reservation station
+TEST_F(PipelineDispatchIssueUnitTest, purgeFlushedMemoryDependence) {
+  const std::vector<uint16_t> suppPorts = {EAGA};
+  std::array<Register, 0> regs = {};
+
+  uopPtr->setSequenceId(0);
+  uopPtr->setInstructionAddress(0x80);
+  uop2Ptr->setSequenceId(1);
+  uop2Ptr->setInstructionAddress(0x100);
+  storeSets.update(uop2Ptr, uopPtr);
+  storeSets.dispatchStore(uopPtr);
+
+  // Dispatch the load
+  EXPECT_CALL(*uop2, getSupportedPorts()).WillOnce(ReturnRef(suppPorts));
+  EXPECT_CALL(*uop2, getSourceRegisters())
+      .WillOnce(Return(span<Register>(regs)));
+  EXPECT_CALL(*uop2, getDestinationRegisters())
+      .WillOnce(Return(span<Register>(regs)));
+  EXPECT_CALL(*uop2, isLoad()).WillOnce(Return(true));
+  EXPECT_CALL(portAlloc, allocate(suppPorts)).WillOnce(Return(EAGA));
+  input.getHeadSlots()[0] = uop2Ptr;
+  diUnit.tick();
+
+  std::vector<uint32_t> rsSizes;
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes[RS_EAGA], refRsSizes[RS_EAGA] - 1);
+
+  // Flush both the store and the load
+  EXPECT_CALL(portAlloc, deallocate(EAGA)).Times(1);
+  uopPtr->setFlushed();
+  uop2Ptr->setFlushed();
+  diUnit.purgeFlushed();
+
+  rsSizes.clear();
+  diUnit.getRSSizes(rsSizes);
+  EXPECT_EQ(rsSizes, refRsSizes);
+
+  // The flushed store should no longer be predicted
+  EXPECT_EQ(storeSets.predictDependency(uop2Ptr), nullptr);
+
+  // Releasing the flushed store should not issue the load
+  diUnit.releaseMemoryDependents(uopPtr);
+  diUnit.issue();
+  EXPECT_EQ(output[EAGA].getTailSlots()[0], nullptr);
+}
+
 // Test based on a64fx config file reservation staion configuration
 TEST_F(PipelineDispatchIssueUnitTest, getRSSizes) {
   std::vector<uint32_t> rsSizes;
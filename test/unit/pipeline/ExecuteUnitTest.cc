@@ -212,6 +212,27 @@ TEST_F(PipelineExecuteUnitTest, PipelineStall) {
   EXPECT_EQ(output.getTailSlots()[0].get(), uop);
 }
 
+// Test that the unit only reports itself as active while it has an instruction
+// waiting or in progress
+TEST_F(PipelineExecuteUnitTest, isActive) {
+  EXPECT_FALSE(executeUnit.isActive());
+
+  input.getHeadSlots()[0] = uopPtr;
+  uop->setLatency(3);
+  uop->setStallCycles(3);
+  ON_CALL(*uop, canExecute()).WillByDefault(Return(true));
+  EXPECT_CALL(*uop, execute()).Times(1);
+  EXPECT_TRUE(executeUnit.isActive());
+
+  executeUnit.tick();
+  EXPECT_TRUE(executeUnit.isActive());
+  executeUnit.tick();
+  EXPECT_TRUE(executeUnit.isActive());
+  executeUnit.tick();
+  EXPECT_EQ(output.getTailSlots()[0].get(), uop);
+  EXPECT_FALSE(executeUnit.isActive());
+}
+
 // Test that operation stalling functions correctly by stalling similar
 // operations within the same unit
 TEST_F(PipelineExecuteUnitTest, OperationStall) {
@@ -293,6 +314,9 @@ TEST_F(PipelineExecuteUnitTest, mispredictedBranch) {
   EXPECT_EQ(output.getTailSlots()[0].get(), uop);
   EXPECT_EQ(executeUnit.getFlushAddress(), pc);
   EXPECT_EQ(executeUnit.getFlushInsnId(), insnID);
+
+  // The unit must be ticked again to clear the flush
+  EXPECT_TRUE(executeUnit.isActive());
 }
 
 // Test that the flushing mechansim works correctly via purgeFlushed()
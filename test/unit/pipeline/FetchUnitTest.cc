@@ -1,3 +1,5 @@
+#include <array>
+
 #include "../MockArchitecture.hh"
 #include "../MockBranchPredictor.hh"
 #include "../MockInstruction.hh"
@@ -810,6 +812,153 @@ TEST_P(PipelineFetchUnitTest, branchesFetchedCountedIncorrectly) {
   EXPECT_EQ(fetchUnit.getBranchFetchedCount(), 6);
 }
 
+// Tests that instructions predecoded from instruction memory are later supplied
+// by the micro-op cache, without reading instruction memory
+TEST_P(PipelineFetchUnitTest, MicroOpCacheSupply) {
+  MicroOpCache microOpCache(12, 2, 6, blockSize);
+  FetchUnit cachingFetchUnit(output, memory, 1024, 0, blockSize, isa,
+                             predictor, &microOpCache);
+  MacroOp macroOp = {uopPtr};
+
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  ON_CALL(memory, getCompletedReads()).WillByDefault(Return(completedReads));
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(macroOp), Return(4)));
+
+  // A branch at address 0 predicted to branch back to itself
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(true));
+  ON_CALL(predictor, predict(0, _, _))
+      .WillByDefault(Return(BranchPrediction{true, 0}));
+
+  // Predecode the branch from instruction memory, filling the micro-op cache
+  EXPECT_CALL(isa, predecode(_, _, 0, _)).Times(1);
+  cachingFetchUnit.tick();
+  EXPECT_EQ(output.getTailSlots()[0].size(), 1);
+  EXPECT_EQ(cachingFetchUnit.getMicroOpCacheHits(), 0);
+  EXPECT_EQ(cachingFetchUnit.getMicroOpCacheMisses(), 1);
+
+  // As the micro-op cache holds the branch, no fetch block is requested
+  EXPECT_CALL(memory, requestRead(_, _)).Times(0);
+  cachingFetchUnit.requestFromPC();
+
+  // Supply the branch from the micro-op cache
+  output.getTailSlots()[0].clear();
+  EXPECT_CALL(memory, getCompletedReads()).Times(0);
+  EXPECT_CALL(isa, predecode(_, 4, 0, _)).Times(1);
+  cachingFetchUnit.tick();
+  EXPECT_EQ(output.getTailSlots()[0].size(), 1);
+  EXPECT_EQ(cachingFetchUnit.getMicroOpCacheHits(), 1);
+  EXPECT_EQ(cachingFetchUnit.getMicroOpCacheMisses(), 1);
+  EXPECT_EQ(cachingFetchUnit.getBranchFetchedCount(), 2);
+}
+
+// Tests that a micro-op cache lookup which misses is counted once, however many
+// instructions are then predecoded from instruction memory
+TEST_P(PipelineFetchUnitTest, MicroOpCacheMissCountedPerLookup) {
+  PipelineBuffer<MacroOp> wideOutput(2, {});
+  MicroOpCache microOpCache(12, 2, 6, blockSize);
+  FetchUnit cachingFetchUnit(wideOutput, memory, 1024, 0, blockSize, isa,
+                             predictor, &microOpCache);
+  MacroOp macroOp = {uopPtr};
+
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  ON_CALL(memory, getCompletedReads()).WillByDefault(Return(completedReads));
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(macroOp), Return(4)));
+
+  // Predecode two instructions from instruction memory after a single lookup
+  EXPECT_CALL(isa, predecode(_, _, _, _)).Times(2);
+  cachingFetchUnit.tick();
+  EXPECT_EQ(wideOutput.getTailSlots()[0].size(), 1);
+  EXPECT_EQ(wideOutput.getTailSlots()[1].size(), 1);
+  EXPECT_EQ(cachingFetchUnit.getMicroOpCacheHits(), 0);
+  EXPECT_EQ(cachingFetchUnit.getMicroOpCacheMisses(), 1);
+}
+
+// Tests that the fetch target queue prefetches sequential blocks ahead of
+// fetch, which are then supplied to fetch from the queue
+TEST_P(PipelineFetchUnitTest, FetchTargetQueuePrefetch) {
+  // The block required by fetch is requested, followed by a single prefetched
+  // block each cycle until the queue is full
+  EXPECT_CALL(memory, requestRead(Field(&memory::MemoryAccessTarget::address,
+                                        AnyOf(0, 16, 32, 48)),
+                                  _))
+      .Times(4);
+  FetchUnit ftqFetchUnit(output, memory, 1024, 0, blockSize, isa, predictor,
+                         nullptr, 4);
+  ftqFetchUnit.requestFromPC();
+  ftqFetchUnit.requestFromPC();
+  ftqFetchUnit.requestFromPC();
+  EXPECT_EQ(ftqFetchUnit.getPrefetchesIssued(), 3);
+  EXPECT_EQ(ftqFetchUnit.getAverageFetchTargetQueueOccupancy(), 3.25);
+
+  MacroOp macroOp = {uopPtr};
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(macroOp), Return(4)));
+
+  // The first two blocks' reads complete together
+  std::array<memory::MemoryReadResult, 2> reads = {
+      memory::MemoryReadResult{{0, blockSize}, RegisterValue(0, blockSize), 1},
+      memory::MemoryReadResult{{16, blockSize}, RegisterValue(0, blockSize),
+                               1}};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(reads)));
+
+  // Tick 5 times to process the 16 bytes of the first block, and the first
+  // instruction of the prefetched second block
+  EXPECT_CALL(isa, predecode(_, _, _, _)).Times(5);
+  for (int i = 0; i < 5; i++) {
+    ftqFetchUnit.tick();
+  }
+  EXPECT_EQ(ftqFetchUnit.getPrefetchesUsed(), 1);
+}
+
+// Tests that the fetch target queue follows the path of fetch blocks taken
+// when they were previously fetched
+TEST_P(PipelineFetchUnitTest, FetchTargetQueueFollowsRedirection) {
+  EXPECT_CALL(memory, requestRead(_, _)).Times(AnyNumber());
+  FetchUnit ftqFetchUnit(output, memory, 1024, 0, blockSize, isa, predictor,
+                         nullptr, 4);
+
+  MacroOp macroOp = {uopPtr};
+  ON_CALL(isa, getMaxInstructionSize()).WillByDefault(Return(insnMaxSizeBytes));
+  ON_CALL(isa, getMinInstructionSize()).WillByDefault(Return(insnMinSizeBytes));
+  ON_CALL(isa, predecode(_, _, _, _))
+      .WillByDefault(DoAll(SetArgReferee<3>(macroOp), Return(4)));
+
+  // A branch at address 0 predicted to branch to address 64
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(true));
+  ON_CALL(predictor, predict(0, _, _))
+      .WillByDefault(Return(BranchPrediction{true, 64}));
+
+  std::array<memory::MemoryReadResult, 2> reads = {
+      memory::MemoryReadResult{{0, blockSize}, RegisterValue(0, blockSize), 1},
+      memory::MemoryReadResult{{64, blockSize}, RegisterValue(0, blockSize),
+                               1}};
+  ON_CALL(memory, getCompletedReads())
+      .WillByDefault(Return(span<memory::MemoryReadResult>(reads)));
+
+  // Fetch the branch, then the block at its target
+  ftqFetchUnit.tick();
+  ftqFetchUnit.requestFromPC();
+  ftqFetchUnit.tick();
+
+  // Once redirected back to the branch, the block at its target is prefetched
+  // in place of the next sequential block
+  ftqFetchUnit.updatePC(0);
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 0), _))
+      .Times(1);
+  EXPECT_CALL(memory,
+              requestRead(Field(&memory::MemoryAccessTarget::address, 64), _))
+      .Times(1);
+  ftqFetchUnit.requestFromPC();
+}
+
 INSTANTIATE_TEST_SUITE_P(PipelineFetchUnitTests, PipelineFetchUnitTest,
                          ::testing::Values(std::pair(2, 4), std::pair(4, 4)));
 
@@ -0,0 +1,142 @@
+#include "../MockInstruction.hh"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/FusedInstruction.hh"
+
+namespace simeng {
+namespace pipeline {
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Return;
+
+class FusedInstructionTest : public testing::Test {
+ public:
+  FusedInstructionTest()
+      : first(new MockInstruction),
+        second(new MockInstruction),
+        firstPtr(first),
+        secondPtr(second) {
+    // The first instruction reads r0 and writes r1; the second reads r1 and r2
+    // and writes r1
+    ON_CALL(*first, getSourceRegisters())
+        .WillByDefault(Return(span<Register>(firstSources)));
+    ON_CALL(*first, getDestinationRegisters())
+        .WillByDefault(Return(span<Register>(firstDestinations)));
+    ON_CALL(*second, getSourceRegisters())
+        .WillByDefault(Return(span<Register>(secondSources)));
+    ON_CALL(*second, getDestinationRegisters())
+        .WillByDefault(Return(span<Register>(secondDestinations)));
+  }
+
+ protected:
+  const Register r0 = {0, 0};
+  const Register r1 = {0, 1};
+  const Register r2 = {0, 2};
+
+  std::array<Register, 1> firstSources = {r0};
+  std::array<Register, 1> firstDestinations = {r1};
+  std::array<Register, 2> secondSources = {r1, r2};
+  std::array<Register, 1> secondDestinations = {r1};
+
+  MockInstruction* first;
+  MockInstruction* second;
+  std::shared_ptr<Instruction> firstPtr;
+  std::shared_ptr<Instruction> secondPtr;
+};
+
+// Tests that the operands of both instructions are renamed and supplied through
+// the macro-op, other than those the first instruction produces
+TEST_F(FusedInstructionTest, operands) {
+  FusedInstruction fused(firstPtr, secondPtr, {1, 1, {0}});
+
+  auto sources = fused.getSourceRegisters();
+  ASSERT_EQ(sources.size(), 2);
+  EXPECT_EQ(sources[0], r0);
+  EXPECT_EQ(sources[1], r2);
+  // The destination written by both instructions is renamed once, for both
+  auto destinations = fused.getDestinationRegisters();
+  ASSERT_EQ(destinations.size(), 1);
+  EXPECT_EQ(destinations[0], r1);
+  EXPECT_FALSE(fused.canExecute());
+
+  EXPECT_CALL(*second, renameSource(1, Register{0, 7}));
+  fused.renameSource(1, {0, 7});
+  EXPECT_CALL(*second, renameDestination(0, Register{0, 8}));
+  EXPECT_CALL(*first, renameDestination(0, Register{0, 8}));
+  fused.renameDestination(0, {0, 8});
+
+  EXPECT_CALL(*first, supplyOperand(0, _));
+  fused.supplyOperand(0, RegisterValue(1, 8));
+  EXPECT_CALL(*second, supplyOperand(1, _));
+  fused.supplyOperand(1, RegisterValue(2, 8));
+  EXPECT_TRUE(fused.canExecute());
+}
+
+// Tests that destinations of the first instruction which the second doesn't
+// write are renamed separately, ahead of those of the second
+TEST_F(FusedInstructionTest, unsharedDestinations) {
+  const Register r3 = {0, 3};
+  std::array<Register, 2> destinations = {r3, r1};
+  ON_CALL(*first, getDestinationRegisters())
+      .WillByDefault(Return(span<Register>(destinations)));
+  FusedInstruction fused(firstPtr, secondPtr, {1, 1, {0}});
+
+  auto fusedDestinations = fused.getDestinationRegisters();
+  ASSERT_EQ(fusedDestinations.size(), 2);
+  EXPECT_EQ(fusedDestinations[0], r3);
+  EXPECT_EQ(fusedDestinations[1], r1);
+
+  EXPECT_CALL(*first, renameDestination(0, Register{0, 8}));
+  fused.renameDestination(0, {0, 8});
+  EXPECT_CALL(*second, renameDestination(0, Register{0, 9}));
+  EXPECT_CALL(*first, renameDestination(1, Register{0, 9}));
+  fused.renameDestination(1, {0, 9});
+
+  fused.supplyOperand(0, RegisterValue(1, 8));
+  fused.supplyOperand(1, RegisterValue(2, 8));
+  std::array<RegisterValue, 2> firstResults = {RegisterValue(4, 8),
+                                               RegisterValue(3, 8)};
+  std::array<RegisterValue, 1> secondResults = {RegisterValue(5, 8)};
+  ON_CALL(*first, getResults())
+      .WillByDefault(Return(span<RegisterValue>(firstResults)));
+  ON_CALL(*second, getResults())
+      .WillByDefault(Return(span<RegisterValue>(secondResults)));
+  fused.execute();
+
+  auto results = fused.getResults();
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].get<uint64_t>(), 4);
+  EXPECT_EQ(results[1].get<uint64_t>(), 5);
+}
+
+// Tests that executing the macro-op forwards the results of the first
+// instruction to the second, and collects the results of both, keeping only
+// the second's value of a destination they share
+TEST_F(FusedInstructionTest, execute) {
+  FusedInstruction fused(firstPtr, secondPtr, {1, 1, {0}});
+  fused.supplyOperand(0, RegisterValue(1, 8));
+  fused.supplyOperand(1, RegisterValue(2, 8));
+
+  std::array<RegisterValue, 1> firstResults = {RegisterValue(3, 8)};
+  std::array<RegisterValue, 1> secondResults = {RegisterValue(5, 8)};
+  ON_CALL(*first, getResults())
+      .WillByDefault(Return(span<RegisterValue>(firstResults)));
+  ON_CALL(*second, getResults())
+      .WillByDefault(Return(span<RegisterValue>(secondResults)));
+  {
+    InSequence seq;
+    EXPECT_CALL(*first, execute());
+    EXPECT_CALL(*second, supplyOperand(0, _));
+    EXPECT_CALL(*second, execute());
+  }
+  fused.execute();
+
+  EXPECT_TRUE(fused.hasExecuted());
+  auto results = fused.getResults();
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].get<uint64_t>(), 5);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
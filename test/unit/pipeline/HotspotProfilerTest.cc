@@ -0,0 +1,155 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/HotspotProfiler.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class PipelineHotspotProfilerTest : public testing::Test {
+ public:
+  PipelineHotspotProfilerTest() : profiler(1) {}
+
+ protected:
+  /** The stall counts of a cycle in which no stalls were counted. */
+  const std::array<uint64_t, STALL_CAUSE_COUNT> noStalls = {};
+
+  /** Retrieve the stall cycles of `cause` attributed to `address`. */
+  uint64_t getStalls(uint64_t address, StallCause cause) {
+    const auto& entry = profiler.getEntries().at(address);
+    return entry.stalls[static_cast<size_t>(cause)];
+  }
+
+  HotspotProfiler profiler;
+};
+
+// Tests that a cycle is shared between the instructions retiring in it, and
+// that cycles without retirement are attributed to the head of the ROB
+TEST_F(PipelineHotspotProfilerTest, RetireAndHead) {
+  profiler.retire(0, 0x10, 1, false, false);
+  profiler.retire(0, 0x14, 1, false, false);
+  profiler.endCycle(0, false, 0x18, noStalls);
+
+  std::array<uint64_t, STALL_CAUSE_COUNT> stalls = {};
+  stalls[static_cast<size_t>(StallCause::ROB)] = 1;
+  stalls[static_cast<size_t>(StallCause::PortBusy)] = 2;
+  profiler.endCycle(0, false, 0x18, stalls);
+  profiler.endCycle(0, false, 0x18, stalls);
+  profiler.retire(0, 0x18, 1, false, false);
+  profiler.endCycle(0, false, 0x1c, noStalls);
+
+  const auto& entries = profiler.getEntries();
+  EXPECT_DOUBLE_EQ(entries.at(0x10).cycles, 0.5);
+  EXPECT_DOUBLE_EQ(entries.at(0x14).cycles, 0.5);
+  EXPECT_DOUBLE_EQ(entries.at(0x18).cycles, 3.0);
+  EXPECT_EQ(entries.at(0x18).retired, 1);
+  EXPECT_EQ(getStalls(0x18, StallCause::ROB), 2);
+  EXPECT_EQ(getStalls(0x18, StallCause::PortBusy), 4);
+  EXPECT_EQ(getStalls(0x18, StallCause::Frontend), 0);
+}
+
+// Tests that cycles spent with an empty ROB are attributed to the next
+// instruction to retire
+TEST_F(PipelineHotspotProfilerTest, Frontend) {
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.endCycle(0, false, 0x40, noStalls);
+  EXPECT_DOUBLE_EQ(profiler.getEntries().at(0x40).cycles, 1.0);
+
+  profiler.retire(0, 0x40, 1, false, false);
+  profiler.endCycle(0, true, 0, noStalls);
+  EXPECT_DOUBLE_EQ(profiler.getEntries().at(0x40).cycles, 4.0);
+  EXPECT_EQ(getStalls(0x40, StallCause::Frontend), 2);
+}
+
+// Tests that cycles spent with an empty ROB after a misprediction or exception
+// are attributed to the instruction responsible, until the ROB refills
+TEST_F(PipelineHotspotProfilerTest, Recovery) {
+  profiler.retire(0, 0x80, 1, true, false);
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.endCycle(0, false, 0x100, noStalls);
+  // The ROB refilled, so further empty cycles await the next instruction
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.retire(0, 0x100, 1, false, false);
+  profiler.endCycle(0, true, 0, noStalls);
+
+  profiler.retire(0, 0x104, 1, false, true);
+  profiler.endCycle(0, true, 0, noStalls);
+  profiler.endCycle(0, true, 0, noStalls);
+
+  const auto& entries = profiler.getEntries();
+  EXPECT_EQ(entries.at(0x80).mispredicts, 1);
+  EXPECT_DOUBLE_EQ(entries.at(0x80).cycles, 3.0);
+  EXPECT_EQ(getStalls(0x80, StallCause::Recovery), 2);
+  EXPECT_DOUBLE_EQ(entries.at(0x100).cycles, 3.0);
+  EXPECT_EQ(getStalls(0x100, StallCause::Frontend), 1);
+  EXPECT_DOUBLE_EQ(entries.at(0x104).cycles, 2.0);
+  EXPECT_EQ(getStalls(0x104, StallCause::Recovery), 1);
+
+  // Every cycle is attributed
+  double cycles = 0.0;
+  for (const auto& [address, entry] : entries) cycles += entry.cycles;
+  EXPECT_DOUBLE_EQ(cycles, 8.0);
+}
+
+// Tests that load latencies are accumulated per address
+TEST_F(PipelineHotspotProfilerTest, Loads) {
+  profiler.completeLoad(0x200, 4);
+  profiler.completeLoad(0x200, 10);
+  EXPECT_EQ(profiler.getEntries().at(0x200).loads, 2);
+  EXPECT_EQ(profiler.getEntries().at(0x200).loadLatency, 14);
+}
+
+// Tests that addresses are named by the function holding them
+TEST_F(PipelineHotspotProfilerTest, Symbolise) {
+  profiler.setSymbols(
+      {{"_start", 0x400, 0x20}, {"main", 0x500, 0}, {"exit", 0x600, 0}});
+  EXPECT_EQ(profiler.symbolise(0x3fc), "");
+  EXPECT_EQ(profiler.symbolise(0x400), "_start");
+  EXPECT_EQ(profiler.symbolise(0x41c), "_start+0x1c");
+  EXPECT_EQ(profiler.symbolise(0x420), "");
+  // Functions of an unknown size extend up to the next function
+  EXPECT_EQ(profiler.symbolise(0x5f0), "main+0xf0");
+  EXPECT_EQ(profiler.symbolise(0x600), "");
+}
+
+// Tests that the written profile lists functions and addresses by descending
+// cycles
+TEST_F(PipelineHotspotProfilerTest, Write) {
+  profiler.setSymbols({{"init", 0x1000, 0x100}, {"kernel", 0x2000, 0x100}});
+  profiler.retire(0, 0x1000, 1, false, false);
+  profiler.endCycle(0, false, 0x2000, noStalls);
+  for (int i = 0; i < 3; i++) profiler.endCycle(0, false, 0x2004, noStalls);
+  profiler.retire(0, 0x2000, 1, false, false);
+  profiler.endCycle(0, false, 0x2004, noStalls);
+  profiler.retire(0, 0x2004, 1, false, false);
+  profiler.endCycle(0, false, 0x3000, noStalls);
+  profiler.endCycle(0, false, 0x3000, noStalls);
+  profiler.endCycle(0, false, 0x3000, noStalls);
+
+  std::ostringstream out;
+  profiler.write(out);
+  std::string profile = out.str();
+  EXPECT_THAT(profile, testing::HasSubstr("8 cycles, 3 instructions retired"));
+  auto kernel = profile.find("  kernel\n");
+  auto init = profile.find("  init\n");
+  auto unknown = profile.find("  [unknown]\n");
+  ASSERT_NE(kernel, std::string::npos);
+  ASSERT_NE(init, std::string::npos);
+  ASSERT_NE(unknown, std::string::npos);
+  EXPECT_LT(kernel, init);
+  EXPECT_LT(unknown, init);
+
+  auto hottest = profile.find("  0x2004 kernel+0x4\n");
+  auto head = profile.find("  0x2000 kernel\n");
+  ASSERT_NE(hottest, std::string::npos);
+  ASSERT_NE(head, std::string::npos);
+  EXPECT_LT(hottest, head);
+  EXPECT_NE(profile.find("  0x3000\n"), std::string::npos);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -65,7 +65,10 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
                           uint16_t storeBandwidth = UINT16_MAX,
                           uint16_t permittedRequests = UINT16_MAX,
                           uint16_t permittedLoads = UINT16_MAX,
-                          uint16_t permittedStores = UINT16_MAX) {
+                          uint16_t permittedStores = UINT16_MAX,
+                          bool coalesceRequests = false,
+                          uint16_t cacheLineWidth = 64,
+                          uint16_t forwardingLatency = 4) {
     if (GetParam()) {
       // Combined queue
       return LoadStoreQueue(
@@ -75,7 +78,8 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
             forwardOperandsHandler.forwardOperands(registers, values);
           },
           [](auto uop) {}, exclusive, loadBandwidth, storeBandwidth,
-          permittedRequests, permittedLoads, permittedStores);
+          permittedRequests, permittedLoads, permittedStores, coalesceRequests,
+          cacheLineWidth, forwardingLatency);
     } else {
       // Split queue
       return LoadStoreQueue(
@@ -85,7 +89,8 @@ class LoadStoreQueueTest : public ::testing::TestWithParam<bool> {
             forwardOperandsHandler.forwardOperands(registers, values);
           },
           [](auto uop) {}, exclusive, loadBandwidth, storeBandwidth,
-          permittedRequests, permittedLoads, permittedStores);
+          permittedRequests, permittedLoads, permittedStores, coalesceRequests,
+          cacheLineWidth, forwardingLatency);
     }
   }
 
@@ -319,6 +324,42 @@ TEST_P(LoadStoreQueueTest, Load) {
   EXPECT_EQ(completionSlots[0].getTailSlots()[0].get(), loadUop);
 }
 
+// Tests that the queue only reports itself as active while it has requests to
+// send or responses to process
+TEST_P(LoadStoreQueueTest, isActive) {
+  loadUop->setSequenceId(1);
+  auto queue = getQueue();
+
+  memory::MemoryReadResult completedRead = {addresses[0], data[0], 1};
+  span<memory::MemoryReadResult> completedReads = {&completedRead, 1};
+
+  // Set load instruction attributes
+  EXPECT_CALL(*loadUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(addressesSpan));
+  loadUop->setLSQLatency(1);
+
+  EXPECT_CALL(dataMemory, getCompletedReads())
+      .WillRepeatedly(Return(span<memory::MemoryReadResult>()));
+  EXPECT_FALSE(queue.isActive());
+
+  queue.addLoad(loadUopPtr);
+  EXPECT_FALSE(queue.isActive());
+
+  // The load's request is waiting to be sent
+  queue.startLoad(loadUopPtr);
+  EXPECT_TRUE(queue.isActive());
+
+  EXPECT_CALL(dataMemory, requestRead(addresses[0], _)).Times(1);
+  queue.tick();
+  EXPECT_FALSE(queue.isActive());
+
+  // The response to the load's request has arrived
+  EXPECT_CALL(dataMemory, getCompletedReads())
+      .WillRepeatedly(Return(completedReads));
+  EXPECT_TRUE(queue.isActive());
+}
+
 // Tests that a queue can perform a load with no addresses
 TEST_P(LoadStoreQueueTest, LoadWithNoAddresses) {
   loadUop->setSequenceId(1);
@@ -840,9 +881,9 @@ TEST_P(LoadStoreQueueTest, FlushDuringConfliction) {
   queue.tick();
 }
 
-// Test that a load access exactly conflicting on a store access (matching
-// address and access size no larger) gets its data supplied when the store
-// commits
+// Test that a load access contained within an older store access has the
+// store's data forwarded to it, whilst an access only partially overlapping the
+// store is requested from memory once the store commits
 TEST_P(LoadStoreQueueTest, SupplyDataToConfliction) {
   auto queue = getQueue();
 
@@ -880,25 +921,321 @@ TEST_P(LoadStoreQueueTest, SupplyDataToConfliction) {
   queue.addStore(storeUopPtr);
   queue.addLoad(loadUopPtr);
 
-  // Supply store data so the store can commit
+  // Supply store data so it can be forwarded
   queue.supplyStoreData(storeUopPtr);
 
-  // Start the load so the confliction can be registered
+  // Start the load so the conflictions can be registered
   queue.startLoad(loadUopPtr);
 
-  // Two of the accesses don't exactly conflict so they should generate memory
-  // accesses
-  EXPECT_CALL(dataMemory, requestRead(loadAddresses[1], 1)).Times(1);
+  // Only the access which doesn't overlap a store access should generate a
+  // memory access
+  EXPECT_CALL(dataMemory, requestRead(loadAddresses[1], _)).Times(0);
   EXPECT_CALL(dataMemory, requestRead(loadAddresses[2], 1)).Times(1);
+
+  // The access contained within a store access should get its data forwarded
+  // once the forwarding latency has elapsed
+  EXPECT_CALL(*loadUop, supplyData(_, _)).Times(0);
+  for (int i = 0; i < 3; i++) queue.tick();
+  EXPECT_CALL(*loadUop,
+              supplyData(loadAddresses[0].address,
+                         Property(&RegisterValue::get<uint8_t>, 0x01)))
+      .Times(1);
   queue.tick();
 
-  // The one access which does exactly conflict with a store access should get
-  // its data supplied on the store's commitment
+  // As the load took its data from the store, no violation should be detected
+  // when it commits. The partially overlapping access can now be requested
+  EXPECT_FALSE(queue.commitStore(storeUopPtr));
+  EXPECT_CALL(dataMemory, requestRead(loadAddresses[1], 1)).Times(1);
+  queue.tick();
+
+  EXPECT_EQ(queue.getForwardedAccessesCount(), 1);
+  EXPECT_EQ(queue.getStalledAccessesCount(), 1);
+}
+
+// Test that a load conflicting with a store whose data isn't yet available has
+// the data forwarded to it once supplied
+TEST_P(LoadStoreQueueTest, ForwardOnStoreData) {
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, false, 64, 2);
+
+  // The store is split into an address and a data micro-op
+  storeUop->setSequenceId(0);
+  storeUop->setInstructionId(0);
+  storeUop2->setSequenceId(1);
+  storeUop2->setInstructionId(0);
+  loadUop->setSequenceId(2);
+  loadUop->setInstructionId(1);
+  ON_CALL(*storeUop, isStoreData()).WillByDefault(Return(false));
+  ON_CALL(*storeUop2, isStoreData()).WillByDefault(Return(true));
+
+  // The store writes 4 bytes, of which the load reads the middle two
+  std::vector<memory::MemoryAccessTarget> storeAddresses = {{8, 4}};
+  span<const memory::MemoryAccessTarget> storeAddressesSpan = {
+      storeAddresses.data(), storeAddresses.size()};
+  std::vector<RegisterValue> storeData = {static_cast<uint32_t>(0x44332211)};
+  span<const RegisterValue> storeDataSpan = {storeData.data(),
+                                             storeData.size()};
+  EXPECT_CALL(*storeUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(storeAddressesSpan));
+  EXPECT_CALL(*storeUop2, getData())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(storeDataSpan));
+
+  std::vector<memory::MemoryAccessTarget> loadAddresses = {{9, 2}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan = {
+      loadAddresses.data(), loadAddresses.size()};
+  EXPECT_CALL(*loadUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(loadAddressesSpan));
+
+  queue.addStore(storeUopPtr);
+  queue.addLoad(loadUopPtr);
+
+  // Generate the store's addresses before starting the load
+  queue.supplyStoreData(storeUopPtr);
+  queue.startLoad(loadUopPtr);
+
+  // No data is available to forward, and the load mustn't read from memory
+  EXPECT_CALL(dataMemory, requestRead(_, _)).Times(0);
+  EXPECT_CALL(*loadUop, supplyData(_, _)).Times(0);
+  for (int i = 0; i < 4; i++) queue.tick();
+
+  // Supply the store's data, which should be forwarded after two cycles
+  queue.supplyStoreData(storeUopPtr2);
+  queue.tick();
   EXPECT_CALL(*loadUop,
               supplyData(loadAddresses[0].address,
-                         Property(&RegisterValue::get<uint8_t>, storeData[0])))
+                         Property(&RegisterValue::get<uint16_t>, 0x3322)))
       .Times(1);
+  queue.tick();
+
+  EXPECT_EQ(queue.getForwardedAccessesCount(), 1);
+  EXPECT_EQ(queue.getStalledAccessesCount(), 0);
+}
+
+// Test that a load overlapping multiple older stores on the same address only
+// has data forwarded to it by the most recent of those stores
+TEST_P(LoadStoreQueueTest, ForwardFromYoungestStore) {
+  auto queue = getQueue();
+
+  storeUop->setSequenceId(0);
+  storeUop->setInstructionId(0);
+  storeUop2->setSequenceId(1);
+  storeUop2->setInstructionId(1);
+  loadUop->setSequenceId(2);
+  loadUop->setInstructionId(2);
+
+  std::vector<RegisterValue> storeData2 = {static_cast<uint8_t>(0x10)};
+  span<const RegisterValue> storeDataSpan2 = {storeData2.data(),
+                                              storeData2.size()};
+  ON_CALL(*storeUop2, isStoreAddress()).WillByDefault(Return(true));
+  ON_CALL(*storeUop2, isStoreData()).WillByDefault(Return(true));
+  EXPECT_CALL(*storeUop2, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(addressesSpan));
+  EXPECT_CALL(*storeUop2, getData())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(storeDataSpan2));
+
+  queue.addStore(storeUopPtr);
+  queue.addStore(storeUopPtr2);
+  queue.addLoad(loadUopPtr);
+
+  // Supply the younger store's data first, such that the order the stores are
+  // discovered in doesn't match the program order
+  queue.supplyStoreData(storeUopPtr2);
+  queue.supplyStoreData(storeUopPtr);
+
+  // Both stores conflict with the load so no read requests should be made, and
+  // only the younger store's data should be forwarded
+  queue.startLoad(loadUopPtr);
+  EXPECT_CALL(dataMemory, requestRead(_, _)).Times(0);
+  EXPECT_CALL(*loadUop,
+              supplyData(addresses[0].address,
+                         Property(&RegisterValue::get<uint8_t>, 0x10)))
+      .Times(1);
+  for (int i = 0; i < 4; i++) queue.tick();
+
+  // Neither store should detect a violation with the load
+  EXPECT_FALSE(queue.commitStore(storeUopPtr));
+  EXPECT_FALSE(queue.commitStore(storeUopPtr2));
+}
+
+// Tests that committing a store detects a violation with a load which crosses
+// into the cache line written to, and reports the oldest violating load
+TEST_P(LoadStoreQueueTest, ViolationAcrossCacheLines) {
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, false, 16);
+
+  storeUop->setSequenceId(0);
+  storeUop->setInstructionId(0);
+  loadUop->setSequenceId(2);
+  loadUop->setInstructionId(2);
+  loadUop2->setSequenceId(1);
+  loadUop2->setInstructionId(1);
+
+  // The store writes to the start of the cache line [16, 32)
+  std::vector<memory::MemoryAccessTarget> storeAddresses = {{16, 2}};
+  span<const memory::MemoryAccessTarget> storeAddressesSpan = {
+      storeAddresses.data(), storeAddresses.size()};
+  EXPECT_CALL(*storeUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(storeAddressesSpan));
+
+  // Both loads overlap the store, with the younger load residing entirely
+  // within the line and the older load crossing into it from the line [0, 16)
+  std::vector<memory::MemoryAccessTarget> loadAddresses = {{17, 1}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan = {
+      loadAddresses.data(), loadAddresses.size()};
+  EXPECT_CALL(*loadUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(loadAddressesSpan));
+  std::vector<memory::MemoryAccessTarget> loadAddresses2 = {{14, 4}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan2 = {
+      loadAddresses2.data(), loadAddresses2.size()};
+  ON_CALL(*loadUop2, isLoad()).WillByDefault(Return(true));
+  EXPECT_CALL(*loadUop2, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(loadAddressesSpan2));
+
+  queue.addStore(storeUopPtr);
+  queue.addLoad(loadUopPtr2);
+  queue.addLoad(loadUopPtr);
+
+  // Start both loads before the store's addresses are known
+  queue.startLoad(loadUopPtr);
+  queue.startLoad(loadUopPtr2);
+  queue.supplyStoreData(storeUopPtr);
+
+  EXPECT_TRUE(queue.commitStore(storeUopPtr));
+  EXPECT_EQ(queue.getViolatingLoad(), loadUopPtr2);
+}
+
+// Tests that the element accesses of a load falling within the same cache line
+// are coalesced into a single request, and the returned data is scattered back
+// to each element
+TEST_P(LoadStoreQueueTest, CoalescedLoad) {
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, true, 16);
+  loadUop->setSequenceId(1);
+
+  // Three accesses fall within the cache line [16, 32), with the final access
+  // residing in the next line
+  std::vector<memory::MemoryAccessTarget> loadAddresses = {
+      {24, 4}, {16, 4}, {20, 2}, {36, 4}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan = {
+      loadAddresses.data(), loadAddresses.size()};
+  EXPECT_CALL(*loadUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(loadAddressesSpan));
+
+  queue.addLoad(loadUopPtr);
+  queue.startLoad(loadUopPtr);
+
+  // Expect one request spanning the first three accesses and one for the
+  // remaining access
+  memory::MemoryAccessTarget lineRequest = {16, 12};
+  EXPECT_CALL(dataMemory, requestRead(lineRequest, 1)).Times(1);
+  EXPECT_CALL(dataMemory, requestRead(loadAddresses[3], 1)).Times(1);
+
+  uint8_t lineData[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  memory::MemoryReadResult completedRead = {lineRequest,
+                                            RegisterValue(lineData), 1};
+  span<memory::MemoryReadResult> completedReads = {&completedRead, 1};
+  EXPECT_CALL(dataMemory, getCompletedReads())
+      .WillRepeatedly(Return(completedReads));
+
+  // Each element access should be supplied with its slice of the line data
+  EXPECT_CALL(*loadUop,
+              supplyData(16, Property(&RegisterValue::get<uint32_t>,
+                                      0x03020100)))
+      .Times(1);
+  EXPECT_CALL(*loadUop,
+              supplyData(20, Property(&RegisterValue::get<uint16_t>, 0x0504)))
+      .Times(1);
+  EXPECT_CALL(*loadUop,
+              supplyData(24, Property(&RegisterValue::get<uint32_t>,
+                                      0x0b0a0908)))
+      .Times(1);
+  queue.tick();
+
+  EXPECT_EQ(queue.getCoalescedAccessesCount(), 3);
+  EXPECT_EQ(queue.getCoalescedRequestsCount(), 1);
+}
+
+// Tests that element accesses which cross a cache line boundary, or which would
+// exceed the load bandwidth, aren't coalesced
+TEST_P(LoadStoreQueueTest, CoalescedLoadLimits) {
+  auto queue = getQueue(false, 8, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        UINT16_MAX, true, 16);
+  loadUop->setSequenceId(1);
+
+  // The first access crosses the boundary between the lines [0, 16) and
+  // [16, 32). The remaining accesses share a line but span more bytes than the
+  // load bandwidth permits in one request
+  std::vector<memory::MemoryAccessTarget> loadAddresses = {
+      {14, 4}, {18, 4}, {22, 4}, {26, 4}};
+  span<const memory::MemoryAccessTarget> loadAddressesSpan = {
+      loadAddresses.data(), loadAddresses.size()};
+  EXPECT_CALL(*loadUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(loadAddressesSpan));
+
+  queue.addLoad(loadUopPtr);
+  queue.startLoad(loadUopPtr);
+
+  memory::MemoryAccessTarget firstPair = {18, 8};
+  memory::MemoryAccessTarget secondAccess = {26, 4};
+  EXPECT_CALL(dataMemory, requestRead(loadAddresses[0], 1)).Times(1);
+  EXPECT_CALL(dataMemory, requestRead(firstPair, 1)).Times(1);
+  EXPECT_CALL(dataMemory, requestRead(secondAccess, 1)).Times(1);
+  for (int i = 0; i < 3; i++) queue.tick();
+
+  EXPECT_EQ(queue.getCoalescedAccessesCount(), 2);
+  EXPECT_EQ(queue.getCoalescedRequestsCount(), 1);
+}
+
+// Tests that a store's element accesses falling within the same cache line only
+// contend for LSQ resources once, whilst each element is still written
+TEST_P(LoadStoreQueueTest, CoalescedStore) {
+  auto queue = getQueue(false, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX,
+                        1, true, 16);
+  storeUop->setSequenceId(1);
+  storeUop->setInstructionId(1);
+  loadUop->setSequenceId(2);
+  loadUop->setInstructionId(2);
+
+  std::vector<memory::MemoryAccessTarget> storeAddresses = {{0, 1}, {4, 1}};
+  span<const memory::MemoryAccessTarget> storeAddressesSpan = {
+      storeAddresses.data(), storeAddresses.size()};
+  std::vector<RegisterValue> storeData = {static_cast<uint8_t>(0x01),
+                                          static_cast<uint8_t>(0x10)};
+  span<const RegisterValue> storeDataSpan = {storeData.data(),
+                                             storeData.size()};
+  EXPECT_CALL(*storeUop, getGeneratedAddresses())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(storeAddressesSpan));
+  EXPECT_CALL(*storeUop, getData())
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(storeDataSpan));
+
+  queue.addStore(storeUopPtr);
+  queue.supplyStoreData(storeUopPtr);
+
+  EXPECT_CALL(dataMemory, requestWrite(storeAddresses[0], _)).Times(1);
+  EXPECT_CALL(dataMemory, requestWrite(storeAddresses[1], _)).Times(1);
   queue.commitStore(storeUopPtr);
+
+  // With only one store permitted per cycle, a following load can only be
+  // scheduled in the same cycle if the store consumed a single request
+  queue.addLoad(loadUopPtr);
+  queue.startLoad(loadUopPtr);
+  EXPECT_CALL(dataMemory, requestRead(addresses[0], 2)).Times(1);
+  queue.tick();
+
+  EXPECT_EQ(queue.getCoalescedAccessesCount(), 2);
+  EXPECT_EQ(queue.getCoalescedRequestsCount(), 1);
 }
 
 INSTANTIATE_TEST_SUITE_P(LoadStoreQueueTests, LoadStoreQueueTest,
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "simeng/pipeline/MicroOpCache.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class MicroOpCacheTest : public testing::Test {
+ public:
+  // Two sets of two lines, each of up to four micro-ops, over 16-byte fetch
+  // blocks
+  MicroOpCacheTest() : cache(16, 2, 4, 16) {}
+
+ protected:
+  /** Construct a 4-byte instruction at `address` decoding into `uops`
+   * micro-ops. */
+  MicroOpCacheEntry entry(uint64_t address, uint16_t uops = 1) {
+    return {static_cast<uint32_t>(address), 4, address, uops};
+  }
+
+  MicroOpCache cache;
+};
+
+// Tests that a cache with no capacity is disabled and holds nothing
+TEST_F(MicroOpCacheTest, Disabled) {
+  MicroOpCache disabled(0, 2, 4, 16);
+  EXPECT_FALSE(disabled.isEnabled());
+  disabled.fill(entry(0), true);
+  EXPECT_FALSE(disabled.probe(0));
+  EXPECT_EQ(disabled.lookup(0).first, nullptr);
+}
+
+// Tests that a line ended by a taken branch may be entered at any instruction
+TEST_F(MicroOpCacheTest, LookupWithinLine) {
+  EXPECT_TRUE(cache.isEnabled());
+  cache.fill(entry(0), false);
+  cache.fill(entry(4), false);
+  // The line isn't held until it ends
+  EXPECT_FALSE(cache.probe(0));
+  cache.fill(entry(8), true);
+
+  EXPECT_TRUE(cache.probe(0));
+  auto [line, index] = cache.lookup(4);
+  ASSERT_NE(line, nullptr);
+  EXPECT_EQ(index, 1);
+  ASSERT_EQ(line->size(), 3);
+  EXPECT_EQ((*line)[2].address, 8);
+  EXPECT_FALSE(cache.probe(12));
+}
+
+// Tests that lines end at fetch block boundaries, at discontinuities, and once
+// full
+TEST_F(MicroOpCacheTest, LineEnds) {
+  // Crossing into the fetch block at 16 ends the line
+  cache.fill(entry(8), false);
+  cache.fill(entry(12), false);
+  cache.fill(entry(16, 3), false);
+  ASSERT_NE(cache.lookup(8).first, nullptr);
+  EXPECT_EQ(cache.lookup(8).first->size(), 2);
+  EXPECT_FALSE(cache.probe(16));
+
+  // The next instruction would exceed the four micro-ops of the line
+  cache.fill(entry(20, 2), false);
+  ASSERT_NE(cache.lookup(16).first, nullptr);
+  EXPECT_EQ(cache.lookup(16).first->size(), 1);
+
+  // A redirected instruction stream ends the line
+  cache.fill(entry(64), false);
+  EXPECT_TRUE(cache.probe(20));
+
+  // Instructions with more micro-ops than a line holds are never cached
+  cache.fill(entry(68, 5), true);
+  cache.fill(entry(72), true);
+  EXPECT_TRUE(cache.probe(64));
+  EXPECT_FALSE(cache.probe(68));
+  EXPECT_TRUE(cache.probe(72));
+}
+
+// Tests that the least recently used line of a set is replaced
+TEST_F(MicroOpCacheTest, ReplaceLRU) {
+  // Fetch blocks 0, 32 and 64 all map to the same set
+  cache.fill(entry(0), true);
+  cache.fill(entry(32), true);
+  cache.lookup(0);
+  cache.fill(entry(64), true);
+
+  EXPECT_TRUE(cache.probe(0));
+  EXPECT_FALSE(cache.probe(32));
+  EXPECT_TRUE(cache.probe(64));
+  // Block 16 maps to the other set
+  cache.fill(entry(16), true);
+  EXPECT_TRUE(cache.probe(0));
+  EXPECT_TRUE(cache.probe(16));
+}
+
+}  // namespace pipeline
+}  // namespace simeng
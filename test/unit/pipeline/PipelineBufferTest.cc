@@ -59,6 +59,21 @@ TEST_P(PipelineBufferTest, Fill) {
   }
 }
 
+// Test that a buffer is only empty while every slot holds the empty value
+TEST_P(PipelineBufferTest, IsEmpty) {
+  auto pipelineBuffer = PipelineBuffer<int>(GetParam(), 0);
+  EXPECT_TRUE(pipelineBuffer.isEmpty(0));
+
+  pipelineBuffer.getTailSlots()[GetParam() - 1] = 1;
+  EXPECT_FALSE(pipelineBuffer.isEmpty(0));
+
+  pipelineBuffer.tick();
+  EXPECT_FALSE(pipelineBuffer.isEmpty(0));
+
+  pipelineBuffer.getHeadSlots()[GetParam() - 1] = 0;
+  EXPECT_TRUE(pipelineBuffer.isEmpty(0));
+}
+
 INSTANTIATE_TEST_SUITE_P(PipelineBufferTests, PipelineBufferTest,
                          ::testing::Range<size_t>(1, 9, 1));
 
@@ -97,5 +97,38 @@ TEST_F(RegisterAliasTableTest, Rewind) {
   EXPECT_EQ(rat.freeRegistersAvailable(0), initialFreeRegisters);
 }
 
+// Tests that a RAT for a later partition of the physical register file only
+// maps to, allocates, and frees registers within its partition
+TEST_F(RegisterAliasTableTest, Partition) {
+  auto partitionRAT =
+      RegisterAliasTable({{8, architecturalCount}}, {physicalCount}, 1);
+  auto initialFreeRegisters = partitionRAT.freeRegistersAvailable(0);
+  EXPECT_EQ(initialFreeRegisters, physicalCount - architecturalCount);
+
+  auto oldMapping = partitionRAT.getMapping(reg);
+  EXPECT_GE(oldMapping.tag, physicalCount);
+  EXPECT_LT(oldMapping.tag, 2 * physicalCount);
+
+  // Allocate every free register, checking each lies within the partition
+  std::vector<Register> allocated;
+  for (unsigned int i = 0; i < initialFreeRegisters; i++) {
+    auto mapping = partitionRAT.allocate(reg);
+    EXPECT_GE(mapping.tag, physicalCount);
+    EXPECT_LT(mapping.tag, 2 * physicalCount);
+    allocated.push_back(mapping);
+  }
+  EXPECT_EQ(partitionRAT.freeRegistersAvailable(0), 0);
+
+  // Rewind the youngest allocation and commit the rest, restoring the free
+  // registers
+  partitionRAT.rewind(allocated.back());
+  allocated.pop_back();
+  EXPECT_EQ(partitionRAT.getMapping(reg), allocated.back());
+  for (const auto& mapping : allocated) {
+    partitionRAT.commit(mapping);
+  }
+  EXPECT_EQ(partitionRAT.freeRegistersAvailable(0), initialFreeRegisters);
+}
+
 }  // namespace pipeline
 }  // namespace simeng
@@ -22,7 +22,7 @@ class RenameUnitTest : public testing::Test {
             [](auto registers, auto values) {}, [](auto insn) {}),
         rob(
             robSize, rat, lsq, [](auto insn) {}, [](auto branchAddr) {},
-            predictor, 16, 4),
+            predictor, storeSets, 16, 4),
         renameUnit(input, output, rob, rat, lsq, physRegCounts.size()),
         uop(new MockInstruction),
         uop2(new MockInstruction),
@@ -52,6 +52,7 @@ class RenameUnitTest : public testing::Test {
 
   MockMemoryInterface memory;
   MockBranchPredictor predictor;
+  StoreSetPredictor storeSets = StoreSetPredictor(0, 1);
   span<PipelineBuffer<std::shared_ptr<Instruction>>> completionSlots;
 
   RegisterAliasTable rat;
@@ -116,6 +117,7 @@ TEST_F(RenameUnitTest, tick) {
   EXPECT_EQ(renameUnit.getROBStalls(), 0);
   EXPECT_EQ(renameUnit.getLoadQueueStalls(), 0);
   EXPECT_EQ(renameUnit.getStoreQueueStalls(), 0);
+  EXPECT_EQ(renameUnit.getRenamedCount(), 1);
 
   // Check ROB, LSQ, and RAT mappings have been changed accordingly
   EXPECT_EQ(rob.size(), 1);
@@ -152,6 +154,7 @@ TEST_F(RenameUnitTest, uopException) {
   EXPECT_EQ(renameUnit.getROBStalls(), 0);
   EXPECT_EQ(renameUnit.getLoadQueueStalls(), 0);
   EXPECT_EQ(renameUnit.getStoreQueueStalls(), 0);
+  EXPECT_EQ(renameUnit.getRenamedCount(), 1);
 }
 
 // Test for when no physical registers are available
@@ -216,6 +219,7 @@ TEST_F(RenameUnitTest, fullROB) {
   EXPECT_EQ(renameUnit.getROBStalls(), 1);
   EXPECT_EQ(renameUnit.getLoadQueueStalls(), 0);
   EXPECT_EQ(renameUnit.getStoreQueueStalls(), 0);
+  EXPECT_EQ(renameUnit.getRenamedCount(), 0);
 }
 
 // Test a LOAD instruction is handled correctly
@@ -33,11 +33,12 @@ class ReorderBufferTest : public testing::Test {
         uopPtr(uop),
         uopPtr2(uop2),
         uopPtr3(uop3),
+        storeSets(64, 8),
         reorderBuffer(
             maxROBSize, rat, lsq,
             [this](auto insn) { exceptionHandler.raiseException(insn); },
             [this](auto branchAddress) { loopBoundaryAddr = branchAddress; },
-            predictor, 4, 2) {}
+            predictor, storeSets, 4, 2) {}
 
  protected:
   const uint8_t maxLSQLoads = 32;
@@ -61,6 +62,8 @@ class ReorderBufferTest : public testing::Test {
 
   MockMemoryInterface dataMemory;
 
+  StoreSetPredictor storeSets;
+
   ReorderBuffer reorderBuffer;
 
   uint64_t loopBoundaryAddr = 0;
@@ -89,6 +92,22 @@ TEST_F(ReorderBufferTest, SequenceId) {
   EXPECT_EQ(reorderBuffer.size(), 2);
 }
 
+// Tests that a ROB for another hardware thread tags its instructions with that
+// thread, and allocates IDs from a range disjoint from the first thread's
+TEST_F(ReorderBufferTest, ThreadId) {
+  ReorderBuffer threadBuffer(
+      maxROBSize, rat, lsq, [](auto insn) {}, [](auto branchAddress) {},
+      predictor, storeSets, 4, 2, 1);
+  reorderBuffer.reserve(uopPtr);
+  threadBuffer.reserve(uopPtr2);
+
+  EXPECT_EQ(uop->getThreadId(), 0);
+  EXPECT_EQ(uop2->getThreadId(), 1);
+  EXPECT_NE(uop->getSequenceId(), uop2->getSequenceId());
+  EXPECT_NE(uop->getInstructionId(), uop2->getInstructionId());
+  EXPECT_EQ(uop2->getInstructionId() >> 48, 1);
+}
+
 // Tests that the amount of free space is correctly reported
 TEST_F(ReorderBufferTest, FreeSpace) {
   reorderBuffer.reserve(uopPtr);
@@ -149,6 +168,26 @@ TEST_F(ReorderBufferTest, CommitMultiple) {
   EXPECT_EQ(reorderBuffer.getInstructionsCommittedCount(), 2);
 }
 
+// Tests that the retire handler is called with each committed instruction in
+// order, and that the oldest remaining instruction is exposed as the head
+TEST_F(ReorderBufferTest, RetireHandler) {
+  std::vector<std::shared_ptr<Instruction>> retired;
+  reorderBuffer.setRetireHandler(
+      [&retired](const auto& insn) { retired.push_back(insn); });
+  reorderBuffer.reserve(uopPtr);
+  reorderBuffer.reserve(uopPtr2);
+  reorderBuffer.reserve(uopPtr3);
+  EXPECT_EQ(reorderBuffer.getHead(), uopPtr);
+
+  uopPtr->setCommitReady();
+  uopPtr2->setCommitReady();
+  auto committed = reorderBuffer.commit(3);
+
+  EXPECT_EQ(committed, 2);
+  EXPECT_THAT(retired, ElementsAre(uopPtr, uopPtr2));
+  EXPECT_EQ(reorderBuffer.getHead(), uopPtr3);
+}
+
 // Tests that the reorder buffer correctly informs the LSQ when committing a
 // load
 TEST_F(ReorderBufferTest, CommitLoad) {
@@ -290,6 +329,84 @@ TEST_F(ReorderBufferTest, commitMicroOps) {
   EXPECT_EQ(reorderBuffer.size(), 0);
 }
 
+// Test that a macro-op whose micro-ops wrap around the end of the ROB's
+// underlying storage is correctly set to commitReady
+TEST_F(ReorderBufferTest, commitMicroOpsWrapAround) {
+  // Advance the head of the ROB to two entries before the end of its storage
+  for (int i = 0; i < maxROBSize - 2; i++) {
+    std::shared_ptr<Instruction> filler = std::make_shared<MockInstruction>();
+    reorderBuffer.reserve(filler);
+    filler->setCommitReady();
+    EXPECT_EQ(reorderBuffer.commit(1), 1);
+  }
+  EXPECT_EQ(reorderBuffer.size(), 0);
+
+  uop->setIsMicroOp(true);
+  uop->setIsLastMicroOp(false);
+  uop2->setIsMicroOp(true);
+  uop2->setIsLastMicroOp(false);
+  uop3->setIsMicroOp(true);
+  uop3->setIsLastMicroOp(true);
+  reorderBuffer.reserve(uopPtr);
+  reorderBuffer.reserve(uopPtr2);
+  reorderBuffer.reserve(uopPtr3);
+  EXPECT_EQ(reorderBuffer.size(), 3);
+  EXPECT_EQ(reorderBuffer.getFreeSpace(), maxROBSize - 3);
+
+  uint64_t insnId = uopPtr->getInstructionId();
+  EXPECT_EQ(uopPtr3->getInstructionId(), insnId);
+
+  uop->setWaitingCommit();
+  uop2->setWaitingCommit();
+  reorderBuffer.commitMicroOps(insnId);
+  EXPECT_FALSE(uopPtr->canCommit());
+  EXPECT_FALSE(uopPtr3->canCommit());
+
+  uop3->setWaitingCommit();
+  reorderBuffer.commitMicroOps(insnId);
+  EXPECT_TRUE(uopPtr->canCommit());
+  EXPECT_TRUE(uopPtr2->canCommit());
+  EXPECT_TRUE(uopPtr3->canCommit());
+
+  EXPECT_EQ(reorderBuffer.commit(3), 3);
+  EXPECT_EQ(reorderBuffer.getInstructionsCommittedCount(), maxROBSize - 1);
+  EXPECT_EQ(reorderBuffer.size(), 0);
+}
+
+// Test that a macro-op partially removed by a flush is not set to commitReady,
+// and that its instruction ID can be reused by newly reserved micro-ops
+TEST_F(ReorderBufferTest, commitMicroOpsAfterFlush) {
+  std::shared_ptr<Instruction> older = std::make_shared<MockInstruction>();
+  reorderBuffer.reserve(older);
+
+  uop->setIsMicroOp(true);
+  uop->setIsLastMicroOp(false);
+  uop2->setIsMicroOp(true);
+  uop2->setIsLastMicroOp(false);
+  reorderBuffer.reserve(uopPtr);
+  reorderBuffer.reserve(uopPtr2);
+
+  // Flush the incomplete macro-op before its final micro-op is reserved
+  reorderBuffer.flush(older->getInstructionId());
+  EXPECT_EQ(reorderBuffer.size(), 1);
+  EXPECT_TRUE(uop->isFlushed());
+  EXPECT_TRUE(uop2->isFlushed());
+
+  // Reserve a new macro-op which is assigned the same instruction ID
+  uop3->setIsMicroOp(true);
+  uop3->setIsLastMicroOp(true);
+  reorderBuffer.reserve(uopPtr3);
+  EXPECT_EQ(uopPtr3->getInstructionId(), uopPtr->getInstructionId());
+
+  uop3->setWaitingCommit();
+  reorderBuffer.commitMicroOps(uopPtr3->getInstructionId());
+  EXPECT_TRUE(uopPtr3->canCommit());
+
+  older->setCommitReady();
+  EXPECT_EQ(reorderBuffer.commit(2), 2);
+  EXPECT_EQ(reorderBuffer.size(), 0);
+}
+
 // Test that a detected violating load in the lsq leads to a flush
 TEST_F(ReorderBufferTest, violatingLoad) {
   const uint64_t strAddr = 16;
@@ -322,7 +439,7 @@ TEST_F(ReorderBufferTest, violatingLoad) {
 
   // Start load "Out of order"
   EXPECT_CALL(*uop2, getGeneratedAddresses()).Times(1);
-  EXPECT_CALL(*uop, getGeneratedAddresses()).Times(1);
+  EXPECT_CALL(*uop, getGeneratedAddresses()).Times(0);
   lsq.startLoad(uopPtr2);
 
   // Set store "ready to commit" so that violation gets detected
@@ -332,12 +449,14 @@ TEST_F(ReorderBufferTest, violatingLoad) {
   span<const RegisterValue> strDataSpan = {&strData, 1};
   ON_CALL(*uop, getData()).WillByDefault(Return(strDataSpan));
   EXPECT_CALL(*uop, getData()).Times(1);
+  // Store's addresses are registered with the LSQ once generated
+  EXPECT_CALL(*uop, getGeneratedAddresses()).Times(1);
   lsq.supplyStoreData(uopPtr);
 
   EXPECT_CALL(*uop, isStoreAddress()).WillOnce(Return(true));
   EXPECT_CALL(*uop, getGeneratedAddresses()).Times(1);        // in LSQ
   EXPECT_CALL(dataMemory, requestWrite(strTarget, strData));  // in LSQ
-  EXPECT_CALL(*uop2, getGeneratedAddresses()).Times(1);       // in LSQ
+  EXPECT_CALL(*uop2, getGeneratedAddresses()).Times(0);       // in LSQ
   unsigned int committed = reorderBuffer.commit(4);
 
   EXPECT_EQ(committed, 1);
@@ -347,6 +466,12 @@ TEST_F(ReorderBufferTest, violatingLoad) {
   EXPECT_EQ(lsq.getViolatingLoad(), uopPtr2);
   EXPECT_EQ(reorderBuffer.getFlushAddress(), 4096);
   EXPECT_EQ(reorderBuffer.getFlushInsnId(), 0);
+
+  // The violation should train the store set predictor such that the load is
+  // now predicted to depend on the store
+  EXPECT_EQ(storeSets.getTrainingsCount(), 1);
+  storeSets.dispatchStore(uopPtr);
+  EXPECT_EQ(storeSets.predictDependency(uopPtr2), uopPtr);
 }
 
 // Test that a branch is treated as expected, will trigger the loop buffer when
@@ -447,6 +572,44 @@ TEST_F(ReorderBufferTest, branch) {
 
   // Check that branch misprediction metrics have been correctly collected
   EXPECT_EQ(reorderBuffer.getBranchMispredictedCount(), 8);
+  EXPECT_EQ(reorderBuffer.getRetiredIndirectBranchesCount(), 0);
+}
+
+// Test that register-indirect branches are counted separately
+TEST_F(ReorderBufferTest, indirectBranch) {
+  const uint64_t insnAddr = 4096;
+  const uint64_t branchAddr = 1024;
+  ON_CALL(*uop, isBranch()).WillByDefault(Return(true));
+  ON_CALL(*uop, getBranchType())
+      .WillByDefault(Return(BranchType::Unconditional));
+  ON_CALL(*uop, getKnownOffset()).WillByDefault(Return(0));
+  uopPtr->setSequenceId(0);
+  uopPtr->setInstructionId(0);
+  uopPtr->setInstructionAddress(insnAddr);
+  uopPtr->setBranchPrediction({true, branchAddr});
+  uop->setExecuted(true);
+  uopPtr->setCommitReady();
+
+  // Mispredicted target
+  uop->setBranchResults(true, branchAddr + 64);
+  reorderBuffer.reserve(uopPtr);
+  EXPECT_CALL(predictor,
+              update(insnAddr, true, branchAddr + 64, BranchType::Unconditional,
+                     uop->getInstructionId()));
+  reorderBuffer.commit(1);
+
+  // Correctly predicted target
+  uop->setBranchResults(true, branchAddr);
+  reorderBuffer.reserve(uopPtr);
+  EXPECT_CALL(predictor,
+              update(insnAddr, true, branchAddr, BranchType::Unconditional,
+                     uop->getInstructionId()));
+  reorderBuffer.commit(1);
+
+  EXPECT_EQ(reorderBuffer.getRetiredBranchesCount(), 2);
+  EXPECT_EQ(reorderBuffer.getBranchMispredictedCount(), 1);
+  EXPECT_EQ(reorderBuffer.getRetiredIndirectBranchesCount(), 2);
+  EXPECT_EQ(reorderBuffer.getIndirectBranchMispredictedCount(), 1);
 }
 
 // Tests that only those destination registers which have been renamed are
@@ -0,0 +1,127 @@
+#include "../MockInstruction.hh"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "simeng/Instruction.hh"
+#include "simeng/pipeline/StoreSetPredictor.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class StoreSetPredictorTest : public testing::Test {
+ public:
+  StoreSetPredictorTest()
+      : predictor(ssitSize, lfstSize),
+        load(new MockInstruction),
+        store(new MockInstruction),
+        store2(new MockInstruction),
+        loadPtr(load),
+        storePtr(store),
+        store2Ptr(store2) {
+    load->setInstructionAddress(0x100);
+    store->setInstructionAddress(0x80);
+    store2->setInstructionAddress(0x40);
+  }
+
+ protected:
+  const uint32_t ssitSize = 1024;
+  const uint32_t lfstSize = 128;
+
+  StoreSetPredictor predictor;
+
+  MockInstruction* load;
+  MockInstruction* store;
+  MockInstruction* store2;
+
+  std::shared_ptr<Instruction> loadPtr;
+  std::shared_ptr<Instruction> storePtr;
+  std::shared_ptr<Instruction> store2Ptr;
+};
+
+// Tests that no dependence is predicted for an untrained load
+TEST_F(StoreSetPredictorTest, Untrained) {
+  EXPECT_TRUE(predictor.isEnabled());
+  predictor.dispatchStore(storePtr);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), nullptr);
+  EXPECT_EQ(predictor.getPredictedDependenciesCount(), 0);
+}
+
+// Tests that a predictor with no SSIT entries never predicts a dependence
+TEST_F(StoreSetPredictorTest, Disabled) {
+  StoreSetPredictor disabled(0, lfstSize);
+  EXPECT_FALSE(disabled.isEnabled());
+
+  disabled.update(loadPtr, storePtr);
+  disabled.dispatchStore(storePtr);
+  EXPECT_EQ(disabled.predictDependency(loadPtr), nullptr);
+  EXPECT_EQ(disabled.getTrainingsCount(), 0);
+}
+
+// Tests that a trained load is predicted to depend on the in-flight store of
+// its store set until that store has generated its addresses
+TEST_F(StoreSetPredictorTest, PredictAfterViolation) {
+  predictor.update(loadPtr, storePtr);
+  EXPECT_EQ(predictor.getTrainingsCount(), 1);
+
+  // No store of the set is in flight
+  EXPECT_EQ(predictor.predictDependency(loadPtr), nullptr);
+
+  predictor.dispatchStore(storePtr);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), storePtr);
+  EXPECT_EQ(predictor.getPredictedDependenciesCount(), 1);
+
+  predictor.storeExecuted(storePtr);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), nullptr);
+}
+
+// Tests that the most recently dispatched store of a set is predicted, and
+// that an older store of the set executing does not clear it
+TEST_F(StoreSetPredictorTest, YoungestStore) {
+  predictor.update(loadPtr, storePtr);
+
+  predictor.dispatchStore(storePtr);
+  std::shared_ptr<Instruction> youngerStore(new MockInstruction);
+  youngerStore->setInstructionAddress(0x80);
+  predictor.dispatchStore(youngerStore);
+
+  EXPECT_EQ(predictor.predictDependency(loadPtr), youngerStore);
+  predictor.storeExecuted(storePtr);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), youngerStore);
+}
+
+// Tests that training a load against a second store merges the stores into the
+// load's existing store set
+TEST_F(StoreSetPredictorTest, MergeSets) {
+  predictor.update(loadPtr, storePtr);
+  predictor.update(loadPtr, store2Ptr);
+
+  predictor.dispatchStore(store2Ptr);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), store2Ptr);
+
+  predictor.dispatchStore(storePtr);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), storePtr);
+}
+
+// Tests that flushed stores are not predicted
+TEST_F(StoreSetPredictorTest, FlushedStore) {
+  predictor.update(loadPtr, storePtr);
+  predictor.dispatchStore(storePtr);
+
+  storePtr->setFlushed();
+  EXPECT_EQ(predictor.predictDependency(loadPtr), nullptr);
+  EXPECT_EQ(predictor.getPredictedDependenciesCount(), 0);
+}
+
+// Tests that a load isn't predicted to depend on a store of another hardware
+// thread
+TEST_F(StoreSetPredictorTest, OtherThreadStore) {
+  predictor.update(loadPtr, storePtr);
+  storePtr->setThreadId(1);
+  predictor.dispatchStore(storePtr);
+
+  EXPECT_EQ(predictor.predictDependency(loadPtr), nullptr);
+  loadPtr->setThreadId(1);
+  EXPECT_EQ(predictor.predictDependency(loadPtr), storePtr);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
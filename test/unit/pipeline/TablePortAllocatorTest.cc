@@ -0,0 +1,162 @@
+#include <random>
+
+#include "../ConfigInit.hh"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/A64FXPortAllocator.hh"
+#include "simeng/pipeline/TablePortAllocator.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class TablePortAllocatorTest : public testing::Test {
+ public:
+  TablePortAllocatorTest()
+      : portAllocator(portArrangement), a64fxAllocator(portArrangement) {
+    portAllocator.setRSSizeGetter(
+        [this](std::vector<uint32_t>& sizeVec) { rsSizes(sizeVec); });
+    a64fxAllocator.setRSSizeGetter(
+        [this](std::vector<uint32_t>& sizeVec) { rsSizes(sizeVec); });
+  }
+
+  void rsSizes(std::vector<uint32_t>& sizeVec) const {
+    sizeVec = rsFreeEntries;
+  }
+
+ protected:
+  // The A64FX port and reservation station layout, with the A64FX dispatch
+  // policy expressed as allocation rules. The final rule spreads instructions
+  // across the ports of RSE0 which aren't otherwise shared.
+  ConfigInit configInit = ConfigInit(config::ISA::AArch64, R"YAML({
+  Ports: {
+    '0': {Portname: FLA, Instruction-Group-Support: [ALL]},
+    '1': {Portname: PR, Instruction-Group-Support: [ALL]},
+    '2': {Portname: EXA, Instruction-Group-Support: [ALL]},
+    '3': {Portname: FLB, Instruction-Group-Support: [ALL]},
+    '4': {Portname: EXB, Instruction-Group-Support: [ALL]},
+    '5': {Portname: EAGA, Instruction-Group-Support: [ALL]},
+    '6': {Portname: EAGB, Instruction-Group-Support: [ALL]},
+    '7': {Portname: BR, Instruction-Group-Support: [ALL]}
+  },
+  Reservation-Stations: {
+    '0': {Size: 20, Dispatch-Rate: 2, Ports: [FLA, PR, EXA]},
+    '1': {Size: 20, Dispatch-Rate: 2, Ports: [FLB, EXB]},
+    '2': {Size: 10, Dispatch-Rate: 1, Ports: [EAGA]},
+    '3': {Size: 10, Dispatch-Rate: 1, Ports: [EAGB]},
+    '4': {Size: 19, Dispatch-Rate: 1, Ports: [BR]}
+  },
+  Execution-Units: {
+    '0': {Pipelined: True}, '1': {Pipelined: True}, '2': {Pipelined: True},
+    '3': {Pipelined: True}, '4': {Pipelined: True}, '5': {Pipelined: True},
+    '6': {Pipelined: True}, '7': {Pipelined: True}
+  },
+  Port-Allocator: {
+    Type: Table,
+    Rules: {
+      '0': {Ports: [EXA, EXB, EAGA, EAGB], Cases: {
+        '0': {Conditions: {
+                '0': {Stations: [0, 1], Minus: [2, 3], At-Least: 4},
+                '1': {Stations: [0], Minus: [1], At-Least: 4}},
+              Table: {'0': {Stations: [0, 1]}}},
+        '1': {Conditions: {'0': {Stations: [0, 1], Minus: [2, 3], At-Least: 4}},
+              Table: {'0': {Stations: [0, 1]}, '1': {Stations: [0, 1], Rank: 1}}},
+        '2': {Conditions: {'0': {Stations: [2, 3], Minus: [0, 1], At-Least: 4}},
+              Table: {'0': {Stations: [2, 3]}, '1': {Stations: [2, 3], Rank: 1}}},
+        '3': {Conditions: {'0': {Most-Free: [0, 1, 2, 3], In: [0, 1]}},
+              Table: {'0': {Stations: [0, 1]}, '1': {Stations: [0, 1], Rank: 1},
+                      '2': {Stations: [2, 3]}, '3': {Stations: [2, 3], Rank: 1}}},
+        '4': {Table: {'0': {Stations: [2, 3]}, '1': {Stations: [2, 3], Rank: 1},
+                      '2': {Stations: [0, 1]}, '3': {Stations: [0, 1], Rank: 1}}}}},
+      '1': {Ports: [EXA, EXB], Cases: {
+        '0': {Conditions: {'0': {Stations: [0], Minus: [1], At-Least: 1},
+                           '1': {Stations: [1], At-Most: 0}},
+              Table: {'0': {Stations: [0]}}},
+        '1': {Conditions: {'0': {Stations: [1], Minus: [0], At-Least: 1},
+                           '1': {Stations: [0], At-Most: 0}},
+              Table: {'0': {Stations: [1]}}},
+        '2': {Table: {'0': {Stations: [0]}, '1': {Stations: [1]}}}}},
+      '2': {Ports: [FLA, FLB], Cases: {
+        '0': {Conditions: {'0': {Stations: [0], Minus: [1], At-Least: 1},
+                           '1': {Stations: [1], At-Most: 0}},
+              Table: {'0': {Stations: [0]}}},
+        '1': {Conditions: {'0': {Stations: [1], Minus: [0], At-Least: 1},
+                           '1': {Stations: [0], At-Most: 0}},
+              Table: {'0': {Stations: [1]}}},
+        '2': {Table: {'0': {Stations: [0]}, '1': {Stations: [1]}}}}},
+      '3': {Ports: [EAGA, EAGB], Cases: {
+        '0': {Conditions: {'0': {Stations: [2], Minus: [3], At-Least: 1},
+                           '1': {Stations: [3], At-Most: 0}},
+              Table: {'0': {Stations: [2]}}},
+        '1': {Conditions: {'0': {Stations: [3], Minus: [2], At-Least: 1},
+                           '1': {Stations: [2], At-Most: 0}},
+              Table: {'0': {Stations: [3]}}},
+        '2': {Table: {'0': {Stations: [2]}, '1': {Stations: [3]}}}}},
+      '4': {Ports: [FLA, PR, FLB], Cases: {
+        '0': {Table: {'0': {Stations: [0]}}}}}
+    }
+  }
+  })YAML");
+
+  std::vector<uint32_t> rsFreeEntries = {20, 20, 10, 10, 19};
+  const std::vector<std::vector<uint16_t>> portArrangement = {
+      {0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}};
+
+  TablePortAllocator portAllocator;
+  A64FXPortAllocator a64fxAllocator;
+};
+
+// Tests that the A64FX dispatch policy, expressed as allocation rules, makes
+// the same allocations as the A64FXPortAllocator
+TEST_F(TablePortAllocatorTest, matchesA64FX) {
+  const std::vector<std::vector<uint16_t>> groups = {
+      {2, 4, 5, 6}, {2, 4}, {0, 3}, {5, 6}, {2}, {0}, {1}, {4}, {3}, {7}};
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<uint32_t> smallRS(0, 10);
+  std::uniform_int_distribution<uint32_t> largeRS(0, 20);
+  std::uniform_int_distribution<size_t> group(0, groups.size() - 1);
+  std::uniform_int_distribution<size_t> width(1, 4);
+
+  for (int cycle = 0; cycle < 10000; cycle++) {
+    // Bias free entries towards empty and full stations, so that every case is
+    // exercised
+    rsFreeEntries = {largeRS(rng), largeRS(rng), smallRS(rng), smallRS(rng),
+                     19};
+    if (cycle % 3 == 0) rsFreeEntries[cycle % 4] = 0;
+
+    portAllocator.tick();
+    a64fxAllocator.tick();
+    size_t allocations = width(rng);
+    for (size_t i = 0; i < allocations; i++) {
+      const auto& ports = groups[group(rng)];
+      uint16_t port = portAllocator.allocate(ports);
+      EXPECT_EQ(port, a64fxAllocator.allocate(ports));
+      portAllocator.issued(port);
+    }
+  }
+}
+
+// Tests that the lowest weighted of an instruction's ports within the selected
+// reservation station is allocated
+TEST_F(TablePortAllocatorTest, lowestWeightInStation) {
+  portAllocator.tick();
+  EXPECT_EQ(portAllocator.allocate({0, 1, 3}), 0);
+  EXPECT_EQ(portAllocator.allocate({0, 1, 3}), 1);
+  EXPECT_EQ(portAllocator.allocate({0, 1, 3}), 0);
+  portAllocator.issued(0);
+  portAllocator.issued(0);
+  EXPECT_EQ(portAllocator.allocate({0, 1, 3}), 0);
+}
+
+// Tests that instructions no rule applies to are allocated the lowest weighted
+// of their ports
+TEST_F(TablePortAllocatorTest, noRule) {
+  portAllocator.tick();
+  EXPECT_EQ(portAllocator.allocate({1, 2}), 1);
+  EXPECT_EQ(portAllocator.allocate({1, 2}), 2);
+  portAllocator.issued(2);
+  EXPECT_EQ(portAllocator.allocate({1, 2}), 2);
+  portAllocator.deallocate(1);
+  EXPECT_EQ(portAllocator.allocate({1, 2}), 1);
+}
+
+}  // namespace pipeline
+}  // namespace simeng
@@ -0,0 +1,112 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "simeng/pipeline/TopDownAnalysis.hh"
+
+namespace simeng {
+namespace pipeline {
+
+class PipelineTopDownAnalysisTest : public testing::Test {
+ public:
+  PipelineTopDownAnalysisTest() : analysis(4) {}
+
+ protected:
+  /** Retrieve the slots of the top-level category `name`, or of its
+   * subcategory `child` if one is given. */
+  uint64_t getSlots(const std::string& name, const std::string& child = "") {
+    for (const auto& node : analysis.getBreakdown()) {
+      if (node.name != name) continue;
+      if (child.empty()) return node.slots;
+      for (const auto& subcategory : node.children) {
+        if (subcategory.name == child) return subcategory.slots;
+      }
+    }
+    ADD_FAILURE() << "No category " << name << " " << child;
+    return 0;
+  }
+
+  TopDownAnalysis analysis;
+};
+
+// Tests that unfilled slots are attributed to the cause supplied, with those
+// of the front-end split by whether any uop was delivered
+TEST_F(PipelineTopDownAnalysisTest, UnfilledSlots) {
+  analysis.addCycle(0, SlotStall::Frontend);
+  analysis.addCycle(3, SlotStall::Frontend);
+  analysis.addCycle(4, SlotStall::Frontend);
+  analysis.addCycle(1, SlotStall::MemoryBound);
+  analysis.addCycle(2, SlotStall::CoreBound);
+  analysis.addCycle(0, SlotStall::BranchMispredict);
+  analysis.addCycle(0, SlotStall::MachineClear);
+
+  EXPECT_EQ(analysis.getCycles(), 7);
+  EXPECT_EQ(getSlots("frontendBound", "latency"), 4);
+  EXPECT_EQ(getSlots("frontendBound", "bandwidth"), 1);
+  EXPECT_EQ(getSlots("frontendBound"), 5);
+  EXPECT_EQ(getSlots("backendBound", "memoryBound"), 3);
+  EXPECT_EQ(getSlots("backendBound", "coreBound"), 2);
+  EXPECT_EQ(getSlots("backendBound"), 5);
+  EXPECT_EQ(getSlots("badSpeculation", "branchMispredicts"), 4);
+  EXPECT_EQ(getSlots("badSpeculation", "machineClears"), 4);
+}
+
+// Tests that every slot is accounted for once the uops delivered have retired
+// or been squashed
+TEST_F(PipelineTopDownAnalysisTest, SlotsSumToCycles) {
+  analysis.addCycle(4, SlotStall::Frontend);
+  analysis.addCycle(2, SlotStall::CoreBound);
+  analysis.retire(3);
+  analysis.squash(3, SlotStall::BranchMispredict);
+  analysis.addCycle(0, SlotStall::BranchMispredict);
+  analysis.addCycle(1, SlotStall::Frontend);
+  analysis.retire(1);
+
+  EXPECT_EQ(getSlots("retiring"), 4);
+  EXPECT_EQ(getSlots("badSpeculation", "branchMispredicts"), 7);
+  EXPECT_EQ(getSlots("badSpeculation"), 7);
+
+  uint64_t slots = 0;
+  for (const auto& node : analysis.getBreakdown()) {
+    uint64_t childSlots = 0;
+    for (const auto& child : node.children) childSlots += child.slots;
+    if (!node.children.empty()) {
+      EXPECT_EQ(childSlots, node.slots);
+    }
+    slots += node.slots;
+  }
+  EXPECT_EQ(slots, analysis.getCycles() * 4);
+
+  auto stats = analysis.getStats();
+  EXPECT_EQ(stats["topdown.slots"], "16");
+  EXPECT_EQ(stats["topdown.retiring"], "25%");
+  EXPECT_EQ(stats["topdown.badSpeculation.branchMispredicts"], "43.8%");
+  EXPECT_EQ(stats["topdown.backendBound.coreBound"], "12.5%");
+  EXPECT_EQ(stats["topdown.frontendBound.bandwidth"], "18.8%");
+}
+
+// Tests that the breakdown is written as nested YAML or JSON
+TEST_F(PipelineTopDownAnalysisTest, Write) {
+  analysis.addCycle(2, SlotStall::Frontend);
+  analysis.retire(2);
+
+  std::ostringstream yaml;
+  analysis.write(yaml, false);
+  EXPECT_THAT(yaml.str(), testing::HasSubstr("slots: 4\n"));
+  EXPECT_THAT(yaml.str(),
+              testing::HasSubstr("retiring:\n  slots: 2\n  fraction: 0.5000"));
+  EXPECT_THAT(yaml.str(),
+              testing::HasSubstr("  bandwidth:\n    slots: 2\n    fraction: "
+                                 "0.5000"));
+
+  std::ostringstream json;
+  analysis.write(json, true);
+  EXPECT_EQ(json.str().front(), '{');
+  EXPECT_THAT(json.str(),
+              testing::HasSubstr("\"frontendBound\": {\"slots\": 2,"));
+  EXPECT_THAT(json.str(), testing::HasSubstr("\"machineClears\": {\"slots\": "
+                                             "0,\"fraction\": 0.0000}"));
+}
+
+}  // namespace pipeline
+}  // namespace simeng
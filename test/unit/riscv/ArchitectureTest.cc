@@ -148,13 +148,14 @@ TEST_F(RiscVArchitectureTest, getMaxInstructionSize) {
 
 TEST_F(RiscVArchitectureTest, updateSystemTimerRegisters) {
   RegisterFileSet regFile = config::SimInfo::getArchRegStruct();
+  ArchitecturalRegisterFileSet archRegFile(regFile);
   Register cycleSystemReg = {
       RegisterType::SYSTEM,
       static_cast<uint16_t>(arch->getSystemRegisterTag(RISCV_SYSREG_CYCLE))};
 
   uint64_t ticks = 30;
   EXPECT_EQ(regFile.get(cycleSystemReg), RegisterValue(0, 8));
-  arch->updateSystemTimerRegisters(&regFile, ticks);
+  arch->updateSystemTimerRegisters(&archRegFile, ticks);
   EXPECT_EQ(regFile.get(cycleSystemReg), RegisterValue(ticks, 8));
 }
 
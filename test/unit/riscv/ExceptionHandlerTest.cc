@@ -400,6 +400,36 @@ TEST_F(RiscVExceptionHandlerTest, readBufferThen_length0) {
   EXPECT_EQ(retVal, expectedVal);
 }
 
+// Test that `readBufferThen()` reads the buffer as a single block when the
+// memory interface permits it
+TEST_F(RiscVExceptionHandlerTest, readBufferThen_block) {
+  // Create new mock instruction and ExceptionHandler
+  std::shared_ptr<MockInstruction> uopPtr(new MockInstruction);
+  ExceptionHandler handler(uopPtr, core, memory, kernel);
+
+  uint64_t retVal = 0;
+  uint64_t ptr = 16;
+  uint64_t length = 1000;
+
+  // Emulate a memory interface able to service the whole read immediately
+  EXPECT_CALL(memory, readBlock(ptr, ::testing::_, length))
+      .WillOnce(::testing::Invoke([](uint64_t, char* buffer, uint64_t size) {
+        std::fill(buffer, buffer + size, 'q');
+        return true;
+      }));
+  EXPECT_CALL(memory, requestRead(::testing::_, ::testing::_)).Times(0);
+  bool outcome = handler.readBufferThen(ptr, length, [&retVal]() {
+    retVal = 10;
+    return true;
+  });
+  EXPECT_TRUE(outcome);
+  EXPECT_EQ(retVal, 10);
+  EXPECT_EQ(handler.dataBuffer_.size(), length);
+  for (uint64_t i = 0; i < length; i++) {
+    EXPECT_EQ(handler.dataBuffer_[i], static_cast<unsigned char>('q'));
+  }
+}
+
 // Test that all RISC-V exception types print as expected
 TEST_F(RiscVExceptionHandlerTest, printException) {
   ON_CALL(core, getArchitecturalRegisterFileSet())